@@ -4,7 +4,28 @@ import argparse
 import time
 from pathlib import Path
 
-from kiln.sim.genesis import GenesisSim, GenesisSimConfig
+import numpy as np
+
+from kiln.sim.genesis import EnvPool, EnvPoolConfig, GenesisSim, GenesisSimConfig
+
+
+def _run_pool(bundle_dir: Path, *, n_envs: int, steps: int, backend: str) -> int:
+    cfg = EnvPoolConfig(
+        bundle_dir=str(bundle_dir),
+        num_envs=n_envs,
+        sim=GenesisSimConfig(dt=1 / 60, substeps=8, headless=True, seed=0, backend=backend),
+    )
+    with EnvPool(cfg) as pool:
+        print(f"[pool] envs={pool.num_envs} obs_shape={pool.obs_shape} act_shape={pool.act_shape}")
+        pool.reset()
+        actions = np.zeros((pool.num_envs, *pool.act_shape))
+        t0 = time.perf_counter()
+        for _ in range(steps):
+            pool.step(actions)
+        dt = time.perf_counter() - t0
+    env_steps = steps * n_envs
+    print(f"[pool] env_steps={env_steps} wall_time={dt:.3f}s env_steps/s={env_steps / max(1e-9, dt):.2f}")
+    return 0
 
 
 def main() -> int:
@@ -22,24 +43,68 @@ def main() -> int:
         default="cpu",
         help="Genesis backend selector.",
     )
+    parser.add_argument(
+        "--envs",
+        type=int,
+        default=0,
+        help="If > 0, step this many copies of the bundle in an EnvPool (one worker process each) "
+        "and report aggregate throughput.",
+    )
+    parser.add_argument(
+        "--merge-static",
+        action="store_true",
+        help="Merge fixed primitives into static compound entities (fewer entities for large scenes).",
+    )
+    parser.add_argument(
+        "--done-every",
+        type=int,
+        default=30,
+        help="Task bundles: read the done flags (one host sync) and reset finished episodes every N steps.",
+    )
     args = parser.parse_args()
 
     bundle_dir = Path(args.bundle)
+    if args.envs > 0:
+        return _run_pool(bundle_dir, n_envs=int(args.envs), steps=int(args.steps), backend=args.gs_backend)
+
     sim = GenesisSim(GenesisSimConfig(dt=1 / 60, substeps=8, headless=True, backend=args.gs_backend))
-    loaded = sim.load_env_bundle(bundle_dir)
+    loaded = sim.load_env_bundle(bundle_dir, merge_static=bool(args.merge_static))
     print(
         f"[bundle] dir={bundle_dir} entities={list(loaded.entities_by_id.keys())} "
         f"spawn_points={list(loaded.spawn_points.keys())}"
     )
+    for group in loaded.merged:
+        print(f"[bundle] static compound: {len(group.ids)} primitives {list(group.ids)}")
     print(f"[runtime] {sim.runtime_info()}")
 
+    # Bundles with a `task` section get device-side rewards/dones. Done flags are accumulated on
+    # the device and only read every `--done-every` steps, so other steps need no host reads
+    # (an episode that ends in between runs on until the next check).
+    task = sim.create_task(loaded) if loaded.bundle.task is not None else None
+    episode_return = None
+    done = None
+    episodes = 0
+    done_every = max(1, int(args.done_every))
+
     # Quick step loop for smoke testing.
     t0 = time.perf_counter()
-    for _ in range(int(args.steps)):
+    for step in range(1, int(args.steps) + 1):
         sim.step()
+        if task is not None:
+            ts = task.step()
+            episode_return = ts.reward if episode_return is None else episode_return + ts.reward
+            done = ts.done if done is None else done | ts.done
+            if step % done_every == 0 or step == int(args.steps):
+                if bool(done.any()):
+                    episodes += 1
+                    sim.reset()
+                    task.reset()
+                done = None
     dt = time.perf_counter() - t0
     sps = float(args.steps) / max(1e-9, dt)
     print(f"[run] steps={args.steps} wall_time={dt:.3f}s steps/s={sps:.2f}")
+    if task is not None and episode_return is not None:
+        print(f"[task] episodes_done={episodes} total_reward={float(episode_return.sum()):.3f} obs_dim={task.obs_dim}")
     return 0
 
 
@@ -7,6 +7,8 @@ and to later support scene authoring via USD.
 
 from .actions import ControlMode, DiscreteAction  # noqa: F401
 from .car import CarBlock, CarBlockConfig  # noqa: F401
-from .npc import NPCBlock, NPCBlockConfig  # noqa: F401
+from .components import step_control_all  # noqa: F401
+from .npc import NPCBlock, NPCBlockConfig, NPCCrowdPolicy, compute_crowd_avoidance  # noqa: F401
+from .observations import ObservationBuffer, ObservationSpec  # noqa: F401
 
 
@@ -10,7 +10,12 @@ from .actions import DiscreteAction
 
 @dataclass(frozen=True)
 class ActorState:
-    """Minimal kinematic state for an actor (intended for RL observation construction)."""
+    """
+    Minimal kinematic state for an actor (debugging / one-off reads).
+
+    For per-step RL observations of many actors use `kiln.actors.observations.ObservationBuffer`,
+    which writes the same fields for all of them into one preallocated float32 array.
+    """
 
     position: tuple[float, float, float]
     yaw: float
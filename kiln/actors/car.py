@@ -7,7 +7,8 @@ from typing import Any, Callable, Iterable
 
 from .actions import ControlMode, DiscreteAction
 from .base import ActorState
-from .components import BlockBody, BlockController, CollisionEvent, CollisionTracker
+from .components import BlockBody, BlockController, CollisionEvent, collision_tracker_for
+from .observations import ACTOR_OBS_SPEC, ObservationSpec
 from ..sim.genesis.sim import GenesisSim
 
 
@@ -37,6 +38,9 @@ class CarBlockConfig:
 class CarBlock:
     """A simple "car" represented as a rigid block."""
 
+    # Row layout of this actor in an `ObservationBuffer`.
+    OBS_SPEC: ObservationSpec = ACTOR_OBS_SPEC
+
     def __init__(
         self,
         sim: GenesisSim,
@@ -53,7 +57,7 @@ class CarBlock:
         self.entity = self._body.entity
         self._controller = BlockController(sim, self.entity, self.config, initial_yaw=self.config.initial_yaw)
 
-        self._collisions = CollisionTracker(self.entity)
+        self._collisions = collision_tracker_for(sim, self.entity)
         self.collision_events_this_step: list[CollisionEvent] = []
 
     def apply_action(self, action: int | DiscreteAction) -> None:
@@ -4,13 +4,18 @@ from __future__ import annotations
 
 import math
 import random
-from dataclasses import dataclass
-from enum import Enum
-from typing import Any, Callable, Iterable, Protocol
+from typing import Any, Callable, Iterable, Mapping, Protocol
+
+import numpy as np
 
 from .actions import ControlMode, DiscreteAction
 from .base import ActorState
+from .npc_state import NPCPolicyStore, npc_policy_store
 from .pathfinding import NavGrid, astar, cells_to_waypoints, simplify_path_cells
+from .planner import CrowdPlanner, PathRequest
+from ..sim.genesis.collisions import CollisionEvent, CollisionPhase, _import_torch_optional
+from ..sim.genesis.collisions import geom_range as _geom_range
+from ..sim.genesis.state import NO_ACTION, ActorStateStore, actor_state_store
 
 
 class BlockShapeConfig(Protocol):
@@ -44,27 +49,18 @@ class NPCPolicyConfig(Protocol):
     progress_eps: float
     waypoint_tolerance: float
     max_goal_samples: int
-
-
-class CollisionPhase(str, Enum):
-    BEGIN = "begin"
-    END = "end"
-
-
-@dataclass(frozen=True)
-class CollisionEvent:
-    """Collision begin/end event for this actor against a tracked target entity."""
-
-    step_idx: int
-    phase: CollisionPhase
-    other_entity: Any
-    other_entity_id: int
-    max_force: float | None = None
-    contact_count: int = 0
+    nav_diagonal: bool
+    nav_jps: bool
 
 
 class CollisionTracker:
-    """Collision polling utility for a rigid entity."""
+    """
+    Collision polling utility for a rigid entity.
+
+    Contact classification runs as tensor ops on the contact device: a geom -> tracked-target
+    lookup table (built in `set_targets`), a scatter-max for per-target force and a bincount
+    for contact counts. Only the per-target BEGIN/END diff is copied to the host, once per poll.
+    """
 
     def __init__(self, entity: Any) -> None:
         self.entity = entity
@@ -72,11 +68,17 @@ class CollisionTracker:
         self._handlers: list[Callable[[CollisionEvent], None]] = []
         self._tracked_entities: list[Any] = []
         self._ignore_entities: list[Any] = []
-        self._tracked_ranges: list[tuple[int, int, int]] = []  # (geom_start, geom_end, entity_id)
-        self._ignore_ranges: list[tuple[int, int]] = []  # (geom_start, geom_end)
+        # One entry per tracked target; the list position is the target's lookup-table value.
+        self._targets: list[tuple[int, Any]] = []  # (entity_id, entity)
         self._tracked_by_id: dict[int, Any] = {}
+        # CPU lookup table geom index -> target index (-1: untracked/ignored); moved to the
+        # contact device on first poll.
+        self._geom_lut_cpu: Any | None = None
+        self._geom_lut: Any | None = None
+        # Device-resident per-target state from the previous poll.
+        self._active: Any | None = None
+        self._active_force: Any | None = None
         self._active_entity_ids: set[int] = set()
-        self._active_max_force: dict[int, float] = {}
 
     def register_handler(self, handler: Callable[[CollisionEvent], None]) -> None:
         """Register a callback invoked for each BEGIN/END event."""
@@ -92,41 +94,47 @@ class CollisionTracker:
         self._tracked_entities = list(tracked_entities or [])
         self._ignore_entities = list(ignore_entities or [])
 
-        self._tracked_ranges = []
-        self._ignore_ranges = []
+        self._targets = []
         self._tracked_by_id = {}
         self._active_entity_ids.clear()
-        self._active_max_force.clear()
-
-        def geom_range(ent: Any) -> tuple[int, int] | None:
-            gs = getattr(ent, "geom_start", None)
-            ge = getattr(ent, "geom_end", None)
-            if gs is None or ge is None:
-                return None
-            try:
-                return (int(gs), int(ge))
-            except Exception:
-                return None
+        self._active = None
+        self._active_force = None
+        self._geom_lut = None
 
+        ranges: list[tuple[int, int, int]] = []
         for ent in self._tracked_entities:
-            r = geom_range(ent)
+            r = _geom_range(ent)
             if r is None:
                 continue
             eid = id(ent)
             self._tracked_by_id[eid] = ent
-            self._tracked_ranges.append((r[0], r[1], eid))
+            ranges.append((r[0], r[1], len(self._targets)))
+            self._targets.append((eid, ent))
+        # Tracked ranges are written in reverse so the first listed entity wins where ranges
+        # overlap (e.g. an entity tracked directly and through its parent).
+        ranges.reverse()
 
+        # Ignore ranges are written last so they win over overlapping tracked ranges.
         for ent in self._ignore_entities:
-            r = geom_range(ent)
+            r = _geom_range(ent)
             if r is None:
                 continue
-            self._ignore_ranges.append((r[0], r[1]))
+            ranges.append((r[0], r[1], -1))
+
+        self._geom_lut_cpu = None
+        torch = _import_torch_optional()
+        if torch is not None and self._targets:
+            n_geoms = max(e for _, e, _ in ranges)
+            lut = torch.full((max(1, n_geoms),), -1, dtype=torch.long)
+            for s, e, t in ranges:
+                lut[s:e] = t
+            self._geom_lut_cpu = lut
 
     def poll(self, *, step_idx: int, min_force: float = 0.0) -> list[CollisionEvent]:
         """Poll contacts from the last `scene.step()` and emit BEGIN/END events."""
         self.events_this_step = []
 
-        if not self._tracked_ranges:
+        if not self._targets:
             return self.events_this_step
         if not hasattr(self.entity, "get_contacts"):
             return self.events_this_step
@@ -148,66 +156,83 @@ class CollisionTracker:
         force_a = contacts.get("force_a") if min_force > 0.0 else None
         force_b = contacts.get("force_b") if min_force > 0.0 else None
 
-        try:
-            import torch
-        except Exception:
-            torch = None  # type: ignore[assignment]
-
-        current_ids: set[int] = set()
-        current_max_force: dict[int, float] = {}
-        current_counts: dict[int, int] = {}
-
-        if torch is not None and hasattr(geom_a, "shape"):
-            car_gs_i = int(car_gs)
-            car_ge_i = int(car_ge)
-
-            in_a = (geom_a >= car_gs_i) & (geom_a < car_ge_i)
-            in_b = (geom_b >= car_gs_i) & (geom_b < car_ge_i)
-            mask = in_a | in_b
-
-            if mask.numel() > 0 and bool(mask.any()):
-                other_geom = torch.where(in_a, geom_b, geom_a)[mask]
-                in_a_f = in_a[mask]
-
-                force_mag = None
-                if force_a is not None and force_b is not None:
-                    car_force = torch.where(in_a_f.unsqueeze(-1), force_a[mask], force_b[mask])
-                    force_mag = torch.linalg.vector_norm(car_force, dim=1)
-
-                def in_any_range(g: int, ranges: list[tuple[int, int]]) -> bool:
-                    for s, e in ranges:
-                        if s <= g < e:
-                            return True
-                    return False
-
-                def geom_to_tracked_id(g: int) -> int | None:
-                    if in_any_range(g, self._ignore_ranges):
-                        return None
-                    for s, e, eid in self._tracked_ranges:
-                        if s <= g < e:
-                            return eid
-                    return None
-
-                n = int(other_geom.shape[0])
-                for i in range(n):
-                    g = int(other_geom[i].item())
-                    eid = geom_to_tracked_id(g)
-                    if eid is None:
-                        continue
-                    if force_mag is not None:
-                        f = float(force_mag[i].item())
-                        if f < float(min_force):
-                            continue
-                        prev = current_max_force.get(eid)
-                        if prev is None or f > prev:
-                            current_max_force[eid] = f
-                    current_ids.add(eid)
-                    current_counts[eid] = current_counts.get(eid, 0) + 1
-
-        begins = current_ids.difference(self._active_entity_ids)
-        ends = self._active_entity_ids.difference(current_ids)
-
-        for eid in sorted(begins):
+        torch = _import_torch_optional()
+        if torch is None or self._geom_lut_cpu is None or not hasattr(geom_a, "shape"):
+            # No tensor contacts: nothing is touching, so every active contact ends.
+            ended = [(eid, 0.0) for eid in self._active_entity_ids]
+            self._active = None
+            self._active_force = None
+            return self._emit(step_idx=step_idx, begins=[], ends=ended)
+
+        device = geom_a.device
+        n_targets = len(self._targets)
+        if self._geom_lut is None or self._geom_lut.device != device:
+            self._geom_lut = self._geom_lut_cpu.to(device)
+        if self._active is None or self._active.device != device:
+            self._active = torch.zeros(n_targets, dtype=torch.bool, device=device)
+            self._active_force = torch.zeros(n_targets, dtype=torch.float32, device=device)
+
+        car_gs_i = int(car_gs)
+        car_ge_i = int(car_ge)
+        in_a = (geom_a >= car_gs_i) & (geom_a < car_ge_i)
+        in_b = (geom_b >= car_gs_i) & (geom_b < car_ge_i)
+        mask = in_a | in_b
+
+        other_geom = torch.where(in_a, geom_b, geom_a)[mask].long()
+        lut = self._geom_lut
+        n_lut = int(lut.shape[0])
+        target = lut[other_geom.clamp(0, n_lut - 1)]
+        in_lut = (other_geom >= 0) & (other_geom < n_lut)
+        keep = in_lut & (target >= 0)
+
+        force_mag = None
+        if force_a is not None and force_b is not None:
+            car_force = torch.where(in_a[mask].unsqueeze(-1), force_a[mask], force_b[mask])
+            force_mag = torch.linalg.vector_norm(car_force, dim=1).float()
+            keep = keep & (force_mag >= float(min_force))
+
+        target_k = target[keep]
+        counts = torch.bincount(target_k, minlength=n_targets)[:n_targets]
+        current = counts > 0
+        max_force = torch.zeros(n_targets, dtype=torch.float32, device=device)
+        if force_mag is not None:
+            max_force = max_force.scatter_reduce(0, target_k, force_mag[keep], reduce="amax", include_self=True)
+
+        begin = current & ~self._active
+        end = self._active & ~current
+        # Single device->host transfer per poll: [changed, begin, count, max_force, last_active_force].
+        packed = torch.stack(
+            [(begin | end).float(), begin.float(), counts.float(), max_force, self._active_force]
+        ).cpu()
+
+        if force_mag is not None:
+            self._active_force = torch.where(current, max_force, self._active_force)
+        else:
+            self._active_force = torch.where(begin, torch.zeros_like(self._active_force), self._active_force)
+        self._active = current
+
+        changed = torch.nonzero(packed[0]).flatten().tolist()
+        rows = packed.t().tolist()
+        begins: list[tuple[int, float | None, int]] = []
+        ends: list[tuple[int, float]] = []
+        for t in changed:
+            _, is_begin, count, mf, last_mf = rows[t]
+            eid = self._targets[t][0]
+            if is_begin:
+                begins.append((eid, mf if force_mag is not None else None, int(count)))
+            else:
+                ends.append((eid, last_mf))
+        return self._emit(step_idx=step_idx, begins=begins, ends=ends)
+
+    def _emit(
+        self,
+        *,
+        step_idx: int,
+        begins: list[tuple[int, float | None, int]],
+        ends: list[tuple[int, float]],
+    ) -> list[CollisionEvent]:
+        """Build BEGIN (then END) events in entity-id order and dispatch them to handlers."""
+        for eid, max_force, count in sorted(begins, key=lambda b: b[0]):
             other = self._tracked_by_id.get(eid)
             if other is None:
                 continue
@@ -216,15 +241,15 @@ class CollisionTracker:
                 phase=CollisionPhase.BEGIN,
                 other_entity=other,
                 other_entity_id=eid,
-                max_force=current_max_force.get(eid),
-                contact_count=int(current_counts.get(eid, 0)),
+                max_force=max_force,
+                contact_count=int(count),
             )
             self.events_this_step.append(ev)
-            self._active_max_force[eid] = current_max_force.get(eid, 0.0)
+            self._active_entity_ids.add(eid)
             for h in self._handlers:
                 h(ev)
 
-        for eid in sorted(ends):
+        for eid, last_force in sorted(ends, key=lambda e: e[0]):
             other = self._tracked_by_id.get(eid)
             if other is None:
                 continue
@@ -233,23 +258,33 @@ class CollisionTracker:
                 phase=CollisionPhase.END,
                 other_entity=other,
                 other_entity_id=eid,
-                max_force=self._active_max_force.get(eid),
+                max_force=last_force,
                 contact_count=0,
             )
             self.events_this_step.append(ev)
-            self._active_max_force.pop(eid, None)
+            self._active_entity_ids.discard(eid)
             for h in self._handlers:
                 h(ev)
 
-        self._active_entity_ids = set(current_ids)
-        for eid, mf in current_max_force.items():
-            self._active_max_force[eid] = mf
-
         return self.events_this_step
 
 
+def collision_tracker_for(sim: Any, entity: Any) -> Any:
+    """
+    Return a collision tracker for `entity`.
+
+    Uses the sim's shared scene-level `CollisionService` when it has one (one contact fetch per
+    step for all actors), otherwise a per-entity `CollisionTracker`. Both expose the same
+    `register_handler` / `set_targets` / `poll` interface.
+    """
+    service = getattr(sim, "collisions", None)
+    if service is not None and hasattr(service, "subscribe"):
+        return service.subscribe(entity)
+    return CollisionTracker(entity)
+
+
 class BlockBody:
-    """Rigid-body wrapper that owns the Genesis entity and cached position."""
+    """Rigid-body wrapper that owns the Genesis entity and its slot in the sim's state store."""
 
     def __init__(
         self,
@@ -268,21 +303,23 @@ class BlockBody:
             mass=config.mass,
             color=config.color,
         )
-        self._last_position = (float(position[0]), float(position[1]), float(position[2]))
+        self._state = actor_state_store(sim)
+        self.slot = self._state.add(self.entity, position=position)
 
     @property
     def last_position(self) -> tuple[float, float, float]:
-        return self._last_position
+        x, y, z = self._state.position[self.slot].tolist()
+        return (x, y, z)
 
     def update_cached_position(self, position: tuple[float, float, float]) -> None:
-        self._last_position = (float(position[0]), float(position[1]), float(position[2]))
+        self._state.position[self.slot] = (float(position[0]), float(position[1]), float(position[2]))
 
     def get_position(self, *, allow_cached: bool = False) -> tuple[float, float, float]:
         try:
             p = self.sim.get_position(self.entity)
         except Exception:
             if allow_cached:
-                return self._last_position
+                return self.last_position
             raise
         self.update_cached_position(p)
         return p
@@ -293,7 +330,7 @@ class BlockBody:
 
 
 class BlockController:
-    """Action-to-control policy for a rigid block."""
+    """Action-to-control policy for a rigid block (state lives in the sim's `ActorStateStore`)."""
 
     def __init__(
         self,
@@ -306,48 +343,57 @@ class BlockController:
         self.sim = sim
         self.entity = entity
         self.config = config
-        self._yaw = float(initial_yaw)
-        self._target_speed = 0.0
-        self._target_yaw_rate = 0.0
-        self._last_action: DiscreteAction | None = None
+        self._state = actor_state_store(sim)
+        self.slot = self._state.add(entity)
+        self._state.configure_control(self.slot, config, initial_yaw=initial_yaw)
 
     @property
     def yaw(self) -> float:
-        return float(self._yaw)
+        return float(self._state.yaw[self.slot])
 
     @property
     def target_speed(self) -> float:
-        return float(self._target_speed)
+        return float(self._state.target_speed[self.slot])
 
     @property
     def target_yaw_rate(self) -> float:
-        return float(self._target_yaw_rate)
+        return float(self._state.target_yaw_rate[self.slot])
+
+    @property
+    def last_action(self) -> DiscreteAction | None:
+        a = int(self._state.last_action[self.slot])
+        return None if a == NO_ACTION else DiscreteAction(a)
 
     def set_target_speed(self, speed: float) -> None:
-        self._target_speed = float(speed)
+        self._state.target_speed[self.slot] = float(speed)
+
+    def set_nav_grid(self, nav_grid: NavGrid | None) -> None:
+        """Set the NavGrid that `step_control_all` uses to keep kinematic motion out of blocked cells."""
+        self._state.set_nav_grid(self.slot, nav_grid)
 
     def apply_action(self, action: int | DiscreteAction) -> None:
         """Apply a discrete action by updating target speed and/or yaw-rate."""
         a = DiscreteAction(int(action))
-        self._last_action = a
+        st, i = self._state, self.slot
+        st.last_action[i] = int(a)
 
         if a == DiscreteAction.ACCELERATE:
-            self._target_speed = min(self.config.max_speed, self._target_speed + self.config.speed_delta)
-            self._target_yaw_rate = 0.0
+            st.target_speed[i] = min(self.config.max_speed, float(st.target_speed[i]) + self.config.speed_delta)
+            st.target_yaw_rate[i] = 0.0
         elif a == DiscreteAction.DECELERATE:
-            self._target_speed = max(0.0, self._target_speed - self.config.speed_delta)
-            self._target_yaw_rate = 0.0
+            st.target_speed[i] = max(0.0, float(st.target_speed[i]) - self.config.speed_delta)
+            st.target_yaw_rate[i] = 0.0
         elif a == DiscreteAction.TURN_LEFT:
-            self._target_yaw_rate = +self.config.turn_rate
+            st.target_yaw_rate[i] = +self.config.turn_rate
         elif a == DiscreteAction.TURN_RIGHT:
-            self._target_yaw_rate = -self.config.turn_rate
+            st.target_yaw_rate[i] = -self.config.turn_rate
 
     def state(self, position: tuple[float, float, float]) -> ActorState:
         return ActorState(
             position=position,
-            yaw=float(self._yaw),
-            linear_speed=float(self._target_speed),
-            yaw_rate=float(self._target_yaw_rate),
+            yaw=self.yaw,
+            linear_speed=self.target_speed,
+            yaw_rate=self.target_yaw_rate,
         )
 
     def step_control(self, dt: float) -> None:
@@ -362,21 +408,29 @@ class BlockController:
             return
         raise ValueError(f"Unknown control_mode: {self.config.control_mode!r}")
 
+    def _advance_yaw(self, dt: float) -> tuple[float, float]:
+        st, i = self._state, self.slot
+        rate = float(st.target_yaw_rate[i])
+        yaw = float(st.yaw[i]) + rate * float(dt)
+        st.yaw[i] = yaw
+        return yaw, rate
+
     def compute_kinematic(self, dt: float) -> tuple[tuple[float, float, float], tuple[float, float, float]]:
-        self._yaw += self._target_yaw_rate * float(dt)
-        fx = math.cos(self._yaw)
-        fy = math.sin(self._yaw)
-        vx = self._target_speed * fx
-        vy = self._target_speed * fy
-        return (vx, vy, 0.0), (0.0, 0.0, self._target_yaw_rate)
+        yaw, rate = self._advance_yaw(dt)
+        speed = self.target_speed
+        fx = math.cos(yaw)
+        fy = math.sin(yaw)
+        vx = speed * fx
+        vy = speed * fy
+        return (vx, vy, 0.0), (0.0, 0.0, rate)
 
     def apply_kinematic(self, v_xyz: tuple[float, float, float], w_xyz: tuple[float, float, float]) -> None:
         self.sim.set_linear_angular_velocity(self.entity, v_xyz, w_xyz)
 
     def compute_force_torque(self, dt: float) -> tuple[tuple[float, float, float], tuple[float, float, float]]:
-        self._yaw += self._target_yaw_rate * float(dt)
+        yaw, _ = self._advance_yaw(dt)
 
-        a = self._last_action
+        a = self.last_action
         if a == DiscreteAction.ACCELERATE:
             force_mag = +self.config.force
         elif a == DiscreteAction.DECELERATE:
@@ -384,8 +438,8 @@ class BlockController:
         else:
             force_mag = 0.0
 
-        fx = math.cos(self._yaw)
-        fy = math.sin(self._yaw)
+        fx = math.cos(yaw)
+        fy = math.sin(yaw)
         force = (force_mag * fx, force_mag * fy, 0.0)
 
         if a == DiscreteAction.TURN_LEFT:
@@ -401,8 +455,98 @@ class BlockController:
         self.sim.apply_torque(self.entity, tau_xyz)
 
 
+def step_control_all(sim: Any, dt: float) -> None:
+    """
+    Advance control for every actor on `sim` in one vectorized pass.
+
+    Equivalent to calling `step_control(dt)` on each `CarBlock` / `NPCBlock` (including the NPC
+    nav-grid clamp), but computes all kinematic velocities and force/torques with numpy over the
+    shared `ActorStateStore` and pushes each control-mode group with a single batched DoF write.
+    Call it instead of (not in addition to) the per-actor `step_control` loop.
+    """
+    st = actor_state_store(sim)
+    kin, ft = st.control_groups()
+    dtf = float(dt)
+
+    if kin.size:
+        rate = st.target_yaw_rate[kin]
+        yaw = st.yaw[kin] + rate * dtf
+        st.yaw[kin] = yaw
+        speed = st.target_speed[kin]
+        vel6 = np.zeros((kin.size, 6), dtype=np.float64)
+        vel6[:, 0] = speed * np.cos(yaw)
+        vel6[:, 1] = speed * np.sin(yaw)
+        vel6[:, 5] = rate
+        _clamp_to_nav_grids(st, kin, vel6, dtf)
+        st.vel6[kin] = vel6
+        _write_dofs_group(sim, st, kin, vel6, kinematic=True)
+
+    if ft.size:
+        yaw = st.yaw[ft] + st.target_yaw_rate[ft] * dtf
+        st.yaw[ft] = yaw
+        a = st.last_action[ft]
+        force_mag = np.where(
+            a == int(DiscreteAction.ACCELERATE),
+            st.force[ft],
+            np.where(a == int(DiscreteAction.DECELERATE), -st.force[ft], 0.0),
+        )
+        torque = np.where(
+            a == int(DiscreteAction.TURN_LEFT),
+            st.torque[ft],
+            np.where(a == int(DiscreteAction.TURN_RIGHT), -st.torque[ft], 0.0),
+        )
+        force6 = np.zeros((ft.size, 6), dtype=np.float64)
+        force6[:, 0] = force_mag * np.cos(yaw)
+        force6[:, 1] = force_mag * np.sin(yaw)
+        force6[:, 5] = torque
+        st.force6[ft] = force6
+        _write_dofs_group(sim, st, ft, force6, kinematic=False)
+
+
+def _clamp_to_nav_grids(st: ActorStateStore, kin: np.ndarray, vel6: np.ndarray, dt: float) -> None:
+    """Zero linear velocity (and target speed) of slots whose next position is a blocked cell."""
+    for grid, slots in st.nav_grid_groups(kin):
+        rows = np.searchsorted(kin, slots)
+        nxt = st.position[slots, :2] + vel6[rows, :2] * dt
+        blocked = grid.blocked_at(nxt[:, 0], nxt[:, 1])
+        if blocked.any():
+            vel6[rows[blocked], 0:3] = 0.0
+            st.target_speed[slots[blocked]] = 0.0
+
+
+def _write_dofs_group(sim: Any, st: ActorStateStore, slots: np.ndarray, values: np.ndarray, *, kinematic: bool) -> None:
+    entities = [st.entities[i] for i in slots.tolist()]
+    batch_write = getattr(sim, "set_dofs_velocity_batch" if kinematic else "apply_dofs_force_batch", None)
+    if batch_write is not None:
+        batch_write(entities, values)
+        return
+    # Duck-typed sims without batched I/O: fall back to per-entity writes.
+    for ent, v in zip(entities, values.tolist()):
+        if kinematic:
+            sim.set_linear_angular_velocity(ent, v[0:3], v[3:6])
+        else:
+            sim.apply_force(ent, v[0:3])
+            sim.apply_torque(ent, v[3:6])
+
+
+class CrowdAvoidance:
+    """Precomputed per-NPC proximity avoidance actions for one step (see `compute_crowd_avoidance`)."""
+
+    def __init__(self, actions_by_id: dict[int, int]) -> None:
+        self.actions_by_id = actions_by_id
+
+    def action_for(self, entity: Any) -> DiscreteAction | None:
+        code = self.actions_by_id.get(id(entity), -1)
+        return DiscreteAction(code) if code >= 0 else None
+
+
 class NPCPolicy:
-    """Goal-seeking policy for NPC blocks (optional nav grid + avoidance)."""
+    """
+    Goal-seeking policy for NPC blocks (optional nav grid + avoidance).
+
+    Goal, progress and waypoint state lives in the sim's `NPCPolicyStore`, so
+    `NPCCrowdPolicy` can step many NPCs at once over the same rows.
+    """
 
     def __init__(
         self,
@@ -412,70 +556,202 @@ class NPCPolicy:
         *,
         rng: random.Random | None = None,
         nav_grid: NavGrid | None = None,
+        planner: CrowdPlanner | None = None,
     ) -> None:
         self._body = body
         self._controller = controller
         self._config = config
         self._rng = rng or random.Random()
+        self._state: NPCPolicyStore = npc_policy_store(body.sim)
+        self.slot = self._state.add(self)
 
-        self._goal_xy: tuple[float, float] | None = None
         self._roam_xy_min = config.roam_xy_min
         self._roam_xy_max = config.roam_xy_max
-        self._prev_goal_dist: float | None = None
-        self._stuck_counter: int = 0
 
-        self._nav_grid: NavGrid | None = nav_grid
-        self._waypoints_xy: list[tuple[float, float]] = []
-        self._waypoint_idx: int = 0
+        self._nav_grid: NavGrid | None = None
+        self.set_nav_grid(nav_grid)
+
+        # Optional shared planner: path queries are queued and answered in batch per tick.
+        self._planner: CrowdPlanner | None = planner
+        self._request: PathRequest | None = None
+        self._path_request_is_replan = False
+
+    # Per-slot state (rows of the shared NPCPolicyStore).
+    @property
+    def _goal_xy(self) -> tuple[float, float] | None:
+        if not self._state.has_goal[self.slot]:
+            return None
+        x, y = self._state.goal_xy[self.slot].tolist()
+        return (x, y)
+
+    @_goal_xy.setter
+    def _goal_xy(self, goal: tuple[float, float] | None) -> None:
+        self._state.has_goal[self.slot] = goal is not None
+        if goal is not None:
+            self._state.goal_xy[self.slot] = (float(goal[0]), float(goal[1]))
+
+    @property
+    def _prev_goal_dist(self) -> float | None:
+        d = float(self._state.prev_goal_dist[self.slot])
+        return None if math.isnan(d) else d
+
+    @_prev_goal_dist.setter
+    def _prev_goal_dist(self, dist: float | None) -> None:
+        self._state.prev_goal_dist[self.slot] = math.nan if dist is None else float(dist)
+
+    @property
+    def _stuck_counter(self) -> int:
+        return int(self._state.stuck_counter[self.slot])
+
+    @_stuck_counter.setter
+    def _stuck_counter(self, n: int) -> None:
+        self._state.stuck_counter[self.slot] = int(n)
+
+    @property
+    def _waypoints_xy(self) -> list[tuple[float, float]]:
+        k = int(self._state.waypoint_count[self.slot])
+        return [(x, y) for x, y in self._state.waypoints[self.slot, :k].tolist()]
+
+    @_waypoints_xy.setter
+    def _waypoints_xy(self, waypoints: Iterable[tuple[float, float]]) -> None:
+        self._state.set_waypoints(self.slot, list(waypoints))
+
+    @property
+    def _waypoint_count(self) -> int:
+        return int(self._state.waypoint_count[self.slot])
+
+    def _waypoint(self, i: int) -> tuple[float, float]:
+        x, y = self._state.waypoints[self.slot, i].tolist()
+        return (x, y)
+
+    @property
+    def _waypoint_idx(self) -> int:
+        return int(self._state.waypoint_idx[self.slot])
+
+    @_waypoint_idx.setter
+    def _waypoint_idx(self, i: int) -> None:
+        self._state.waypoint_idx[self.slot] = int(i)
+
+    @property
+    def _path_request(self) -> PathRequest | None:
+        return self._request
+
+    @_path_request.setter
+    def _path_request(self, req: PathRequest | None) -> None:
+        self._request = req
+        self._state.pending[self.slot] = req is not None
 
     @property
     def nav_grid(self) -> NavGrid | None:
         return self._nav_grid
 
+    @property
+    def planner(self) -> CrowdPlanner | None:
+        return self._planner
+
+    def set_planner(self, planner: CrowdPlanner | None) -> None:
+        self._planner = planner
+        self._path_request = None
+
     def set_roam_bounds(self, xy_min: tuple[float, float], xy_max: tuple[float, float]) -> None:
         self._roam_xy_min = xy_min
         self._roam_xy_max = xy_max
 
     def set_nav_grid(self, nav_grid: NavGrid | None) -> None:
         self._nav_grid = nav_grid
+        self._state.has_nav_grid[self.slot] = nav_grid is not None
         self._waypoints_xy = []
         self._waypoint_idx = 0
-
-    def pick_new_goal(self) -> tuple[float, float]:
+        self._path_request = None
+
+    def _find_path(self, start: tuple[int, int], goal: tuple[int, int]) -> list[tuple[int, int]] | None:
+        assert self._nav_grid is not None
+        return astar(self._nav_grid, start, goal, diagonal=self._config.nav_diagonal, jps=self._config.nav_jps)
+
+    def _sample_reachable_goal(self, start: tuple[int, int]) -> tuple[float, float] | None:
+        """
+        Sample a goal inside the roam bounds whose cell is reachable from `start`.
+
+        Unreachable samples are rejected in O(1) with the grid's component labels, so no
+        search is spent on them. If none of `max_goal_samples` samples is reachable, fall back
+        to a uniformly sampled free cell of the start's component (None if start is blocked).
+        """
+        grid = self._nav_grid
+        assert grid is not None
+        xmin, ymin = self._roam_xy_min
+        xmax, ymax = self._roam_xy_max
+        for _ in range(max(1, self._config.max_goal_samples)):
+            gx = self._rng.uniform(xmin, xmax)
+            gy = self._rng.uniform(ymin, ymax)
+            if grid.reachable(start, grid.world_to_cell(gx, gy)):
+                return (gx, gy)
+        label = grid.component_of(start) if grid.in_bounds(start) else -1
+        cell = grid.sample_free_cell(self._rng, component=label) if label >= 0 else None
+        return grid.cell_center_world(cell) if cell is not None else None
+
+    def _set_unplanned_goal(self) -> None:
         xmin, ymin = self._roam_xy_min
         xmax, ymax = self._roam_xy_max
+        self._goal_xy = (self._rng.uniform(xmin, xmax), self._rng.uniform(ymin, ymax))
+        self._waypoints_xy = []
+        self._waypoint_idx = 0
+
+    def _poll_path_request(self) -> bool:
+        """Consume an answered planner request; returns True while one is still pending."""
+        req = self._path_request
+        if req is None or not req.done:
+            return req is not None
+        self._path_request = None
+        if req.waypoints is not None:
+            self._waypoints_xy = list(req.waypoints)
+            self._waypoint_idx = 0
+            self._stuck_counter = 0
+        elif self._path_request_is_replan:
+            self.pick_new_goal()
+        else:
+            self._set_unplanned_goal()
+        return self._path_request is not None
+
+    def pick_new_goal(self) -> tuple[float, float]:
         if self._nav_grid is not None:
             px, py = self._body.get_xy(allow_cached=True)
             start = self._nav_grid.world_to_cell(px, py)
-
-            for _ in range(max(1, self._config.max_goal_samples)):
-                gx = self._rng.uniform(xmin, xmax)
-                gy = self._rng.uniform(ymin, ymax)
-                goal = self._nav_grid.world_to_cell(gx, gy)
-                path = astar(self._nav_grid, start, goal)
-                if path is None:
-                    continue
-                path = simplify_path_cells(path)
-                self._waypoints_xy = cells_to_waypoints(self._nav_grid, path)
-                self._waypoint_idx = 0
-                self._goal_xy = (gx, gy)
-                break
-            else:
-                self._goal_xy = (self._rng.uniform(xmin, xmax), self._rng.uniform(ymin, ymax))
+            goal_xy = self._sample_reachable_goal(start)
+            if goal_xy is None:
+                self._set_unplanned_goal()
+            elif self._planner is not None:
+                # Queued; answered by the planner's next `solve_pending()` (or now, on a cache hit).
+                self._goal_xy = goal_xy
                 self._waypoints_xy = []
                 self._waypoint_idx = 0
+                self._path_request_is_replan = False
+                self._path_request = self._planner.submit(start, self._nav_grid.world_to_cell(*goal_xy))
+                self._poll_path_request()
+            else:
+                path = self._find_path(start, self._nav_grid.world_to_cell(*goal_xy))
+                if path is not None:
+                    path = simplify_path_cells(path)
+                    self._waypoints_xy = cells_to_waypoints(self._nav_grid, path)
+                    self._waypoint_idx = 0
+                    self._goal_xy = goal_xy
+                else:
+                    self._set_unplanned_goal()
         else:
+            xmin, ymin = self._roam_xy_min
+            xmax, ymax = self._roam_xy_max
             self._goal_xy = (self._rng.uniform(xmin, xmax), self._rng.uniform(ymin, ymax))
 
         self._prev_goal_dist = None
         self._stuck_counter = 0
+        assert self._goal_xy is not None
         return self._goal_xy
 
     def policy_step(
         self,
         obstacles: Iterable[Any] | None = None,
         *,
-        positions_by_id: dict[int, tuple[float, float, float]] | None = None,
+        positions_by_id: Mapping[int, tuple[float, float, float]] | None = None,
+        avoidance: CrowdAvoidance | None = None,
     ) -> DiscreteAction:
         if self._goal_xy is None:
             self.pick_new_goal()
@@ -489,23 +765,30 @@ class NPCPolicy:
                 px, py = self._body.get_xy(allow_cached=True)
         else:
             px, py = self._body.get_xy(allow_cached=True)
+        if self._path_request is not None and self._poll_path_request():
+            # Waiting for the shared planner to answer (next `solve_pending()`).
+            return DiscreteAction.DECELERATE
+        assert self._goal_xy is not None
         target_x, target_y = self._goal_xy
 
-        if self._nav_grid is not None and self._waypoints_xy:
-            while self._waypoint_idx < len(self._waypoints_xy):
-                wx, wy = self._waypoints_xy[self._waypoint_idx]
-                if math.hypot(wx - px, wy - py) <= self._config.waypoint_tolerance:
-                    self._waypoint_idx += 1
+        n_waypoints = self._waypoint_count
+        if self._nav_grid is not None and n_waypoints:
+            idx = self._waypoint_idx
+            while idx < n_waypoints:
+                wx, wy = self._waypoint(idx)
+                if _planar_dist(wx - px, wy - py) <= self._config.waypoint_tolerance:
+                    idx += 1
                     continue
                 break
-            if self._waypoint_idx >= len(self._waypoints_xy):
+            self._waypoint_idx = idx
+            if idx >= n_waypoints:
                 self.pick_new_goal()
                 target_x, target_y = self._goal_xy
             else:
-                target_x, target_y = self._waypoints_xy[self._waypoint_idx]
+                target_x, target_y = self._waypoint(idx)
 
         dx, dy = target_x - px, target_y - py
-        target_dist = math.hypot(dx, dy)
+        target_dist = _planar_dist(dx, dy)
 
         if self._nav_grid is None and target_dist <= self._config.goal_tolerance:
             self.pick_new_goal()
@@ -518,10 +801,17 @@ class NPCPolicy:
         self._prev_goal_dist = target_dist
 
         if self._stuck_counter >= self._config.stuck_steps:
-            if self._nav_grid is not None and self._goal_xy is not None:
+            if self._nav_grid is not None and self._goal_xy is not None and self._planner is not None:
+                start = self._nav_grid.world_to_cell(px, py)
+                goal = self._nav_grid.world_to_cell(self._goal_xy[0], self._goal_xy[1])
+                self._stuck_counter = 0
+                self._path_request_is_replan = True
+                self._path_request = self._planner.submit(start, goal)
+                self._poll_path_request()
+            elif self._nav_grid is not None and self._goal_xy is not None:
                 start = self._nav_grid.world_to_cell(px, py)
                 goal = self._nav_grid.world_to_cell(self._goal_xy[0], self._goal_xy[1])
-                path = astar(self._nav_grid, start, goal)
+                path = self._find_path(start, goal)
                 if path is not None:
                     path = simplify_path_cells(path)
                     self._waypoints_xy = cells_to_waypoints(self._nav_grid, path)
@@ -533,7 +823,11 @@ class NPCPolicy:
                 self.pick_new_goal()
             return DiscreteAction.TURN_LEFT if self._rng.random() < 0.5 else DiscreteAction.TURN_RIGHT
 
-        if obstacles is not None:
+        if avoidance is not None:
+            avoid = avoidance.action_for(self._body.entity)
+            if avoid is not None:
+                return avoid
+        elif obstacles is not None:
             avoid = self._avoid_with_proximity(obstacles, self_xy=(px, py), positions_by_id=positions_by_id)
             if avoid is not None:
                 return avoid
@@ -564,15 +858,14 @@ class NPCPolicy:
         left = rot(fx, fy, +self._config.raycast_angle)
         right = rot(fx, fy, -self._config.raycast_angle)
 
-        h_c = self._body.sim.raycast(origin, fwd, max_distance=self._config.raycast_length)
+        # One batched query for all three feelers.
+        hits = self._body.sim.raycast_batch([origin], [fwd, left, right], max_distance=self._config.raycast_length)
+        h_c, h_l, h_r = hits[0], hits[1], hits[2]
         if not h_c.hit or (h_c.distance is not None and h_c.distance > self._config.avoid_distance):
             return None
         if h_c.distance is not None and h_c.distance <= self._config.brake_distance:
             return DiscreteAction.DECELERATE
 
-        h_l = self._body.sim.raycast(origin, left, max_distance=self._config.raycast_length)
-        h_r = self._body.sim.raycast(origin, right, max_distance=self._config.raycast_length)
-
         left_blocked = h_l.hit and (h_l.distance is None or h_l.distance <= self._config.avoid_distance)
         right_blocked = h_r.hit and (h_r.distance is None or h_r.distance <= self._config.avoid_distance)
 
@@ -587,7 +880,7 @@ class NPCPolicy:
         obstacles: Iterable[Any],
         *,
         self_xy: tuple[float, float] | None = None,
-        positions_by_id: dict[int, tuple[float, float, float]] | None = None,
+        positions_by_id: Mapping[int, tuple[float, float, float]] | None = None,
     ) -> DiscreteAction | None:
         if self_xy is None:
             px, py = self._body.get_xy(allow_cached=True)
@@ -636,6 +929,11 @@ class NPCPolicy:
         return DiscreteAction.TURN_RIGHT if best_cross > 0 else DiscreteAction.TURN_LEFT
 
 
+def _planar_dist(dx: float, dy: float) -> float:
+    # sqrt form (not math.hypot) so the crowd pass's numpy math gives bit-identical results.
+    return math.sqrt(dx * dx + dy * dy)
+
+
 def _wrap_pi(a: float) -> float:
     while a > math.pi:
         a -= 2.0 * math.pi
@@ -2,15 +2,23 @@ from __future__ import annotations
 
 """NPC actor built from a rigid block with a heuristic roaming policy."""
 
+import math
 import random
 from dataclasses import dataclass
-from typing import Any, Iterable
+from typing import Any, Callable, Iterable, Mapping, Sequence
+
+import numpy as np
 
 from .actions import ControlMode, DiscreteAction
 from .base import ActorState
 from .car import CarBlockConfig
-from .components import BlockBody, BlockController, NPCPolicy
+from .components import BlockBody, BlockController, CollisionEvent, CrowdAvoidance, NPCPolicy, collision_tracker_for
+from .observations import NPC_OBS_SPEC, ObservationSpec
 from .pathfinding import NavGrid
+from .planner import CrowdPlanner
+from .spatial import NO_AVOIDANCE, SpatialHash, proximity_avoidance_actions
+from ..sim.genesis.batch import PositionSnapshot
+from ..sim.genesis.state import actor_state_store
 
 
 @dataclass(frozen=True)
@@ -43,11 +51,16 @@ class NPCBlockConfig(CarBlockConfig):
     nav_inflate: float = 0.3
     waypoint_tolerance: float = 0.35
     max_goal_samples: int = 50
+    nav_diagonal: bool = False  # 8-connected A* (octile heuristic, no corner cutting)
+    nav_jps: bool = False  # Jump Point Search (implies 8-connected)
 
 
 class NPCBlock:
     """NPC-controlled block with the same 4-action interface as `CarBlock`."""
 
+    # Row layout of this actor in an `ObservationBuffer` (adds the roam goal).
+    OBS_SPEC: ObservationSpec = NPC_OBS_SPEC
+
     def __init__(
         self,
         sim: Any,
@@ -57,6 +70,7 @@ class NPCBlock:
         config: NPCBlockConfig | None = None,
         rng: random.Random | None = None,
         nav_grid: NavGrid | None = None,
+        planner: CrowdPlanner | None = None,
     ):
         self.sim = sim
         self.name = name
@@ -66,7 +80,13 @@ class NPCBlock:
         self._body = BlockBody(sim, name=name, position=position, config=self.npc_config)
         self.entity = self._body.entity
         self._controller = BlockController(sim, self.entity, self.npc_config, initial_yaw=self.npc_config.initial_yaw)
-        self._policy = NPCPolicy(self._body, self._controller, self.npc_config, rng=rng, nav_grid=nav_grid)
+        self._policy = NPCPolicy(
+            self._body, self._controller, self.npc_config, rng=rng, nav_grid=nav_grid, planner=planner
+        )
+        self._controller.set_nav_grid(nav_grid)
+
+        self._collisions = collision_tracker_for(sim, self.entity)
+        self.collision_events_this_step: list[CollisionEvent] = []
 
     def set_roam_bounds(self, xy_min: tuple[float, float], xy_max: tuple[float, float]) -> None:
         """Set the roaming bounds used for sampling random goals (XY)."""
@@ -75,6 +95,15 @@ class NPCBlock:
     def set_nav_grid(self, nav_grid: NavGrid | None) -> None:
         """Set or clear a navigation grid (A* waypoints will be generated when present)."""
         self._policy.set_nav_grid(nav_grid)
+        self._controller.set_nav_grid(nav_grid)
+
+    def set_planner(self, planner: CrowdPlanner | None) -> None:
+        """
+        Route path queries through a shared `CrowdPlanner` (None plans inline with `astar`).
+
+        With a planner, call `planner.solve_pending()` once per tick before the policy steps.
+        """
+        self._policy.set_planner(planner)
 
     def pick_new_goal(self) -> tuple[float, float]:
         """Sample a new goal and (optionally) build an A* path to it if a nav grid is set."""
@@ -84,10 +113,16 @@ class NPCBlock:
         self,
         obstacles: Iterable[Any] | None = None,
         *,
-        positions_by_id: dict[int, tuple[float, float, float]] | None = None,
+        positions_by_id: Mapping[int, tuple[float, float, float]] | None = None,
+        avoidance: CrowdAvoidance | None = None,
     ) -> DiscreteAction:
-        """Compute a discrete action from the heuristic policy."""
-        return self._policy.policy_step(obstacles=obstacles, positions_by_id=positions_by_id)
+        """
+        Compute a discrete action from the heuristic policy.
+
+        Pass `avoidance` (from `compute_crowd_avoidance`) to use crowd-wide precomputed
+        proximity avoidance instead of scanning `obstacles` for this NPC.
+        """
+        return self._policy.policy_step(obstacles=obstacles, positions_by_id=positions_by_id, avoidance=avoidance)
 
     def apply_action(self, action: int | DiscreteAction) -> None:
         """Apply a discrete action by updating target speed and/or yaw-rate."""
@@ -97,6 +132,9 @@ class NPCBlock:
         """
         Apply control with an extra safety clamp when using a nav grid:
         don't drive into blocked cells (buildings).
+
+        For large crowds prefer `step_control_all(sim, dt)`, which applies the same clamp to
+        every actor in one vectorized pass.
         """
         nav_grid = self._policy.nav_grid
         if nav_grid is not None and self.config.control_mode == ControlMode.KINEMATIC:
@@ -126,3 +164,292 @@ class NPCBlock:
     def target_speed(self) -> float:
         """Return the current target speed (m/s)."""
         return self._controller.target_speed
+
+    # ----------------------------
+    # Collision events (polling)
+    # ----------------------------
+    def register_collision_handler(self, handler: Callable[[CollisionEvent], None]) -> None:
+        """Register a callback invoked for each BEGIN/END event produced by polling."""
+        self._collisions.register_handler(handler)
+
+    def set_collision_targets(
+        self,
+        *,
+        tracked_entities: Iterable[Any] | None = None,
+        ignore_entities: Iterable[Any] | None = None,
+    ) -> None:
+        """Configure which entities count as collisions for this actor."""
+        self._collisions.set_targets(tracked_entities=tracked_entities, ignore_entities=ignore_entities)
+
+    def poll_collision_events(self, *, step_idx: int, min_force: float = 0.0) -> list[CollisionEvent]:
+        """Return this step's BEGIN/END events (the shared contact pass runs once per step)."""
+        self.collision_events_this_step = self._collisions.poll(step_idx=step_idx, min_force=min_force)
+        return self.collision_events_this_step
+
+
+def _crowd_avoidance_codes(
+    npcs: Sequence[NPCBlock],
+    obstacles: Sequence[Any],
+    *,
+    positions_by_id: Mapping[int, tuple[float, float, float]],
+    spatial_hash: SpatialHash | None = None,
+    self_xy: np.ndarray | None = None,
+) -> np.ndarray:
+    """`proximity_avoidance_actions` codes `[len(npcs)]` (see `compute_crowd_avoidance`)."""
+    obs_rows: dict[int, int] = {}
+    obs_xy: list[tuple[float, float]] = []
+    for obs in obstacles:
+        p = positions_by_id.get(id(obs))
+        if p is None or id(obs) in obs_rows:
+            continue
+        obs_rows[id(obs)] = len(obs_xy)
+        obs_xy.append((float(p[0]), float(p[1])))
+
+    n = len(npcs)
+    xy = np.zeros((n, 2), dtype=np.float64) if self_xy is None else self_xy
+    yaw = np.zeros(n, dtype=np.float64)
+    avoid_radius = np.zeros(n, dtype=np.float64)
+    brake_radius = np.zeros(n, dtype=np.float64)
+    self_idx = np.full(n, -1, dtype=np.intp)
+    for i, npc in enumerate(npcs):
+        if self_xy is None:
+            p = positions_by_id.get(id(npc.entity))
+            xy[i] = (float(p[0]), float(p[1])) if p is not None else npc._body.get_xy(allow_cached=True)
+        yaw[i] = npc.heading_yaw()
+        avoid_radius[i] = npc.npc_config.avoid_radius
+        brake_radius[i] = npc.npc_config.emergency_brake_radius
+        self_idx[i] = obs_rows.get(id(npc.entity), -1)
+
+    return proximity_avoidance_actions(
+        xy,
+        yaw,
+        np.asarray(obs_xy, dtype=np.float64).reshape(-1, 2),
+        self_obstacle_idx=self_idx,
+        avoid_radius=avoid_radius,
+        brake_radius=brake_radius,
+        spatial_hash=spatial_hash,
+    )
+
+
+def compute_crowd_avoidance(
+    npcs: Sequence[NPCBlock],
+    obstacles: Sequence[Any],
+    *,
+    positions_by_id: Mapping[int, tuple[float, float, float]],
+    spatial_hash: SpatialHash | None = None,
+) -> CrowdAvoidance:
+    """
+    Run proximity avoidance for every NPC in one vectorized pass.
+
+    Obstacle positions come from `positions_by_id` (e.g. `sim.snapshot()`), are indexed in a
+    spatial hash, and only neighbors within each NPC's `avoid_radius` are considered, so the cost
+    is linear in crowd size. Pass the result to each `NPCBlock.policy_step(avoidance=...)`.
+    Reuse one `spatial_hash` across steps to avoid reallocating it.
+    """
+    codes = _crowd_avoidance_codes(npcs, obstacles, positions_by_id=positions_by_id, spatial_hash=spatial_hash)
+    return CrowdAvoidance({id(npc.entity): int(c) for npc, c in zip(npcs, codes.tolist())})
+
+
+class NPCCrowdPolicy:
+    """
+    `policy_step` for a fixed group of NPCs in one vectorized pass.
+
+    Waypoint advancement, progress/stuck tracking, avoidance and the heading/speed decision run
+    as numpy ops over the shared `NPCPolicyStore` and `ActorStateStore` rows. NPCs that need
+    Python work this step (no goal yet, pending planner request, path finished, goal reached,
+    stuck) fall back to their own `NPCPolicy.policy_step`, in list order, so RNG draws and
+    planner submissions happen exactly as in the per-NPC loop. Decisions match calling
+    `npc.policy_step(...)` on each NPC in order (the heading test uses numpy's `arctan2`, so
+    an exact tie with `heading_threshold` could differ in the last ulp).
+    """
+
+    def __init__(self, npcs: Sequence[NPCBlock]) -> None:
+        self.npcs = tuple(npcs)
+        self.entities = [npc.entity for npc in self.npcs]
+        policies = [npc._policy for npc in self.npcs]
+        self._store = policies[0]._state if policies else None
+        if any(p._state is not self._store for p in policies):
+            raise ValueError("NPCCrowdPolicy requires NPCs from the same sim.")
+        self._actor = actor_state_store(self.npcs[0].sim) if self.npcs else None
+        self._rows = np.asarray([p.slot for p in policies], dtype=np.intp)
+        self._bodies = np.asarray([npc._body.slot for npc in self.npcs], dtype=np.intp)
+
+        def col(name: str) -> np.ndarray:
+            return np.asarray([float(getattr(npc.npc_config, name)) for npc in self.npcs], dtype=np.float64)
+
+        self._waypoint_tolerance = col("waypoint_tolerance")
+        self._goal_tolerance = col("goal_tolerance")
+        self._progress_eps = col("progress_eps")
+        self._stuck_steps = col("stuck_steps")
+        self._heading_threshold = col("heading_threshold")
+        self._cruise_speed = col("cruise_speed")
+        # Last PositionSnapshot index seen, and each NPC's row in it (-1 if absent).
+        self._snapshot_index: Any | None = None
+        self._snapshot_rows = np.zeros(0, dtype=np.intp)
+        self.stats = {"steps": 0, "python_fallbacks": 0}
+
+    def __len__(self) -> int:
+        return len(self.npcs)
+
+    def _positions(self, positions_by_id: Mapping[int, tuple[float, float, float]] | None) -> np.ndarray:
+        """`[n, 2]` XY per NPC; also refreshes the bodies' cached positions like the scalar path."""
+        n = len(self.npcs)
+        xy = np.zeros((n, 2), dtype=np.float64)
+        found = np.zeros(n, dtype=bool)
+        assert self._actor is not None
+        if isinstance(positions_by_id, PositionSnapshot):
+            if positions_by_id.index is not self._snapshot_index:
+                idx = positions_by_id.index
+                self._snapshot_rows = np.asarray([idx.get(id(e), -1) for e in self.entities], dtype=np.intp)
+                self._snapshot_index = idx
+            pos = positions_by_id.positions
+            rows3 = np.asarray(pos[0] if getattr(pos, "ndim", 2) == 3 else pos, dtype=np.float64)
+            found = self._snapshot_rows >= 0
+            p3 = rows3[self._snapshot_rows[found]]
+            xy[found] = p3[:, :2]
+            self._actor.position[self._bodies[found]] = p3
+        elif positions_by_id is not None:
+            for i, ent in enumerate(self.entities):
+                p = positions_by_id.get(id(ent))
+                if p is not None:
+                    found[i] = True
+                    xy[i] = (float(p[0]), float(p[1]))
+                    self._actor.position[self._bodies[i]] = (float(p[0]), float(p[1]), float(p[2]))
+        for i in np.flatnonzero(~found).tolist():
+            xy[i] = self.npcs[i]._body.get_xy(allow_cached=True)
+        return xy
+
+    def policy_step(
+        self,
+        obstacles: Sequence[Any] | None = None,
+        *,
+        positions_by_id: Mapping[int, tuple[float, float, float]] | None = None,
+        spatial_hash: SpatialHash | None = None,
+        avoidance: CrowdAvoidance | None = None,
+    ) -> np.ndarray:
+        """
+        Return `DiscreteAction` codes `[n]` for every NPC (same arguments as `NPCBlock.policy_step`).
+
+        With `obstacles`, crowd-wide proximity avoidance is computed here (reusing
+        `spatial_hash` if given); alternatively pass a precomputed `avoidance`.
+        """
+        n = len(self.npcs)
+        actions = np.zeros(n, dtype=np.int64)
+        if n == 0:
+            return actions
+        st, act = self._store, self._actor
+        assert st is not None and act is not None
+        r, b = self._rows, self._bodies
+        self.stats["steps"] += 1
+
+        xy = self._positions(positions_by_id)
+        px, py = xy[:, 0], xy[:, 1]
+
+        codes: np.ndarray | None = None
+        if avoidance is not None:
+            codes = np.asarray(
+                [avoidance.actions_by_id.get(id(e), NO_AVOIDANCE) for e in self.entities], dtype=np.int64
+            )
+        elif obstacles is not None:
+            codes = _crowd_avoidance_codes(
+                self.npcs, obstacles, positions_by_id=positions_by_id or {}, spatial_hash=spatial_hash, self_xy=xy
+            )
+
+        slow = ~st.has_goal[r] | st.pending[r]
+        target = st.goal_xy[r].copy()
+
+        # Waypoint advancement (same rule as the scalar loop; a vector loop over the few
+        # NPCs that reach one or more waypoints this step).
+        has_grid = st.has_nav_grid[r]
+        count = st.waypoint_count[r]
+        use_wp = has_grid & (count > 0) & ~slow
+        idx = st.waypoint_idx[r].copy()
+        m = np.flatnonzero(use_wp)
+        while m.size:
+            m = m[idx[m] < count[m]]
+            if not m.size:
+                break
+            w = st.waypoints[r[m], idx[m]]
+            wx, wy = w[:, 0] - px[m], w[:, 1] - py[m]
+            m = m[np.sqrt(wx * wx + wy * wy) <= self._waypoint_tolerance[m]]
+            idx[m] += 1
+        exhausted = use_wp & (idx >= count)
+        slow |= exhausted
+        on_wp = np.flatnonzero(use_wp & ~exhausted)
+        target[on_wp] = st.waypoints[r[on_wp], idx[on_wp]]
+
+        dx, dy = target[:, 0] - px, target[:, 1] - py
+        dist = np.sqrt(dx * dx + dy * dy)
+        slow |= ~has_grid & (dist <= self._goal_tolerance)
+
+        prev = st.prev_goal_dist[r]
+        no_progress = ~np.isnan(prev) & (dist >= prev - self._progress_eps)
+        stuck = np.where(no_progress, st.stuck_counter[r] + 1, 0)
+        slow |= stuck >= self._stuck_steps
+
+        fast = ~slow
+        fr = r[fast]
+        st.waypoint_idx[fr] = idx[fast]
+        st.stuck_counter[fr] = stuck[fast]
+        st.prev_goal_dist[fr] = dist[fast]
+
+        yaw_err = np.arctan2(dy, dx) - act.yaw[b]
+        # Same repeated +-2pi steps as `_wrap_pi`, for identical rounding.
+        while True:
+            hi = yaw_err > math.pi
+            lo = yaw_err < -math.pi
+            if not (hi.any() or lo.any()):
+                break
+            yaw_err = np.where(hi, yaw_err - 2.0 * math.pi, np.where(lo, yaw_err + 2.0 * math.pi, yaw_err))
+        turn = np.abs(yaw_err) > self._heading_threshold
+        actions[:] = np.where(
+            turn,
+            np.where(yaw_err > 0, int(DiscreteAction.TURN_LEFT), int(DiscreteAction.TURN_RIGHT)),
+            np.where(
+                act.target_speed[b] < self._cruise_speed,
+                int(DiscreteAction.ACCELERATE),
+                int(DiscreteAction.DECELERATE),
+            ),
+        )
+        if codes is not None:
+            actions[:] = np.where(codes >= 0, codes, actions)
+
+        for i in np.flatnonzero(slow).tolist():
+            npc = self.npcs[i]
+            npc_avoid = None
+            if codes is not None:
+                npc_avoid = CrowdAvoidance({id(npc.entity): int(codes[i])})
+            actions[i] = int(npc.policy_step(positions_by_id=positions_by_id, avoidance=npc_avoid))
+            self.stats["python_fallbacks"] += 1
+        return actions
+
+    def apply_actions(self, actions: Sequence[int] | np.ndarray) -> None:
+        """Vectorized `NPCBlock.apply_action` for every NPC (codes ordered like `npcs`)."""
+        act = self._actor
+        if act is None:
+            return
+        a = np.asarray(actions, dtype=np.int64)
+        b = self._bodies
+        act.last_action[b] = a
+        acc = a == int(DiscreteAction.ACCELERATE)
+        dec = a == int(DiscreteAction.DECELERATE)
+        speed = act.target_speed[b]
+        speed = np.where(acc, np.minimum(act.max_speed[b], speed + act.speed_delta[b]), speed)
+        speed = np.where(dec, np.maximum(0.0, speed - act.speed_delta[b]), speed)
+        act.target_speed[b] = speed
+        rate = np.where(acc | dec, 0.0, act.target_yaw_rate[b])
+        rate = np.where(a == int(DiscreteAction.TURN_LEFT), act.turn_rate[b], rate)
+        rate = np.where(a == int(DiscreteAction.TURN_RIGHT), -act.turn_rate[b], rate)
+        act.target_yaw_rate[b] = rate
+
+    def step(
+        self,
+        obstacles: Sequence[Any] | None = None,
+        *,
+        positions_by_id: Mapping[int, tuple[float, float, float]] | None = None,
+        spatial_hash: SpatialHash | None = None,
+    ) -> np.ndarray:
+        """`policy_step` followed by `apply_actions`; returns the applied action codes."""
+        actions = self.policy_step(obstacles, positions_by_id=positions_by_id, spatial_hash=spatial_hash)
+        self.apply_actions(actions)
+        return actions
@@ -0,0 +1,115 @@
+from __future__ import annotations
+
+"""
+Struct-of-arrays store for NPC policy state.
+
+Every `NPCPolicy` owns one slot. The scalar policy reads and writes its own row, while
+`NPCCrowdPolicy` advances the same columns for a whole crowd in one vectorized pass, so both
+paths always see the same state.
+"""
+
+from typing import Any
+
+import numpy as np
+
+
+class NPCPolicyStore:
+    """
+    Contiguous per-slot NPC policy state.
+
+    Columns (first `n` rows are live; arrays are over-allocated to `capacity`):
+    - `goal_xy` `[N, 2]`, `has_goal` `[N]` (bool): current roam goal
+    - `prev_goal_dist` `[N]`: distance to the target at the previous step (NaN if none)
+    - `stuck_counter` `[N]` (int64): consecutive steps without progress
+    - `has_nav_grid` `[N]` (bool), `pending` `[N]` (bool): a planner request is outstanding
+    - `waypoints` `[N, W, 2]`, `waypoint_count` / `waypoint_idx` `[N]`: current path
+
+    `W` grows (doubling) to fit the longest path set so far.
+    """
+
+    def __init__(self, capacity: int = 64, max_waypoints: int = 16) -> None:
+        self.policies: list[Any] = []
+        self._slots: dict[int, int] = {}
+        self.max_waypoints = max(1, int(max_waypoints))
+        self._alloc(max(1, int(capacity)))
+
+    def _alloc(self, capacity: int) -> None:
+        self.capacity = capacity
+        self.goal_xy = np.zeros((capacity, 2), dtype=np.float64)
+        self.has_goal = np.zeros(capacity, dtype=bool)
+        self.prev_goal_dist = np.full(capacity, np.nan, dtype=np.float64)
+        self.stuck_counter = np.zeros(capacity, dtype=np.int64)
+        self.has_nav_grid = np.zeros(capacity, dtype=bool)
+        self.pending = np.zeros(capacity, dtype=bool)
+        self.waypoints = np.zeros((capacity, self.max_waypoints, 2), dtype=np.float64)
+        self.waypoint_count = np.zeros(capacity, dtype=np.int64)
+        self.waypoint_idx = np.zeros(capacity, dtype=np.int64)
+
+    @staticmethod
+    def column_names() -> tuple[str, ...]:
+        return (
+            "goal_xy",
+            "has_goal",
+            "prev_goal_dist",
+            "stuck_counter",
+            "has_nav_grid",
+            "pending",
+            "waypoints",
+            "waypoint_count",
+            "waypoint_idx",
+        )
+
+    def _grow(self, min_capacity: int, min_waypoints: int) -> None:
+        capacity = self.capacity
+        while capacity < min_capacity:
+            capacity *= 2
+        while self.max_waypoints < min_waypoints:
+            self.max_waypoints *= 2
+        old = {name: getattr(self, name) for name in self.column_names()}
+        n = self.n
+        self._alloc(capacity)
+        for name, arr in old.items():
+            dst = getattr(self, name)
+            if name == "waypoints":
+                dst[:n, : arr.shape[1]] = arr[:n]
+            else:
+                dst[:n] = arr[:n]
+
+    @property
+    def n(self) -> int:
+        """Number of live slots."""
+        return len(self.policies)
+
+    def __len__(self) -> int:
+        return self.n
+
+    def add(self, policy: Any) -> int:
+        """Return the slot for `policy`, allocating a cleared one on first use."""
+        key = id(policy)
+        idx = self._slots.get(key)
+        if idx is None:
+            idx = self.n
+            if idx >= self.capacity:
+                self._grow(idx + 1, self.max_waypoints)
+            self._slots[key] = idx
+            self.policies.append(policy)
+        return idx
+
+    def set_waypoints(self, idx: int, waypoints: Any) -> None:
+        """Replace slot `idx`'s path (resets its waypoint index)."""
+        pts = np.asarray(waypoints, dtype=np.float64).reshape(-1, 2)
+        k = int(pts.shape[0])
+        if k > self.max_waypoints:
+            self._grow(self.capacity, k)
+        self.waypoints[idx, :k] = pts
+        self.waypoint_count[idx] = k
+        self.waypoint_idx[idx] = 0
+
+
+def npc_policy_store(sim: Any) -> NPCPolicyStore:
+    """Return the NPC policy store shared by everything driving `sim` (attaching one on first use)."""
+    store = getattr(sim, "npc_policy_state", None)
+    if store is None:
+        store = NPCPolicyStore()
+        setattr(sim, "npc_policy_state", store)
+    return store
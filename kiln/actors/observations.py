@@ -0,0 +1,205 @@
+from __future__ import annotations
+
+"""
+Fixed-layout float32 observation buffers for actors.
+
+`Actor.state()` builds an `ActorState` per actor per call, which RL wrappers then flatten
+actor by actor. Actor state already lives in contiguous struct-of-arrays stores
+(`ActorStateStore` for bodies/controllers, `NPCPolicyStore` for NPC policies), so an
+`ObservationBuffer` instead copies the requested columns of all its actors straight into one
+preallocated `[n_actors, dim]` float32 array:
+
+- the layout is fixed per actor type by an `ObservationSpec` (`CarBlock.OBS_SPEC`,
+  `NPCBlock.OBS_SPEC`); `spec.slices` maps field names to column ranges,
+- `update()` fills the buffer in place (no per-actor objects, no new arrays: contiguous slot
+  ranges are copied from column views, other slot sets go through preallocated scratch),
+- with `device=...` the host buffer is pinned and mirrored into a preallocated torch tensor
+  with one non-blocking copy per update (on CUDA the next update waits for that copy to finish
+  reading the host buffer before overwriting it).
+
+Positions are whatever the actor store last saw (`sim.snapshot()` refreshes all of them with
+one bulk read; `update(refresh=True)` calls it first).
+"""
+
+from dataclasses import dataclass
+from typing import Any, Sequence
+
+import numpy as np
+
+from ..sim.genesis.state import actor_state_store
+
+# Observation fields: name -> (store, column, width). Store "actor" is the sim's
+# `ActorStateStore`, "npc" its `NPCPolicyStore` (NPC actors only).
+OBS_FIELDS: dict[str, tuple[str, str, int]] = {
+    "position": ("actor", "position", 3),
+    "yaw": ("actor", "yaw", 1),
+    "linear_speed": ("actor", "target_speed", 1),
+    "yaw_rate": ("actor", "target_yaw_rate", 1),
+    "last_action": ("actor", "last_action", 1),
+    "goal_xy": ("npc", "goal_xy", 2),
+    "has_goal": ("npc", "has_goal", 1),
+    "stuck_steps": ("npc", "stuck_counter", 1),
+}
+
+
+@dataclass(frozen=True)
+class ObservationSpec:
+    """Ordered observation fields (names from `OBS_FIELDS`); row layout of an `ObservationBuffer`."""
+
+    fields: tuple[str, ...]
+
+    def __post_init__(self) -> None:
+        unknown = [f for f in self.fields if f not in OBS_FIELDS]
+        if unknown:
+            raise ValueError(f"Unknown observation fields {unknown}; expected names from {list(OBS_FIELDS)}")
+        if len(set(self.fields)) != len(self.fields):
+            raise ValueError(f"Duplicate observation fields in {self.fields}")
+
+    @property
+    def dim(self) -> int:
+        return sum(OBS_FIELDS[f][2] for f in self.fields)
+
+    @property
+    def slices(self) -> dict[str, slice]:
+        """Column range of each field within a row."""
+        out, start = {}, 0
+        for f in self.fields:
+            w = OBS_FIELDS[f][2]
+            out[f] = slice(start, start + w)
+            start += w
+        return out
+
+    @property
+    def needs_npc(self) -> bool:
+        return any(OBS_FIELDS[f][0] == "npc" for f in self.fields)
+
+
+# Same fields as `ActorState`; the layout shared by every block actor.
+ACTOR_OBS_SPEC = ObservationSpec(("position", "yaw", "linear_speed", "yaw_rate"))
+NPC_OBS_SPEC = ObservationSpec((*ACTOR_OBS_SPEC.fields, "goal_xy", "has_goal"))
+
+
+def _slot_index(slots: Sequence[int]) -> slice | np.ndarray:
+    """A slice when `slots` is a contiguous ascending run (copy from a view), else an index array."""
+    a = np.asarray(slots, dtype=np.intp)
+    if a.size and np.array_equal(a, np.arange(a[0], a[0] + a.size)):
+        return slice(int(a[0]), int(a[0]) + int(a.size))
+    return a
+
+
+class ObservationBuffer:
+    """
+    Preallocated observations of a fixed group of actors (see module docstring).
+
+    Args:
+        actors: Block actors (`CarBlock` / `NPCBlock`) of one sim; row `i` is `actors[i]`.
+        spec: Row layout. Defaults to the actors' shared `OBS_SPEC`, or `ACTOR_OBS_SPEC`
+            when the group mixes actor types.
+        device: Torch device to mirror the buffer on (None keeps numpy only).
+    """
+
+    def __init__(self, actors: Sequence[Any], spec: ObservationSpec | None = None, *, device: Any | None = None) -> None:
+        self.actors = tuple(actors)
+        if spec is None:
+            specs = {getattr(a, "OBS_SPEC", ACTOR_OBS_SPEC) for a in self.actors}
+            spec = specs.pop() if len(specs) == 1 else ACTOR_OBS_SPEC
+        self.spec = spec
+        sims = {id(a.sim) for a in self.actors}
+        if len(sims) > 1:
+            raise ValueError("ObservationBuffer requires actors from the same sim.")
+        self.sim = self.actors[0].sim if self.actors else None
+        n = len(self.actors)
+
+        self._stores: dict[str, Any] = {}
+        index: dict[str, slice | np.ndarray] = {}
+        if self.actors:
+            self._stores["actor"] = actor_state_store(self.sim)
+            index["actor"] = _slot_index([a._body.slot for a in self.actors])
+        if spec.needs_npc and self.actors:
+            policies = [getattr(a, "_policy", None) for a in self.actors]
+            if any(p is None for p in policies):
+                raise ValueError(f"Observation fields of {spec.fields} need NPC actors.")
+            self._stores["npc"] = policies[0]._state
+            index["npc"] = _slot_index([p.slot for p in policies])
+
+        self.device = None
+        # Device mirror of `data` (None on the host).
+        self._mirror: Any | None = None
+        # CUDA event recorded after each mirror copy (None: copies are blocking).
+        self._copied: Any | None = None
+        self._torch_view: Any | None = None
+        if device is not None and str(device) != "cpu":
+            from ..sim.genesis.batch import _import_torch
+
+            torch = _import_torch()
+            self.device = torch.device(device)
+            self._host = torch.zeros((n, spec.dim), dtype=torch.float32, pin_memory=True)
+            self.data = self._host.numpy()
+            self._mirror = torch.zeros((n, spec.dim), dtype=torch.float32, device=self.device)
+            if self.device.type == "cuda":
+                self._copied = torch.cuda.Event()
+        else:
+            self.data = np.zeros((n, spec.dim), dtype=np.float32)
+
+        # One copy plan per field: (store, column, index, destination view, scratch or None).
+        self._plan: list[tuple[str, str, slice | np.ndarray, np.ndarray, np.ndarray | None]] = []
+        for name, cols in spec.slices.items():
+            store, column, width = OBS_FIELDS[name]
+            if store not in self._stores:
+                continue
+            out = self.data[:, cols.start] if width == 1 else self.data[:, cols]
+            idx = index[store]
+            scratch = None
+            if not isinstance(idx, slice):
+                src = getattr(self._stores[store], column)
+                scratch = np.empty((n, *src.shape[1:]), dtype=src.dtype)
+            self._plan.append((store, column, idx, out, scratch))
+
+    def __len__(self) -> int:
+        return len(self.actors)
+
+    @property
+    def dim(self) -> int:
+        return self.spec.dim
+
+    def field(self, name: str) -> np.ndarray:
+        """View of one field's columns (`[n]` for width-1 fields, else `[n, width]`)."""
+        cols = self.spec.slices[name]
+        return self.data[:, cols.start] if cols.stop - cols.start == 1 else self.data[:, cols]
+
+    def update(self, *, refresh: bool = False) -> np.ndarray:
+        """
+        Copy the current actor state into the buffer and return it (the same array every call).
+
+        With `refresh=True`, positions are first re-read for every actor body via `sim.snapshot()`.
+        """
+        if refresh and self.actors:
+            self.sim.snapshot()
+        if self._copied is not None:
+            # The previous update's non-blocking copy may still be reading the pinned buffer.
+            self._copied.synchronize()
+        for store, column, idx, out, scratch in self._plan:
+            # Re-fetch the column: stores reallocate them when they grow.
+            src = getattr(self._stores[store], column)
+            if scratch is None:
+                np.copyto(out, src[idx], casting="unsafe")
+            else:
+                np.take(src, idx, axis=0, out=scratch, mode="clip")
+                np.copyto(out, scratch, casting="unsafe")
+        if self._mirror is not None:
+            self._mirror.copy_(self._host, non_blocking=self._copied is not None)
+            if self._copied is not None:
+                from ..sim.genesis.batch import _import_torch
+
+                self._copied.record(_import_torch().cuda.current_stream(self.device))
+        return self.data
+
+    def as_torch(self) -> Any:
+        """The buffer as a torch tensor (the device mirror, or a zero-copy view of the numpy array)."""
+        if self._mirror is not None:
+            return self._mirror
+        if self._torch_view is None:
+            from ..sim.genesis.batch import _import_torch
+
+            self._torch_view = _import_torch().from_numpy(self.data)
+        return self._torch_view
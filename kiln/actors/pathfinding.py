@@ -4,8 +4,13 @@ from __future__ import annotations
 
 import heapq
 import math
-from dataclasses import dataclass
-from typing import Iterable, Iterator
+import weakref
+from array import array
+from dataclasses import dataclass, field
+from functools import cached_property
+from typing import Any, Iterable, Iterator
+
+import numpy as np
 
 
 Cell = tuple[int, int]  # (ix, iy)
@@ -27,16 +32,55 @@ class AABB:
         return (self.xmin <= x <= self.xmax) and (self.ymin <= y <= self.ymax)
 
 
-@dataclass(frozen=True)
+@dataclass(frozen=True, eq=False)
 class NavGrid:
-    """A 2D occupancy grid in XY with fixed-size square cells."""
+    """
+    A 2D occupancy grid in XY with fixed-size square cells.
+
+    Occupancy is stored as a packed bitset (`bits`, one bit per cell, rows of `ceil(width / 8)`
+    bytes), so a 2000x2000 grid takes ~0.5 MB instead of a tuple of tuples of bools.
+
+    Connected components of free cells (4-connected; 8-connected movement without corner
+    cutting has the same components) are labeled once at construction, and free cells are
+    indexed by component so reachability checks and uniform reachable-goal sampling are O(1).
+    Labels use the narrowest signed integer type that fits the component count (1 byte per
+    cell for up to 127 components, else 2 or 4); the free-cell index (4 bytes per free cell) is
+    only built when goal sampling first needs it.
+    """
 
     xy_min: tuple[float, float]
     xy_max: tuple[float, float]
     cell_size: float
     width: int
     height: int
-    blocked: tuple[tuple[bool, ...], ...]  # [iy][ix]
+    bits: np.ndarray = field(repr=False)  # uint8 [height, ceil(width / 8)], MSB-first per byte
+    # Derived in __post_init__ when not given:
+    # - labels: int8/16/32 [height, width] component label per cell, -1 = blocked
+    # - component_offsets: int64 [n_components + 1]; label k owns free_cells[off[k]:off[k + 1]]
+    labels: np.ndarray = field(default=None, repr=False)  # type: ignore[assignment]
+    component_offsets: np.ndarray = field(default=None, repr=False)  # type: ignore[assignment]
+
+    def __post_init__(self) -> None:
+        if self.labels is None:
+            labels, n = _label_components(~self.occupancy)
+            object.__setattr__(self, "labels", labels)
+        else:
+            n = int(self.labels.max()) + 1 if self.labels.size else 0
+        if self.component_offsets is None:
+            flat_labels = self.labels.ravel()
+            counts = np.bincount(flat_labels[flat_labels >= 0], minlength=n)
+            offsets = np.zeros(n + 1, dtype=np.int64)
+            np.cumsum(counts, out=offsets[1:])
+            object.__setattr__(self, "component_offsets", offsets)
+
+    @cached_property
+    def free_cells(self) -> np.ndarray:
+        """Flat indices (`iy * width + ix`) of free cells grouped by label (built on first use)."""
+        flat_labels = self.labels.ravel()
+        free = np.flatnonzero(flat_labels >= 0)
+        order = np.argsort(flat_labels[free], kind="stable")
+        dtype = np.int32 if self.width * self.height < 2**31 else np.int64
+        return free[order].astype(dtype)
 
     @staticmethod
     def build(
@@ -50,6 +94,9 @@ class NavGrid:
         """
         Build a NavGrid by rasterizing AABB obstacles onto a cell grid.
 
+        Each inflated AABB is written directly into the cell range it covers, so build cost is
+        O(cells covered) instead of O(cells x obstacles).
+
         Args:
             xy_min: World-space min bounds (x, y).
             xy_max: World-space max bounds (x, y).
@@ -67,30 +114,87 @@ class NavGrid:
         width = int(math.ceil((xmax - xmin) / cell_size))
         height = int(math.ceil((ymax - ymin) / cell_size))
 
-        inflated = [o.inflated(inflate) for o in obstacles]
-
-        rows: list[list[bool]] = []
-        for iy in range(height):
-            row: list[bool] = []
-            for ix in range(width):
-                # Mark blocked if the obstacle intersects the cell area (more conservative than
-                # sampling only the center; avoids routes that "clip" building corners).
-                cx0 = xmin + ix * cell_size
-                cy0 = ymin + iy * cell_size
-                cx1 = cx0 + cell_size
-                cy1 = cy0 + cell_size
-                row.append(any(_aabb_intersects(cx0, cy0, cx1, cy1, o) for o in inflated))
-            rows.append(row)
+        occ = np.zeros((height, width), dtype=bool)
+        for o in obstacles:
+            b = o.inflated(inflate)
+            # A cell is blocked if the obstacle intersects the cell area (more conservative than
+            # sampling only the center; avoids routes that "clip" building corners).
+            ix = _covered_range(xmin, cell_size, width, b.xmin, b.xmax)
+            iy = _covered_range(ymin, cell_size, height, b.ymin, b.ymax)
+            if ix is not None and iy is not None:
+                occ[iy[0] : iy[1] + 1, ix[0] : ix[1] + 1] = True
 
+        return NavGrid.from_occupancy(xy_min=xy_min, xy_max=xy_max, cell_size=cell_size, occupancy=occ)
+
+    @staticmethod
+    def from_occupancy(
+        *,
+        xy_min: tuple[float, float],
+        xy_max: tuple[float, float],
+        cell_size: float,
+        occupancy: np.ndarray,
+    ) -> "NavGrid":
+        """Build a NavGrid from a `[height, width]` boolean occupancy array (True = blocked)."""
+        occ = np.asarray(occupancy, dtype=bool)
+        if occ.ndim != 2:
+            raise ValueError("occupancy must be a 2D [height, width] array")
+        height, width = occ.shape
         return NavGrid(
             xy_min=xy_min,
             xy_max=xy_max,
             cell_size=cell_size,
-            width=width,
-            height=height,
-            blocked=tuple(tuple(r) for r in rows),
+            width=int(width),
+            height=int(height),
+            bits=np.packbits(occ, axis=1),
         )
 
+    @property
+    def occupancy(self) -> np.ndarray:
+        """Unpacked `[height, width]` boolean occupancy (a fresh array; True = blocked)."""
+        return np.unpackbits(self.bits, axis=1, count=self.width).astype(bool)
+
+    @property
+    def blocked(self) -> tuple[tuple[bool, ...], ...]:
+        """Occupancy as `[iy][ix]` nested tuples (compatibility view; prefer `occupancy`)."""
+        return tuple(tuple(r) for r in self.occupancy.tolist())
+
+    @property
+    def n_components(self) -> int:
+        """Number of connected components of free cells."""
+        return int(self.component_offsets.shape[0]) - 1
+
+    def component_of(self, c: Cell) -> int:
+        """Return the component label of cell `c` (-1 if blocked)."""
+        ix, iy = c
+        return int(self.labels[iy, ix])
+
+    def component_size(self, label: int) -> int:
+        """Number of free cells in component `label`."""
+        return int(self.component_offsets[label + 1] - self.component_offsets[label])
+
+    def reachable(self, a: Cell, b: Cell) -> bool:
+        """True if free, in-bounds cells `a` and `b` are connected (O(1), no search)."""
+        if not (self.in_bounds(a) and self.in_bounds(b)):
+            return False
+        la = self.component_of(a)
+        return la >= 0 and la == self.component_of(b)
+
+    def sample_free_cell(self, rng: Any, *, component: int | None = None) -> Cell | None:
+        """
+        Uniformly sample a free cell (optionally restricted to one component) with `rng`
+        (a `random.Random`). Returns None if there is no such cell.
+        """
+        if component is None:
+            lo, hi = 0, int(self.free_cells.shape[0])
+        else:
+            if not 0 <= component < self.n_components:
+                return None
+            lo, hi = int(self.component_offsets[component]), int(self.component_offsets[component + 1])
+        if hi <= lo:
+            return None
+        iy, ix = divmod(int(self.free_cells[rng.randrange(lo, hi)]), self.width)
+        return (ix, iy)
+
     def in_bounds(self, c: Cell) -> bool:
         """Return True if the cell index is inside the grid bounds."""
         ix, iy = c
@@ -99,7 +203,13 @@ class NavGrid:
     def is_blocked(self, c: Cell) -> bool:
         """Return True if the cell is blocked by an obstacle."""
         ix, iy = c
-        return self.blocked[iy][ix]
+        return bool((int(self.bits[iy, ix >> 3]) >> (7 - (ix & 7))) & 1)
+
+    def cells_blocked(self, ix: np.ndarray, iy: np.ndarray) -> np.ndarray:
+        """Vectorized `is_blocked` for in-bounds integer cell index arrays."""
+        ix = np.asarray(ix, dtype=np.intp)
+        iy = np.asarray(iy, dtype=np.intp)
+        return ((self.bits[iy, ix >> 3] >> (7 - (ix & 7)).astype(np.uint8)) & 1).astype(bool)
 
     def world_to_cell(self, x: float, y: float) -> Cell:
         """Convert world-space XY to a clamped grid cell index."""
@@ -111,6 +221,13 @@ class NavGrid:
         iy = max(0, min(self.height - 1, iy))
         return (ix, iy)
 
+    def blocked_at(self, x: np.ndarray, y: np.ndarray) -> np.ndarray:
+        """Vectorized `is_blocked(world_to_cell(x, y))` for world-space coordinate arrays."""
+        xmin, ymin = self.xy_min
+        ix = np.clip(np.floor((np.asarray(x) - xmin) / self.cell_size).astype(np.intp), 0, self.width - 1)
+        iy = np.clip(np.floor((np.asarray(y) - ymin) / self.cell_size).astype(np.intp), 0, self.height - 1)
+        return self.cells_blocked(ix, iy)
+
     def cell_center_world(self, c: Cell) -> tuple[float, float]:
         """Return the world-space center of a cell."""
         ix, iy = c
@@ -128,49 +245,444 @@ class NavGrid:
                 yield n
 
 
-def astar(grid: NavGrid, start: Cell, goal: Cell) -> list[Cell] | None:
-    """
-    4-connected A* path on a NavGrid.
+_SQRT2 = math.sqrt(2.0)
+_GEN_LIMIT = (1 << 31) - 2
 
-    Returns a list of cells from start->goal inclusive, or None if no path.
+# Reusable search buffers per grid (NavGrid is immutable, so they never go stale).
+_SEARCHES: "weakref.WeakKeyDictionary[NavGrid, GridSearch]" = weakref.WeakKeyDictionary()
+
+
+class GridSearch:
+    """
+    Reusable A* / Jump Point Search engine over one NavGrid.
+
+    Open/closed bookkeeping lives in flat arrays indexed by a padded, column-major cell index
+    (a one-cell blocked border removes bounds checks) and is reset in O(1) per query with a
+    generation stamp, so repeated queries allocate only heap entries and the returned path.
+    Buffers take ~16 bytes per cell and are allocated on the first query.
+
+    Movement:
+    - 4-connected (default): unit steps, Manhattan heuristic. Paths are shortest, but among
+      equal-length routes the one returned may differ from the original dict-based `astar`.
+    - 8-connected (`diagonal=True`): diagonal steps cost sqrt(2), octile heuristic; diagonals
+      may not cut blocked corners.
+    - `jps=True`: Jump Point Search over the same 8-connected rules (uniform-cost grids only).
+
+    Not thread-safe: use one instance per thread. The grid is held weakly (the shared
+    `grid_search` cache is keyed by it), so keep a reference to the grid while searching.
     """
-    if not grid.in_bounds(start) or not grid.in_bounds(goal):
+
+    def __init__(self, grid: NavGrid) -> None:
+        # A strong reference would keep the `_SEARCHES` key (and these buffers) alive forever.
+        self._grid = weakref.ref(grid)
+        self._stride = grid.height + 2
+        self._free: bytearray | None = None
+        self._g: array | None = None
+        self._parent: array | None = None
+        self._stamp: array | None = None
+        self._gen = 0
+
+    @property
+    def grid(self) -> NavGrid:
+        grid = self._grid()
+        if grid is None:
+            raise ReferenceError("GridSearch used after its NavGrid was freed")
+        return grid
+
+    def _ensure_buffers(self) -> None:
+        if self._free is not None:
+            return
+        grid = self.grid
+        padded = np.zeros((grid.width + 2, grid.height + 2), dtype=np.uint8)
+        padded[1:-1, 1:-1] = ~grid.occupancy.T
+        n = padded.size
+        self._free = bytearray(padded.tobytes())
+        self._g = array("d", [0.0]) * n
+        self._parent = array("i", [0]) * n
+        self._stamp = array("I", [0]) * n
+
+    def _next_gen(self) -> int:
+        # Stamps: 2*gen = seen (open) this query, 2*gen + 1 = closed this query.
+        self._gen += 1
+        if self._gen >= _GEN_LIMIT:
+            assert self._stamp is not None
+            self._stamp = array("I", [0]) * len(self._stamp)
+            self._gen = 1
+        return 2 * self._gen
+
+    def _index(self, c: Cell) -> int:
+        return (c[0] + 1) * self._stride + (c[1] + 1)
+
+    def _cell(self, idx: int) -> Cell:
+        x, y = divmod(idx, self._stride)
+        return (x - 1, y - 1)
+
+    def find_path(self, start: Cell, goal: Cell, *, diagonal: bool = False, jps: bool = False) -> list[Cell] | None:
+        """
+        Return a path of cells from start->goal inclusive, or None if no path.
+
+        JPS paths are expanded back to consecutive cells, so all modes return the same format.
+        """
+        grid = self.grid
+        if not grid.in_bounds(start) or not grid.in_bounds(goal):
+            return None
+        if grid.is_blocked(start) or grid.is_blocked(goal):
+            return None
+        if not grid.reachable(start, goal):
+            # Different connected components: fail without exploring the start's component.
+            return None
+        self._ensure_buffers()
+        s = self._index(start)
+        t = self._index(goal)
+        if jps:
+            return self._jps(s, t)
+        return self._astar(s, t, diagonal=diagonal)
+
+    def _reconstruct(self, cur: int, start: int) -> list[Cell]:
+        parent = self._parent
+        assert parent is not None
+        path = [self._cell(cur)]
+        while cur != start:
+            cur = parent[cur]
+            path.append(self._cell(cur))
+        path.reverse()
+        return path
+
+    def _astar(self, s: int, t: int, *, diagonal: bool) -> list[Cell] | None:
+        free, g_score, parent, stamp = self._free, self._g, self._parent, self._stamp
+        assert free is not None and g_score is not None and parent is not None and stamp is not None
+        S = self._stride
+        seen = self._next_gen()
+        gx, gy = divmod(t, S)
+        push, pop = heapq.heappush, heapq.heappop
+
+        orth = (S, -S, 1, -1)
+        # (offset, orthogonal a, orthogonal b): diagonals need both orthogonal cells free.
+        diag = ((S + 1, S, 1), (S - 1, S, -1), (-S + 1, -S, 1), (-S - 1, -S, -1)) if diagonal else ()
+
+        def h(idx: int) -> float:
+            x, y = divmod(idx, S)
+            dx = abs(x - gx)
+            dy = abs(y - gy)
+            if diagonal:
+                return float(dx + dy) + (_SQRT2 - 2.0) * float(min(dx, dy))
+            # Manhattan distance is admissible for 4-connected movement.
+            return float(dx + dy)
+
+        # Heap entries are (f, tie, idx) with tie = sign * g. Manhattan f-values form large
+        # plateaus on 4-connected grids, so there ties go to the deepest node (sign = -1), which
+        # expands far fewer cells; octile f-values rarely tie, so 8-connected keeps g ascending.
+        sign = 1.0 if diagonal else -1.0
+
+        stamp[s] = seen
+        g_score[s] = 0.0
+        open_heap: list[tuple[float, float, int]] = [(h(s), 0.0, s)]
+
+        while open_heap:
+            _, tie, cur = pop(open_heap)
+            g = sign * tie
+            if cur == t:
+                return self._reconstruct(cur, s)
+
+            # Stale entry check
+            if g > g_score[cur]:
+                continue
+
+            ng = g + 1.0
+            for d in orth:
+                nb = cur + d
+                if free[nb] and (stamp[nb] != seen or ng < g_score[nb]):
+                    stamp[nb] = seen
+                    g_score[nb] = ng
+                    parent[nb] = cur
+                    push(open_heap, (ng + h(nb), sign * ng, nb))
+
+            if diag:
+                ng = g + _SQRT2
+                for d, a, b in diag:
+                    nb = cur + d
+                    if free[nb] and free[cur + a] and free[cur + b] and (stamp[nb] != seen or ng < g_score[nb]):
+                        stamp[nb] = seen
+                        g_score[nb] = ng
+                        parent[nb] = cur
+                        push(open_heap, (ng + h(nb), sign * ng, nb))
+
         return None
-    if grid.is_blocked(start) or grid.is_blocked(goal):
+
+    # ----------------------------
+    # One goal, many starts
+    # ----------------------------
+    def paths_to(
+        self, goal: Cell, starts: Iterable[Cell], *, diagonal: bool = False
+    ) -> dict[Cell, list[Cell] | None]:
+        """
+        Shortest paths from every cell in `starts` to `goal` with one reverse search.
+
+        Runs Dijkstra outward from `goal` (movement rules are symmetric) and stops as soon as
+        every requested start is settled, so k NPCs heading to the same goal cost one partial
+        flow-field expansion instead of k searches. Each path runs start->goal inclusive;
+        unreachable or blocked starts map to None (rejected up front via component labels).
+        """
+        grid = self.grid
+        out: dict[Cell, list[Cell] | None] = {}
+        wanted: dict[int, Cell] = {}
+        for c in starts:
+            if grid.reachable(c, goal):
+                wanted[self._index(c)] = c
+            else:
+                out[c] = None
+        if not wanted:
+            return out
+
+        self._ensure_buffers()
+        free, g_score, parent, stamp = self._free, self._g, self._parent, self._stamp
+        assert free is not None and g_score is not None and parent is not None and stamp is not None
+        S = self._stride
+        seen = self._next_gen()
+        closed = seen + 1
+        push, pop = heapq.heappush, heapq.heappop
+        orth = (S, -S, 1, -1)
+        diag = ((S + 1, S, 1), (S - 1, S, -1), (-S + 1, -S, 1), (-S - 1, -S, -1)) if diagonal else ()
+
+        t = self._index(goal)
+        stamp[t] = seen
+        g_score[t] = 0.0
+        parent[t] = t
+        heap: list[tuple[float, int]] = [(0.0, t)]
+        remaining = len(wanted)
+        while heap and remaining:
+            g, cur = pop(heap)
+            if stamp[cur] == closed:
+                continue
+            stamp[cur] = closed
+            if cur in wanted:
+                remaining -= 1
+
+            ng = g + 1.0
+            for d in orth:
+                nb = cur + d
+                if free[nb] and stamp[nb] != closed and (stamp[nb] != seen or ng < g_score[nb]):
+                    stamp[nb] = seen
+                    g_score[nb] = ng
+                    parent[nb] = cur
+                    push(heap, (ng, nb))
+            if diag:
+                ng = g + _SQRT2
+                for d, a, b in diag:
+                    nb = cur + d
+                    if (
+                        free[nb]
+                        and free[cur + a]
+                        and free[cur + b]
+                        and stamp[nb] != closed
+                        and (stamp[nb] != seen or ng < g_score[nb])
+                    ):
+                        stamp[nb] = seen
+                        g_score[nb] = ng
+                        parent[nb] = cur
+                        push(heap, (ng, nb))
+
+        for idx, c in wanted.items():
+            if stamp[idx] != closed:
+                out[c] = None
+                continue
+            # Parents point toward the goal, so walking them yields start->goal order directly.
+            path = [c]
+            while idx != t:
+                idx = parent[idx]
+                path.append(self._cell(idx))
+            out[c] = path
+        return out
+
+    # ----------------------------
+    # Jump Point Search (8-connected, no corner cutting)
+    # ----------------------------
+    def _jump(self, idx: int, dx: int, dy: int, t: int) -> int:
+        """Walk from `idx` in direction (dx, dy) and return the next jump point index, or -1."""
+        free = self._free
+        assert free is not None
+        S = self._stride
+        step = dx * S + dy
+        while True:
+            if not free[idx]:
+                return -1
+            if idx == t:
+                return idx
+            if dx and dy:
+                if self._jump(idx + dx * S, dx, 0, t) >= 0 or self._jump(idx + dy, 0, dy, t) >= 0:
+                    return idx
+                if not (free[idx + dx * S] and free[idx + dy]):
+                    return -1
+            elif dx:
+                back = idx - dx * S
+                if (free[idx - 1] and not free[back - 1]) or (free[idx + 1] and not free[back + 1]):
+                    return idx
+            else:
+                if (free[idx - S] and not free[idx - S - dy]) or (free[idx + S] and not free[idx + S - dy]):
+                    return idx
+            idx += step
+
+    def _jps_dirs(self, idx: int, par: int) -> list[tuple[int, int]]:
+        """Pruned successor directions of `idx` reached from `par` (-1 for the start node)."""
+        free = self._free
+        assert free is not None
+        S = self._stride
+        dirs: list[tuple[int, int]] = []
+        if par < 0:
+            for dx, dy in ((1, 0), (-1, 0), (0, 1), (0, -1)):
+                if free[idx + dx * S + dy]:
+                    dirs.append((dx, dy))
+            for dx, dy in ((1, 1), (1, -1), (-1, 1), (-1, -1)):
+                if free[idx + dx * S] and free[idx + dy]:
+                    dirs.append((dx, dy))
+            return dirs
+
+        x, y = divmod(idx, S)
+        px, py = divmod(par, S)
+        dx = (x > px) - (x < px)
+        dy = (y > py) - (y < py)
+        if dx and dy:
+            fy = free[idx + dy]
+            fx = free[idx + dx * S]
+            if fy:
+                dirs.append((0, dy))
+            if fx:
+                dirs.append((dx, 0))
+            if fx and fy:
+                dirs.append((dx, dy))
+        elif dx:
+            nxt = free[idx + dx * S]
+            up = free[idx + 1]
+            down = free[idx - 1]
+            if nxt:
+                dirs.append((dx, 0))
+                if up:
+                    dirs.append((dx, 1))
+                if down:
+                    dirs.append((dx, -1))
+            if up:
+                dirs.append((0, 1))
+            if down:
+                dirs.append((0, -1))
+        else:
+            nxt = free[idx + dy]
+            right = free[idx + S]
+            left = free[idx - S]
+            if nxt:
+                dirs.append((0, dy))
+                if right:
+                    dirs.append((1, dy))
+                if left:
+                    dirs.append((-1, dy))
+            if right:
+                dirs.append((1, 0))
+            if left:
+                dirs.append((-1, 0))
+        return dirs
+
+    def _jps(self, s: int, t: int) -> list[Cell] | None:
+        g_score, parent, stamp = self._g, self._parent, self._stamp
+        assert g_score is not None and parent is not None and stamp is not None
+        S = self._stride
+        seen = self._next_gen()
+        closed = seen + 1
+        gx, gy = divmod(t, S)
+        push, pop = heapq.heappush, heapq.heappop
+
+        def octile(ax: int, ay: int, bx: int, by: int) -> float:
+            dx = abs(ax - bx)
+            dy = abs(ay - by)
+            return float(dx + dy) + (_SQRT2 - 2.0) * float(min(dx, dy))
+
+        stamp[s] = seen
+        g_score[s] = 0.0
+        parent[s] = -1
+        sx, sy = divmod(s, S)
+        open_heap: list[tuple[float, float, int]] = [(octile(sx, sy, gx, gy), 0.0, s)]
+
+        while open_heap:
+            _, g, cur = pop(open_heap)
+            if stamp[cur] == closed:
+                continue
+            stamp[cur] = closed
+            if cur == t:
+                return self._expand_jump_points(cur, s)
+
+            cx, cy = divmod(cur, S)
+            for dx, dy in self._jps_dirs(cur, parent[cur] if cur != s else -1):
+                jp = self._jump(cur + dx * S + dy, dx, dy, t)
+                if jp < 0 or stamp[jp] == closed:
+                    continue
+                jx, jy = divmod(jp, S)
+                ng = g + octile(cx, cy, jx, jy)
+                if stamp[jp] != seen or ng < g_score[jp]:
+                    stamp[jp] = seen
+                    g_score[jp] = ng
+                    parent[jp] = cur
+                    push(open_heap, (ng + octile(jx, jy, gx, gy), ng, jp))
+
         return None
 
-    def h(c: Cell) -> float:
-        # Manhattan distance is admissible for 4-connected movement.
-        return float(abs(c[0] - goal[0]) + abs(c[1] - goal[1]))
+    def _expand_jump_points(self, cur: int, start: int) -> list[Cell]:
+        """Reconstruct the jump-point chain and fill in the straight/diagonal runs between them."""
+        parent = self._parent
+        assert parent is not None
+        chain = [cur]
+        while cur != start:
+            cur = parent[cur]
+            chain.append(cur)
+        chain.reverse()
+
+        path = [self._cell(chain[0])]
+        for a, b in zip(chain, chain[1:]):
+            ax, ay = self._cell(a)
+            bx, by = self._cell(b)
+            dx = (bx > ax) - (bx < ax)
+            dy = (by > ay) - (by < ay)
+            while (ax, ay) != (bx, by):
+                ax += dx
+                ay += dy
+                path.append((ax, ay))
+        return path
 
-    open_heap: list[tuple[float, float, Cell]] = []
-    heapq.heappush(open_heap, (h(start), 0.0, start))
 
-    came_from: dict[Cell, Cell] = {}
-    g_score: dict[Cell, float] = {start: 0.0}
+def grid_search(grid: NavGrid) -> GridSearch:
+    """Return the shared `GridSearch` for `grid` (buffers are reused across calls)."""
+    search = _SEARCHES.get(grid)
+    if search is None:
+        search = GridSearch(grid)
+        _SEARCHES[grid] = search
+    return search
 
-    while open_heap:
-        _, g, cur = heapq.heappop(open_heap)
-        if cur == goal:
-            return _reconstruct(came_from, cur)
 
-        # Stale entry check
-        if g > g_score.get(cur, float("inf")):
-            continue
+def astar(
+    grid: NavGrid,
+    start: Cell,
+    goal: Cell,
+    *,
+    diagonal: bool = False,
+    jps: bool = False,
+) -> list[Cell] | None:
+    """
+    A* path on a NavGrid (4-connected by default).
 
-        for nb in grid.neighbors4(cur):
-            ng = g + 1.0
-            if ng < g_score.get(nb, float("inf")):
-                came_from[nb] = cur
-                g_score[nb] = ng
-                heapq.heappush(open_heap, (ng + h(nb), ng, nb))
+    Runs on the grid's shared `GridSearch`, so repeated calls reuse the same search buffers.
 
-    return None
+    Args:
+        grid: Grid to search.
+        start: Start cell.
+        goal: Goal cell.
+        diagonal: Allow 8-connected movement (sqrt(2) diagonal cost, no corner cutting).
+        jps: Use Jump Point Search (implies 8-connected movement).
+
+    Returns a list of cells from start->goal inclusive, or None if no path.
+    """
+    return grid_search(grid).find_path(start, goal, diagonal=diagonal, jps=jps)
 
 
 def simplify_path_cells(path: list[Cell]) -> list[Cell]:
     """
-    Drop intermediate collinear points from a 4-connected grid path.
+    Drop intermediate collinear points from a (4- or 8-connected) grid path.
     """
     if len(path) <= 2:
         return path
@@ -193,15 +705,6 @@ def cells_to_waypoints(grid: NavGrid, path: list[Cell]) -> list[tuple[float, flo
     return [grid.cell_center_world(c) for c in path]
 
 
-def _reconstruct(came_from: dict[Cell, Cell], cur: Cell) -> list[Cell]:
-    path = [cur]
-    while cur in came_from:
-        cur = came_from[cur]
-        path.append(cur)
-    path.reverse()
-    return path
-
-
 def _aabb_intersects(
     ax0: float,
     ay0: float,
@@ -217,3 +720,72 @@ def _aabb_intersects(
     return True
 
 
+def _covered_range(lo: float, cell_size: float, n: int, bmin: float, bmax: float) -> tuple[int, int] | None:
+    """
+    Return the inclusive cell index range `[i0, i1]` along one axis whose closed cell intervals
+    intersect `[bmin, bmax]` (same test as `_aabb_intersects`), or None if it is empty.
+    """
+
+    def c0(i: int) -> float:
+        return lo + i * cell_size
+
+    def overlaps(i: int) -> bool:
+        a0 = c0(i)
+        return not (a0 + cell_size < bmin or a0 > bmax)
+
+    # Analytic estimate, then nudge by at most a cell to match the float expressions exactly.
+    i0 = max(0, int(math.floor((bmin - lo) / cell_size)) - 1)
+    i1 = min(n - 1, int(math.floor((bmax - lo) / cell_size)) + 1)
+    if i0 > i1:
+        return None
+    while i0 <= i1 and not overlaps(i0):
+        i0 += 1
+    while i1 >= i0 and not overlaps(i1):
+        i1 -= 1
+    if i0 > i1:
+        return None
+    return (i0, i1)
+
+
+def _label_components(free: np.ndarray) -> tuple[np.ndarray, int]:
+    """
+    Label 4-connected components of `free` (`[height, width]` bool).
+
+    Works on horizontal runs of free cells: runs that share a column in adjacent rows are
+    merged by vectorized min-label propagation with root hooking and pointer jumping, so the
+    cost scales with the number of runs rather than the number of cells. Returns
+    `(labels, n_components)`, where `labels` is the narrowest of int8/int16/int32 that holds
+    every label and is -1 on blocked cells.
+    """
+    height, width = free.shape
+    run_starts = free.copy()
+    run_starts[:, 1:] &= ~free[:, :-1]
+    n_runs = int(run_starts.sum())
+    if n_runs == 0:
+        return np.full((height, width), -1, dtype=np.int8), 0
+    run_of_cell = np.cumsum(run_starts.ravel(), dtype=np.int64).reshape(height, width) - 1
+
+    vertical = free[:-1] & free[1:]
+    edges = np.unique(run_of_cell[:-1][vertical] * n_runs + run_of_cell[1:][vertical])
+    a = edges // n_runs
+    b = edges % n_runs
+
+    root = np.arange(n_runs, dtype=np.int64)
+    while a.size:
+        ra = root[a]
+        rb = root[b]
+        if np.array_equal(ra, rb):
+            break
+        m = np.minimum(ra, rb)
+        np.minimum.at(root, ra, m)
+        np.minimum.at(root, rb, m)
+        np.minimum.at(root, a, m)
+        np.minimum.at(root, b, m)
+        root = root[root]
+
+    _, component = np.unique(root, return_inverse=True)
+    n = int(component.max()) + 1
+    dtype = next(t for t in (np.int8, np.int16, np.int32) if n - 1 <= np.iinfo(t).max)
+    labels = np.full((height, width), -1, dtype=dtype)
+    labels[free] = component[run_of_cell[free]].astype(dtype)
+    return labels, n
@@ -0,0 +1,145 @@
+from __future__ import annotations
+
+"""
+Shared path planning for NPC crowds.
+
+`CrowdPlanner` sits between NPC policies and the grid search: NPCs submit `(start, goal)`
+cell requests, and one `solve_pending()` call per tick answers all of them in a batch.
+"""
+
+from collections import OrderedDict
+from dataclasses import dataclass
+from typing import Iterable
+
+from .pathfinding import Cell, NavGrid, cells_to_waypoints, grid_search, simplify_path_cells
+
+Waypoints = tuple[tuple[float, float], ...]
+
+
+@dataclass
+class PathRequest:
+    """
+    A pending or answered path query.
+
+    Attributes:
+        start: Start cell.
+        goal: Goal cell.
+        done: True once `waypoints` holds the answer.
+        waypoints: Simplified world-space waypoints (start->goal), or None if no path exists.
+    """
+
+    start: Cell
+    goal: Cell
+    done: bool = False
+    waypoints: Waypoints | None = None
+
+
+class CrowdPlanner:
+    """
+    Batched path service for every NPC navigating one static `NavGrid`.
+
+    Per `solve_pending()`:
+    - identical `(start, goal)` requests are answered once;
+    - requests that share a goal (at least `shared_goal_min` distinct starts) are solved with
+      one reverse search from the goal (`GridSearch.paths_to`, a partial flow field);
+    - everything else runs a regular `astar` query on the grid's shared search buffers.
+
+    Answers are kept in an LRU cache of simplified waypoint lists keyed by
+    `(start cell, goal cell)`, so repeated trips are free.
+    """
+
+    def __init__(
+        self,
+        grid: NavGrid,
+        *,
+        cache_size: int = 4096,
+        diagonal: bool = False,
+        jps: bool = False,
+        shared_goal_min: int = 4,
+    ) -> None:
+        self.grid = grid
+        self.cache_size = max(0, int(cache_size))
+        self.diagonal = bool(diagonal or jps)
+        self.jps = bool(jps)
+        self.shared_goal_min = max(2, int(shared_goal_min))
+        self._cache: OrderedDict[tuple[Cell, Cell], Waypoints | None] = OrderedDict()
+        self._pending: list[PathRequest] = []
+        self.stats = {"requests": 0, "cache_hits": 0, "searches": 0, "shared_goal_searches": 0}
+
+    @property
+    def pending(self) -> int:
+        """Number of unanswered requests."""
+        return len(self._pending)
+
+    def submit(self, start: Cell, goal: Cell) -> PathRequest:
+        """
+        Queue a path request (answered on the next `solve_pending()`).
+
+        Cache hits are answered immediately, so callers should check `done` right away.
+        """
+        self.stats["requests"] += 1
+        req = PathRequest(start=start, goal=goal)
+        key = (start, goal)
+        if key in self._cache:
+            self.stats["cache_hits"] += 1
+            self._cache.move_to_end(key)
+            req.waypoints = self._cache[key]
+            req.done = True
+            return req
+        self._pending.append(req)
+        return req
+
+    def plan(self, start: Cell, goal: Cell) -> Waypoints | None:
+        """Answer one request synchronously (through the cache)."""
+        req = self.submit(start, goal)
+        if not req.done:
+            self._pending.remove(req)
+            self._solve([req])
+        return req.waypoints
+
+    def solve_pending(self) -> int:
+        """Answer every queued request; returns how many were answered."""
+        if not self._pending:
+            return 0
+        batch, self._pending = self._pending, []
+        self._solve(batch)
+        return len(batch)
+
+    def clear_cache(self) -> None:
+        self._cache.clear()
+
+    def _solve(self, requests: Iterable[PathRequest]) -> None:
+        reqs = list(requests)
+        results: dict[tuple[Cell, Cell], Waypoints | None] = {}
+        by_goal: dict[Cell, set[Cell]] = {}
+        for r in reqs:
+            key = (r.start, r.goal)
+            if key in self._cache:
+                results[key] = self._cache[key]
+            else:
+                by_goal.setdefault(r.goal, set()).add(r.start)
+
+        search = grid_search(self.grid)
+        for goal, starts in by_goal.items():
+            if len(starts) >= self.shared_goal_min:
+                self.stats["shared_goal_searches"] += 1
+                for start, path in search.paths_to(goal, starts, diagonal=self.diagonal).items():
+                    results[(start, goal)] = self._store((start, goal), path)
+            else:
+                for start in starts:
+                    self.stats["searches"] += 1
+                    path = search.find_path(start, goal, diagonal=self.diagonal, jps=self.jps)
+                    results[(start, goal)] = self._store((start, goal), path)
+
+        for r in reqs:
+            r.waypoints = results[(r.start, r.goal)]
+            r.done = True
+
+    def _store(self, key: tuple[Cell, Cell], path: list[Cell] | None) -> Waypoints | None:
+        value = None if path is None else tuple(cells_to_waypoints(self.grid, simplify_path_cells(path)))
+        if self.cache_size > 0:
+            self._cache[key] = value
+            self._cache.move_to_end(key)
+            while len(self._cache) > self.cache_size:
+                self._cache.popitem(last=False)
+        return value
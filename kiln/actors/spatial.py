@@ -0,0 +1,165 @@
+from __future__ import annotations
+
+"""
+Uniform-grid spatial hashing for crowd neighbor queries.
+
+`SpatialHash` is rebuilt once per step from a bulk position snapshot and answers
+"which points are within r of each query point" for all queries at once, so crowd-wide
+proximity checks cost O(N * neighbors) instead of O(N^2).
+"""
+
+import math
+from typing import Any
+
+import numpy as np
+
+from .actions import DiscreteAction
+
+# Cell key = ix * _KEY_X + iy (int64); valid while |iy| < 2**31.
+_KEY_X = np.int64(1) << np.int64(32)
+
+# `proximity_avoidance_actions` code for "no avoidance needed".
+NO_AVOIDANCE = -1
+
+
+class SpatialHash:
+    """
+    Cell list over 2D points with square cells of `cell_size` (usually the query radius).
+
+    Points are sorted by cell key on `rebuild`; each query cell is then a contiguous range
+    found with `searchsorted`, so both rebuild and query are fully vectorized.
+    """
+
+    def __init__(self, cell_size: float) -> None:
+        if cell_size <= 0:
+            raise ValueError("cell_size must be > 0")
+        self.cell_size = float(cell_size)
+        self._xy = np.zeros((0, 2), dtype=np.float64)
+        self._sorted_keys = np.zeros(0, dtype=np.int64)
+        self._order = np.zeros(0, dtype=np.intp)
+
+    def __len__(self) -> int:
+        return int(self._xy.shape[0])
+
+    def _keys(self, xy: np.ndarray) -> np.ndarray:
+        cells = np.floor(xy / self.cell_size).astype(np.int64)
+        return cells[:, 0] * _KEY_X + cells[:, 1]
+
+    def rebuild(self, xy: Any) -> None:
+        """Replace the indexed points with `xy` (`[n, 2]`, or `[n, 3]` with z ignored)."""
+        pts = np.asarray(xy, dtype=np.float64)
+        pts = pts.reshape(-1, pts.shape[-1] if pts.ndim > 1 else 2)[:, :2]
+        keys = self._keys(pts)
+        order = np.argsort(keys, kind="stable")
+        self._xy = pts
+        self._sorted_keys = keys[order]
+        self._order = order
+
+    def query_pairs(self, points: Any, radius: float) -> tuple[np.ndarray, np.ndarray, np.ndarray, np.ndarray, np.ndarray]:
+        """
+        Return all `(query, point)` pairs within `radius` (inclusive).
+
+        Returns `(qi, pj, dx, dy, dist)` arrays, where `qi` indexes `points`, `pj` indexes the
+        indexed points, and `(dx, dy)` is `point - query`.
+        """
+        q = np.asarray(points, dtype=np.float64)
+        q = q.reshape(-1, q.shape[-1] if q.ndim > 1 else 2)[:, :2]
+        empty_i = np.zeros(0, dtype=np.intp)
+        empty_f = np.zeros(0, dtype=np.float64)
+        if q.shape[0] == 0 or self._xy.shape[0] == 0:
+            return empty_i, empty_i, empty_f, empty_f, empty_f
+
+        ring = max(1, int(math.ceil(float(radius) / self.cell_size)))
+        base = self._keys(q)
+        qidx = np.arange(q.shape[0], dtype=np.intp)
+        qi_parts: list[np.ndarray] = []
+        pj_parts: list[np.ndarray] = []
+        for ox in range(-ring, ring + 1):
+            for oy in range(-ring, ring + 1):
+                k = base + np.int64(ox) * _KEY_X + np.int64(oy)
+                lo = np.searchsorted(self._sorted_keys, k, side="left")
+                hi = np.searchsorted(self._sorted_keys, k, side="right")
+                cnt = hi - lo
+                total = int(cnt.sum())
+                if total == 0:
+                    continue
+                # Expand each [lo, hi) range into explicit point positions.
+                first = np.repeat(np.cumsum(cnt) - cnt, cnt)
+                pos = np.repeat(lo, cnt) + (np.arange(total) - first)
+                qi_parts.append(np.repeat(qidx, cnt))
+                pj_parts.append(self._order[pos])
+
+        if not qi_parts:
+            return empty_i, empty_i, empty_f, empty_f, empty_f
+        qi = np.concatenate(qi_parts)
+        pj = np.concatenate(pj_parts)
+        d = self._xy[pj] - q[qi]
+        dist = np.hypot(d[:, 0], d[:, 1])
+        keep = dist <= float(radius)
+        return qi[keep], pj[keep], d[keep, 0], d[keep, 1], dist[keep]
+
+
+def proximity_avoidance_actions(
+    self_xy: np.ndarray,
+    yaw: np.ndarray,
+    obstacle_xy: np.ndarray,
+    *,
+    self_obstacle_idx: np.ndarray,
+    avoid_radius: np.ndarray,
+    brake_radius: np.ndarray,
+    spatial_hash: SpatialHash | None = None,
+) -> np.ndarray:
+    """
+    Vectorized proximity avoidance for a whole crowd (same rules as the per-NPC loop).
+
+    For each agent, only obstacles ahead of it (positive projection on its heading) count:
+    any within its brake radius -> DECELERATE; otherwise the nearest within its avoid radius
+    decides TURN_RIGHT / TURN_LEFT by the side it is on. Agents with nothing nearby get
+    `NO_AVOIDANCE`.
+
+    Args:
+        self_xy: `[n, 2]` agent positions.
+        yaw: `[n]` agent headings (radians).
+        obstacle_xy: `[m, 2]` obstacle positions.
+        self_obstacle_idx: `[n]` row of each agent in `obstacle_xy` (-1 if absent), so an
+            agent never avoids itself.
+        avoid_radius: `[n]` turn-away radius per agent.
+        brake_radius: `[n]` emergency-brake radius per agent.
+        spatial_hash: Reused hash (its cell size should be about the max radius); it is
+            rebuilt from `obstacle_xy` here.
+
+    Returns an int array `[n]` of `DiscreteAction` codes or `NO_AVOIDANCE`.
+    """
+    n = int(self_xy.shape[0])
+    out = np.full(n, NO_AVOIDANCE, dtype=np.int64)
+    if n == 0 or obstacle_xy.shape[0] == 0:
+        return out
+    radius = float(max(np.max(avoid_radius), np.max(brake_radius)))
+    if radius <= 0.0:
+        return out
+    grid = spatial_hash if spatial_hash is not None else SpatialHash(radius)
+    grid.rebuild(obstacle_xy)
+    qi, pj, dx, dy, dist = grid.query_pairs(self_xy, radius)
+
+    fx = np.cos(yaw)[qi]
+    fy = np.sin(yaw)[qi]
+    proj = dx * fx + dy * fy
+    ahead = (dist > 1e-9) & (proj > 0) & (pj != self_obstacle_idx[qi])
+
+    brake = ahead & (dist <= brake_radius[qi])
+    braking = np.zeros(n, dtype=bool)
+    braking[qi[brake]] = True
+
+    near = ahead & (dist <= avoid_radius[qi]) & ~braking[qi]
+    if near.any():
+        nq, nj, nd = qi[near], pj[near], dist[near]
+        cross = (fx * dy - fy * dx)[near]
+        # Nearest per agent; ties go to the earlier obstacle (matches the sequential loop).
+        order = np.lexsort((nj, nd, nq))
+        nq_sorted = nq[order]
+        first = order[np.flatnonzero(np.r_[True, nq_sorted[1:] != nq_sorted[:-1]])]
+        out[nq[first]] = np.where(
+            cross[first] > 0, int(DiscreteAction.TURN_RIGHT), int(DiscreteAction.TURN_LEFT)
+        )
+    out[braking] = int(DiscreteAction.DECELERATE)
+    return out
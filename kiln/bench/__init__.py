@@ -0,0 +1,12 @@
+"""
+Benchmark suite for Kiln.
+
+Named scenarios (`SCENARIOS`) time the simulation loop phases (policy, control, physics,
+collisions, render) on a procedural city and the pure-Python subsystems (bundle loading, NavGrid
+builds, A* replans). `kiln-bench run` writes a JSON report with p50/p99 per phase and
+`kiln-bench compare` flags per-phase regressions between two reports.
+"""
+
+from .report import Delta, compare, load_report, make_report, write_report  # noqa: F401
+from .scenarios import SCENARIOS, BenchContext, Scenario, scenario  # noqa: F401
+from .stats import PHASES, PhaseTimer, summarize, time_calls  # noqa: F401
@@ -0,0 +1,220 @@
+from __future__ import annotations
+
+"""
+Procedural city world shared by the benchmark scenarios and `examples/genesis_demo.py`.
+
+A grid of randomly sized buildings with roads between them, a `NavGrid` planned around them, one
+car on the bottom road and `n_npcs` pedestrians spawned in the largest connected free region.
+`city_n` and `half_extent` scale it up.
+"""
+
+from dataclasses import dataclass, field
+import math
+import random
+from typing import Any, Callable
+
+from kiln.actors.pathfinding import AABB, NavGrid
+
+ROAD_W = 1.5
+
+# Category-coded colors.
+CAR_COLOR = (1.0, 0.1, 0.1)
+NPC_COLOR = (0.15, 0.55, 1.0)
+BUILDING_COLOR = (0.6, 0.6, 0.6)
+
+
+@dataclass(frozen=True)
+class Building:
+    cx: float
+    cy: float
+    sx: float
+    sy: float
+    sz: float
+
+    @property
+    def aabb(self) -> AABB:
+        return AABB(self.cx - 0.5 * self.sx, self.cy - 0.5 * self.sy, self.cx + 0.5 * self.sx, self.cy + 0.5 * self.sy)
+
+
+def city_layout(
+    rng: random.Random,
+    *,
+    city_n: int = 5,
+    half_extent: float = 12.0,
+    road_w: float = ROAD_W,
+    cell_margin: float = 0.25,
+) -> list[Building]:
+    """Building footprints/heights of a `city_n x city_n` block grid inside `[-half_extent, half_extent]^2`."""
+    lo = -float(half_extent)
+    span = 2.0 * float(half_extent)
+    cell_w = (span - (city_n + 1) * road_w) / city_n
+    out: list[Building] = []
+    for ix in range(city_n):
+        for iy in range(city_n):
+            cell_xmin = lo + road_w + ix * (cell_w + road_w)
+            cell_ymin = lo + road_w + iy * (cell_w + road_w)
+            max_b = max(1.0, cell_w - 2.0 * cell_margin)
+            bx = rng.uniform(1.2, max_b)
+            by = rng.uniform(1.2, max_b)
+            ox = rng.uniform(cell_margin, max(cell_margin, cell_w - cell_margin - bx))
+            oy = rng.uniform(cell_margin, max(cell_margin, cell_w - cell_margin - by))
+            cx = cell_xmin + ox + 0.5 * bx
+            cy = cell_ymin + oy + 0.5 * by
+            # Slightly taller near the center.
+            dist = math.hypot(cx, cy) / max(1e-6, float(half_extent))
+            sz = rng.uniform(2.0, 5.0) + (1.0 - dist) * rng.uniform(0.0, 3.0)
+            out.append(Building(cx, cy, bx, by, sz))
+    return out
+
+
+def city_nav_grid(buildings: list[Building], *, half_extent: float = 12.0, cell_size: float = 0.5) -> NavGrid:
+    h = float(half_extent)
+    return NavGrid.build(
+        xy_min=(-h, -h),
+        xy_max=(h, h),
+        cell_size=cell_size,
+        obstacles=[b.aabb for b in buildings],
+        inflate=0.55,
+    )
+
+
+@dataclass
+class CityWorld:
+    """Entities and planning state of a built city scene."""
+
+    sim: Any
+    buildings: list[Building]
+    building_entities: list[Any]
+    nav_grid: NavGrid
+    planner: Any
+    car: Any
+    npcs: list[Any]
+    crowd: Any
+    avoid_hash: Any
+    dynamic: list[Any] = field(default_factory=list)
+    # Chase cameras on every dynamic body (None unless `camera_rig_res > 0`).
+    rig: Any | None = None
+
+
+def build_city(
+    sim: Any,
+    *,
+    seed: int = 0,
+    city_n: int = 5,
+    half_extent: float = 12.0,
+    n_npcs: int = 5,
+    collisions: bool = False,
+    control_mode: str = "kinematic",
+    camera_rig_res: int = 0,
+    camera_rig_every: int = 1,
+    before_build: Callable[[Any], None] | None = None,
+) -> CityWorld:
+    """
+    Populate `sim` (fresh scene with ground) with a city, a car and `n_npcs` NPCs, then build it.
+
+    `before_build(sim)` runs right before `sim.build()`, for extra entities or cameras.
+    """
+    from kiln.actors import (
+        CarBlock,
+        CarBlockConfig,
+        ControlMode,
+        NPCBlock,
+        NPCBlockConfig,
+        NPCCrowdPolicy,
+    )
+    from kiln.actors.planner import CrowdPlanner
+    from kiln.actors.spatial import SpatialHash
+
+    rng = random.Random(seed)
+    mode = ControlMode.KINEMATIC if control_mode == "kinematic" else ControlMode.FORCE_TORQUE
+    sim.create_programmatic_scene()
+
+    buildings = city_layout(rng, city_n=city_n, half_extent=half_extent)
+    building_entities = [
+        sim.add_box(
+            name=f"building_{i}",
+            size=(b.sx, b.sy, b.sz),
+            position=(b.cx, b.cy, b.sz / 2.0),
+            mass=0.0,
+            color=BUILDING_COLOR,
+        )
+        for i, b in enumerate(buildings)
+    ]
+    nav_grid = city_nav_grid(buildings, half_extent=half_extent)
+    planner = CrowdPlanner(nav_grid)
+    spawn_component = max(range(nav_grid.n_components), key=nav_grid.component_size, default=-1)
+
+    def free_xy(*, preferred: tuple[float, float] | None = None) -> tuple[float, float]:
+        if preferred is not None:
+            c = nav_grid.world_to_cell(preferred[0], preferred[1])
+            if not nav_grid.is_blocked(c):
+                return nav_grid.cell_center_world(c)
+        c = nav_grid.sample_free_cell(rng, component=spawn_component)
+        if c is None:
+            raise RuntimeError("Failed to sample a free spawn cell.")
+        return nav_grid.cell_center_world(c)
+
+    h = float(half_extent)
+    car = CarBlock(
+        sim,
+        name="car",
+        position=(*free_xy(preferred=(0.0, -h + 0.5 * ROAD_W)), 0.15),
+        config=CarBlockConfig(control_mode=mode, color=CAR_COLOR),
+    )
+    npcs = [
+        NPCBlock(
+            sim,
+            name=f"npc_{i}",
+            position=(*free_xy(), 0.15),
+            config=NPCBlockConfig(
+                control_mode=mode,
+                roam_xy_min=(-h, -h),
+                roam_xy_max=(h, h),
+                cruise_speed=4.0,
+                max_speed=6.0,
+                speed_delta=1.0,
+                turn_rate=3.0,
+                heading_threshold=0.25,
+                waypoint_tolerance=0.6,
+                color=NPC_COLOR,
+                size=(0.25, 0.25, 0.5),
+            ),
+            rng=random.Random(seed + 1000 + i),
+            nav_grid=nav_grid,
+            planner=planner,
+        )
+        for i in range(n_npcs)
+    ]
+    rig = None
+    if camera_rig_res > 0:
+        from kiln.sim.genesis.cameras import CameraRigConfig
+
+        r = int(camera_rig_res)
+        rig = sim.add_camera_rig(
+            CameraRigConfig(res=(r, r), every=max(1, int(camera_rig_every))),
+            mounts=[car.entity, *(n.entity for n in npcs)],
+        )
+    if before_build is not None:
+        before_build(sim)
+    sim.build()
+
+    if collisions:
+        npc_entities = [n.entity for n in npcs]
+        car.set_collision_targets(tracked_entities=npc_entities + building_entities)
+        for n in npcs:
+            n.set_collision_targets(tracked_entities=[car.entity] + building_entities)
+
+    avoid_hash = SpatialHash(max((n.npc_config.avoid_radius for n in npcs), default=1.0))
+    return CityWorld(
+        sim=sim,
+        buildings=buildings,
+        building_entities=building_entities,
+        nav_grid=nav_grid,
+        planner=planner,
+        car=car,
+        npcs=npcs,
+        crowd=NPCCrowdPolicy(npcs),
+        avoid_hash=avoid_hash,
+        dynamic=[car.entity, *(n.entity for n in npcs)],
+        rig=rig,
+    )
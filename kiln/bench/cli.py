@@ -0,0 +1,197 @@
+from __future__ import annotations
+
+"""
+Command-line entry point for the benchmark suite.
+
+Usage:
+    kiln-bench list
+    kiln-bench run [--scenario NAME ...] [--backend cpu --backend gpu] [--quick] [--out results.json]
+    kiln-bench compare base.json new.json [--threshold 0.10]
+
+(`python -m kiln.bench ...` works without installing the console script.)
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+from typing import Any, Sequence
+
+from .report import compare, format_deltas, load_report, make_report, write_report
+from .scenarios import SCENARIOS, BenchContext
+
+
+def _parse_override(text: str) -> tuple[str, Any]:
+    key, _, raw = text.partition("=")
+    if not key or not raw:
+        raise argparse.ArgumentTypeError(f"Expected KEY=VALUE (JSON value), got {text!r}")
+    try:
+        value = json.loads(raw)
+    except json.JSONDecodeError:
+        value = raw
+    return key, value
+
+
+def run_scenarios(
+    names: Sequence[str],
+    ctx: BenchContext,
+    *,
+    overrides: dict[str, Any] | None = None,
+    log: Any = print,
+) -> list[dict[str, Any]]:
+    """Run scenarios in this process (simulation scenarios on `ctx.backend`)."""
+    results: list[dict[str, Any]] = []
+    for name in names:
+        sc = SCENARIOS[name]
+        params = sc.resolved_params(ctx, overrides)
+        backend = ctx.backend if sc.needs_sim else None
+        if sc.needs_sim:
+            try:
+                import genesis  # type: ignore  # noqa: F401
+            except ModuleNotFoundError:
+                results.append(_skipped(name, params, backend, "genesis is not installed"))
+                log(f"[bench] {name}: skipped (genesis is not installed)")
+                continue
+        try:
+            cases = sc.run(ctx, params)
+        except Exception as e:
+            results.append({**_skipped(name, params, backend, repr(e)), "status": "error"})
+            log(f"[bench] {name}: error {e!r}")
+            continue
+        for r in cases:
+            step = r["phases"].get("step") or next(iter(r["phases"].values()))
+            log(f"[bench] {name}/{r['case']} backend={backend or '-'} p50={step['p50_ms']:.3f}ms p99={step['p99_ms']:.3f}ms")
+        results.extend(cases)
+    return results
+
+
+def _skipped(name: str, params: dict[str, Any], backend: str | None, reason: str) -> dict[str, Any]:
+    return {
+        "scenario": name,
+        "case": "-",
+        "params": params,
+        "backend": backend,
+        "status": "skipped",
+        "reason": reason,
+        "phases": {},
+        "extra": {},
+    }
+
+
+def _run_child(args: argparse.Namespace, names: Sequence[str], backend: str) -> list[dict[str, Any]]:
+    """Run simulation scenarios for one backend in a fresh process (Genesis initializes once)."""
+    with tempfile.TemporaryDirectory() as d:
+        out = Path(d) / "child.json"
+        cmd = [sys.executable, "-m", "kiln.bench", "run", "--backend", backend, "--out", str(out)]
+        cmd += ["--steps", str(args.steps), "--warmup", str(args.warmup), "--seed", str(args.seed)]
+        for n in names:
+            cmd += ["--scenario", n]
+        for k, v in args.set or []:
+            cmd += ["--set", f"{k}={json.dumps(v)}"]
+        if args.quick:
+            cmd.append("--quick")
+        proc = subprocess.run(cmd)
+        if proc.returncode != 0 or not out.exists():
+            return [
+                {**_skipped(n, {}, backend, f"worker exited with {proc.returncode}"), "status": "error"} for n in names
+            ]
+        return list(load_report(out)["results"])
+
+
+def _cmd_list(args: argparse.Namespace) -> int:
+    for sc in SCENARIOS.values():
+        kind = "sim" if sc.needs_sim else "cpu"
+        print(f"{sc.name:<14} [{kind}] {sc.description}")
+    return 0
+
+
+def _cmd_run(args: argparse.Namespace) -> int:
+    names = list(args.scenario or SCENARIOS)
+    unknown = [n for n in names if n not in SCENARIOS]
+    if unknown:
+        print(f"Unknown scenario(s): {unknown}. Known: {sorted(SCENARIOS)}", file=sys.stderr)
+        return 2
+    backends = list(dict.fromkeys(args.backend or ["cpu"]))
+    overrides = dict(args.set or [])
+    sim_names = [n for n in names if SCENARIOS[n].needs_sim]
+    pure_names = [n for n in names if not SCENARIOS[n].needs_sim]
+
+    def ctx_for(backend: str) -> BenchContext:
+        return BenchContext(backend=backend, steps=args.steps, warmup=args.warmup, seed=args.seed, quick=args.quick)
+
+    results = run_scenarios(pure_names, ctx_for(backends[0]), overrides=overrides)
+    if sim_names:
+        if len(backends) == 1:
+            results += run_scenarios(sim_names, ctx_for(backends[0]), overrides=overrides)
+        else:
+            for b in backends:
+                results += _run_child(args, sim_names, b)
+
+    settings = {"backends": backends, "steps": args.steps, "warmup": args.warmup, "seed": args.seed, "quick": args.quick}
+    report = make_report(results, settings=settings)
+    if args.out:
+        write_report(report, args.out)
+        print(f"[bench] wrote {args.out}")
+    else:
+        print(json.dumps(report, indent=2, sort_keys=True))
+    return 0 if all(r["status"] != "error" for r in results) else 1
+
+
+def _cmd_compare(args: argparse.Namespace) -> int:
+    deltas = compare(load_report(args.base), load_report(args.new), metric=args.metric)
+    if not deltas:
+        print("No common scenario cases between the two reports.")
+        return 0
+    print(format_deltas(deltas, threshold=args.threshold, min_ms=args.min_ms))
+    regressions = [d for d in deltas if d.regressed(args.threshold, args.min_ms)]
+    if regressions:
+        print(f"\n{len(regressions)} phase(s) regressed by more than {args.threshold * 100.0:.0f}%.")
+        return 1
+    return 0
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(prog="kiln-bench", description="Kiln benchmark suite.")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("list", help="List scenarios.")
+    p.set_defaults(func=_cmd_list)
+
+    p = sub.add_parser("run", help="Run scenarios and write a JSON report.")
+    p.add_argument("--scenario", action="append", help="Scenario name (repeatable; default: all).")
+    p.add_argument(
+        "--backend",
+        action="append",
+        choices=["cpu", "gpu", "cuda", "vulkan"],
+        help="Genesis backend for simulation scenarios (repeatable; each runs in its own process).",
+    )
+    p.add_argument("--steps", type=int, default=300, help="Timed steps per simulation case.")
+    p.add_argument("--warmup", type=int, default=30, help="Untimed warmup steps per case.")
+    p.add_argument("--seed", type=int, default=0, help="RNG seed for procedural content.")
+    p.add_argument("--quick", action="store_true", help="Smaller scenario sizes (smoke runs / CI).")
+    p.add_argument(
+        "--set",
+        action="append",
+        type=_parse_override,
+        metavar="KEY=VALUE",
+        help="Override a scenario parameter (JSON value), e.g. --set n_npcs=256.",
+    )
+    p.add_argument("--out", type=str, default=None, help="Report path (default: print JSON to stdout).")
+    p.set_defaults(func=_cmd_run)
+
+    p = sub.add_parser("compare", help="Compare two reports and flag per-phase regressions.")
+    p.add_argument("base", help="Baseline report (e.g. previous release).")
+    p.add_argument("new", help="New report.")
+    p.add_argument("--metric", choices=["p50_ms", "p99_ms", "mean_ms"], default="p50_ms")
+    p.add_argument("--threshold", type=float, default=0.10, help="Relative slowdown that counts as a regression.")
+    p.add_argument("--min-ms", type=float, default=0.05, help="Ignore phases faster than this in the new report.")
+    p.set_defaults(func=_cmd_compare)
+
+    args = parser.parse_args(argv)
+    return int(args.func(args))
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,108 @@
+from __future__ import annotations
+
+"""Benchmark reports (JSON) and release-to-release regression comparison."""
+
+from dataclasses import dataclass
+import json
+import platform
+import sys
+import time
+from pathlib import Path
+from typing import Any, Iterable, Sequence
+
+FORMAT = "kiln-bench"
+FORMAT_VERSION = 1
+
+
+def _version(dist: str) -> str | None:
+    from importlib import metadata
+
+    try:
+        return metadata.version(dist)
+    except metadata.PackageNotFoundError:
+        return None
+
+
+def environment() -> dict[str, Any]:
+    """Versions and host info recorded with every report."""
+    from kiln.sim.genesis.kernel_cache import genesis_version
+
+    return {
+        "kiln_version": _version("kiln"),
+        "genesis_version": genesis_version(),
+        "torch_version": _version("torch"),
+        "python": sys.version.split()[0],
+        "platform": platform.platform(),
+        "machine": platform.machine(),
+    }
+
+
+def make_report(results: Sequence[dict[str, Any]], *, settings: dict[str, Any]) -> dict[str, Any]:
+    return {
+        "format": FORMAT,
+        "version": FORMAT_VERSION,
+        "created_at": time.strftime("%Y-%m-%dT%H:%M:%S%z"),
+        "environment": environment(),
+        "settings": settings,
+        "results": list(results),
+    }
+
+
+def load_report(path: str | Path) -> dict[str, Any]:
+    report = json.loads(Path(path).read_text(encoding="utf-8"))
+    if report.get("format") != FORMAT:
+        raise ValueError(f"Not a kiln bench report: {path}")
+    return report
+
+
+def write_report(report: dict[str, Any], path: str | Path) -> None:
+    path = Path(path)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    path.write_text(json.dumps(report, indent=2, sort_keys=True), encoding="utf-8")
+
+
+@dataclass(frozen=True)
+class Delta:
+    """Change of one phase metric between two reports (`ratio = new / base`)."""
+
+    scenario: str
+    case: str
+    backend: str | None
+    phase: str
+    base_ms: float
+    new_ms: float
+
+    @property
+    def ratio(self) -> float:
+        return self.new_ms / self.base_ms if self.base_ms > 0.0 else (1.0 if self.new_ms == 0.0 else float("inf"))
+
+    def regressed(self, threshold: float, min_ms: float) -> bool:
+        return self.new_ms >= min_ms and self.ratio > 1.0 + threshold
+
+
+def _index(report: dict[str, Any]) -> dict[tuple[str, str, str | None], dict[str, Any]]:
+    return {(r["scenario"], r["case"], r.get("backend")): r for r in report["results"] if r.get("status") == "ok"}
+
+
+def compare(base: dict[str, Any], new: dict[str, Any], *, metric: str = "p50_ms") -> list[Delta]:
+    """Per-phase deltas for every (scenario, case, backend) present and ok in both reports."""
+    a, b = _index(base), _index(new)
+    out: list[Delta] = []
+    for key in sorted(set(a) & set(b), key=lambda k: (k[0], k[1], k[2] or "")):
+        pa, pb = a[key]["phases"], b[key]["phases"]
+        for phase in pa:
+            if phase in pb and metric in pa[phase] and metric in pb[phase]:
+                out.append(Delta(key[0], key[1], key[2], phase, float(pa[phase][metric]), float(pb[phase][metric])))
+    return out
+
+
+def format_deltas(deltas: Iterable[Delta], *, threshold: float, min_ms: float) -> str:
+    lines = [f"{'scenario':<14} {'case':<18} {'backend':<8} {'phase':<14} {'base':>10} {'new':>10} {'change':>8}"]
+    for d in deltas:
+        flag = "  REGRESSION" if d.regressed(threshold, min_ms) else ""
+        change = f"{(d.ratio - 1.0) * 100.0:+.1f}%" if d.ratio != float("inf") else "new"
+        lines.append(
+            f"{d.scenario:<14} {d.case:<18} {str(d.backend or '-'):<8} {d.phase:<14} "
+            f"{d.base_ms:>9.3f}m {d.new_ms:>9.3f}m {change:>8}{flag}"
+        )
+    return "\n".join(lines)
@@ -0,0 +1,360 @@
+from __future__ import annotations
+
+"""
+Named benchmark scenarios.
+
+Each scenario runs one or more cases and returns one result dict per case:
+
+    {"scenario", "case", "params", "backend", "status", "phases": {phase: summary}, "extra": {...}}
+
+where each phase summary holds `p50_ms`, `p99_ms`, `mean_ms`, `total_s` and `n` (see
+`stats.summarize`). Simulation scenarios step a Genesis scene on `ctx.backend` and report the
+`policy` / `control` / `physics` / `collisions` / `render` phases of the demo loop; the other
+scenarios time pure-Python subsystems (bundle loading, NavGrid builds, A* replans) and report
+their own phases.
+"""
+
+from dataclasses import dataclass, field
+import json
+import random
+import tempfile
+from pathlib import Path
+from typing import Any, Callable
+
+from .stats import PhaseTimer, summarize, time_calls
+
+CaseResult = dict[str, Any]
+
+
+@dataclass
+class BenchContext:
+    """
+    Run settings shared by every scenario.
+
+    Attributes:
+        backend: Genesis backend for simulation scenarios ("cpu", "gpu", ...).
+        steps: Timed steps per simulation case (repeats for timed calls).
+        warmup: Untimed steps (calls) before timing.
+        seed: RNG seed for procedural content.
+        quick: Use each scenario's smaller `quick` parameters.
+    """
+
+    backend: str = "cpu"
+    steps: int = 300
+    warmup: int = 30
+    seed: int = 0
+    quick: bool = False
+    _sim: Any | None = field(default=None, repr=False)
+
+    def sim(self) -> Any:
+        """The process-wide `GenesisSim` for `backend` (Genesis can only be initialized once)."""
+        if self._sim is None:
+            from kiln.sim.genesis import GenesisSim, GenesisSimConfig
+
+            self._sim = GenesisSim(
+                GenesisSimConfig(dt=1 / 60, substeps=8, headless=True, seed=self.seed, backend=self.backend)
+            )
+        return self._sim
+
+
+@dataclass(frozen=True)
+class Scenario:
+    """
+    Attributes:
+        name: Registry key (`python -m kiln.bench run --scenario NAME`).
+        description: One-line summary for `list`.
+        run: `run(ctx, params) -> [case results]`.
+        needs_sim: Whether the scenario steps Genesis (run once per backend).
+        params: Default parameters.
+        quick: Overrides applied with `--quick`.
+    """
+
+    name: str
+    description: str
+    run: Callable[[BenchContext, dict[str, Any]], list[CaseResult]]
+    needs_sim: bool
+    params: dict[str, Any] = field(default_factory=dict)
+    quick: dict[str, Any] = field(default_factory=dict)
+
+    def resolved_params(self, ctx: BenchContext, overrides: dict[str, Any] | None = None) -> dict[str, Any]:
+        out = dict(self.params)
+        if ctx.quick:
+            out.update(self.quick)
+        out.update(overrides or {})
+        return out
+
+
+SCENARIOS: dict[str, Scenario] = {}
+
+
+def scenario(name: str, description: str, *, needs_sim: bool, quick: dict[str, Any] | None = None, **params: Any):
+    """Register a scenario function under `name`."""
+
+    def deco(fn: Callable[[BenchContext, dict[str, Any]], list[CaseResult]]):
+        SCENARIOS[name] = Scenario(name, description, fn, needs_sim, dict(params), dict(quick or {}))
+        return fn
+
+    return deco
+
+
+def _case(name: str, case: str, params: dict[str, Any], ctx: BenchContext, phases: dict, **extra: Any) -> CaseResult:
+    return {
+        "scenario": name,
+        "case": case,
+        "params": params,
+        "backend": ctx.backend if SCENARIOS[name].needs_sim else None,
+        "status": "ok",
+        "phases": phases,
+        "extra": extra,
+    }
+
+
+# ----------------------------
+# Simulation scenarios
+# ----------------------------
+def car_action(step: int) -> int:
+    """The demo car's lazy loop: accelerate, turn right, brake."""
+    from kiln.actors import DiscreteAction
+
+    phase = step % 240
+    if phase < 120:
+        return int(DiscreteAction.ACCELERATE)
+    if phase < 180:
+        return int(DiscreteAction.TURN_RIGHT)
+    return int(DiscreteAction.DECELERATE)
+
+
+def run_city_loop(
+    world: Any,
+    ctx: BenchContext,
+    *,
+    mode: str = "full",
+    collisions: bool = False,
+    min_force: float = 0.0,
+    on_window_start: Callable[[], None] | None = None,
+) -> dict:
+    """
+    The demo's step loop with per-phase timing (also `genesis_demo.py --bench`).
+
+    Modes: `full` runs everything, `physics_only` only steps the sim, `python_only` skips
+    `sim.step()` and feeds the policy a snapshot taken once. `on_window_start()` runs once the
+    warmup steps are done, right before the timed window.
+    """
+    from kiln.actors import step_control_all
+
+    sim = world.sim
+    dt = sim.config.dt
+    timer = PhaseTimer()
+    frozen = sim.snapshot() if mode == "python_only" else None
+    for step in range(ctx.warmup + ctx.steps):
+        if step == ctx.warmup:
+            if on_window_start is not None:
+                on_window_start()
+            timer.reset()
+        if mode != "physics_only":
+            with timer.phase("policy"):
+                world.car.apply_action(car_action(step))
+                snap = frozen if frozen is not None else sim.snapshot()
+                world.crowd.step(world.dynamic, positions_by_id=snap, spatial_hash=world.avoid_hash)
+                world.planner.solve_pending()
+            with timer.phase("control"):
+                step_control_all(sim, dt)
+        if mode != "python_only":
+            with timer.phase("physics"):
+                sim.step()
+        if collisions and mode == "full":
+            with timer.phase("collisions"):
+                world.car.poll_collision_events(step_idx=step, min_force=min_force)
+                for n in world.npcs:
+                    n.poll_collision_events(step_idx=step, min_force=min_force)
+        if world.rig is not None and mode != "physics_only":
+            with timer.phase("render"):
+                world.rig.render(step)
+        timer.end_step()
+    return timer.summary()
+
+
+def _city(ctx: BenchContext, p: dict[str, Any], **overrides: Any) -> Any:
+    from .city import build_city
+
+    kw = {k: p[k] for k in ("city_n", "half_extent", "n_npcs", "collisions", "camera_rig_res") if k in p}
+    kw.update(overrides)
+    return build_city(ctx.sim(), seed=ctx.seed, **kw)
+
+
+@scenario(
+    "city",
+    "Demo city (car + NPCs + buildings) in the full / python_only / physics_only bench modes.",
+    needs_sim=True,
+    quick={"city_n": 3},
+    city_n=8,
+    half_extent=20.0,
+    n_npcs=16,
+    modes=("full", "python_only", "physics_only"),
+    camera_rig_res=0,
+)
+def _scenario_city(ctx: BenchContext, p: dict[str, Any]) -> list[CaseResult]:
+    out = []
+    for mode in p["modes"]:
+        world = _city(ctx, p)
+        phases = run_city_loop(world, ctx, mode=mode)
+        out.append(_case("city", mode, p, ctx, phases, n_buildings=len(world.buildings)))
+    return out
+
+
+@scenario(
+    "npc_sweep",
+    "Full loop cost as the NPC count grows.",
+    needs_sim=True,
+    quick={"counts": (4, 16)},
+    city_n=5,
+    half_extent=12.0,
+    counts=(8, 32, 128),
+)
+def _scenario_npc_sweep(ctx: BenchContext, p: dict[str, Any]) -> list[CaseResult]:
+    out = []
+    for n in p["counts"]:
+        world = _city(ctx, p, n_npcs=int(n))
+        out.append(_case("npc_sweep", f"npcs={n}", p, ctx, run_city_loop(world, ctx), n_npcs=int(n)))
+    return out
+
+
+@scenario(
+    "collisions",
+    "Dense crowd in a small city with collision polling for every actor.",
+    needs_sim=True,
+    quick={"n_npcs": 16},
+    city_n=3,
+    half_extent=8.0,
+    n_npcs=64,
+)
+def _scenario_collisions(ctx: BenchContext, p: dict[str, Any]) -> list[CaseResult]:
+    world = _city(ctx, p, collisions=True)
+    phases = run_city_loop(world, ctx, collisions=True)
+    return [_case("collisions", f"npcs={p['n_npcs']}", p, ctx, phases)]
+
+
+# ----------------------------
+# Pure-Python scenarios
+# ----------------------------
+def _write_bundle(directory: Path, n: int, seed: int) -> Path:
+    rng = random.Random(seed)
+    prims = [
+        {
+            "id": f"box_{i}",
+            "shape": "box",
+            "pose": {"pos": [rng.uniform(-50, 50), rng.uniform(-50, 50), 1.0], "quat": [1.0, 0.0, 0.0, 0.0]},
+            "size": [rng.uniform(1, 4), rng.uniform(1, 4), rng.uniform(2, 8)],
+            "mass": 0.0,
+            "color": [0.6, 0.6, 0.6],
+        }
+        for i in range(n)
+    ]
+    env = {"schema_version": 1, "scene_file": "scene.usda", "world": {"enabled": False}, "primitives": prims}
+    directory.mkdir(parents=True, exist_ok=True)
+    (directory / "env.json").write_text(json.dumps(env), encoding="utf-8")
+    return directory
+
+
+@scenario(
+    "bundle_load",
+    "env.json parse vs compiled env.kbundle load (plus lazy primitive access) for generated bundles.",
+    needs_sim=False,
+    quick={"sizes": (200,)},
+    sizes=(1000, 10000),
+)
+def _scenario_bundle_load(ctx: BenchContext, p: dict[str, Any]) -> list[CaseResult]:
+    from kiln.envio.bundle import load_env_bundle
+    from kiln.envio.compiled import compile_env_bundle
+
+    out = []
+    repeat = max(3, min(ctx.steps, 20))
+    with tempfile.TemporaryDirectory() as d:
+        for n in p["sizes"]:
+            bundle_dir = _write_bundle(Path(d) / f"b{n}", int(n), ctx.seed)
+            phases = {"json": time_calls(lambda: load_env_bundle(bundle_dir, compiled=False), repeat=repeat)}
+            t = PhaseTimer(phases=("compile",))
+            with t.phase("compile"):
+                compile_env_bundle(bundle_dir)
+            t.end_step()
+            phases["compile"] = t.summary()["compile"]
+            phases["compiled"] = time_calls(lambda: load_env_bundle(bundle_dir, compiled=True), repeat=repeat)
+            phases["compiled_iter"] = time_calls(
+                lambda: list(load_env_bundle(bundle_dir, compiled=True).primitives), repeat=repeat
+            )
+            out.append(_case("bundle_load", f"primitives={n}", p, ctx, phases, n_primitives=int(n)))
+    return out
+
+
+@scenario(
+    "navgrid_build",
+    "NavGrid.build over city layouts of growing size.",
+    needs_sim=False,
+    quick={"sizes": ((5, 12.0),)},
+    sizes=((5, 12.0), (20, 48.0), (40, 96.0)),
+    cell_size=0.5,
+)
+def _scenario_navgrid(ctx: BenchContext, p: dict[str, Any]) -> list[CaseResult]:
+    from .city import city_layout, city_nav_grid
+
+    out = []
+    repeat = max(3, min(ctx.steps, 20))
+    for city_n, half in p["sizes"]:
+        buildings = city_layout(random.Random(ctx.seed), city_n=int(city_n), half_extent=float(half))
+        phases = {
+            "build": time_calls(
+                lambda: city_nav_grid(buildings, half_extent=float(half), cell_size=float(p["cell_size"])),
+                repeat=repeat,
+            )
+        }
+        grid = city_nav_grid(buildings, half_extent=float(half), cell_size=float(p["cell_size"]))
+        out.append(
+            _case(
+                "navgrid_build",
+                f"city_n={city_n}",
+                p,
+                ctx,
+                phases,
+                cells=int(grid.width * grid.height),
+                obstacles=len(buildings),
+            )
+        )
+    return out
+
+
+@scenario(
+    "astar_replans",
+    "CrowdPlanner.solve_pending with a batch of uncached replans per tick.",
+    needs_sim=False,
+    quick={"requests_per_tick": 16},
+    city_n=10,
+    half_extent=24.0,
+    requests_per_tick=64,
+)
+def _scenario_astar(ctx: BenchContext, p: dict[str, Any]) -> list[CaseResult]:
+    from kiln.actors.planner import CrowdPlanner
+
+    from .city import city_layout, city_nav_grid
+
+    rng = random.Random(ctx.seed)
+    buildings = city_layout(rng, city_n=int(p["city_n"]), half_extent=float(p["half_extent"]))
+    grid = city_nav_grid(buildings, half_extent=float(p["half_extent"]))
+    comp = max(range(grid.n_components), key=grid.component_size, default=-1)
+    # No cache: every tick measures fresh searches.
+    planner = CrowdPlanner(grid, cache_size=0)
+    timer = PhaseTimer(phases=("solve",))
+    k = int(p["requests_per_tick"])
+    for tick in range(ctx.warmup + ctx.steps):
+        if tick == ctx.warmup:
+            timer.reset()
+        for _ in range(k):
+            a = grid.sample_free_cell(rng, component=comp)
+            b = grid.sample_free_cell(rng, component=comp)
+            if a is not None and b is not None:
+                planner.submit(a, b)
+        with timer.phase("solve"):
+            planner.solve_pending()
+        timer.end_step()
+    phases = timer.summary()
+    per_request = summarize([s / max(1, k) for s in timer.samples["solve"]])
+    return [_case("astar_replans", f"requests={k}", p, ctx, phases, per_request_ms=per_request["p50_ms"])]
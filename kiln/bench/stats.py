@@ -0,0 +1,98 @@
+from __future__ import annotations
+
+"""Per-step phase timing and percentile summaries."""
+
+from contextlib import contextmanager
+import time
+from typing import Callable, Iterator, Sequence
+
+import numpy as np
+
+# Canonical phase names, in report order (scenarios may add their own).
+PHASES = ("policy", "control", "physics", "collisions", "render")
+
+
+class PhaseTimer:
+    """
+    Collects one duration per phase per step.
+
+    Usage:
+        timer = PhaseTimer()
+        for step in range(n):
+            with timer.phase("policy"):
+                ...
+            timer.end_step()
+
+    Phases not entered in a step record 0, so every phase has one sample per step.
+    """
+
+    def __init__(self, phases: Sequence[str] = PHASES) -> None:
+        self.phases: list[str] = list(phases)
+        self.samples: dict[str, list[float]] = {p: [] for p in self.phases}
+        self.step_samples: list[float] = []
+        self._current: dict[str, float] = {}
+        self._step_t0 = time.perf_counter()
+
+    @contextmanager
+    def phase(self, name: str) -> Iterator[None]:
+        t0 = time.perf_counter()
+        try:
+            yield
+        finally:
+            self.add(name, time.perf_counter() - t0)
+
+    def add(self, name: str, seconds: float) -> None:
+        """Add `seconds` to phase `name` for the current step."""
+        if name not in self.samples:
+            self.phases.append(name)
+            # Earlier steps did not run this phase.
+            self.samples[name] = [0.0] * len(self.step_samples)
+        self._current[name] = self._current.get(name, 0.0) + float(seconds)
+
+    def end_step(self) -> None:
+        now = time.perf_counter()
+        for p in self.phases:
+            self.samples[p].append(self._current.get(p, 0.0))
+        self.step_samples.append(now - self._step_t0)
+        self._current = {}
+        self._step_t0 = now
+
+    def reset(self) -> None:
+        """Drop samples collected so far (e.g. after warmup steps)."""
+        self.samples = {p: [] for p in self.phases}
+        self.step_samples = []
+        self._current = {}
+        self._step_t0 = time.perf_counter()
+
+    def summary(self) -> dict[str, dict[str, float]]:
+        out = {p: summarize(self.samples[p]) for p in self.phases}
+        out["step"] = summarize(self.step_samples)
+        return out
+
+
+def summarize(samples: Sequence[float]) -> dict[str, float]:
+    """p50/p99/mean in milliseconds plus total seconds and sample count."""
+    a = np.asarray(samples, dtype=np.float64)
+    if a.size == 0:
+        return {"n": 0, "p50_ms": 0.0, "p99_ms": 0.0, "mean_ms": 0.0, "total_s": 0.0}
+    p50, p99 = np.percentile(a, [50.0, 99.0])
+    return {
+        "n": int(a.size),
+        "p50_ms": round(float(p50) * 1e3, 6),
+        "p99_ms": round(float(p99) * 1e3, 6),
+        "mean_ms": round(float(a.mean()) * 1e3, 6),
+        "total_s": round(float(a.sum()), 6),
+    }
+
+
+def time_calls(fn: Callable[[], object], *, repeat: int, warmup: int = 1) -> dict[str, float]:
+    """Summary of `repeat` timed calls of `fn()` after `warmup` untimed ones."""
+    for _ in range(max(0, int(warmup))):
+        fn()
+    samples = []
+    for _ in range(max(1, int(repeat))):
+        t0 = time.perf_counter()
+        fn()
+        samples.append(time.perf_counter() - t0)
+    return summarize(samples)
+
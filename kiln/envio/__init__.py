@@ -4,17 +4,20 @@ Env bundle IO for Kiln.
 An env bundle is a small directory containing:
 - a USD file (geometry)
 - an `env.json` sidecar (simulation semantics)
+- optionally an `env.kbundle` compiled, memory-mapped copy of `env.json` (see `compiled.py`)
 """
 
 from .bundle import (  # noqa: F401
+    CollisionLodSpec,
     EnvBundle,
     EnvBundleError,
     EnvBundleV1,
     Pose,
     PrimitiveSpec,
+    TaskSpec,
+    TaskTermSpec,
     WorldSpec,
     load_env_bundle,
     save_env_bundle,
 )
-
-
+from .compiled import PrimitiveColumns, compile_env_bundle, load_compiled_bundle  # noqa: F401
@@ -21,6 +21,8 @@ from dataclasses import dataclass, field
 from pathlib import Path
 from typing import Any, Literal, Mapping, MutableMapping, Sequence, TypeAlias
 
+from .files import write_bytes_if_changed
+
 Vec3: TypeAlias = tuple[float, float, float]
 Quat4: TypeAlias = tuple[float, float, float, float]  # (w, x, y, z) to match Genesis
 RGB: TypeAlias = tuple[float, float, float]
@@ -115,6 +117,51 @@ class Pose:
         }
 
 
+COLLISION_LOD_TYPES: tuple[str, ...] = ("full", "boxes", "convex", "heightfield")
+
+
+@dataclass(frozen=True)
+class CollisionLodSpec:
+    """
+    Collision level of detail for the USD world (`WorldSpec.collision_lod`).
+
+    - full: collide against the USD mesh itself (default)
+    - boxes: up to `max_parts` boxes bounding spatial clusters of the mesh triangles
+    - convex: up to `max_parts` convex hulls of the same clusters
+    - heightfield: terrain sampled from above every `cell_size` (for ground-like worlds)
+
+    For anything but `full` the USD mesh is only rendered and the proxies (cached next to
+    the bundle, see `kiln.sim.genesis.world_lod`) are added as collision-only geometry.
+    JSON accepts the bare type string or an object with `type`, `max_parts` and `cell_size`.
+    """
+
+    type: str = "full"
+    max_parts: int = 64
+    cell_size: float = 0.5
+
+    @staticmethod
+    def from_json(obj: Any, *, ctx: str) -> "CollisionLodSpec":
+        if obj is None:
+            return CollisionLodSpec()
+        if isinstance(obj, str):
+            obj = {"type": obj}
+        if not isinstance(obj, Mapping):
+            raise EnvBundleError(f"Expected a string or object for {ctx}, got {obj!r}")
+        kind = _as_str(obj.get("type", "full"), ctx=f"{ctx}.type")
+        if kind not in COLLISION_LOD_TYPES:
+            raise EnvBundleError(f"Unsupported {ctx}.type={kind!r}. Expected one of {list(COLLISION_LOD_TYPES)}")
+        max_parts = obj.get("max_parts", 64)
+        if isinstance(max_parts, bool) or not isinstance(max_parts, int) or max_parts < 1:
+            raise EnvBundleError(f"Expected {ctx}.max_parts to be a positive integer, got {max_parts!r}")
+        cell_size = _as_float(obj.get("cell_size", 0.5), ctx=f"{ctx}.cell_size")
+        if cell_size <= 0.0:
+            raise EnvBundleError(f"Expected {ctx}.cell_size > 0, got {cell_size!r}")
+        return CollisionLodSpec(type=kind, max_parts=int(max_parts), cell_size=cell_size)
+
+    def to_json(self) -> dict[str, Any]:
+        return {"type": self.type, "max_parts": int(self.max_parts), "cell_size": float(self.cell_size)}
+
+
 @dataclass(frozen=True)
 class WorldSpec:
     """
@@ -129,6 +176,7 @@ class WorldSpec:
     collision: bool = True
     visualization: bool = True
     scale: float = 1.0
+    collision_lod: CollisionLodSpec = field(default_factory=CollisionLodSpec)
 
     @staticmethod
     def from_json(obj: Any, *, ctx: str) -> "WorldSpec":
@@ -144,10 +192,11 @@ class WorldSpec:
             collision=_as_bool(obj.get("collision", True), ctx=f"{ctx}.collision"),
             visualization=_as_bool(obj.get("visualization", True), ctx=f"{ctx}.visualization"),
             scale=_as_float(obj.get("scale", 1.0), ctx=f"{ctx}.scale"),
+            collision_lod=CollisionLodSpec.from_json(obj.get("collision_lod", None), ctx=f"{ctx}.collision_lod"),
         )
 
     def to_json(self) -> dict[str, Any]:
-        return {
+        out: dict[str, Any] = {
             "enabled": bool(self.enabled),
             "pose": self.pose.to_json(),
             "fixed": bool(self.fixed),
@@ -155,6 +204,10 @@ class WorldSpec:
             "visualization": bool(self.visualization),
             "scale": float(self.scale),
         }
+        # Omitted at the default so existing env.json files round-trip unchanged.
+        if self.collision_lod != CollisionLodSpec():
+            out["collision_lod"] = self.collision_lod.to_json()
+        return out
 
 
 PrimitiveShape: TypeAlias = Literal["plane", "box", "sphere", "cylinder"]
@@ -292,6 +345,167 @@ class PrimitiveSpec:
         return {k: v for k, v in out.items() if v is not None}
 
 
+RewardType: TypeAlias = Literal["goal_distance", "progress", "goal_reached", "collision", "alive"]
+TerminationType: TypeAlias = Literal["goal_reached", "contact"]
+REWARD_TYPES: tuple[str, ...] = ("goal_distance", "progress", "goal_reached", "collision", "alive")
+TERMINATION_TYPES: tuple[str, ...] = ("goal_reached", "contact")
+OBSERVATION_TERMS: tuple[str, ...] = ("agent_pos", "agent_vel", "goal_delta", "goal_distance", "time_left", "contacts")
+
+
+@dataclass(frozen=True)
+class TaskTermSpec:
+    """
+    One reward or termination term of a `TaskSpec`.
+
+    Reward types (`weight` scales the term):
+    - goal_distance: distance from the agent to the goal (use a negative weight)
+    - progress: decrease of that distance since the previous step
+    - goal_reached: 1 while the agent is within `radius` of the goal
+    - collision: 1 while the agent touches a primitive with `role`
+    - alive: 1 every step
+
+    Termination types: `goal_reached` (within `radius`) and `contact` (touching `role`).
+    """
+
+    type: str
+    weight: float = 1.0
+    role: str | None = None
+    radius: float = 0.5
+
+    @staticmethod
+    def from_json(obj: Any, *, ctx: str, allowed: tuple[str, ...], roles: Mapping[str, Any]) -> "TaskTermSpec":
+        if not isinstance(obj, Mapping):
+            raise EnvBundleError(f"Expected an object for {ctx}, got {obj!r}")
+        kind = _as_str(obj.get("type", ""), ctx=f"{ctx}.type")
+        if kind not in allowed:
+            raise EnvBundleError(f"Unsupported {ctx}.type={kind!r}. Expected one of {list(allowed)}")
+        role = obj.get("role", None)
+        if role is not None:
+            role = _as_str(role, ctx=f"{ctx}.role")
+        if kind in ("collision", "contact"):
+            if role is None:
+                raise EnvBundleError(f"Missing {ctx}.role for {kind!r}")
+            if role not in roles:
+                raise EnvBundleError(f"Unknown {ctx}.role={role!r}; declare it in task.roles")
+        radius = _as_float(obj.get("radius", 0.5), ctx=f"{ctx}.radius")
+        if radius <= 0.0:
+            raise EnvBundleError(f"Expected {ctx}.radius > 0, got {radius!r}")
+        return TaskTermSpec(
+            type=kind,
+            weight=_as_float(obj.get("weight", 1.0), ctx=f"{ctx}.weight"),
+            role=role,
+            radius=radius,
+        )
+
+    def to_json(self) -> dict[str, Any]:
+        out: dict[str, Any] = {"type": self.type, "weight": float(self.weight), "radius": float(self.radius)}
+        if self.role is not None:
+            out["role"] = self.role
+        return out
+
+
+def _as_terms(raw: Any, *, ctx: str, allowed: tuple[str, ...], roles: Mapping[str, Any]) -> tuple[TaskTermSpec, ...]:
+    if raw is None:
+        return ()
+    if not isinstance(raw, Sequence) or isinstance(raw, (str, bytes)):
+        raise EnvBundleError(f"Expected a list for {ctx}, got {raw!r}")
+    return tuple(TaskTermSpec.from_json(t, ctx=f"{ctx}[{i}]", allowed=allowed, roles=roles) for i, t in enumerate(raw))
+
+
+@dataclass(frozen=True)
+class TaskSpec:
+    """
+    Optional RL task definition (`env.json` `task` section).
+
+    Fields:
+    - agent: id of the primitive the task is about (runtimes may pass another entity instead)
+    - goal: fixed goal position, or the name of a spawn point
+    - roles: role name -> primitive id patterns (`fnmatch` style, e.g. `"building_*"`)
+    - rewards / terminations: `TaskTermSpec` lists (rewards are summed)
+    - time_limit: episode length in steps (truncation); None for no limit
+    - observations: names from `OBSERVATION_TERMS`, concatenated in this order
+    """
+
+    agent: str | None = None
+    goal: Vec3 | str | None = None
+    roles: Mapping[str, tuple[str, ...]] = field(default_factory=dict)
+    rewards: tuple[TaskTermSpec, ...] = ()
+    terminations: tuple[TaskTermSpec, ...] = ()
+    time_limit: int | None = None
+    observations: tuple[str, ...] = ("agent_pos", "agent_vel", "goal_delta")
+
+    @staticmethod
+    def from_json(obj: Any, *, ctx: str) -> "TaskSpec | None":
+        """Parse TaskSpec from JSON (None for a missing/null section)."""
+        if obj is None:
+            return None
+        if not isinstance(obj, Mapping):
+            raise EnvBundleError(f"Expected an object for {ctx}, got {obj!r}")
+        agent = obj.get("agent", None)
+        if agent is not None:
+            agent = _as_str(agent, ctx=f"{ctx}.agent")
+
+        goal_raw = obj.get("goal", None)
+        goal: Vec3 | str | None
+        if goal_raw is None or isinstance(goal_raw, str):
+            goal = goal_raw
+        else:
+            goal = _as_vec3(goal_raw, ctx=f"{ctx}.goal")
+
+        roles_raw = obj.get("roles", {}) or {}
+        if not isinstance(roles_raw, Mapping):
+            raise EnvBundleError(f"Expected an object for {ctx}.roles, got {roles_raw!r}")
+        roles: dict[str, tuple[str, ...]] = {}
+        for k, v in roles_raw.items():
+            name = _as_str(k, ctx=f"{ctx}.roles key")
+            if isinstance(v, str):
+                v = [v]
+            if not isinstance(v, Sequence):
+                raise EnvBundleError(f"Expected a list of id patterns for {ctx}.roles[{name!r}], got {v!r}")
+            roles[name] = tuple(_as_str(x, ctx=f"{ctx}.roles[{name!r}][{i}]") for i, x in enumerate(v))
+
+        time_limit = obj.get("time_limit", None)
+        if time_limit is not None:
+            if isinstance(time_limit, bool) or not isinstance(time_limit, int) or time_limit <= 0:
+                raise EnvBundleError(f"Expected a positive integer for {ctx}.time_limit, got {time_limit!r}")
+
+        obs_raw = obj.get("observations", None)
+        observations = TaskSpec.observations
+        if obs_raw is not None:
+            if not isinstance(obs_raw, Sequence) or isinstance(obs_raw, (str, bytes)):
+                raise EnvBundleError(f"Expected a list for {ctx}.observations, got {obs_raw!r}")
+            observations = tuple(_as_str(o, ctx=f"{ctx}.observations[{i}]") for i, o in enumerate(obs_raw))
+            for o in observations:
+                if o not in OBSERVATION_TERMS:
+                    raise EnvBundleError(
+                        f"Unsupported {ctx}.observations entry {o!r}. Expected one of {list(OBSERVATION_TERMS)}"
+                    )
+
+        return TaskSpec(
+            agent=agent,
+            goal=goal,
+            roles=roles,
+            rewards=_as_terms(obj.get("rewards"), ctx=f"{ctx}.rewards", allowed=REWARD_TYPES, roles=roles),
+            terminations=_as_terms(
+                obj.get("terminations"), ctx=f"{ctx}.terminations", allowed=TERMINATION_TYPES, roles=roles
+            ),
+            time_limit=time_limit,
+            observations=observations,
+        )
+
+    def to_json(self) -> dict[str, Any]:
+        out: dict[str, Any] = {
+            "agent": self.agent,
+            "goal": list(self.goal) if isinstance(self.goal, tuple) else self.goal,
+            "roles": {k: list(v) for k, v in self.roles.items()},
+            "rewards": [t.to_json() for t in self.rewards],
+            "terminations": [t.to_json() for t in self.terminations],
+            "time_limit": self.time_limit,
+            "observations": list(self.observations),
+        }
+        return {k: v for k, v in out.items() if v is not None}
+
+
 @dataclass(frozen=True)
 class EnvBundleV1:
     """Env bundle schema v1 for `env.json`."""
@@ -301,6 +515,7 @@ class EnvBundleV1:
     world: WorldSpec = field(default_factory=WorldSpec)
     primitives: tuple[PrimitiveSpec, ...] = ()
     spawn_points: Mapping[str, Pose] = field(default_factory=lambda: {"default": Pose(pos=(0.0, 0.0, 0.5))})
+    task: TaskSpec | None = None
 
     def resolve_scene_path(self, bundle_dir: Path) -> Path:
         """
@@ -346,52 +561,76 @@ class EnvBundleV1:
         if not spawn_points:
             spawn_points = {"default": Pose(pos=(0.0, 0.0, 0.5))}
 
+        task = TaskSpec.from_json(obj.get("task", None), ctx=f"{ctx}.task")
+        if task is not None and isinstance(task.goal, str) and task.goal not in spawn_points:
+            raise EnvBundleError(f"{ctx}.task.goal references unknown spawn point {task.goal!r}")
+
         return EnvBundleV1(
             schema_version=1,
             scene_file=scene_file,
             world=world,
             primitives=primitives,
             spawn_points=spawn_points,
+            task=task,
         )
 
     def to_json(self) -> dict[str, Any]:
         """Convert to a JSON-serializable dict."""
         spawn_points: dict[str, Any] = {k: v.to_json() for k, v in self.spawn_points.items()}
-        return {
+        out: dict[str, Any] = {
             "schema_version": int(self.schema_version),
             "scene_file": self.scene_file,
             "world": self.world.to_json(),
             "primitives": [p.to_json() for p in self.primitives],
             "spawn_points": spawn_points,
         }
+        if self.task is not None:
+            out["task"] = self.task.to_json()
+        return out
 
 
 EnvBundle: TypeAlias = EnvBundleV1
 
 
-def load_env_bundle(bundle_dir: str | Path, *, env_filename: str = "env.json") -> EnvBundle:
+def load_env_bundle(
+    bundle_dir: str | Path,
+    *,
+    env_filename: str = "env.json",
+    compiled: bool | None = None,
+) -> EnvBundle:
     """
     Load and validate an env bundle directory.
 
     Args:
         bundle_dir: Bundle directory path (contains `env.json` and optionally a USD file).
         env_filename: Name of the JSON sidecar file within the bundle.
+        compiled: Use the compiled sidecar (`env.kbundle`, see `kiln.envio.compiled`).
+            None (default) uses it when present and built from the current `env_filename`;
+            True requires it; False always parses JSON.
 
     Returns:
-        Parsed `EnvBundleV1`.
+        Parsed `EnvBundleV1` (with lazily decoded, memory-mapped primitives when compiled).
 
     Raises:
         EnvBundleError: If JSON is missing/invalid or references a missing scene file.
     """
+    from .compiled import compiled_path, is_fresh, load_compiled_bundle
+
     bundle_path = Path(bundle_dir)
     env_path = bundle_path / env_filename
-    if not env_path.exists():
-        raise EnvBundleError(f"Missing env bundle file: {env_path}")
-    try:
-        obj = json.loads(env_path.read_text(encoding="utf-8"))
-    except Exception as e:
-        raise EnvBundleError(f"Failed to read {env_path}: {e}") from e
-    bundle = EnvBundleV1.from_json(obj, ctx=env_filename)
+    bin_path = compiled_path(bundle_path, env_filename=env_filename)
+    if compiled or (compiled is None and is_fresh(bin_path, env_path)):
+        if not bin_path.exists():
+            raise EnvBundleError(f"Missing compiled env bundle file: {bin_path}")
+        bundle = load_compiled_bundle(bin_path)
+    else:
+        if not env_path.exists():
+            raise EnvBundleError(f"Missing env bundle file: {env_path}")
+        try:
+            obj = json.loads(env_path.read_text(encoding="utf-8"))
+        except Exception as e:
+            raise EnvBundleError(f"Failed to read {env_path}: {e}") from e
+        bundle = EnvBundleV1.from_json(obj, ctx=env_filename)
     # validate scene path exists when world is enabled
     if bundle.world.enabled:
         scene_path = bundle.resolve_scene_path(bundle_path)
@@ -405,10 +644,14 @@ def save_env_bundle(
     bundle: EnvBundle,
     *,
     env_filename: str = "env.json",
+    skip_unchanged: bool = True,
 ) -> Path:
     """
     Write an env bundle JSON sidecar (`env.json`).
 
+    With `skip_unchanged` an existing file with identical content is left untouched (keeping
+    its mtime, so e.g. a compiled `env.kbundle` built from it stays fresh).
+
     Note: this function does not write/copy the USD scene file; that is handled by exporters.
     """
     bundle_path = Path(bundle_dir)
@@ -416,7 +659,11 @@ def save_env_bundle(
     env_path = bundle_path / env_filename
     data = bundle.to_json()
     # Ensure stable formatting for diffs.
-    env_path.write_text(json.dumps(data, indent=2, sort_keys=True) + "\n", encoding="utf-8")
+    text = json.dumps(data, indent=2, sort_keys=True) + "\n"
+    if skip_unchanged:
+        write_bytes_if_changed(env_path, text.encode("utf-8"))
+    else:
+        env_path.write_text(text, encoding="utf-8")
     return env_path
 
 
@@ -0,0 +1,115 @@
+from __future__ import annotations
+
+"""
+Command-line tools for env bundles.
+
+Usage:
+    kiln-env compile <bundle_dir> [--env-filename env.json]
+    kiln-env info <bundle_dir>
+    kiln-env collision <bundle_dir> [--lod boxes|convex|heightfield] [--max-parts N] [--cell-size S]
+
+(`python -m kiln.envio ...` works without installing the console script.)
+"""
+
+import argparse
+import time
+from pathlib import Path
+from typing import Sequence
+
+
+def _cmd_compile(args: argparse.Namespace) -> int:
+    from .compiled import compile_env_bundle
+
+    t0 = time.perf_counter()
+    out = compile_env_bundle(Path(args.bundle_dir), env_filename=args.env_filename)
+    dt = time.perf_counter() - t0
+    print(f"[compile] wrote {out} ({out.stat().st_size} bytes) in {dt:.3f}s")
+    return 0
+
+
+def _cmd_info(args: argparse.Namespace) -> int:
+    from .bundle import load_env_bundle
+    from .compiled import PrimitiveColumns, compiled_path, is_fresh
+
+    bundle_dir = Path(args.bundle_dir)
+    bin_path = compiled_path(bundle_dir, env_filename=args.env_filename)
+    t0 = time.perf_counter()
+    bundle = load_env_bundle(bundle_dir, env_filename=args.env_filename)
+    dt = time.perf_counter() - t0
+    compiled = isinstance(bundle.primitives, PrimitiveColumns)
+    stale = bin_path.exists() and not is_fresh(bin_path, bundle_dir / args.env_filename)
+    print(
+        f"[info] primitives={len(bundle.primitives)} spawn_points={sorted(bundle.spawn_points)} "
+        f"source={'compiled' if compiled else 'json'}{' (compiled file is stale)' if stale else ''} "
+        f"load_time={dt:.3f}s"
+    )
+    return 0
+
+
+def _cmd_collision(args: argparse.Namespace) -> int:
+    from dataclasses import replace
+
+    from kiln.sim.genesis.kernel_cache import file_digest
+    from kiln.sim.genesis.sim import _usd_world_triangles
+    from kiln.sim.genesis.world_lod import load_world_proxies, world_proxy_cache_dirs
+
+    from .bundle import CollisionLodSpec, load_env_bundle
+
+    bundle_dir = Path(args.bundle_dir)
+    bundle = load_env_bundle(bundle_dir, env_filename=args.env_filename)
+    lod = bundle.world.collision_lod
+    if args.lod is not None:
+        lod = replace(lod, type=args.lod)
+    if args.max_parts is not None:
+        lod = replace(lod, max_parts=args.max_parts)
+    if args.cell_size is not None:
+        lod = replace(lod, cell_size=args.cell_size)
+    if lod.type == "full":
+        print("[collision] world.collision_lod is 'full'; nothing to build (pass --lod)")
+        return 0
+    lod = CollisionLodSpec.from_json(lod.to_json(), ctx="--lod")
+
+    usd_path = bundle.resolve_scene_path(bundle_dir)
+    t0 = time.perf_counter()
+    proxies = load_world_proxies(
+        lod,
+        source_digest=file_digest(usd_path),
+        load_triangles=lambda: _usd_world_triangles(usd_path),
+        cache_dirs=world_proxy_cache_dirs(bundle_dir),
+    )
+    dt = time.perf_counter() - t0
+    if proxies is None:
+        print(f"[collision] no triangles read from {usd_path} (is `pxr` installed?)")
+        return 1
+    print(f"[collision] {proxies.kind}: {len(proxies)} part(s), key={proxies.key} in {dt:.3f}s")
+    return 0
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(prog="kiln-env", description="Kiln env bundle tools.")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("compile", help="Compile env.json into the memory-mapped env.kbundle sidecar.")
+    p.add_argument("bundle_dir", help="Env bundle directory.")
+    p.add_argument("--env-filename", default="env.json", help="JSON sidecar name within the bundle.")
+    p.set_defaults(func=_cmd_compile)
+
+    p = sub.add_parser("info", help="Load a bundle (compiled sidecar if fresh) and print a summary.")
+    p.add_argument("bundle_dir", help="Env bundle directory.")
+    p.add_argument("--env-filename", default="env.json", help="JSON sidecar name within the bundle.")
+    p.set_defaults(func=_cmd_info)
+
+    p = sub.add_parser("collision", help="Build (or reuse) the cached collision LOD proxies of the USD world.")
+    p.add_argument("bundle_dir", help="Env bundle directory.")
+    p.add_argument("--env-filename", default="env.json", help="JSON sidecar name within the bundle.")
+    p.add_argument("--lod", choices=("boxes", "convex", "heightfield"), help="Override world.collision_lod.type.")
+    p.add_argument("--max-parts", type=int, help="Override world.collision_lod.max_parts.")
+    p.add_argument("--cell-size", type=float, help="Override world.collision_lod.cell_size.")
+    p.set_defaults(func=_cmd_collision)
+
+    args = parser.parse_args(argv)
+    return int(args.func(args))
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,308 @@
+from __future__ import annotations
+
+"""
+Compiled (binary, memory-mapped) env bundle format.
+
+`env.json` is convenient to author but slow to load for large generated scenes: every
+primitive goes through `json.loads` and per-field validation, in every process that loads it.
+`compile_env_bundle` validates `env.json` once and writes `env.kbundle` next to it:
+
+- an 8-byte magic, a little-endian `u64` header length and a JSON header (scene file, world,
+  spawn points, task, source-file fingerprint and a column table)
+- one 64-byte aligned array per primitive column (shape codes, poses, sizes, masses, colors,
+  flags, and the ids as an offsets + bytes string table)
+
+`load_compiled_bundle` maps the file read-only and returns an `EnvBundleV1` whose `primitives`
+is a lazy sequence over the mapped arrays, so the OS page cache is shared by every process that
+loads the same bundle and `PrimitiveSpec`s are only built when accessed.
+"""
+
+import hashlib
+import json
+import os
+from collections.abc import Sequence
+from pathlib import Path
+from typing import Any, Iterator, overload
+
+import numpy as np
+
+from .bundle import EnvBundleError, EnvBundleV1, Pose, PrimitiveSpec, TaskSpec, WorldSpec
+
+MAGIC = b"KILNENV1"
+# 2: header carries the optional `task` section.
+FORMAT_VERSION = 2
+COMPILED_SUFFIX = ".kbundle"
+_ALIGN = 64
+
+SHAPES = ("plane", "box", "sphere", "cylinder")
+_SHAPE_CODES = {s: i for i, s in enumerate(SHAPES)}
+
+# `flags` column bits.
+FLAG_COLLISION = 1
+FLAG_VISUALIZATION = 2
+
+
+def compiled_path(bundle_dir: str | Path, *, env_filename: str = "env.json") -> Path:
+    """Path of the compiled sidecar for `env_filename` (e.g. `env.json` -> `env.kbundle`)."""
+    return Path(bundle_dir) / Path(env_filename).with_suffix(COMPILED_SUFFIX).name
+
+
+def _fingerprint(path: Path) -> dict[str, Any]:
+    st = path.stat()
+    return {"size": int(st.st_size), "mtime_ns": int(st.st_mtime_ns), "sha256": _sha256(path)}
+
+
+def _sha256(path: Path) -> str:
+    h = hashlib.sha256()
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(1 << 20), b""):
+            h.update(chunk)
+    return h.hexdigest()
+
+
+def _columns(primitives: Sequence[PrimitiveSpec]) -> dict[str, np.ndarray]:
+    """Pack primitives into columns (NaN marks absent optional floats)."""
+    n = len(primitives)
+    nan = np.nan
+    cols: dict[str, np.ndarray] = {
+        "shape": np.zeros(n, dtype=np.uint8),
+        "pos": np.zeros((n, 3), dtype=np.float64),
+        "quat": np.zeros((n, 4), dtype=np.float64),
+        "fixed": np.zeros(n, dtype=np.uint8),
+        "mass": np.full(n, nan, dtype=np.float64),
+        "flags": np.zeros(n, dtype=np.uint8),
+        "color": np.full((n, 4), nan, dtype=np.float64),
+        "color_len": np.zeros(n, dtype=np.uint8),
+        "size": np.full((n, 3), nan, dtype=np.float64),
+        "radius": np.full(n, nan, dtype=np.float64),
+        "height": np.full(n, nan, dtype=np.float64),
+        "normal": np.full((n, 3), nan, dtype=np.float64),
+    }
+    ids = [p.id.encode("utf-8") for p in primitives]
+    offsets = np.zeros(n + 1, dtype=np.int64)
+    np.cumsum([len(b) for b in ids], out=offsets[1:])
+    cols["id_offsets"] = offsets
+    cols["id_bytes"] = np.frombuffer(b"".join(ids), dtype=np.uint8).copy()
+
+    for i, p in enumerate(primitives):
+        cols["shape"][i] = _SHAPE_CODES[p.shape]
+        cols["pos"][i] = p.pose.pos
+        cols["quat"][i] = p.pose.quat
+        # Loaders resolve `fixed` defaults, so it is always a bool here.
+        cols["fixed"][i] = bool(p.fixed)
+        if p.mass is not None:
+            cols["mass"][i] = p.mass
+        cols["flags"][i] = (FLAG_COLLISION if p.collision else 0) | (FLAG_VISUALIZATION if p.visualization else 0)
+        if p.color is not None:
+            cols["color"][i, : len(p.color)] = p.color
+            cols["color_len"][i] = len(p.color)
+        # Only the validated shape parameters are stored (see `PrimitiveSpec.from_json`).
+        if p.shape == "box" and p.size is not None:
+            cols["size"][i] = p.size
+        if p.shape in ("sphere", "cylinder") and p.radius is not None:
+            cols["radius"][i] = p.radius
+        if p.shape == "cylinder" and p.height is not None:
+            cols["height"][i] = p.height
+        if p.shape == "plane" and p.normal is not None:
+            cols["normal"][i] = p.normal
+    return cols
+
+
+def save_compiled_bundle(path: str | Path, bundle: EnvBundleV1, *, source: Path | None = None) -> Path:
+    """Write `bundle` in the compiled format (atomically; `source` is fingerprinted for staleness checks)."""
+    path = Path(path)
+    cols = _columns(bundle.primitives)
+
+    table: dict[str, Any] = {}
+    offset = 0
+    for name, arr in cols.items():
+        table[name] = {"dtype": arr.dtype.str, "shape": list(arr.shape), "offset": offset}
+        offset = -(-(offset + arr.nbytes) // _ALIGN) * _ALIGN
+    header = {
+        "format_version": FORMAT_VERSION,
+        "schema_version": int(bundle.schema_version),
+        "scene_file": bundle.scene_file,
+        "world": bundle.world.to_json(),
+        "spawn_points": {k: v.to_json() for k, v in bundle.spawn_points.items()},
+        "task": bundle.task.to_json() if bundle.task is not None else None,
+        "n_primitives": len(bundle.primitives),
+        "source": _fingerprint(source) if source is not None and source.exists() else None,
+        "columns": table,
+    }
+    head = json.dumps(header, sort_keys=True).encode("utf-8")
+    data_start = -(-(len(MAGIC) + 8 + len(head)) // _ALIGN) * _ALIGN
+
+    tmp = path.with_name(f".{path.name}.{os.getpid()}.tmp")
+    with open(tmp, "wb") as f:
+        f.write(MAGIC)
+        f.write(len(head).to_bytes(8, "little"))
+        f.write(head)
+        for name, arr in cols.items():
+            f.seek(data_start + table[name]["offset"])
+            f.write(np.ascontiguousarray(arr).tobytes())
+        f.truncate(data_start + offset)
+    os.replace(tmp, path)
+    return path
+
+
+def _read_header(path: Path) -> tuple[dict[str, Any], int]:
+    with open(path, "rb") as f:
+        magic = f.read(len(MAGIC))
+        if magic != MAGIC:
+            raise EnvBundleError(f"Not a compiled env bundle: {path}")
+        n = int.from_bytes(f.read(8), "little")
+        try:
+            header = json.loads(f.read(n).decode("utf-8"))
+        except Exception as e:
+            raise EnvBundleError(f"Corrupt compiled env bundle header: {path}: {e}") from e
+    if int(header.get("format_version", 0)) != FORMAT_VERSION:
+        raise EnvBundleError(f"Unsupported compiled bundle format_version in {path}")
+    data_start = -(-(len(MAGIC) + 8 + n) // _ALIGN) * _ALIGN
+    return header, data_start
+
+
+def is_fresh(path: str | Path, source: str | Path) -> bool:
+    """True if the compiled file at `path` was built from the current contents of `source`."""
+    path, source = Path(path), Path(source)
+    if not path.exists():
+        return False
+    if not source.exists():
+        return True
+    try:
+        rec = _read_header(path)[0].get("source")
+    except EnvBundleError:
+        return False
+    if not rec:
+        return False
+    st = source.stat()
+    if int(rec["size"]) != int(st.st_size):
+        return False
+    # Same size and mtime: trust it. Otherwise (e.g. a copied bundle) compare contents.
+    return int(rec["mtime_ns"]) == int(st.st_mtime_ns) or rec["sha256"] == _sha256(source)
+
+
+class PrimitiveColumns(Sequence):  # type: ignore[type-arg]
+    """
+    Read-only sequence of `PrimitiveSpec` backed by memory-mapped columns.
+
+    Items are built on access; vectorized consumers can read `columns` directly (arrays named
+    like the `PrimitiveSpec` fields, `shape` as codes into `SHAPES`, NaN for absent floats).
+    """
+
+    def __init__(self, columns: dict[str, np.ndarray]) -> None:
+        self.columns = columns
+        self._n = int(columns["shape"].shape[0])
+
+    def __len__(self) -> int:
+        return self._n
+
+    def id(self, i: int) -> str:
+        off = self.columns["id_offsets"]
+        return bytes(self.columns["id_bytes"][int(off[i]) : int(off[i + 1])]).decode("utf-8")
+
+    def ids(self) -> list[str]:
+        """All primitive ids (one decode of the string table)."""
+        blob = bytes(self.columns["id_bytes"])
+        off = self.columns["id_offsets"].tolist()
+        return [blob[off[i] : off[i + 1]].decode("utf-8") for i in range(self._n)]
+
+    def _spec(self, i: int) -> PrimitiveSpec:
+        c = self.columns
+        shape = SHAPES[int(c["shape"][i])]
+        mass = float(c["mass"][i])
+        k = int(c["color_len"][i])
+        flags = int(c["flags"][i])
+
+        def vec3(name: str) -> tuple[float, float, float] | None:
+            v = c[name][i]
+            if np.isnan(v[0]):
+                return None
+            return (float(v[0]), float(v[1]), float(v[2]))
+
+        def scalar(name: str) -> float | None:
+            v = float(c[name][i])
+            return None if v != v else v
+
+        px, py, pz = c["pos"][i].tolist()
+        qw, qx, qy, qz = c["quat"][i].tolist()
+        return PrimitiveSpec(
+            id=self.id(i),
+            shape=shape,  # type: ignore[arg-type]
+            pose=Pose(pos=(px, py, pz), quat=(qw, qx, qy, qz)),
+            fixed=bool(c["fixed"][i]),
+            mass=None if mass != mass else mass,
+            collision=bool(flags & FLAG_COLLISION),
+            visualization=bool(flags & FLAG_VISUALIZATION),
+            color=tuple(float(v) for v in c["color"][i, :k]) if k else None,  # type: ignore[arg-type]
+            size=vec3("size") if shape == "box" else None,
+            radius=scalar("radius"),
+            height=scalar("height"),
+            normal=vec3("normal") if shape == "plane" else None,
+        )
+
+    @overload
+    def __getitem__(self, i: int) -> PrimitiveSpec: ...
+
+    @overload
+    def __getitem__(self, i: slice) -> tuple[PrimitiveSpec, ...]: ...
+
+    def __getitem__(self, i: int | slice) -> PrimitiveSpec | tuple[PrimitiveSpec, ...]:
+        if isinstance(i, slice):
+            return tuple(self._spec(j) for j in range(*i.indices(self._n)))
+        j = int(i)
+        if j < 0:
+            j += self._n
+        if not 0 <= j < self._n:
+            raise IndexError(i)
+        return self._spec(j)
+
+    def __iter__(self) -> Iterator[PrimitiveSpec]:
+        for i in range(self._n):
+            yield self._spec(i)
+
+    def __eq__(self, other: object) -> bool:
+        if isinstance(other, Sequence):
+            return len(other) == self._n and all(a == b for a, b in zip(self, other))
+        return NotImplemented
+
+    __hash__ = None  # type: ignore[assignment]
+
+
+def load_compiled_bundle(path: str | Path) -> EnvBundleV1:
+    """Map a compiled bundle read-only and return it as an `EnvBundleV1` (primitives are lazy)."""
+    path = Path(path)
+    header, data_start = _read_header(path)
+    n = int(header["n_primitives"])
+    mm = np.memmap(path, dtype=np.uint8, mode="r")
+    columns: dict[str, np.ndarray] = {}
+    for name, meta in header["columns"].items():
+        dt = np.dtype(meta["dtype"])
+        shape = tuple(int(v) for v in meta["shape"])
+        start = data_start + int(meta["offset"])
+        count = int(np.prod(shape, dtype=np.int64))
+        if start + count * dt.itemsize > mm.shape[0]:
+            raise EnvBundleError(f"Truncated compiled env bundle: {path}")
+        columns[name] = mm[start : start + count * dt.itemsize].view(dt).reshape(shape)
+    if columns["shape"].shape[0] != n:
+        raise EnvBundleError(f"Corrupt compiled env bundle (primitive count mismatch): {path}")
+
+    spawn_points = {k: Pose.from_json(v, ctx=f"spawn_points[{k!r}]") for k, v in header["spawn_points"].items()}
+    return EnvBundleV1(
+        schema_version=int(header["schema_version"]),
+        scene_file=str(header["scene_file"]),
+        world=WorldSpec.from_json(header["world"], ctx="world"),
+        primitives=PrimitiveColumns(columns),  # type: ignore[arg-type]
+        spawn_points=spawn_points,
+        task=TaskSpec.from_json(header.get("task"), ctx="task"),
+    )
+
+
+def compile_env_bundle(bundle_dir: str | Path, *, env_filename: str = "env.json") -> Path:
+    """Validate `env_filename` in `bundle_dir` and write its compiled sidecar; returns its path."""
+    from .bundle import load_env_bundle
+
+    bundle_path = Path(bundle_dir)
+    bundle = load_env_bundle(bundle_path, env_filename=env_filename, compiled=False)
+    return save_compiled_bundle(
+        compiled_path(bundle_path, env_filename=env_filename), bundle, source=bundle_path / env_filename
+    )
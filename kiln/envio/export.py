@@ -10,13 +10,22 @@ Exports a Kiln :class:`~kiln.scene.Scene` to a directory containing:
 The XML follows the Kiln MJCF schema with the ``kiln:`` namespace so that
 downstream tooling (Gymnasium envs, simulation loaders) can reconstruct
 the full scene.
+
+By default the XML is streamed: only the fixed header is built as an element
+tree, and each object's ``<body>`` / ``<kiln:object>`` is built, written and
+dropped in turn, one complete element per object (so ``iterparse`` readers can
+consume bodies one by one).  The USD copy runs on a worker thread meanwhile,
+and files whose content is unchanged are not rewritten.
 """
 
-import shutil
 import math
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
-from typing import TYPE_CHECKING
+from typing import TYPE_CHECKING, Callable, Iterable, Iterator
 from xml.etree.ElementTree import Element, SubElement, ElementTree, indent
+from xml.sax.saxutils import escape
+
+from kiln.envio.files import HashingWriter, copy_if_changed, replace_if_changed, temp_path
 
 if TYPE_CHECKING:
     from kiln.scene import Scene
@@ -81,6 +90,8 @@ def export_scene_mjcf(
     *,
     model_name: str = "kiln_scene",
     overwrite: bool = False,
+    streaming: bool = True,
+    concurrent: bool = True,
 ) -> Path:
     """Export a loaded scene to a Kiln MJCF bundle.
 
@@ -93,6 +104,12 @@ def export_scene_mjcf(
         output_dir: Target directory to create.
         model_name: Value for ``<mujoco model="...">``.
         overwrite: If True and *output_dir* exists, clear it first.
+        streaming: Write bodies incrementally (see module docstring) instead
+            of building and indenting the whole tree in memory.
+        concurrent: Copy the USD file on a worker thread while the XML is
+            generated.
+
+    Files whose content is unchanged (same sha256) are left untouched.
 
     Returns:
         The path to the created XML file.
@@ -117,21 +134,105 @@ def export_scene_mjcf(
 
     out.mkdir(parents=True, exist_ok=True)
 
-    # ---- 1. Copy USD file ----
+    # ---- 1. Copy USD file (concurrently with the XML by default) ----
     scene_filename = f"scene{src_usd.suffix.lower()}"
     dst_usd = out / scene_filename
-    shutil.copy2(src_usd, dst_usd)
+    pool = ThreadPoolExecutor(max_workers=1, thread_name_prefix="kiln-export") if concurrent else None
+    try:
+        copy = pool.submit(copy_if_changed, src_usd, dst_usd) if pool else None
+        if copy is None:
+            copy_if_changed(src_usd, dst_usd)
+
+        # ---- 2. Write XML ----
+        xml_path = out / "scene.xml"
+        tmp = temp_path(xml_path)
+        try:
+            if streaming:
+                with open(tmp, "wb") as f:
+                    writer = HashingWriter(f)
+                    write_mjcf_stream(writer.write, scene, scene_filename, model_name)
+                digest = writer.hexdigest()
+            else:
+                root = _build_mjcf(scene, scene_filename, model_name)
+                tree = ElementTree(root)
+                indent(tree, space="  ")
+                tree.write(str(tmp), encoding="utf-8", xml_declaration=True)
+                digest = None
+            replace_if_changed(tmp, xml_path, digest)
+        finally:
+            tmp.unlink(missing_ok=True)
+
+        if copy is not None:
+            copy.result()
+    finally:
+        if pool is not None:
+            pool.shutdown(wait=True)
 
-    # ---- 2. Build XML tree ----
-    root = _build_mjcf(scene, scene_filename, model_name)
+    return xml_path
 
-    tree = ElementTree(root)
-    indent(tree, space="  ")
 
-    xml_path = out / "scene.xml"
-    tree.write(str(xml_path), encoding="unicode", xml_declaration=True)
+def write_mjcf_stream(
+    write: Callable[[str], object],
+    scene: "Scene",
+    scene_filename: str,
+    model_name: str = "kiln_scene",
+) -> None:
+    """Write the MJCF document for *scene* through *write*, one object at a time.
 
-    return xml_path
+    Produces byte for byte what ``ElementTree.write`` gives for the indented
+    :func:`_build_mjcf` tree, without holding the per-object elements in memory.
+    """
+    root, worldbody, ui_el = _mjcf_skeleton(scene_filename, model_name)
+    write("<?xml version='1.0' encoding='utf-8'?>\n")
+    write(f"<mujoco xmlns:kiln={_quote(KILN_NS)}{_attrs(root)}>\n")
+    for child in root:
+        if child is worldbody:
+            extra: Iterable[Element] = _object_bodies(scene.objects)
+        elif child is ui_el:
+            extra = (_ui_object_element(obj) for obj in scene.objects)
+        else:
+            extra = ()
+        _write_element(write, child, 1, extra)
+    write("</mujoco>")
+
+
+def _qname(name: str) -> str:
+    if name.startswith(f"{{{KILN_NS}}}"):
+        return "kiln:" + name[len(KILN_NS) + 2:]
+    return name
+
+
+def _quote(value: str) -> str:
+    return '"' + escape(value, {'"': "&quot;", "\n": "&#10;", "\r": "&#13;", "\t": "&#09;"}) + '"'
+
+
+def _attrs(elem: Element) -> str:
+    return "".join(f" {_qname(k)}={_quote(v)}" for k, v in elem.attrib.items())
+
+
+def _write_element(write: Callable[[str], object], elem: Element, level: int, extra: Iterable[Element] = ()) -> None:
+    pad = "  " * level
+    tag = _qname(elem.tag)
+    head = f"{pad}<{tag}{_attrs(elem)}"
+    children = iter(list(elem))
+    extra = iter(extra)
+    first = next(children, None)
+    if first is None:
+        first = next(extra, None)
+    if first is None and not elem.text:
+        write(head + " />\n")
+        return
+    write(head + ">")
+    if elem.text:
+        write(escape(elem.text))
+    write("\n")
+    if first is not None:
+        _write_element(write, first, level + 1)
+    for child in children:
+        _write_element(write, child, level + 1)
+    for child in extra:
+        _write_element(write, child, level + 1)
+    write(f"{pad}</{tag}>\n")
 
 
 # ------------------------------------------------------------------
@@ -140,6 +241,20 @@ def export_scene_mjcf(
 
 def _build_mjcf(scene: "Scene", scene_filename: str, model_name: str) -> Element:
     """Construct the full ``<mujoco>`` element tree from a Scene."""
+    root, worldbody, _ = _mjcf_skeleton(scene_filename, model_name)
+
+    # -- Scene objects as bodies --
+    for obj in scene.objects:
+        _add_object_body(worldbody, obj)
+
+    # <kiln:ui_objects> — preserves the full editor state
+    _add_ui_objects(root, scene)
+
+    return root
+
+
+def _mjcf_skeleton(scene_filename: str, model_name: str) -> tuple[Element, Element, Element]:
+    """The ``<mujoco>`` tree without per-object elements: (root, worldbody, ui_objects)."""
 
     root = Element("mujoco")
     root.set("model", model_name)
@@ -184,10 +299,6 @@ def _build_mjcf(scene: "Scene", scene_filename: str, model_name: str) -> Element
     kiln_world.set("visualization", "true")
     kiln_world.set("scale", "1.0")
 
-    # -- Scene objects as bodies --
-    for obj in scene.objects:
-        _add_object_body(worldbody, obj)
-
     # <kiln:spawn_points>
     spawn_el = SubElement(root, f"{{{KILN_NS}}}spawn_points")
     default_spawn = SubElement(spawn_el, f"{{{KILN_NS}}}spawn")
@@ -195,10 +306,21 @@ def _build_mjcf(scene: "Scene", scene_filename: str, model_name: str) -> Element
     default_spawn.set("pos", "0 0 1.2")
     default_spawn.set("quat", "1 0 0 0")
 
-    # <kiln:ui_objects> — preserves the full editor state
-    _add_ui_objects(root, scene)
+    # <kiln:ui_objects> — preserves the full editor state (filled by the caller)
+    ui_el = SubElement(root, f"{{{KILN_NS}}}ui_objects")
+    ui_el.set(f"{{{KILN_NS}}}up_axis", "y")
+
+    return root, worldbody, ui_el
 
-    return root
+
+def _object_bodies(objects: Iterable["BaseObject"]) -> Iterator[Element]:
+    """Yield one detached ``<body>`` element per object."""
+    holder = Element("worldbody")
+    for obj in objects:
+        _add_object_body(holder, obj)
+        body = holder[0]
+        holder.remove(body)
+        yield body
 
 
 def _add_object_body(worldbody: Element, obj: "BaseObject") -> None:
@@ -314,26 +436,34 @@ def _add_ui_objects(root: Element, scene: "Scene") -> None:
     This allows round-tripping: opening an exported XML in Kiln can
     reconstruct all objects with their original transforms.
     """
+    ui_el = root.find(f"{{{KILN_NS}}}ui_objects")
+    if ui_el is None:
+        ui_el = SubElement(root, f"{{{KILN_NS}}}ui_objects")
+        ui_el.set(f"{{{KILN_NS}}}up_axis", "y")
+
+    for obj in scene.objects:
+        ui_el.append(_ui_object_element(obj))
+
+
+def _ui_object_element(obj: "BaseObject") -> Element:
+    """A detached ``<kiln:object>`` element recording *obj*'s editor state."""
     from kiln.objects import Plane, Box
 
-    ui_el = SubElement(root, f"{{{KILN_NS}}}ui_objects")
-    ui_el.set(f"{{{KILN_NS}}}up_axis", "y")
+    o = Element(f"{{{KILN_NS}}}object")
+    o.set("id", _safe_id(obj.name))
 
-    for obj in scene.objects:
-        o = SubElement(ui_el, f"{{{KILN_NS}}}object")
-        o.set("id", _safe_id(obj.name))
-
-        if isinstance(obj, Plane):
-            o.set("type", "Plane")
-            o.set("width", _fmt(obj.width))
-            o.set("depth", _fmt(obj.depth))
-        elif isinstance(obj, Box):
-            o.set("type", "Box")
-            o.set("size", _fmt(obj.size))
-        else:
-            o.set("type", "Unknown")
+    if isinstance(obj, Plane):
+        o.set("type", "Plane")
+        o.set("width", _fmt(obj.width))
+        o.set("depth", _fmt(obj.depth))
+    elif isinstance(obj, Box):
+        o.set("type", "Box")
+        o.set("size", _fmt(obj.size))
+    else:
+        o.set("type", "Unknown")
 
-        o.set("pos_ui", _vec3_str(obj.position.x(), obj.position.y(), obj.position.z()))
-        o.set("rot_xyz_deg", _vec3_str(obj.rotation.x(), obj.rotation.y(), obj.rotation.z()))
-        o.set("scale", _vec3_str(obj.scale.x(), obj.scale.y(), obj.scale.z()))
-        o.set("color", f"{obj.color.redF():.3f} {obj.color.greenF():.3f} {obj.color.blueF():.3f}")
+    o.set("pos_ui", _vec3_str(obj.position.x(), obj.position.y(), obj.position.z()))
+    o.set("rot_xyz_deg", _vec3_str(obj.rotation.x(), obj.rotation.y(), obj.rotation.z()))
+    o.set("scale", _vec3_str(obj.scale.x(), obj.scale.y(), obj.scale.z()))
+    o.set("color", f"{obj.color.redF():.3f} {obj.color.greenF():.3f} {obj.color.blueF():.3f}")
+    return o
@@ -0,0 +1,85 @@
+from __future__ import annotations
+
+"""
+Content-hash aware file writes for bundle exporters.
+
+Re-exporting a large scene usually changes few (often none) of the bundle files. Writing
+them anyway costs I/O and bumps mtimes, which invalidates downstream caches keyed on the
+file fingerprint (e.g. the compiled `env.kbundle`). These helpers stage output in a
+temporary file next to the target and only replace the target if the content differs.
+"""
+
+import hashlib
+import os
+import shutil
+from pathlib import Path
+from typing import IO, Any
+
+_CHUNK = 1 << 20
+
+
+def sha256_file(path: str | Path) -> str:
+    h = hashlib.sha256()
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(_CHUNK), b""):
+            h.update(chunk)
+    return h.hexdigest()
+
+
+def temp_path(path: Path) -> Path:
+    """Hidden per-process staging path next to *path* (same filesystem, so `os.replace` is atomic)."""
+    return path.with_name(f".{path.name}.{os.getpid()}.tmp")
+
+
+def replace_if_changed(tmp: Path, path: Path, digest: str | None = None) -> bool:
+    """
+    Move *tmp* over *path* unless *path* already has the same content.
+
+    *digest* is the sha256 of *tmp* if the caller hashed it while writing. Returns True if
+    *path* was (re)written; *tmp* is removed either way.
+    """
+    if path.exists() and path.stat().st_size == tmp.stat().st_size:
+        if (digest or sha256_file(tmp)) == sha256_file(path):
+            tmp.unlink()
+            return False
+    os.replace(tmp, path)
+    return True
+
+
+def write_bytes_if_changed(path: str | Path, data: bytes) -> bool:
+    """Write *data* to *path* unless it already holds exactly that; returns True if written."""
+    path = Path(path)
+    if path.exists() and path.stat().st_size == len(data):
+        if hashlib.sha256(data).hexdigest() == sha256_file(path):
+            return False
+    tmp = temp_path(path)
+    tmp.write_bytes(data)
+    os.replace(tmp, path)
+    return True
+
+
+def copy_if_changed(src: str | Path, dst: str | Path) -> bool:
+    """`shutil.copy2` *src* to *dst* unless *dst* already has the same content; returns True if copied."""
+    src, dst = Path(src), Path(dst)
+    if dst.exists() and dst.stat().st_size == src.stat().st_size and sha256_file(src) == sha256_file(dst):
+        return False
+    tmp = temp_path(dst)
+    shutil.copy2(src, tmp)
+    os.replace(tmp, dst)
+    return True
+
+
+class HashingWriter:
+    """Text writer that UTF-8 encodes into a binary file while hashing the bytes written."""
+
+    def __init__(self, f: IO[bytes]) -> None:
+        self._f = f
+        self._h = hashlib.sha256()
+
+    def write(self, text: str) -> Any:
+        data = text.encode("utf-8")
+        self._h.update(data)
+        return self._f.write(data)
+
+    def hexdigest(self) -> str:
+        return self._h.hexdigest()
@@ -11,12 +11,26 @@ from .bundle import EnvBundleV1, Pose
 Entity: TypeAlias = Any
 
 
+@dataclass(frozen=True)
+class MergedPrimitives:
+    """One static compound entity and the ids of the fixed primitives merged into it (geom order)."""
+
+    entity: Entity
+    ids: tuple[str, ...]
+
+
 @dataclass(frozen=True)
 class LoadedEnvBundle:
-    """Runtime representation of a loaded env bundle."""
+    """
+    Runtime representation of a loaded env bundle.
+
+    With `merge_static=True`, merged primitive ids map to their compound entity in
+    `entities_by_id` (several ids share one entity) and `merged` lists the compounds.
+    """
 
     bundle_dir: Path
     bundle: EnvBundleV1
     entities_by_id: dict[str, Entity]
     world_entity: Entity | None
     spawn_points: dict[str, Pose]
+    merged: tuple[MergedPrimitives, ...] = ()
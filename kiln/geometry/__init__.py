@@ -0,0 +1,5 @@
+"""
+Backend-neutral geometry helpers (numpy only).
+"""
+
+from .bvh import BVH  # noqa: F401
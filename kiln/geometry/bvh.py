@@ -0,0 +1,168 @@
+from __future__ import annotations
+
+"""
+Backend-neutral bounding-volume hierarchy over axis-aligned boxes.
+
+`BVH` is shared by the sim's batched raycasts (`kiln.sim.genesis.raycast`) and the editor's
+viewport picking (`kiln.ui.picking`); it only depends on numpy.
+"""
+
+from typing import Callable
+
+import numpy as np
+
+# Stand-in for zero direction components, so slab tests never compute 0 * inf.
+TINY = 1e-30
+
+
+def slab(bmin: np.ndarray, bmax: np.ndarray, o: np.ndarray, inv: np.ndarray) -> tuple[np.ndarray, np.ndarray]:
+    """Entry/exit distances of rays against axis-aligned boxes (row-wise)."""
+    t1 = (bmin - o) * inv
+    t2 = (bmax - o) * inv
+    return np.minimum(t1, t2).max(axis=1), np.maximum(t1, t2).min(axis=1)
+
+
+def safe_inv(d: np.ndarray) -> np.ndarray:
+    """`1 / d` with zero components replaced by `TINY`."""
+    return 1.0 / np.where(d == 0.0, TINY, d)
+
+
+class BVH:
+    """
+    Binary AABB tree over `n` items (median split on the widest centroid axis).
+
+    Nodes are stored as flat arrays; leaves reference a contiguous range of `order`.
+    """
+
+    def __init__(self, bmin: np.ndarray, bmax: np.ndarray, *, leaf_size: int = 4) -> None:
+        n = int(bmin.shape[0])
+        cent = 0.5 * (bmin + bmax)
+        order = np.arange(n, dtype=np.intp)
+        nmin: list[np.ndarray] = []
+        nmax: list[np.ndarray] = []
+        left: list[int] = []
+        right: list[int] = []
+        start: list[int] = []
+        count: list[int] = []
+        depth: list[int] = []
+
+        stack: list[tuple[int, int, int, int]] = [(0, n, -1, 0)] if n else []
+        while stack:
+            lo, hi, parent, side = stack.pop()
+            node = len(start)
+            if parent >= 0:
+                (left if side == 0 else right)[parent] = node
+            depth.append(depth[parent] + 1 if parent >= 0 else 0)
+            idx = order[lo:hi]
+            nmin.append(bmin[idx].min(axis=0))
+            nmax.append(bmax[idx].max(axis=0))
+            left.append(-1)
+            right.append(-1)
+            if hi - lo <= leaf_size:
+                start.append(lo)
+                count.append(hi - lo)
+                continue
+            start.append(0)
+            count.append(0)
+            c = cent[idx]
+            axis = int(np.argmax(c.max(axis=0) - c.min(axis=0)))
+            mid = (lo + hi) // 2
+            order[lo:hi] = idx[np.argpartition(c[:, axis], mid - lo)]
+            stack.append((mid, hi, node, 1))
+            stack.append((lo, mid, node, 0))
+
+        self.order = order
+        self.node_min = np.asarray(nmin, dtype=np.float64).reshape(-1, 3)
+        self.node_max = np.asarray(nmax, dtype=np.float64).reshape(-1, 3)
+        self.left = np.asarray(left, dtype=np.intp)
+        self.right = np.asarray(right, dtype=np.intp)
+        self.start = np.asarray(start, dtype=np.intp)
+        self.count = np.asarray(count, dtype=np.intp)
+        self._depth = np.asarray(depth, dtype=np.intp)
+
+    def refit(self, bmin: np.ndarray, bmax: np.ndarray) -> None:
+        """Recompute node bounds for moved items, keeping the tree topology."""
+        if len(self) == 0:
+            return
+        leaves = np.flatnonzero(self.count > 0)
+        leaves = leaves[np.argsort(self.start[leaves])]
+        self.node_min[leaves] = np.minimum.reduceat(bmin[self.order], self.start[leaves], axis=0)
+        self.node_max[leaves] = np.maximum.reduceat(bmax[self.order], self.start[leaves], axis=0)
+        inner = np.flatnonzero(self.count == 0)
+        for level in range(int(self._depth.max()) - 1, -1, -1):
+            k = inner[self._depth[inner] == level]
+            if k.size:
+                self.node_min[k] = np.minimum(self.node_min[self.left[k]], self.node_min[self.right[k]])
+                self.node_max[k] = np.maximum(self.node_max[self.left[k]], self.node_max[self.right[k]])
+
+    def __len__(self) -> int:
+        return int(self.order.shape[0])
+
+    def query(self, accept: Callable[[np.ndarray, np.ndarray], np.ndarray]) -> np.ndarray:
+        """
+        Sorted items under leaves reached through nodes passing `accept(node_min, node_max)`.
+
+        `accept` returns a row-wise bool mask (e.g. an AABB overlap or frustum test). The result
+        is conservative: items are not tested individually.
+        """
+        if len(self) == 0:
+            return np.zeros((0,), dtype=np.intp)
+        out: list[np.ndarray] = []
+        node = np.zeros(1, dtype=np.intp)
+        while node.size:
+            node = node[accept(self.node_min[node], self.node_max[node])]
+            cnt = self.count[node]
+            leaf = cnt > 0
+            if leaf.any():
+                lc = cnt[leaf]
+                first = np.repeat(np.cumsum(lc) - lc, lc)
+                out.append(self.order[np.repeat(self.start[node[leaf]], lc) + (np.arange(int(lc.sum())) - first)])
+            inner = node[~leaf]
+            node = np.concatenate([self.left[inner], self.right[inner]])
+        return np.sort(np.concatenate(out)) if out else np.zeros((0,), dtype=np.intp)
+
+    def closest(
+        self,
+        o: np.ndarray,
+        d: np.ndarray,
+        t_best: np.ndarray,
+        narrow: Callable[[np.ndarray, np.ndarray], np.ndarray],
+    ) -> np.ndarray:
+        """
+        Closest-hit traversal for all rays at once.
+
+        `narrow(rays, items)` returns entry distances (inf on miss) for explicit ray/item pairs.
+        `t_best` (`[n_rays]`, initially the max distance) is lowered in place; returns the
+        winning item per ray, or -1 where nothing closer than the incoming `t_best` was hit.
+        """
+        best = np.full(o.shape[0], -1, dtype=np.intp)
+        if len(self) == 0:
+            return best
+        inv = safe_inv(d)
+        ray = np.flatnonzero(t_best > 0.0)
+        node = np.zeros(ray.shape[0], dtype=np.intp)
+        while ray.size:
+            tn, tf = slab(self.node_min[node], self.node_max[node], o[ray], inv[ray])
+            keep = (tf >= np.maximum(tn, 0.0)) & (tn <= t_best[ray])
+            ray, node = ray[keep], node[keep]
+            cnt = self.count[node]
+            leaf = cnt > 0
+            if leaf.any():
+                lr, lc = ray[leaf], cnt[leaf]
+                rr = np.repeat(lr, lc)
+                first = np.repeat(np.cumsum(lc) - lc, lc)
+                items = self.order[np.repeat(self.start[node[leaf]], lc) + (np.arange(rr.shape[0]) - first)]
+                t = narrow(rr, items)
+                better = t < t_best[rr]
+                if better.any():
+                    rr, items, t = rr[better], items[better], t[better]
+                    # Nearest per ray; equal distances go to the lower item index.
+                    srt = np.lexsort((items, t, rr))
+                    rs = rr[srt]
+                    win = srt[np.flatnonzero(np.r_[True, rs[1:] != rs[:-1]])]
+                    t_best[rr[win]] = t[win]
+                    best[rr[win]] = items[win]
+            inner = ~leaf
+            ray = np.concatenate([ray[inner], ray[inner]])
+            node = np.concatenate([self.left[node[inner]], self.right[node[inner]]])
+        return best
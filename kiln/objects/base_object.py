@@ -20,6 +20,9 @@ class BaseObject:
     # By default, objects support no special roles.
     SUPPORTED_ROLES: list[str | None] = [None]
 
+    # Value of the ``kiln:object_type`` attribute used to recreate the object on reload.
+    USD_OBJECT_TYPE: str | None = None
+
     def __init__(self, name: str, position: QVector3D | None = None, 
                  rotation: QVector3D | None = None, 
                  scale: QVector3D | None = None):
@@ -57,12 +60,25 @@ class BaseObject:
         self.nav_inflate: float = 0.55
         self.waypoint_tolerance: float = 0.6
         self.max_goal_samples: int = 50
+        # Values last written to / read from USD (see `prepare_usd`); cleared by `mark_dirty`.
+        self._usd_written: dict[str, object] = {}
+        self._usd_key: tuple[int, str] | None = None
 
     def get_transform_matrix(self) -> QMatrix4x4:
         """
         Calculates the transformation matrix for rendering.
         Uses numpy to ensure correct TRS construction.
         """
+        # Convert to QMatrix4x4 (expects column-major list)
+        return QMatrix4x4(self.transform_array().T.flatten().tolist())
+
+    def instance_shape(self) -> tuple[str, tuple[float, float, float]] | None:
+        """Shared unit mesh (``"box"`` / ``"plane"``) and its local scale for
+        instanced drawing, or ``None`` to draw this object with `render`."""
+        return None
+
+    def transform_array(self) -> np.ndarray:
+        """Row-major 4x4 TRS matrix (float32) of this object."""
         # Translation matrix (Row-major)
         T = np.eye(4, dtype=np.float32)
         T[0, 3] = self.position.x()
@@ -102,85 +118,247 @@ class BaseObject:
         S[2, 2] = self.scale.z()
         
         # Standard TRS: T * Rz * Ry * Rx * S
-        M = T @ Rz @ Ry @ Rx @ S
-        
-        # Convert to QMatrix4x4 (expects column-major list)
-        return QMatrix4x4(M.T.flatten().tolist())
+        return T @ Rz @ Ry @ Rx @ S
 
     def render(self, program: QOpenGLShaderProgram):
         if not self.visible:
             return
         pass
 
-    def sync_usd(self, stage, parent_path: str = "/World") -> bool:
+    # ------------------------------------------------------------------
+    # USD sync
+    # ------------------------------------------------------------------
+
+    def usd_values(self) -> dict[str, tuple[str, object]]:
+        """Desired USD state: key -> (value type, plain Python value).
+
+        Keys are ``xform:<op>`` for the transform ops and the attribute name
+        otherwise.  Float values are rounded to float32 so they compare equal
+        to what USD stores (and reads back).
+        """
+        out: dict[str, tuple[str, object]] = {
+            "xform:translate": ("Double3", _vec3(self.position)),
+            "xform:rotateXYZ": ("Double3", _vec3(self.rotation)),
+            "xform:scale": ("Double3", _vec3(self.scale)),
+            "kiln:role": ("String", self.role if self.role else ""),
+            "kiln:color": ("Float3", _f32((self.color.redF(), self.color.greenF(), self.color.blueF()))),
+        }
+        if self.USD_OBJECT_TYPE is not None:
+            out["kiln:object_type"] = ("String", self.USD_OBJECT_TYPE)
+        # Actor metadata is persisted on the USD prim so UI settings survive reload.
+        attrs = ACTOR_ATTRS if self.role == "car" else (ACTOR_ATTRS + NPC_ATTRS if self.role == "npc" else ())
+        for usd_name, obj_attr, type_name in attrs:
+            out[usd_name] = (type_name, _typed(type_name, getattr(self, obj_attr)))
+        return out
+
+    def mark_dirty(self) -> None:
+        """Forget what was last written so the next sync rewrites every attribute."""
+        self._usd_written = {}
+
+    def prepare_usd(self, stage, parent_path: str = "/World") -> list | None:
+        """Define the prim (if needed) and return ``(attribute, value)`` writes
+        for the attributes that changed since the last sync or read.
+
+        Prims, references and missing attributes are created here; the value
+        writes themselves are applied by :func:`apply_usd_writes`, which can
+        batch many objects into one ``Sdf.ChangeBlock``.  Returns ``None`` if
+        USD is unavailable.
+        """
         if Usd is None or stage is None:
-            return False
+            return None
 
         safe_name = "".join(c for c in self.name if c.isalnum() or c == "_")
         if not safe_name:
             safe_name = f"Object_{id(self)}"
-            
+
         path = f"{parent_path}/{safe_name}"
+        if getattr(self, "_usd_key", None) != (id(stage), path):
+            # New stage or renamed object: nothing on this prim is known yet.
+            self._usd_written = {}
+            self._usd_key = (id(stage), path)
         self.prim_path = path
 
-        xform = UsdGeom.Xform.Define(stage, path)
-        if not xform:
-            return False
+        prim = stage.GetPrimAtPath(path)
+        if not prim or not prim.IsValid():
+            xform = UsdGeom.Xform.Define(stage, path)
+            if not xform:
+                return None
+            prim = xform.GetPrim()
+            self._usd_written = {}
+        else:
+            xform = UsdGeom.Xform(prim)
 
-        translate_op = xform.GetTranslateOp() or xform.AddTranslateOp()
-        translate_op.Set(Gf.Vec3d(self.position.x(), self.position.y(), self.position.z()))
+        asset_path = self.get_asset_path() if hasattr(self, "get_asset_path") else None
+        if asset_path and not self._usd_written.get("__reference__"):
+            if not prim.HasAuthoredReferences():
+                prim.GetReferences().AddReference(asset_path)
+            self._usd_written["__reference__"] = True
 
-        rotate_op = xform.GetRotateXYZOp() or xform.AddRotateXYZOp()
-        rotate_op.Set(Gf.Vec3d(self.rotation.x(), self.rotation.y(), self.rotation.z()))
+        writes = []
+        for key, (type_name, value) in self.usd_values().items():
+            if self._usd_written.get(key, _MISSING) == value:
+                continue
+            attr = _usd_attribute(prim, xform, key, type_name)
+            writes.append((attr, _to_usd(type_name, value)))
+            self._usd_written[key] = value
+        return writes
 
-        scale_op = xform.GetScaleOp() or xform.AddScaleOp()
-        scale_op.Set(Gf.Vec3d(self.scale.x(), self.scale.y(), self.scale.z()))
+    def read_usd(self, prim) -> None:
+        """Load transform and ``kiln:*`` metadata from *prim*.
 
-        # Sync Metadata
-        from pxr import Sdf
-        prim = xform.GetPrim()
-        
-        # Role
-        role_attr = prim.CreateAttribute("kiln:role", Sdf.ValueTypeNames.String)
-        role_attr.Set(self.role if self.role else "")
-        
-        # Color
-        color_attr = prim.CreateAttribute("kiln:color", Sdf.ValueTypeNames.Float3)
-        color_attr.Set(Gf.Vec3f(self.color.redF(), self.color.greenF(), self.color.blueF()))
+        The values read are remembered, so a following sync only writes what
+        was edited afterwards.
+        """
 
-        # Actor metadata is persisted on the USD prim so UI settings survive reload.
-        if self.role in ("car", "npc"):
-            prim.CreateAttribute("kiln:control_mode", Sdf.ValueTypeNames.String).Set(self.control_mode)
-            prim.CreateAttribute("kiln:max_speed", Sdf.ValueTypeNames.Float).Set(float(self.max_speed))
-            prim.CreateAttribute("kiln:speed_delta", Sdf.ValueTypeNames.Float).Set(float(self.speed_delta))
-            prim.CreateAttribute("kiln:turn_rate", Sdf.ValueTypeNames.Float).Set(float(self.turn_rate))
-            prim.CreateAttribute("kiln:force", Sdf.ValueTypeNames.Float).Set(float(self.force))
-            prim.CreateAttribute("kiln:torque", Sdf.ValueTypeNames.Float).Set(float(self.torque))
-            prim.CreateAttribute("kiln:initial_yaw", Sdf.ValueTypeNames.Float).Set(float(self.initial_yaw))
-
-        if self.role == "npc":
-            prim.CreateAttribute("kiln:roam_xy_min", Sdf.ValueTypeNames.Float2).Set(
-                Gf.Vec2f(float(self.roam_xy_min[0]), float(self.roam_xy_min[1]))
-            )
-            prim.CreateAttribute("kiln:roam_xy_max", Sdf.ValueTypeNames.Float2).Set(
-                Gf.Vec2f(float(self.roam_xy_max[0]), float(self.roam_xy_max[1]))
-            )
-            prim.CreateAttribute("kiln:goal_tolerance", Sdf.ValueTypeNames.Float).Set(float(self.goal_tolerance))
-            prim.CreateAttribute("kiln:cruise_speed", Sdf.ValueTypeNames.Float).Set(float(self.cruise_speed))
-            prim.CreateAttribute("kiln:heading_threshold", Sdf.ValueTypeNames.Float).Set(float(self.heading_threshold))
-            prim.CreateAttribute("kiln:raycast_length", Sdf.ValueTypeNames.Float).Set(float(self.raycast_length))
-            prim.CreateAttribute("kiln:raycast_angle", Sdf.ValueTypeNames.Float).Set(float(self.raycast_angle))
-            prim.CreateAttribute("kiln:avoid_distance", Sdf.ValueTypeNames.Float).Set(float(self.avoid_distance))
-            prim.CreateAttribute("kiln:brake_distance", Sdf.ValueTypeNames.Float).Set(float(self.brake_distance))
-            prim.CreateAttribute("kiln:avoid_radius", Sdf.ValueTypeNames.Float).Set(float(self.avoid_radius))
-            prim.CreateAttribute("kiln:emergency_brake_radius", Sdf.ValueTypeNames.Float).Set(
-                float(self.emergency_brake_radius)
-            )
-            prim.CreateAttribute("kiln:stuck_steps", Sdf.ValueTypeNames.Int).Set(int(self.stuck_steps))
-            prim.CreateAttribute("kiln:progress_eps", Sdf.ValueTypeNames.Float).Set(float(self.progress_eps))
-            prim.CreateAttribute("kiln:nav_cell_size", Sdf.ValueTypeNames.Float).Set(float(self.nav_cell_size))
-            prim.CreateAttribute("kiln:nav_inflate", Sdf.ValueTypeNames.Float).Set(float(self.nav_inflate))
-            prim.CreateAttribute("kiln:waypoint_tolerance", Sdf.ValueTypeNames.Float).Set(float(self.waypoint_tolerance))
-            prim.CreateAttribute("kiln:max_goal_samples", Sdf.ValueTypeNames.Int).Set(int(self.max_goal_samples))
-        
+        written: dict[str, object] = {}
+        xform = UsdGeom.Xform(prim)
+        if xform:
+            for op in xform.GetOrderedXformOps():
+                op_type = op.GetOpType()
+                if op_type == UsdGeom.XformOp.TypeTranslate:
+                    key, obj_attr = "xform:translate", "position"
+                elif op_type == UsdGeom.XformOp.TypeRotateXYZ:
+                    key, obj_attr = "xform:rotateXYZ", "rotation"
+                elif op_type == UsdGeom.XformOp.TypeScale:
+                    key, obj_attr = "xform:scale", "scale"
+                else:
+                    continue
+                v = op.Get()
+                if v is None:
+                    continue
+                setattr(self, obj_attr, QVector3D(v[0], v[1], v[2]))
+                written[key] = (float(v[0]), float(v[1]), float(v[2]))
+
+        def _get(name: str):
+            a = prim.GetAttribute(name)
+            if not a or (not a.IsValid()):
+                return None
+            return a.Get()
+
+        r = _get("kiln:role")
+        if r is not None:
+            self.role = r if r else None
+            written["kiln:role"] = str(r)
+        c = _get("kiln:color")
+        if c is not None:
+            self.color = QColor.fromRgbF(c[0], c[1], c[2])
+            written["kiln:color"] = (float(c[0]), float(c[1]), float(c[2]))
+        t = _get("kiln:object_type")
+        if t is not None:
+            written["kiln:object_type"] = str(t)
+
+        for usd_name, obj_attr, type_name in ACTOR_ATTRS + NPC_ATTRS:
+            v = _get(usd_name)
+            if v is None or (type_name == "String" and not v):
+                continue
+            v = _typed(type_name, v)
+            setattr(self, obj_attr, v)
+            written[usd_name] = v
+
+        if prim.HasAuthoredReferences():
+            written["__reference__"] = True
+        self.prim_path = str(prim.GetPath())
+        self._usd_key = (id(prim.GetStage()), self.prim_path)
+        self._usd_written = written
+
+    def sync_usd(self, stage, parent_path: str = "/World") -> bool:
+        """Write this object's changed attributes to *stage* (one change block)."""
+        writes = self.prepare_usd(stage, parent_path)
+        if writes is None:
+            return False
+        apply_usd_writes(writes)
         return True
+
+
+_MISSING = object()
+
+# (USD attribute, object attribute, value type) persisted for "car" and "npc" roles.
+ACTOR_ATTRS: tuple[tuple[str, str, str], ...] = (
+    ("kiln:control_mode", "control_mode", "String"),
+    ("kiln:max_speed", "max_speed", "Float"),
+    ("kiln:speed_delta", "speed_delta", "Float"),
+    ("kiln:turn_rate", "turn_rate", "Float"),
+    ("kiln:force", "force", "Float"),
+    ("kiln:torque", "torque", "Float"),
+    ("kiln:initial_yaw", "initial_yaw", "Float"),
+)
+
+# NPC policy config, persisted for the "npc" role only.
+NPC_ATTRS: tuple[tuple[str, str, str], ...] = (
+    ("kiln:roam_xy_min", "roam_xy_min", "Float2"),
+    ("kiln:roam_xy_max", "roam_xy_max", "Float2"),
+    ("kiln:goal_tolerance", "goal_tolerance", "Float"),
+    ("kiln:cruise_speed", "cruise_speed", "Float"),
+    ("kiln:heading_threshold", "heading_threshold", "Float"),
+    ("kiln:raycast_length", "raycast_length", "Float"),
+    ("kiln:raycast_angle", "raycast_angle", "Float"),
+    ("kiln:avoid_distance", "avoid_distance", "Float"),
+    ("kiln:brake_distance", "brake_distance", "Float"),
+    ("kiln:avoid_radius", "avoid_radius", "Float"),
+    ("kiln:emergency_brake_radius", "emergency_brake_radius", "Float"),
+    ("kiln:stuck_steps", "stuck_steps", "Int"),
+    ("kiln:progress_eps", "progress_eps", "Float"),
+    ("kiln:nav_cell_size", "nav_cell_size", "Float"),
+    ("kiln:nav_inflate", "nav_inflate", "Float"),
+    ("kiln:waypoint_tolerance", "waypoint_tolerance", "Float"),
+    ("kiln:max_goal_samples", "max_goal_samples", "Int"),
+)
+
+
+def _vec3(v: QVector3D) -> tuple[float, float, float]:
+    return (float(v.x()), float(v.y()), float(v.z()))
+
+
+def _f32(values):
+    return tuple(float(x) for x in np.asarray(values, dtype=np.float32))
+
+
+def _typed(type_name: str, v):
+    """Plain Python value of *v* for USD value type *type_name* (float32-rounded floats)."""
+    if type_name == "String":
+        return str(v)
+    if type_name == "Int":
+        return int(v)
+    if type_name == "Float":
+        return float(np.float32(v))
+    if type_name == "Float2":
+        return _f32((v[0], v[1]))
+    return _f32((v[0], v[1], v[2]))
+
+
+def _to_usd(type_name: str, v):
+    if type_name == "Double3":
+        return Gf.Vec3d(*v)
+    if type_name == "Float3":
+        return Gf.Vec3f(*v)
+    if type_name == "Float2":
+        return Gf.Vec2f(*v)
+    return v
+
+
+def _usd_attribute(prim, xform, key: str, type_name: str):
+    """Existing attribute (or xform op attribute) for *key*, created if missing."""
+    if key == "xform:translate":
+        return (xform.GetTranslateOp() or xform.AddTranslateOp()).GetAttr()
+    if key == "xform:rotateXYZ":
+        return (xform.GetRotateXYZOp() or xform.AddRotateXYZOp()).GetAttr()
+    if key == "xform:scale":
+        return (xform.GetScaleOp() or xform.AddScaleOp()).GetAttr()
+    attr = prim.GetAttribute(key)
+    if attr and attr.IsValid():
+        return attr
+    from pxr import Sdf
+
+    return prim.CreateAttribute(key, getattr(Sdf.ValueTypeNames, type_name))
+
+
+def apply_usd_writes(writes) -> int:
+    """Set ``(attribute, value)`` pairs inside one ``Sdf.ChangeBlock``; returns the count."""
+    if not writes:
+        return 0
+    from pxr import Sdf
+
+    with Sdf.ChangeBlock():
+        for attr, value in writes:
+            attr.Set(value)
+    return len(writes)
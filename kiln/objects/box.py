@@ -15,6 +15,7 @@ except ImportError:
 
 class Box(BaseObject):
     SUPPORTED_ROLES = [None, "building", "car", "npc"]
+    USD_OBJECT_TYPE = "Box"
 
     def __init__(self, name: str, size: float = 1.0, 
                  position: QVector3D | None = None, 
@@ -34,6 +35,9 @@ class Box(BaseObject):
         asset_path = os.path.join(os.path.dirname(current_dir), "assets", "box.usda")
         return asset_path
 
+    def instance_shape(self):
+        return ("box", (self.size, self.size, self.size))
+
     def _setup_gl_resources(self):
         hs = self.size / 2.0
         r, g, b, a = self.color.redF(), self.color.greenF(), self.color.blueF(), 1.0
@@ -125,21 +129,3 @@ class Box(BaseObject):
         glBindVertexArray(self.outline_vao)
         glDrawArrays(GL_LINES, 0, 24) # 12 edges * 2 verts
         glBindVertexArray(0)
-
-    def sync_usd(self, stage, parent_path: str = "/World") -> bool:
-        if not super().sync_usd(stage, parent_path):
-            return False
-        if UsdGeom is None:
-            return False
-
-        prim = stage.GetPrimAtPath(self.prim_path)
-        if not prim:
-            return False
-
-        asset_path = self.get_asset_path()
-        prim.GetReferences().AddReference(asset_path)
-        
-        attr = prim.CreateAttribute("kiln:object_type", Sdf.ValueTypeNames.String)
-        attr.Set("Box")
-        
-        return True
@@ -20,6 +20,7 @@ except ImportError:
 
 class Plane(BaseObject):
     SUPPORTED_ROLES = [None, "ground"]
+    USD_OBJECT_TYPE = "Plane"
     
     def __init__(self, name: str, width: float = 10.0, depth: float = 10.0, 
                  position: QVector3D | None = None, 
@@ -48,6 +49,9 @@ class Plane(BaseObject):
         asset_path = os.path.join(os.path.dirname(current_dir), "assets", "plane.usda")
         return asset_path
 
+    def instance_shape(self):
+        return ("plane", (self.width, 1.0, self.depth))
+
     def _setup_gl_resources(self):
         # Create a simple quad
         # Position (3 floats) + Color (4 floats)
@@ -156,26 +160,3 @@ class Plane(BaseObject):
         glBindVertexArray(self.outline_vao)
         glDrawArrays(GL_LINE_LOOP, 0, 4)
         glBindVertexArray(0)
-
-    def sync_usd(self, stage, parent_path: str = "/World") -> bool:
-        # First sync the Xform (base implementation)
-        if not super().sync_usd(stage, parent_path):
-            return False
-            
-        if UsdGeom is None:
-            return False
-
-        # Get the prim we just created/updated
-        prim = stage.GetPrimAtPath(self.prim_path)
-        
-        # Add reference to the plane asset
-        asset_path = self.get_asset_path()
-        refs = prim.GetReferences()
-        refs.AddReference(asset_path)
-        
-        # Tag with kiln type for reloading
-        # We use a custom attribute
-        attr = prim.CreateAttribute("kiln:object_type", Sdf.ValueTypeNames.String)
-        attr.Set("Plane")
-        
-        return True
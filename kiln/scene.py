@@ -8,6 +8,7 @@ A Scene owns:
 - the list of BaseObject instances currently in the scene
 - the selected object
 - object add / remove helpers
+- incremental USD sync (see `sync_objects` and `_on_objects_changed`)
 - env-bundle export
 
 The UI widgets (ViewportWidget, SceneHierarchyWidget, PropertiesWidget) observe
@@ -20,16 +21,22 @@ from typing import TYPE_CHECKING
 from PyQt6.QtCore import QObject, pyqtSignal
 
 from kiln.objects import BaseObject, Plane, Box
+from kiln.objects.base_object import apply_usd_writes
 
 if TYPE_CHECKING:
     from PyQt6.QtGui import QVector3D
 
 try:
-    from pxr import Usd, UsdGeom, Gf
+    from pxr import Usd, UsdGeom, Gf, Sdf, Tf
 except ImportError:
     Usd = None
     UsdGeom = None
     Gf = None
+    Sdf = None
+    Tf = None
+
+# kiln:object_type -> class used to rebuild objects from the stage.
+OBJECT_TYPES: dict[str, type[BaseObject]] = {"Plane": Plane, "Box": Box}
 
 
 class Scene(QObject):
@@ -41,6 +48,9 @@ class Scene(QObject):
     # Emitted when the selected object changes.  Carries the object (or None).
     selection_changed = pyqtSignal(object)
 
+    # Emitted when an existing object was re-read after an external stage edit.
+    object_changed = pyqtSignal(object)
+
     def __init__(self, parent: QObject | None = None) -> None:
         super().__init__(parent)
 
@@ -48,6 +58,11 @@ class Scene(QObject):
         self.stage: Usd.Stage | None = None  # type: ignore[name-defined]
         self.objects: list[BaseObject] = []
         self.selected_object: BaseObject | None = None
+        # prim path -> object, for mapping stage notices back to objects.
+        self._objects_by_path: dict[str, BaseObject] = {}
+        self._stage_listener = None
+        # True while the scene writes to the stage itself (its own notices are ignored).
+        self._writing = False
 
     # ------------------------------------------------------------------
     # Lifecycle
@@ -66,6 +81,7 @@ class Scene(QObject):
             try:
                 self.stage = Usd.Stage.Open(str(path))
                 self._refresh_from_stage()
+                self._watch_stage()
             except Exception as e:
                 print(f"Failed to open USD stage: {e}")
                 self.stage = None
@@ -83,9 +99,13 @@ class Scene(QObject):
 
     def close(self) -> None:
         """Close the scene and clear all state."""
+        if self._stage_listener is not None:
+            self._stage_listener.Revoke()
+            self._stage_listener = None
         self.scene_path = None
         self.stage = None
         self.objects.clear()
+        self._objects_by_path.clear()
         self.selected_object = None
 
     @property
@@ -108,8 +128,7 @@ class Scene(QObject):
         self.objects.append(obj)
 
         if self.stage:
-            obj.sync_usd(self.stage)
-            self.save()
+            self.sync_objects([obj])
 
         self.objects_changed.emit()
         self.select(obj)
@@ -120,10 +139,16 @@ class Scene(QObject):
             return
 
         self.objects.remove(obj)
+        if self._objects_by_path.get(obj.prim_path) is obj:
+            del self._objects_by_path[obj.prim_path]
 
         # Remove from USD stage
         if self.stage and obj.prim_path:
-            self.stage.RemovePrim(obj.prim_path)
+            self._writing = True
+            try:
+                self.stage.RemovePrim(obj.prim_path)
+            finally:
+                self._writing = False
             self.save()
 
         if self.selected_object is obj:
@@ -168,124 +193,149 @@ class Scene(QObject):
     # ------------------------------------------------------------------
 
     def sync_selected_to_usd(self) -> None:
-        """Sync the currently selected object's transform back to USD and
+        """Sync the currently selected object's changes back to USD and
         save the stage."""
         if self.selected_object and self.stage:
-            self.selected_object.sync_usd(self.stage)
+            self.sync_objects([self.selected_object])
+
+    def sync_objects(self, objects: list[BaseObject] | None = None, *, save: bool = True) -> int:
+        """Write the attributes of *objects* (default: all) that changed since
+        their last sync.
+
+        Only modified attributes are written, all inside one
+        ``Sdf.ChangeBlock`` so the stage recomposes and notifies once.  The
+        stage is saved only if something was written.  Returns the number of
+        attributes written.
+        """
+        if self.stage is None:
+            return 0
+        objects = self.objects if objects is None else objects
+
+        writes = []
+        self._writing = True
+        try:
+            for obj in objects:
+                old_path = obj.prim_path
+                obj_writes = obj.prepare_usd(self.stage)
+                if obj_writes:
+                    writes.extend(obj_writes)
+                if old_path != obj.prim_path and self._objects_by_path.get(old_path) is obj:
+                    del self._objects_by_path[old_path]
+                if obj.prim_path:
+                    self._objects_by_path[obj.prim_path] = obj
+            n = apply_usd_writes(writes)
+        finally:
+            self._writing = False
+
+        if n and save:
             self.save()
+        return n
 
-    def _refresh_from_stage(self) -> None:
-        """Rebuild ``self.objects`` from the current USD stage."""
-        self.objects.clear()
-        if not self.stage:
+    # ------------------------------------------------------------------
+    # Stage -> objects
+    # ------------------------------------------------------------------
+
+    def _watch_stage(self) -> None:
+        """Listen for stage edits made outside the Scene (Python console,
+        other layers, reloads) so only the affected prims are re-read."""
+        if Tf is None or self.stage is None:
             return
+        self._stage_listener = Tf.Notice.Register(
+            Usd.Notice.ObjectsChanged, self._on_objects_changed, self.stage
+        )
 
+    def _root_prim(self):
         root = self.stage.GetPrimAtPath("/World")
         if not root:
             root = self.stage.GetPseudoRoot()
+        return root
+
+    def _object_prim_path(self, path, root_path) -> str | None:
+        """Path of the object prim (a child of the root) owning *path*, or
+        ``None`` if *path* is the root or outside it."""
+        p = path.GetPrimPath()
+        if p == root_path or not p.HasPrefix(root_path):
+            return None
+        while p.GetParentPath() != root_path:
+            p = p.GetParentPath()
+        return str(p)
+
+    def _on_objects_changed(self, notice, sender) -> None:
+        if self._writing or self.stage is None:
+            return
 
-        for prim in root.GetChildren():
-            if not prim.IsValid():
-                continue
+        root_path = self._root_prim().GetPath()
+        resynced_paths = notice.GetResyncedPaths()
+        if any(root_path.HasPrefix(p.GetPrimPath()) for p in resynced_paths):
+            # Root (or an ancestor) recomposed: the object set may have changed wholesale.
+            self._refresh_from_stage()
+            return
+        resynced = {self._object_prim_path(p, root_path) for p in resynced_paths}
+        resynced.discard(None)
+        changed = {self._object_prim_path(p, root_path) for p in notice.GetChangedInfoOnlyPaths()}
+        changed.discard(None)
+        changed -= resynced
+
+        structural = False
+        updated: list[BaseObject] = []
+        for path in sorted(resynced):
+            prim = self.stage.GetPrimAtPath(path)
+            obj = self._objects_by_path.get(path)
+            if prim and prim.IsValid() and prim.IsActive():
+                if obj is None:
+                    obj = self._object_from_prim(prim)
+                    if obj is not None:
+                        self.objects.append(obj)
+                        self._objects_by_path[path] = obj
+                        structural = True
+                else:
+                    obj.read_usd(prim)
+                    updated.append(obj)
+            elif obj is not None:
+                self.objects.remove(obj)
+                del self._objects_by_path[path]
+                structural = True
+                if self.selected_object is obj:
+                    self.select(None)
+
+        for path in sorted(changed):
+            obj = self._objects_by_path.get(path)
+            prim = self.stage.GetPrimAtPath(path)
+            if obj is not None and prim:
+                obj.read_usd(prim)
+                updated.append(obj)
+
+        if structural:
+            self.objects_changed.emit()
+        for obj in updated:
+            self.object_changed.emit(obj)
+
+    def _object_from_prim(self, prim) -> BaseObject | None:
+        """Create the object described by *prim* (``None`` for non-Kiln prims)."""
+        if not prim.IsValid():
+            return None
+        type_attr = prim.GetAttribute("kiln:object_type")
+        obj_type = type_attr.Get() if type_attr and type_attr.IsValid() else None
+        cls = OBJECT_TYPES.get(obj_type)
+        if cls is None:
+            return None
+        obj = cls(prim.GetName())
+        obj.read_usd(prim)
+        return obj
 
-            type_attr = prim.GetAttribute("kiln:object_type")
-            obj_type = None
-            if type_attr and type_attr.IsValid():
-                obj_type = type_attr.Get()
+    def _refresh_from_stage(self) -> None:
+        """Rebuild ``self.objects`` from the current USD stage."""
+        self.objects.clear()
+        self._objects_by_path.clear()
+        if not self.stage:
+            return
 
-            if obj_type not in ("Plane", "Box"):
+        for prim in self._root_prim().GetChildren():
+            obj = self._object_from_prim(prim)
+            if obj is None:
                 continue
-
-            name = prim.GetName()
-            obj: BaseObject = Plane(name) if obj_type == "Plane" else Box(name)
-
-            xform = UsdGeom.Xform(prim)
-            if xform:
-                from PyQt6.QtGui import QVector3D
-
-                trans_op = rot_op = scale_op = None
-                for op in xform.GetOrderedXformOps():
-                    op_type = op.GetOpType()
-                    if op_type == UsdGeom.XformOp.TypeTranslate:
-                        trans_op = op
-                    elif op_type == UsdGeom.XformOp.TypeRotateXYZ:
-                        rot_op = op
-                    elif op_type == UsdGeom.XformOp.TypeScale:
-                        scale_op = op
-
-                if trans_op:
-                    v = trans_op.Get()
-                    obj.position = QVector3D(v[0], v[1], v[2])
-                if rot_op:
-                    v = rot_op.Get()
-                    obj.rotation = QVector3D(v[0], v[1], v[2])
-                if scale_op:
-                    v = scale_op.Get()
-                    obj.scale = QVector3D(v[0], v[1], v[2])
-
-                # Load metadata
-                role_attr = prim.GetAttribute("kiln:role")
-                if role_attr and role_attr.IsValid():
-                    r = role_attr.Get()
-                    obj.role = r if r else None
-
-                color_attr = prim.GetAttribute("kiln:color")
-                if color_attr and color_attr.IsValid():
-                    from PyQt6.QtGui import QColor
-                    c = color_attr.Get()
-                    obj.color = QColor.fromRgbF(c[0], c[1], c[2])
-
-                def _get_attr(name: str):
-                    a = prim.GetAttribute(name)
-                    if not a or (not a.IsValid()):
-                        return None
-                    return a.Get()
-
-                def _set_float_if_present(attr_name: str, obj_attr: str) -> None:
-                    v = _get_attr(attr_name)
-                    if v is not None:
-                        setattr(obj, obj_attr, float(v))
-
-                def _set_int_if_present(attr_name: str, obj_attr: str) -> None:
-                    v = _get_attr(attr_name)
-                    if v is not None:
-                        setattr(obj, obj_attr, int(v))
-
-                control_mode = _get_attr("kiln:control_mode")
-                if control_mode:
-                    obj.control_mode = str(control_mode)
-                _set_float_if_present("kiln:max_speed", "max_speed")
-                _set_float_if_present("kiln:speed_delta", "speed_delta")
-                _set_float_if_present("kiln:turn_rate", "turn_rate")
-                _set_float_if_present("kiln:force", "force")
-                _set_float_if_present("kiln:torque", "torque")
-                _set_float_if_present("kiln:initial_yaw", "initial_yaw")
-
-                roam_xy_min = _get_attr("kiln:roam_xy_min")
-                if roam_xy_min is not None:
-                    obj.roam_xy_min = (float(roam_xy_min[0]), float(roam_xy_min[1]))
-                roam_xy_max = _get_attr("kiln:roam_xy_max")
-                if roam_xy_max is not None:
-                    obj.roam_xy_max = (float(roam_xy_max[0]), float(roam_xy_max[1]))
-                _set_float_if_present("kiln:goal_tolerance", "goal_tolerance")
-                _set_float_if_present("kiln:cruise_speed", "cruise_speed")
-                _set_float_if_present("kiln:heading_threshold", "heading_threshold")
-                _set_float_if_present("kiln:raycast_length", "raycast_length")
-                _set_float_if_present("kiln:raycast_angle", "raycast_angle")
-                _set_float_if_present("kiln:avoid_distance", "avoid_distance")
-                _set_float_if_present("kiln:brake_distance", "brake_distance")
-                _set_float_if_present("kiln:avoid_radius", "avoid_radius")
-                _set_float_if_present("kiln:emergency_brake_radius", "emergency_brake_radius")
-                _set_int_if_present("kiln:stuck_steps", "stuck_steps")
-                _set_float_if_present("kiln:progress_eps", "progress_eps")
-                _set_float_if_present("kiln:nav_cell_size", "nav_cell_size")
-                _set_float_if_present("kiln:nav_inflate", "nav_inflate")
-                _set_float_if_present("kiln:waypoint_tolerance", "waypoint_tolerance")
-                _set_int_if_present("kiln:max_goal_samples", "max_goal_samples")
-
-                obj.prim_path = str(prim.GetPath())
-
             self.objects.append(obj)
+            self._objects_by_path[obj.prim_path] = obj
 
         self.objects_changed.emit()
 
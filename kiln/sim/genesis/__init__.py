@@ -4,6 +4,16 @@ Genesis simulation backend.
 Genesis docs: https://genesis-world.readthedocs.io/en/latest/
 """
 
-from .sim import GenesisSim, GenesisSimConfig, RaycastHit  # noqa: F401
+from .batch import EntityBatch, PositionSnapshot  # noqa: F401
+from .cameras import CameraRig, CameraRigConfig  # noqa: F401
+from .collisions import CollisionEvent, CollisionPhase, CollisionService  # noqa: F401
+from .pipeline import PipelineConfig, PipelinedRunner  # noqa: F401
+from .profiler import Profiler, to_prometheus  # noqa: F401
+from .pool import EnvPool, EnvPoolConfig, EnvPoolResult, EnvTask  # noqa: F401
+from .raycast import RaycastBatch, RaycastHit, RaycastWorld  # noqa: F401
+from .recorder import EpisodeRecorder, RecorderConfig, Recording, load_recording  # noqa: F401
+from .sim import GenesisSim, GenesisSimConfig  # noqa: F401
+from .state import SimStateSnapshot  # noqa: F401
+from .task import TaskRuntime, TaskStep  # noqa: F401
 
 
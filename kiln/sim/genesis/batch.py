@@ -0,0 +1,182 @@
+from __future__ import annotations
+
+"""
+Batched state I/O helpers for the Genesis adapter.
+
+Genesis can replicate one scene `n_envs` times at build time. The helpers here resolve the
+solver-level link/DoF indices of an ordered group of rigid entities once, so whole groups
+can be read or written with one rigid-solver call instead of one Python call per entity.
+
+Tensor layout follows Genesis conventions:
+- batched scenes (`n_envs > 0`): `[n_envs, n_entities, ...]`
+- unbatched scenes (`n_envs == 0`): `[n_entities, ...]` (no leading env dimension)
+"""
+
+from collections.abc import Iterator, Mapping
+from dataclasses import dataclass, field
+from typing import Any, Sequence
+
+# Free rigid bodies expose a 6-DoF base joint: (vx, vy, vz, wx, wy, wz).
+DOFS_PER_BODY = 6
+
+
+def _import_torch() -> Any:
+    try:
+        import torch  # type: ignore
+    except ModuleNotFoundError as e:
+        raise ModuleNotFoundError(
+            "PyTorch is required for batched Genesis state I/O (install it per the Genesis docs)."
+        ) from e
+    return torch
+
+
+@dataclass(frozen=True, eq=False)
+class EntityBatch:
+    """
+    Fixed, ordered group of rigid entities with solver indices resolved once.
+
+    Attributes:
+        entities: The entities, in the order used for the `n_entities` tensor axis.
+        links_idx: Long tensor `[n_entities]` of base-link indices, or None if unavailable.
+        dofs_idx: Long tensor `[n_entities * 6]` of free-joint DoF indices, or None if any
+            entity is not a free 6-DoF body (e.g. fixed buildings).
+        index: Maps `id(entity)` to its position along the entity axis.
+    """
+
+    entities: tuple[Any, ...]
+    links_idx: Any | None = None
+    dofs_idx: Any | None = None
+    index: Mapping[int, int] = field(default_factory=dict)
+
+    def __len__(self) -> int:
+        return len(self.entities)
+
+    @property
+    def controllable(self) -> bool:
+        """True if every entity in the batch is a free body that accepts 6-DoF writes."""
+        return self.dofs_idx is not None
+
+
+def resolve_entity_batch(entities: Sequence[Any], *, device: Any | None = None) -> EntityBatch:
+    """
+    Resolve base-link and DoF indices for `entities` (scene must already be built).
+
+    Missing index attributes are tolerated: the corresponding field is left as None and
+    callers fall back to per-entity accessors.
+    """
+    torch = _import_torch()
+    ents = tuple(entities)
+
+    links: list[int] | None = []
+    dofs: list[int] | None = []
+    for ent in ents:
+        if links is not None:
+            link = getattr(ent, "base_link_idx", None)
+            if link is None:
+                link = getattr(ent, "link_start", None)
+            if link is None:
+                links = None
+            else:
+                links.append(int(link))
+
+        if dofs is not None:
+            dof_start = getattr(ent, "dof_start", None)
+            n_dofs = getattr(ent, "n_dofs", None)
+            if dof_start is None or n_dofs is None or int(n_dofs) != DOFS_PER_BODY:
+                dofs = None
+            else:
+                s = int(dof_start)
+                dofs.extend(range(s, s + DOFS_PER_BODY))
+
+    return EntityBatch(
+        entities=ents,
+        links_idx=torch.tensor(links, dtype=torch.long, device=device) if links is not None else None,
+        dofs_idx=torch.tensor(dofs, dtype=torch.long, device=device) if dofs is not None else None,
+        index={id(ent): i for i, ent in enumerate(ents)},
+    )
+
+
+class PositionSnapshot(Mapping[int, tuple[float, float, float]]):
+    """
+    Host-side base positions of an entity group from one bulk readback.
+
+    Behaves like the `positions_by_id` dict used by actor policies (`id(entity)` -> `(x, y, z)`),
+    while also exposing the contiguous array for vectorized consumers.
+
+    Attributes:
+        positions: `[n_entities, 3]` (unbatched) or `[n_envs, n_entities, 3]` (batched) array.
+            It may be a view of a reused pinned host buffer: it stays valid until the next
+            readback of the same entity group on the same thread, so `copy()` the snapshot
+            if you need to keep it longer.
+        index: Maps `id(entity)` to its row along the entity axis.
+        entities: The entities, in row order.
+    """
+
+    def __init__(self, positions: Any, index: Mapping[int, int], entities: Sequence[Any]) -> None:
+        self.positions = positions
+        self.index = index
+        self.entities = tuple(entities)
+        # Mapping lookups read env 0 in batched mode.
+        self._rows = positions[0] if getattr(positions, "ndim", 2) == 3 else positions
+
+    def copy(self) -> "PositionSnapshot":
+        """A snapshot that owns its positions (detached from any reused readback buffer)."""
+        return PositionSnapshot(self.positions.copy(), self.index, self.entities)
+
+    def row(self, entity: Any) -> int:
+        """Return the row of `entity` (raises KeyError if it is not part of the snapshot)."""
+        return self.index[id(entity)]
+
+    def __getitem__(self, key: int) -> tuple[float, float, float]:
+        x, y, z = self._rows[self.index[key]].tolist()
+        return (x, y, z)
+
+    def __iter__(self) -> Iterator[int]:
+        return iter(self.index)
+
+    def __len__(self) -> int:
+        return len(self.index)
+
+
+def as_dof_tensor(
+    values: Any,
+    *,
+    n_entities: int,
+    n_envs: int,
+    n_envs_selected: int | None,
+    dtype: Any,
+    device: Any,
+) -> Any:
+    """
+    Convert `values` to a solver DoF tensor.
+
+    Accepts `[n_entities, 6]` (broadcast to every selected env in batched scenes) or
+    `[n_envs_selected, n_entities, 6]` and returns `[n_envs_selected, n_entities * 6]`
+    (batched) or `[n_entities * 6]` (unbatched).
+    """
+    torch = _import_torch()
+    v = torch.as_tensor(values, dtype=dtype, device=device)
+
+    if n_envs <= 0:
+        if tuple(v.shape) != (n_entities, DOFS_PER_BODY):
+            raise ValueError(f"Expected shape ({n_entities}, {DOFS_PER_BODY}), got {tuple(v.shape)}")
+        return v.reshape(n_entities * DOFS_PER_BODY)
+
+    n_sel = n_envs if n_envs_selected is None else int(n_envs_selected)
+    if v.dim() == 2:
+        if tuple(v.shape) != (n_entities, DOFS_PER_BODY):
+            raise ValueError(f"Expected shape ({n_entities}, {DOFS_PER_BODY}), got {tuple(v.shape)}")
+        v = v.unsqueeze(0).expand(n_sel, n_entities, DOFS_PER_BODY)
+    elif tuple(v.shape) != (n_sel, n_entities, DOFS_PER_BODY):
+        raise ValueError(f"Expected shape ({n_sel}, {n_entities}, {DOFS_PER_BODY}), got {tuple(v.shape)}")
+    return v.reshape(n_sel, n_entities * DOFS_PER_BODY)
+
+
+def count_envs(envs_idx: Any | None, n_envs: int) -> int | None:
+    """Return how many envs `envs_idx` selects (None means all envs)."""
+    if envs_idx is None:
+        return None if n_envs <= 0 else n_envs
+    try:
+        return int(len(envs_idx))
+    except TypeError:
+        return 1
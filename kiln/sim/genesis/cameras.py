@@ -0,0 +1,217 @@
+from __future__ import annotations
+
+"""
+Camera rigs: many small cameras rendered together into one device tensor.
+
+Pixel observations need a small camera per agent per env, rendered every few steps. Calling
+`cam.render(...)` per camera and copying each image to the host (as the GIF capture path does)
+costs a full render call plus a host round-trip per image. A `CameraRig` owns a group of
+same-resolution cameras, optionally mounted on bodies (chase-camera style, following the
+body's yaw), and renders them in one pass into a reused `[n_cams, H, W, C]` uint8 tensor on the
+simulation device (`[n_cams, n_envs, H, W, C]` when each camera renders every env of a batched
+scene):
+
+- With Genesis' batch renderer enabled (`GenesisSimConfig(batch_render=True)`), the whole rig is
+  rendered by a single scene-level call, and the frames never leave the device.
+- Otherwise each camera is rendered in turn and copied into the shared tensor (same output,
+  one render per camera).
+
+Mounted camera poses are computed for the whole rig from one batched pose readback.
+"""
+
+from dataclasses import dataclass
+from typing import Any, Sequence
+
+import numpy as np
+
+# Scene-level "render every camera" methods across Genesis versions (batch renderer).
+_BATCH_RENDER_METHODS = ("render_all_cameras", "batch_render")
+
+
+@dataclass(frozen=True)
+class CameraRigConfig:
+    """
+    Attributes:
+        res: Per-camera resolution `(width, height)`.
+        fov: Vertical field of view (degrees).
+        every: Frame skip: `render(step)` re-renders only when `step % every == 0` and
+            otherwise returns the previous frames.
+        offset: Mounted cameras: eye position in the body's yaw frame (x forward, z up).
+        lookahead: Mounted cameras: look-at point this far ahead of the body (at body height).
+        near: Near clipping plane.
+        far: Far clipping plane.
+    """
+
+    res: tuple[int, int] = (64, 64)
+    fov: float = 70.0
+    every: int = 1
+    offset: tuple[float, float, float] = (-3.0, 0.0, 1.5)
+    lookahead: float = 3.0
+    near: float = 0.05
+    far: float = 100.0
+
+
+def mount_poses(
+    pos: np.ndarray,
+    quat: np.ndarray,
+    *,
+    offset: Sequence[float],
+    lookahead: float,
+) -> tuple[np.ndarray, np.ndarray]:
+    """
+    Chase-camera eye/look-at points for bodies at `pos [n, 3]` with orientations `quat [n, 4]`
+    (w, x, y, z); only the bodies' yaw is followed so cameras stay level.
+    """
+    pos = np.asarray(pos, dtype=np.float64).reshape(-1, 3)
+    q = np.asarray(quat, dtype=np.float64).reshape(-1, 4)
+    w, x, y, z = q[:, 0], q[:, 1], q[:, 2], q[:, 3]
+    yaw = np.arctan2(2.0 * (w * z + x * y), 1.0 - 2.0 * (y * y + z * z))
+    c, s = np.cos(yaw), np.sin(yaw)
+    ox, oy, oz = (float(v) for v in offset)
+    eye = np.stack([pos[:, 0] + c * ox - s * oy, pos[:, 1] + s * ox + c * oy, pos[:, 2] + oz], axis=1)
+    la = float(lookahead)
+    lookat = np.stack([pos[:, 0] + c * la, pos[:, 1] + s * la, pos[:, 2]], axis=1)
+    return eye, lookat
+
+
+def _as_device_tensor(v: Any, device: Any | None) -> Any:
+    from .batch import _import_torch
+
+    torch = _import_torch()
+    t = v if hasattr(v, "detach") else torch.as_tensor(np.ascontiguousarray(v))
+    return t.to(device) if device is not None else t
+
+
+class CameraRig:
+    """
+    A group of same-resolution cameras rendered together (see module docs).
+
+    Create through `GenesisSim.add_camera_rig(...)` before `build()`.
+
+    Attributes:
+        config: Rig configuration.
+        cameras: Genesis camera objects, in row order of the output tensor.
+        mounts: Bodies the cameras follow (None for static cameras).
+        frames: Last rendered `[n_cams, H, W, C]` uint8 tensor, or `[n_cams, n_envs, H, W, C]`
+            when cameras render every env of a batched scene (None before the first render).
+            It is reused between renders, so clone it to keep a frame longer.
+    """
+
+    def __init__(
+        self,
+        sim: Any,
+        config: CameraRigConfig | None = None,
+        *,
+        mounts: Sequence[Any] | None = None,
+        poses: Sequence[tuple[Sequence[float], Sequence[float]]] | None = None,
+    ) -> None:
+        if (mounts is None) == (poses is None):
+            raise ValueError("Pass exactly one of `mounts` (bodies to follow) or `poses` ((eye, lookat) pairs).")
+        if sim.scene is None:
+            raise RuntimeError("Scene is not created.")
+        if getattr(sim, "_built", False):
+            raise RuntimeError("Cameras must be added before build().")
+        self.sim = sim
+        self.config = config or CameraRigConfig()
+        self.mounts = tuple(mounts) if mounts is not None else None
+        self.frames: Any | None = None
+        self._last_step: int | None = None
+        self._batch_method: str | None | bool = False  # False = not probed yet
+
+        if self.mounts is not None:
+            # Placeholder poses; real ones are set from the bodies before each render.
+            n = len(self.mounts)
+            initial = [((0.0, -1.0, 1.0), (0.0, 0.0, 0.0))] * n
+        else:
+            initial = [(tuple(eye), tuple(lookat)) for eye, lookat in poses or ()]
+        cfg = self.config
+        self.cameras = [
+            sim.scene.add_camera(
+                res=(int(cfg.res[0]), int(cfg.res[1])),
+                pos=tuple(float(v) for v in eye),
+                lookat=tuple(float(v) for v in lookat),
+                fov=float(cfg.fov),
+                GUI=False,
+                near=float(cfg.near),
+                far=float(cfg.far),
+            )
+            for eye, lookat in initial
+        ]
+
+    def __len__(self) -> int:
+        return len(self.cameras)
+
+    def update_poses(self) -> None:
+        """Move mounted cameras behind their bodies (one batched pose readback for the rig)."""
+        if not self.mounts:
+            return
+        from .sim import _host_array
+
+        pos = self.sim.get_positions(self.mounts).positions
+        quat = _host_array(self.sim.get_quats_batch(self.mounts))
+        if pos.ndim == 3:
+            # Cameras follow env 0 in batched scenes.
+            pos, quat = pos[0], quat[0]
+        eye, lookat = mount_poses(pos, quat, offset=self.config.offset, lookahead=self.config.lookahead)
+        for cam, e, la in zip(self.cameras, eye.tolist(), lookat.tolist()):
+            cam.set_pose(pos=tuple(e), lookat=tuple(la))
+
+    def _probe_batch(self) -> str | None:
+        if self._batch_method is False:
+            found = None
+            if getattr(getattr(self.sim, "config", None), "batch_render", False):
+                found = next((m for m in _BATCH_RENDER_METHODS if hasattr(self.sim.scene, m)), None)
+            self._batch_method = found
+        return self._batch_method  # type: ignore[return-value]
+
+    def render(self, step: int | None = None) -> Any:
+        """
+        Render every camera and return the `frames` uint8 device tensor (`[n_cams, H, W, C]`,
+        or `[n_cams, n_envs, H, W, C]` for per-env renders of a batched scene).
+
+        With `step`, renders only every `config.every` steps (other steps return the previous
+        frames without rendering).
+        """
+        every = max(1, int(self.config.every))
+        if step is not None and self.frames is not None and int(step) % every != 0:
+            return self.frames
+        self._last_step = None if step is None else int(step)
+        self.update_poses()
+
+        method = self._probe_batch()
+        if method is not None:
+            out = getattr(self.sim.scene, method)(rgb=True, depth=False, segmentation=False, normal=False)
+            rgb = out[0] if isinstance(out, (tuple, list)) else out
+            # Keep only this rig's cameras when the scene has others.
+            rgb = _as_device_tensor(rgb, self.sim._device())
+            if rgb.shape[0] != len(self.cameras):
+                all_cams = list(getattr(getattr(self.sim.scene, "visualizer", None), "cameras", []) or [])
+                rows = [all_cams.index(c) for c in self.cameras] if all_cams else list(range(len(self.cameras)))
+                rgb = rgb[rows]
+            self.frames = rgb
+            return self.frames
+
+        w, h = int(self.config.res[0]), int(self.config.res[1])
+        for i, cam in enumerate(self.cameras):
+            out = cam.render(rgb=True, depth=False, segmentation=False, normal=False)
+            img = _as_device_tensor(out[0] if isinstance(out, (tuple, list)) else out, self.sim._device())
+            if tuple(img.shape[-2:]) == (h, w):
+                # Single-channel `[H, W]` / `[n_envs, H, W]` renders get a channel axis.
+                img = img.unsqueeze(-1)
+            if self.frames is None or (i == 0 and tuple(self.frames.shape[1:]) != tuple(img.shape)):
+                from .batch import _import_torch
+
+                torch = _import_torch()
+                # Per-camera shape as rendered: `[H, W, C]`, or `[n_envs, H, W, C]` in batched scenes.
+                self.frames = torch.empty((len(self.cameras), *img.shape), dtype=torch.uint8, device=img.device)
+            if tuple(img.shape) != tuple(self.frames.shape[1:]):
+                raise RuntimeError(
+                    f"Camera {i} rendered {tuple(img.shape)}, expected {tuple(self.frames.shape[1:])} like the rest of the rig."
+                )
+            self.frames[i].copy_(img)
+        return self.frames
+
+    @property
+    def last_step(self) -> int | None:
+        """Step index of the last actual render (None if rendered without a step)."""
+        return self._last_step
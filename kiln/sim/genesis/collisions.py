@@ -0,0 +1,427 @@
+from __future__ import annotations
+
+"""
+Collision events and the scene-level contact service.
+
+`CollisionService` fetches the global rigid contact buffer once per step and reduces it to
+touching (subscriber, target) pairs for every subscribed entity in one vectorized pass, instead
+of each actor calling `entity.get_contacts()` on its own. Each `CollisionSubscription` then turns
+its pairs into BEGIN/END `CollisionEvent`s with its own `min_force`.
+"""
+
+from dataclasses import dataclass
+from enum import Enum
+from typing import Any, Callable, Iterable
+
+
+class CollisionPhase(str, Enum):
+    BEGIN = "begin"
+    END = "end"
+
+
+@dataclass(frozen=True)
+class CollisionEvent:
+    """Collision begin/end event for this actor against a tracked target entity."""
+
+    step_idx: int
+    phase: CollisionPhase
+    other_entity: Any
+    other_entity_id: int
+    max_force: float | None = None
+    contact_count: int = 0
+
+
+def _import_torch_optional() -> Any | None:
+    try:
+        import torch  # type: ignore
+    except Exception:
+        return None
+    return torch
+
+
+def geom_range(ent: Any) -> tuple[int, int] | None:
+    """Return an entity's `[geom_start, geom_end)` range, or None if it has none."""
+    gs = getattr(ent, "geom_start", None)
+    ge = getattr(ent, "geom_end", None)
+    if gs is None or ge is None:
+        return None
+    try:
+        return (int(gs), int(ge))
+    except Exception:
+        return None
+
+
+class CollisionSubscription:
+    """
+    One entity's view of the shared `CollisionService`.
+
+    Mirrors the `CollisionTracker` interface (`register_handler`, `set_targets`, `poll`) so
+    actors can use either interchangeably.
+    """
+
+    def __init__(self, service: "CollisionService", entity: Any) -> None:
+        self.service = service
+        self.entity = entity
+        self.events_this_step: list[CollisionEvent] = []
+        self._handlers: list[Callable[[CollisionEvent], None]] = []
+        self.tracked_entities: list[Any] = []
+        self.ignore_entities: list[Any] = []
+        # Touching targets from the service's last pass: eid -> (entity, contact count, contact
+        # force magnitudes or None when the contact buffer has no forces).
+        self._pairs: dict[int, tuple[Any, int, list[float] | None]] = {}
+        # Targets this subscriber reported as touching: eid -> (entity, last max force).
+        self._active: dict[int, tuple[Any, float]] = {}
+        self._polled_step: int | None = None
+
+    def register_handler(self, handler: Callable[[CollisionEvent], None]) -> None:
+        """Register a callback invoked for each BEGIN/END event."""
+        self._handlers.append(handler)
+
+    def set_targets(
+        self,
+        *,
+        tracked_entities: Iterable[Any] | None = None,
+        ignore_entities: Iterable[Any] | None = None,
+    ) -> None:
+        """Configure which entities count as collisions for this subscriber."""
+        self.tracked_entities = list(tracked_entities or [])
+        self.ignore_entities = list(ignore_entities or [])
+        self.service._invalidate()
+
+    def poll(self, *, step_idx: int, min_force: float = 0.0) -> list[CollisionEvent]:
+        """
+        Return this subscriber's events for `step_idx`.
+
+        The first subscriber to poll a given step runs the shared pass for everyone. With
+        `min_force > 0` only contacts at or above it count (for touching, `contact_count` and
+        `max_force`), as in `CollisionTracker`; forces are ignored when the contact buffer has
+        none. Repeated polls for the same step return the same events.
+        """
+        self.service.poll(step_idx=step_idx)
+        if self._polled_step != int(step_idx):
+            self._polled_step = int(step_idx)
+            self._diff(step_idx=int(step_idx), min_force=float(min_force))
+        return self.events_this_step
+
+    def _diff(self, *, step_idx: int, min_force: float) -> None:
+        """Emit BEGIN (then END) events, in entity-id order, against the previously touching targets."""
+        self.events_this_step = []
+        cur: dict[int, tuple[Any, int, float | None]] = {}
+        for eid, (other, count, forces) in self._pairs.items():
+            if min_force <= 0.0 or forces is None:
+                cur[eid] = (other, count, None)
+                continue
+            kept = [f for f in forces if f >= min_force]
+            if kept:
+                cur[eid] = (other, len(kept), max(kept))
+        for eid in sorted(cur.keys() - self._active.keys()):
+            other, count, mf = cur[eid]
+            self._dispatch(
+                CollisionEvent(
+                    step_idx=step_idx,
+                    phase=CollisionPhase.BEGIN,
+                    other_entity=other,
+                    other_entity_id=eid,
+                    max_force=mf,
+                    contact_count=count,
+                )
+            )
+        for eid in sorted(self._active.keys() - cur.keys()):
+            other, mf = self._active[eid]
+            self._dispatch(
+                CollisionEvent(
+                    step_idx=step_idx,
+                    phase=CollisionPhase.END,
+                    other_entity=other,
+                    other_entity_id=eid,
+                    max_force=mf,
+                    contact_count=0,
+                )
+            )
+        self._active = {eid: (other, 0.0 if mf is None else mf) for eid, (other, _, mf) in cur.items()}
+
+    def _dispatch(self, ev: CollisionEvent) -> None:
+        self.events_this_step.append(ev)
+        for h in self._handlers:
+            h(ev)
+
+
+class CollisionService:
+    """
+    Scene-level contact pass shared by all subscribed entities.
+
+    Per poll:
+    1. Fetch the global contact buffer once (rigid solver collider), falling back to per-entity
+       `get_contacts()` on Genesis versions without it.
+    2. Map both contact geoms through device lookup tables (geom -> subscriber, geom -> target)
+       and keep (subscriber, target) pairs allowed by each subscriber's tracked/ignore sets.
+    3. Copy the kept contacts to the host in one transfer: `(pair, force)` rows sorted by pair
+       when the buffer has forces, else per-pair counts from `unique`.
+    4. Hand each subscription its pairs; when it polls it counts the contacts that reach its
+       own `min_force` and diffs against the targets it reported last time.
+
+    Batched scenes are reduced over env 0 only.
+    """
+
+    def __init__(self, sim: Any) -> None:
+        self.sim = sim
+        self._subs: list[CollisionSubscription] = []
+        self._by_entity: dict[int, CollisionSubscription] = {}
+        self._last_step: int | None = None
+        self._topology: dict[str, Any] | None = None
+        self._device_state: dict[str, Any] | None = None
+
+    @property
+    def subscriptions(self) -> tuple[CollisionSubscription, ...]:
+        return tuple(self._subs)
+
+    def subscribe(self, entity: Any) -> CollisionSubscription:
+        """Return the subscription for `entity` (created on first use)."""
+        sub = self._by_entity.get(id(entity))
+        if sub is None:
+            sub = CollisionSubscription(self, entity)
+            self._subs.append(sub)
+            self._by_entity[id(entity)] = sub
+            self._invalidate()
+        return sub
+
+    def clear(self) -> None:
+        """Drop all subscriptions (e.g. when the scene is rebuilt)."""
+        self._subs.clear()
+        self._by_entity.clear()
+        self._last_step = None
+        self._invalidate()
+
+    def _invalidate(self) -> None:
+        self._topology = None
+        self._device_state = None
+
+    # ----------------------------
+    # Topology (rebuilt lazily when subscriptions/targets change)
+    # ----------------------------
+    def _build_topology(self, torch: Any) -> dict[str, Any]:
+        targets: list[tuple[int, Any]] = []
+        target_index: dict[int, int] = {}
+        target_ranges: list[tuple[int, int, int]] = []
+        owner_ranges: list[tuple[int, int, int]] = []
+        allowed_pairs: list[tuple[int, int]] = []
+        n_geoms = 1
+
+        for s, sub in enumerate(self._subs):
+            r = geom_range(sub.entity)
+            if r is None:
+                continue
+            owner_ranges.append((r[0], r[1], s))
+            n_geoms = max(n_geoms, r[1])
+
+            ignored = {id(e) for e in sub.ignore_entities}
+            for ent in sub.tracked_entities:
+                eid = id(ent)
+                if eid in ignored:
+                    continue
+                t = target_index.get(eid)
+                if t is None:
+                    tr = geom_range(ent)
+                    if tr is None:
+                        continue
+                    t = len(targets)
+                    target_index[eid] = t
+                    targets.append((eid, ent))
+                    target_ranges.append((tr[0], tr[1], t))
+                    n_geoms = max(n_geoms, tr[1])
+                allowed_pairs.append((s, t))
+
+        owner_lut = torch.full((n_geoms,), -1, dtype=torch.long)
+        for g0, g1, s in owner_ranges:
+            owner_lut[g0:g1] = s
+        target_lut = torch.full((n_geoms,), -1, dtype=torch.long)
+        for g0, g1, t in target_ranges:
+            target_lut[g0:g1] = t
+
+        n_targets = max(1, len(targets))
+        allowed = torch.zeros(len(self._subs) * n_targets, dtype=torch.bool)
+        if allowed_pairs:
+            keys = torch.tensor([s * n_targets + t for s, t in allowed_pairs], dtype=torch.long)
+            allowed[keys] = True
+
+        return {
+            "targets": targets,
+            "n_targets": n_targets,
+            "owner_lut": owner_lut,
+            "target_lut": target_lut,
+            "allowed": allowed,
+            "any_pairs": bool(allowed_pairs),
+        }
+
+    def _device_tables(self, device: Any) -> dict[str, Any]:
+        topo = self._topology
+        assert topo is not None
+        st = self._device_state
+        if st is None or st["device"] != device:
+            st = {
+                "device": device,
+                "owner_lut": topo["owner_lut"].to(device),
+                "target_lut": topo["target_lut"].to(device),
+                "allowed": topo["allowed"].to(device),
+            }
+            self._device_state = st
+        return st
+
+    # ----------------------------
+    # Contacts
+    # ----------------------------
+    def _fetch_contacts(self, torch: Any, *, with_force: bool) -> tuple[Any, Any, Any, Any, Any] | None:
+        """Return `(geom_a, geom_b, force_a, force_b, source)`; `source` is None for the global buffer."""
+        solver = self.sim._rigid_solver() if hasattr(self.sim, "_rigid_solver") else None
+        collider = getattr(solver, "collider", None)
+        if collider is not None and hasattr(collider, "get_contacts"):
+            try:
+                contacts = collider.get_contacts(as_tensor=True, to_torch=True)
+            except TypeError:
+                contacts = collider.get_contacts()
+            parsed = _parse_contacts(contacts, with_force=with_force)
+            if parsed is not None:
+                return (*parsed, None)
+
+        # Fallback: per-subscriber contacts, tagged with their source so pairs are not double counted.
+        parts: list[tuple[Any, Any, Any, Any, Any]] = []
+        for s, sub in enumerate(self._subs):
+            if not hasattr(sub.entity, "get_contacts"):
+                continue
+            parsed = _parse_contacts(sub.entity.get_contacts(), with_force=with_force)
+            if parsed is None:
+                continue
+            ga, gb, fa, fb = parsed
+            parts.append((ga, gb, fa, fb, torch.full_like(ga, s, dtype=torch.long)))
+        if not parts:
+            return None
+        has_force = with_force and all(p[2] is not None and p[3] is not None for p in parts)
+        fa = torch.cat([p[2] for p in parts]) if has_force else None
+        fb = torch.cat([p[3] for p in parts]) if has_force else None
+        return (
+            torch.cat([p[0] for p in parts]),
+            torch.cat([p[1] for p in parts]),
+            fa,
+            fb,
+            torch.cat([p[4] for p in parts]),
+        )
+
+    def warmup(self) -> None:
+        """Fetch the contact buffer once so its kernels are compiled (no events are routed)."""
+        torch = _import_torch_optional()
+        if torch is not None:
+            self._fetch_contacts(torch, with_force=True)
+
+    # ----------------------------
+    # Polling
+    # ----------------------------
+    def poll(self, *, step_idx: int) -> None:
+        """Run the shared contact pass for `step_idx` (no-op if it already ran for this step)."""
+        if self._last_step == int(step_idx):
+            return
+        self._last_step = int(step_idx)
+        for sub in self._subs:
+            sub._pairs = {}
+        if not self._subs:
+            return
+        with self.sim.profiler.phase("contacts"):
+            self._poll()
+
+    def _poll(self) -> None:
+        torch = _import_torch_optional()
+        if torch is None:
+            return
+        if self._topology is None:
+            self._topology = self._build_topology(torch)
+        topo = self._topology
+        if not topo["any_pairs"]:
+            return
+
+        fetched = self._fetch_contacts(torch, with_force=True)
+        if fetched is None:
+            return
+        geom_a, geom_b, force_a, force_b, source = fetched
+        with_force = force_a is not None and force_b is not None
+        st = self._device_tables(geom_a.device)
+        n_targets = int(topo["n_targets"])
+        owner_lut, target_lut, allowed = st["owner_lut"], st["target_lut"], st["allowed"]
+        n_lut = int(owner_lut.shape[0])
+
+        def lookup(lut: Any, g: Any) -> Any:
+            v = lut[g.clamp(0, n_lut - 1)]
+            return torch.where((g >= 0) & (g < n_lut), v, torch.full_like(v, -1))
+
+        ga = geom_a.long()
+        gb = geom_b.long()
+        keys_parts = []
+        force_parts = []
+        # Both orientations: subscriber on side A vs target on B, and vice versa.
+        for g_self, g_other, f_self in ((ga, gb, force_a), (gb, ga, force_b)):
+            owner = lookup(owner_lut, g_self)
+            target = lookup(target_lut, g_other)
+            ok = (owner >= 0) & (target >= 0)
+            if source is not None:
+                ok = ok & (owner == source)
+            key = owner.clamp(min=0) * n_targets + target.clamp(min=0)
+            ok = ok & allowed[key]
+            if with_force:
+                fmag = torch.linalg.vector_norm(f_self, dim=-1).float()
+                force_parts.append(fmag[ok])
+            keys_parts.append(key[ok])
+
+        keys = torch.cat(keys_parts)
+        if with_force:
+            # Contact-level rows, so each subscriber can count those reaching its own min_force.
+            order = torch.argsort(keys)
+            packed = torch.stack([keys[order].double(), torch.cat(force_parts)[order].double()])
+        else:
+            cur_keys, counts = torch.unique(keys, sorted=True, return_counts=True)
+            packed = torch.stack([cur_keys.double(), counts.double()])
+        # One host transfer: rows are (key, force) per contact, or (key, count) per pair.
+        self.sim.profiler.d2h(packed)
+        self._route(rows=packed.cpu().t().tolist(), topo=topo, with_force=with_force)
+
+    def _route(self, *, rows: list[list[float]], topo: dict[str, Any], with_force: bool) -> None:
+        n_targets = int(topo["n_targets"])
+        targets = topo["targets"]
+        forces: dict[int, list[float]] = {}
+        for key_f, value in rows:
+            key = int(key_f)
+            if with_force:
+                forces.setdefault(key, []).append(value)
+                continue
+            s, t = divmod(key, n_targets)
+            eid, other = targets[t]
+            self._subs[s]._pairs[eid] = (other, int(value), None)
+        for key, fs in forces.items():
+            s, t = divmod(key, n_targets)
+            eid, other = targets[t]
+            self._subs[s]._pairs[eid] = (other, len(fs), fs)
+
+
+def _parse_contacts(contacts: Any, *, with_force: bool) -> tuple[Any, Any, Any, Any] | None:
+    """Normalize a Genesis contacts dict to flat `(geom_a, geom_b, force_a, force_b)` tensors."""
+    if not isinstance(contacts, dict):
+        return None
+    ga = contacts.get("geom_a")
+    gb = contacts.get("geom_b")
+    if ga is None or gb is None or not hasattr(ga, "shape"):
+        return None
+    fa = contacts.get("force_a") if with_force else None
+    fb = contacts.get("force_b") if with_force else None
+    if fa is None or fb is None:
+        # Forces are optional: without them pairs are reported unfiltered.
+        fa = fb = None
+
+    if ga.dim() > 1:
+        # Batched scene: [n_envs, max_contacts] with a validity mask; reduce env 0.
+        valid = contacts.get("valid_mask")
+        ga, gb = ga[0], gb[0]
+        fa = fa[0] if fa is not None else None
+        fb = fb[0] if fb is not None else None
+        if valid is not None:
+            m = valid[0]
+            ga, gb = ga[m], gb[m]
+            fa = fa[m] if fa is not None else None
+            fb = fb[m] if fb is not None else None
+    return ga, gb, fa, fb
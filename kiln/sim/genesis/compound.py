@@ -0,0 +1,96 @@
+from __future__ import annotations
+
+"""
+Static compound entities for env bundles.
+
+Every `scene.add_entity` call adds a link, its geoms and their solver state, so a city block of
+thousands of fixed buildings loaded one entity per primitive bloats both the solver and
+`build()` time. Fixed primitives never move, so they can instead be written as geoms of a single
+fixed MJCF body and added as one entity: each geom keeps its exact convex primitive shape for
+collision and its own color, only the entity count changes.
+
+Files are named by a hash of their contents, so reloading the same bundle reuses the same file
+(and the same scene topology key for the kernel cache).
+"""
+
+import hashlib
+import math
+import os
+from pathlib import Path
+from typing import Any, Sequence
+from xml.etree.ElementTree import Element, SubElement, tostring
+
+# Primitive shapes that can become geoms of a static compound (planes stay separate entities).
+COMPOUND_SHAPES = ("box", "sphere", "cylinder")
+
+
+def _fmt(v: float) -> str:
+    return f"{float(v):.9g}"
+
+
+def _rgba(color: Sequence[float] | None) -> str:
+    if not color:
+        return "0.5 0.5 0.5 1"
+    c = [float(v) for v in color]
+    if max(c) > 1.0:
+        c = [v / 255.0 for v in c]
+    if len(c) == 3:
+        c.append(1.0)
+    return " ".join(_fmt(v) for v in c)
+
+
+def _geom_size(prim: Any) -> str:
+    # MJCF sizes: box half-extents, sphere radius, cylinder radius + half-height (local z axis).
+    if prim.shape == "box":
+        if prim.size is None:
+            raise ValueError(f"Missing size for box: {prim.id}")
+        return " ".join(_fmt(0.5 * float(v)) for v in prim.size)
+    if prim.radius is None:
+        raise ValueError(f"Missing radius for {prim.shape}: {prim.id}")
+    if prim.shape == "sphere":
+        return _fmt(prim.radius)
+    if prim.height is None:
+        raise ValueError(f"Missing height for cylinder: {prim.id}")
+    return f"{_fmt(prim.radius)} {_fmt(0.5 * float(prim.height))}"
+
+
+def can_merge(prim: Any) -> bool:
+    """True if `prim` (a `PrimitiveSpec`) can become a geom of a static compound."""
+    return prim.shape in COMPOUND_SHAPES and (prim.fixed is None or bool(prim.fixed))
+
+
+def static_compound_mjcf(prims: Sequence[Any], *, name: str = "kiln_static") -> str:
+    """MJCF document with one fixed body holding one geom per primitive (in order)."""
+    root = Element("mujoco", model=name)
+    worldbody = SubElement(root, "worldbody")
+    body = SubElement(worldbody, "body", name=name, pos="0 0 0")
+    for i, p in enumerate(prims):
+        if not can_merge(p):
+            raise ValueError(f"Primitive {p.id!r} ({p.shape}, fixed={p.fixed}) cannot be merged")
+        q = [float(v) for v in p.pose.quat]
+        n = math.sqrt(sum(v * v for v in q)) or 1.0
+        SubElement(
+            body,
+            "geom",
+            name=f"g{i}",
+            type=p.shape,
+            size=_geom_size(p),
+            pos=" ".join(_fmt(v) for v in p.pose.pos),
+            quat=" ".join(_fmt(v / n) for v in q),
+            rgba=_rgba(p.color),
+        )
+    return tostring(root, encoding="unicode")
+
+
+def write_static_compound(prims: Sequence[Any], directory: str | Path, *, name: str = "kiln_static") -> Path:
+    """Write `static_compound_mjcf(prims)` under `directory` as `<content hash>.xml` (atomic, reused)."""
+    text = static_compound_mjcf(prims, name=name)
+    digest = hashlib.sha256(text.encode("utf-8")).hexdigest()[:32]
+    directory = Path(directory)
+    directory.mkdir(parents=True, exist_ok=True)
+    path = directory / f"{digest}.xml"
+    if not path.exists():
+        tmp = path.with_suffix(f".{os.getpid()}.tmp")
+        tmp.write_text(text, encoding="utf-8")
+        os.replace(tmp, path)
+    return path
@@ -0,0 +1,92 @@
+from __future__ import annotations
+
+"""
+Per-entity accessor handles for the Genesis adapter.
+
+Genesis renamed entity accessors across versions (`get_pos` / `get_position`, a `pos`
+attribute, `set_dofs_velocity` / `control_dofs_velocity`, ...). `resolve_entity_handle` probes
+an entity once and binds the callables that work, so per-step calls skip the `hasattr` chains.
+"""
+
+from typing import Any, Callable, Sequence
+
+
+def _vec3(v: Any) -> tuple[float, float, float]:
+    """First three components of a position value as floats (env 0 of batched tensors)."""
+    if hasattr(v, "detach"):
+        # Torch tensor: pick env 0 on device, then one host transfer for all components.
+        t = v.detach()
+        if t.ndim == 2:
+            t = t[0]
+        x, y, z = t[:3].tolist()
+        return (float(x), float(y), float(z))
+    if getattr(v, "ndim", 1) == 2:
+        v = v[0]
+    return (float(v[0]), float(v[1]), float(v[2]))
+
+
+def _first_method(entity: Any, names: Sequence[str]) -> Callable[..., Any] | None:
+    for name in names:
+        fn = getattr(entity, name, None)
+        if fn is not None:
+            return fn
+    return None
+
+
+def _position_reader(entity: Any) -> Callable[[], tuple[float, float, float]] | None:
+    # Same precedence as the original probing: a readable position attribute, then a getter.
+    for attr in ("position", "pos"):
+        if hasattr(entity, attr):
+            try:
+                _vec3(getattr(entity, attr))
+            except Exception:
+                continue
+            return lambda: _vec3(getattr(entity, attr))
+    getter = _first_method(entity, ("get_position", "get_pos"))
+    if getter is not None:
+        return lambda: _vec3(getter())
+    return None
+
+
+class EntityHandle:
+    """
+    Accessors bound once for one entity (None where this Genesis version has none).
+
+    Attributes:
+        entity: The wrapped entity.
+        read_position: `() -> (x, y, z)` base position (env 0 in batched scenes).
+        set_position: Position setter.
+        set_dofs_velocity: Base DoF velocity setter (`set_dofs_velocity`, falling back to
+            `control_dofs_velocity`).
+        control_dofs_force: Base DoF force setter.
+    """
+
+    __slots__ = ("entity", "read_position", "set_position", "set_dofs_velocity", "control_dofs_force")
+
+    def __init__(
+        self,
+        entity: Any,
+        *,
+        read_position: Callable[[], tuple[float, float, float]] | None,
+        set_position: Callable[..., Any] | None,
+        set_dofs_velocity: Callable[..., Any] | None,
+        control_dofs_force: Callable[..., Any] | None,
+    ) -> None:
+        self.entity = entity
+        self.read_position = read_position
+        self.set_position = set_position
+        self.set_dofs_velocity = set_dofs_velocity
+        self.control_dofs_force = control_dofs_force
+
+
+def resolve_entity_handle(entity: Any) -> EntityHandle:
+    """Probe `entity`'s accessors once (call after `scene.build()` so tensors are live)."""
+    # NOTE: In Genesis 0.3.x, `control_dofs_velocity()` does not appear to move free rigid
+    # bodies (it's intended for articulated/actuated control), so `set_dofs_velocity()` wins.
+    return EntityHandle(
+        entity,
+        read_position=_position_reader(entity),
+        set_position=_first_method(entity, ("set_position", "set_pos")),
+        set_dofs_velocity=_first_method(entity, ("set_dofs_velocity", "control_dofs_velocity")),
+        control_dofs_force=_first_method(entity, ("control_dofs_force",)),
+    )
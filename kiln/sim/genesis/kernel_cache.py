@@ -0,0 +1,94 @@
+from __future__ import annotations
+
+"""
+Persistent compiled-kernel cache for the Genesis adapter.
+
+Taichi (under Genesis) JIT-compiles every kernel on first use, which costs each new process
+tens of seconds. Pointing Taichi's offline cache and Genesis' own cache at a shared directory
+lets later processes load compiled kernels instead. The directory is namespaced by Genesis
+version and backend (kernels are not portable across either); inside it, Taichi keys kernels
+by their content. Per-scene markers keyed by a topology hash record which scenes were already
+built (and warmed up) with this cache, so `runtime_info()` can report whether a topology was seen
+before. A marker says nothing about whether Taichi actually reused kernels (its cache may have been
+wiped or disabled since); the measured `warmup()` times are the signal for that.
+"""
+
+import hashlib
+import json
+import os
+from pathlib import Path
+import re
+import time
+from typing import Any, Sequence
+
+# Env vars read by Taichi / Genesis when they initialize (must be set before `gs.init()`).
+_TAICHI_CACHE_ENV = "TI_OFFLINE_CACHE"
+_TAICHI_CACHE_PATH_ENV = "TI_OFFLINE_CACHE_FILE_PATH"
+_GENESIS_CACHE_PATH_ENV = "GS_CACHE_FILE_PATH"
+
+
+def genesis_version() -> str:
+    """Installed Genesis version without importing it ("unknown" if not installed)."""
+    from importlib import metadata
+
+    for dist in ("genesis-world", "genesis"):
+        try:
+            return metadata.version(dist)
+        except metadata.PackageNotFoundError:
+            continue
+    return "unknown"
+
+
+def file_digest(path: str | Path) -> str:
+    """sha256 of a file's bytes (identifies geometry assets in topology keys)."""
+    h = hashlib.sha256()
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(1 << 20), b""):
+            h.update(chunk)
+    return h.hexdigest()
+
+
+def topology_hash(records: Sequence[Any], *, n_envs: int, substeps: int) -> str:
+    """Stable content hash of a scene's entity records plus the build options kernels depend on."""
+    payload = json.dumps({"entities": list(records), "n_envs": int(n_envs), "substeps": int(substeps)}, default=repr)
+    return hashlib.sha256(payload.encode("utf-8")).hexdigest()[:32]
+
+
+class KernelCache:
+    """
+    One `<root>/<genesis-version>-<backend>/` cache namespace.
+
+    Attributes:
+        root: Top-level cache directory (shared between jobs).
+        key: Namespace name derived from Genesis version and backend.
+        dir: `root / key`; Taichi kernels live in `dir / "taichi"`, Genesis data in `dir / "genesis"`.
+    """
+
+    def __init__(self, root: str | Path, *, backend: str | None, version: str | None = None) -> None:
+        self.root = Path(root).expanduser()
+        raw = f"genesis-{version or genesis_version()}-{(backend or 'default').strip().lower()}"
+        self.key = re.sub(r"[^A-Za-z0-9._-]+", "_", raw)
+        self.dir = self.root / self.key
+
+    def configure_env(self) -> None:
+        """Point Taichi's offline cache and Genesis' cache at this namespace (call before `gs.init()`)."""
+        for sub in ("taichi", "genesis", "scenes"):
+            (self.dir / sub).mkdir(parents=True, exist_ok=True)
+        os.environ[_TAICHI_CACHE_ENV] = "1"
+        os.environ[_TAICHI_CACHE_PATH_ENV] = str(self.dir / "taichi")
+        os.environ[_GENESIS_CACHE_PATH_ENV] = str(self.dir / "genesis")
+
+    def _marker(self, topology: str) -> Path:
+        return self.dir / "scenes" / f"{topology}.json"
+
+    def scene_seen_before(self, topology: str) -> bool:
+        """True if a scene with this topology was built with this cache before (not a kernel hit)."""
+        return self._marker(topology).exists()
+
+    def record_scene(self, topology: str, **info: Any) -> None:
+        """Mark `topology` as compiled (atomic write, safe with concurrent workers)."""
+        path = self._marker(topology)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        tmp = path.with_suffix(f".{os.getpid()}.tmp")
+        tmp.write_text(json.dumps({"recorded_at": time.time(), **info}, default=repr), encoding="utf-8")
+        os.replace(tmp, path)
@@ -0,0 +1,178 @@
+from __future__ import annotations
+
+"""
+Pipelined stepping for `GenesisSim`.
+
+The plain loop is strictly serial: snapshot -> policy -> control -> `sim.step()` -> collisions
+-> render, so the device idles while Python computes policies and Python waits while the device
+steps. `PipelinedRunner` overlaps the two: physics step N (plus collision polling and camera
+capture observers) runs on a worker thread while the main thread computes the actions for step
+N+1 from the snapshot taken before step N. Actions therefore take effect one step later than in
+the serial loop (`action_latency=1`); `action_latency=0` runs the serial loop unchanged.
+"""
+
+from concurrent.futures import Future, ThreadPoolExecutor
+from dataclasses import dataclass
+import time
+from typing import Any, Callable
+
+PolicyFn = Callable[[Any, int], None]
+ControlFn = Callable[[int], None]
+ObserverFn = Callable[[int], None]
+
+
+@dataclass(frozen=True)
+class PipelineConfig:
+    """
+    Attributes:
+        action_latency: 1 overlaps policy work with the previous physics step (actions are
+            computed from a one-step-old snapshot); 0 keeps the serial order.
+    """
+
+    action_latency: int = 1
+
+
+class _Observer:
+    __slots__ = ("fn", "every")
+
+    def __init__(self, fn: ObserverFn, every: int) -> None:
+        self.fn = fn
+        self.every = every
+
+
+def _default_control(sim: Any) -> ControlFn:
+    # Lazy import: `kiln.sim` does not depend on `kiln.actors` at import time.
+    from kiln.actors import step_control_all
+
+    dt = float(sim.config.dt)
+    return lambda step_idx: step_control_all(sim, dt)
+
+
+def _owned(snapshot: Any) -> Any:
+    # `PositionSnapshot`s can view a reused host buffer that worker-side readbacks refill.
+    copy = getattr(snapshot, "copy", None)
+    return copy() if callable(copy) else snapshot
+
+
+class PipelinedRunner:
+    """
+    Reusable step loop that overlaps `sim.step()` with Python policy work.
+
+    Per `step()` (with `action_latency=1`):
+    1. Take `sim.snapshot()` (the worker is idle, so this is the state after the last step).
+    2. Submit physics step N and its observers (collision polling, camera capture) to the worker.
+    3. Run `policy(snapshot, N + 1)` on the calling thread.
+    4. Join the worker, then run `control(N + 1)` to write the next step's controls.
+
+    The first call primes the pipeline by running policy and control for step 0 before any
+    physics. The snapshot is copied before the worker starts, since observers may read positions
+    into the same readback buffer. `policy` must only read the snapshot and actor-side state
+    (e.g. `apply_action`); anything that touches the scene belongs in `control` or in an
+    observer. Observers run on the worker in registration order, right after their physics step
+    and before the next one.
+
+    Args:
+        sim: A built `GenesisSim` (anything with `snapshot()` and `step()`).
+        policy: `(snapshot, step_idx) -> None`; decides and applies actions for `step_idx`.
+        control: `(step_idx) -> None`; pushes controls to the sim. Defaults to
+            `kiln.actors.step_control_all(sim, sim.config.dt)`.
+        config: Pipeline options.
+    """
+
+    def __init__(
+        self,
+        sim: Any,
+        policy: PolicyFn,
+        *,
+        control: ControlFn | None = None,
+        config: PipelineConfig | None = None,
+    ) -> None:
+        self.sim = sim
+        self.policy = policy
+        self.control = control if control is not None else _default_control(sim)
+        self.config = config or PipelineConfig()
+        if self.config.action_latency not in (0, 1):
+            raise ValueError(f"action_latency must be 0 or 1, got {self.config.action_latency!r}")
+        self._observers: list[_Observer] = []
+        self._executor: ThreadPoolExecutor | None = None
+        self._primed = False
+        self.step_idx = 0
+        self.stats: dict[str, float] = {"steps": 0, "policy_s": 0.0, "control_s": 0.0, "wait_s": 0.0}
+
+    # ----------------------------
+    # Setup
+    # ----------------------------
+    def add_observer(self, fn: ObserverFn, *, every: int = 1) -> None:
+        """Call `fn(step_idx)` after every `every`-th physics step (on the worker thread)."""
+        self._observers.append(_Observer(fn, max(1, int(every))))
+
+    def close(self) -> None:
+        """Stop the worker thread (any in-flight step is finished first)."""
+        if self._executor is not None:
+            self._executor.shutdown(wait=True)
+            self._executor = None
+
+    def __enter__(self) -> "PipelinedRunner":
+        return self
+
+    def __exit__(self, *exc: object) -> None:
+        self.close()
+
+    # ----------------------------
+    # Stepping
+    # ----------------------------
+    def _worker(self) -> ThreadPoolExecutor:
+        if self._executor is None:
+            # One worker keeps every scene access (step, contacts, rendering) serialized.
+            self._executor = ThreadPoolExecutor(max_workers=1, thread_name_prefix="kiln-physics")
+        return self._executor
+
+    def _physics(self, step_idx: int) -> None:
+        self.sim.step()
+        for obs in self._observers:
+            if step_idx % obs.every == 0:
+                obs.fn(step_idx)
+
+    def _decide(self, snapshot: Any, step_idx: int) -> None:
+        t0 = time.perf_counter()
+        self.policy(snapshot, step_idx)
+        t1 = time.perf_counter()
+        self.control(step_idx)
+        t2 = time.perf_counter()
+        self.stats["policy_s"] += t1 - t0
+        self.stats["control_s"] += t2 - t1
+
+    def step(self) -> None:
+        """Advance the simulation by one step."""
+        idx = self.step_idx
+        if self.config.action_latency == 0:
+            self._decide(self.sim.snapshot(), idx)
+            self._physics(idx)
+        else:
+            snapshot = _owned(self.sim.snapshot())
+            if not self._primed:
+                self._decide(snapshot, idx)
+                self._primed = True
+            fut: Future[None] = self._worker().submit(self._physics, idx)
+            t0 = time.perf_counter()
+            try:
+                self.policy(snapshot, idx + 1)
+            except BaseException:
+                # Never leave the worker stepping the scene behind the caller's back.
+                fut.exception()
+                raise
+            t1 = time.perf_counter()
+            fut.result()
+            t2 = time.perf_counter()
+            self.control(idx + 1)
+            t3 = time.perf_counter()
+            self.stats["policy_s"] += t1 - t0
+            self.stats["wait_s"] += t2 - t1
+            self.stats["control_s"] += t3 - t2
+        self.step_idx = idx + 1
+        self.stats["steps"] += 1
+
+    def run(self, n: int) -> None:
+        """Advance the simulation by `n` steps."""
+        for _ in range(int(n)):
+            self.step()
@@ -0,0 +1,508 @@
+from __future__ import annotations
+
+"""
+Multi-process env pool for CPU scaling.
+
+`EnvPool` starts one worker process per env. Each worker loads the same env bundle through
+`GenesisSim.load_env_bundle` and runs an `EnvTask` (action -> step -> reward/obs). Actions
+and results move through one shared-memory block laid out as `ring_depth`-slot ring buffers,
+so nothing is pickled per step: the parent writes actions into the ring, posts a per-worker
+semaphore, and reads observations back as numpy views of the same memory.
+
+Workers auto-reset: when an episode terminates or hits `max_episode_steps`, the worker writes
+the last observation to `final_obs`, resets, and returns the new episode's first observation
+in `obs` (with `terminated` / `truncated` set for that step).
+"""
+
+from collections import deque
+from contextlib import contextmanager
+from dataclasses import dataclass, field, replace
+import multiprocessing as mp
+from multiprocessing import shared_memory
+import os
+import traceback
+from typing import Any, Iterator, Sequence
+
+import numpy as np
+
+from .sim import GenesisSim, GenesisSimConfig
+
+# Per-slot command codes (`cmd` ring).
+CMD_STEP = 0
+CMD_RESET = 1
+CMD_CLOSE = 2
+
+# Thread-pool env vars pinned to `threads_per_worker` in every worker (avoids N x cores oversubscription).
+_THREAD_ENV_VARS = ("OMP_NUM_THREADS", "MKL_NUM_THREADS", "OPENBLAS_NUM_THREADS", "NUMEXPR_NUM_THREADS")
+
+
+class EnvTask:
+    """
+    Per-worker task logic run by `EnvPool`.
+
+    The default task drives every non-fixed bundle primitive: actions are `[n_bodies, 6]` base
+    DoF velocities and observations are `[n_bodies, 3]` base positions (env 0). Subclass and
+    override the hooks for other tasks; instances must be picklable (they are sent to workers).
+    """
+
+    def body_ids(self, bundle: Any) -> list[str]:
+        """Ids of the bundle primitives the default task controls and observes."""
+        return [p.id for p in bundle.primitives if p.fixed is False and p.shape != "plane"]
+
+    def shapes(self, bundle: Any) -> tuple[tuple[int, ...], tuple[int, ...]]:
+        """`(obs_shape, act_shape)` for one env; called in the parent from the parsed bundle."""
+        n = len(self.body_ids(bundle))
+        return (n, 3), (n, 6)
+
+    def load(self, bundle_dir: str, sim_config: GenesisSimConfig) -> tuple[Any, Any]:
+        """Create the worker's sim and load the bundle (returns `(sim, loaded_bundle)`)."""
+        sim = GenesisSim(sim_config)
+        loaded = sim.load_env_bundle(bundle_dir)
+        # Compile step/contact/raycast kernels before reporting ready (fast with `kernel_cache_dir`).
+        sim.warmup()
+        return sim, loaded
+
+    def setup(self, sim: Any, loaded: Any) -> None:
+        """One-time per-worker setup after `load`."""
+        self.bodies = [loaded.entities_by_id[i] for i in self.body_ids(loaded.bundle)]
+
+    def reset(self, sim: Any, loaded: Any, rng: np.random.Generator) -> None:
+        """Start a new episode (default: restore the post-build state with `sim.reset()`)."""
+        sim.reset()
+
+    def act(self, sim: Any, action: np.ndarray) -> None:
+        """Apply one env's action (a view into the shared action ring)."""
+        if self.bodies:
+            sim.set_dofs_velocity_batch(self.bodies, action)
+
+    def observe(self, sim: Any, out: np.ndarray) -> None:
+        """Write one env's observation into `out` (a view into the shared observation ring)."""
+        if self.bodies:
+            snap = sim.get_positions(self.bodies)
+            out[...] = snap.positions[0] if snap.positions.ndim == 3 else snap.positions
+
+    def reward(self, sim: Any) -> float:
+        return 0.0
+
+    def terminated(self, sim: Any) -> bool:
+        return False
+
+
+@dataclass(frozen=True)
+class EnvPoolConfig:
+    """
+    Attributes:
+        bundle_dir: Env bundle directory loaded by every worker.
+        num_envs: Number of worker processes (one env each).
+        sim: Sim config for every worker (`seed` is offset by the worker rank).
+        max_episode_steps: Steps before an episode is truncated and auto-reset (0 = never).
+        ring_depth: Slots per env in the shared rings, i.e. how many `send`s may be in flight
+            before a `recv`. Results returned by `recv` stay valid for `ring_depth - 1` more sends.
+        start_method: multiprocessing start method ("spawn" is the safe default with Genesis).
+        pin_cpus: Pin worker `i` to the `i`-th available CPU (Linux only).
+        threads_per_worker: Value for the OpenMP/BLAS thread-count env vars in workers.
+        startup_timeout: Seconds to wait for every worker to load the bundle.
+    """
+
+    bundle_dir: str
+    num_envs: int
+    sim: GenesisSimConfig = field(default_factory=lambda: GenesisSimConfig(backend="cpu"))
+    max_episode_steps: int = 1000
+    ring_depth: int = 2
+    start_method: str = "spawn"
+    pin_cpus: bool = True
+    threads_per_worker: int = 1
+    startup_timeout: float = 600.0
+
+
+@dataclass(frozen=True)
+class EnvPoolResult:
+    """
+    Results of one `send` batch, as `[len(env_ids), ...]` arrays.
+
+    When the batch covers every env in order, the arrays are zero-copy views into the shared
+    ring; otherwise they are gathered copies.
+    """
+
+    env_ids: np.ndarray
+    obs: np.ndarray
+    reward: np.ndarray
+    terminated: np.ndarray
+    truncated: np.ndarray
+    # Last observation of the finished episode (only meaningful where terminated | truncated).
+    final_obs: np.ndarray
+    elapsed_steps: np.ndarray
+
+
+class _RingLayout:
+    """Byte layout of the shared block: `[ring_depth, num_envs, ...]` arrays packed back to back."""
+
+    def __init__(self, ring_depth: int, num_envs: int, obs_shape: tuple[int, ...], act_shape: tuple[int, ...]) -> None:
+        lead = (ring_depth, num_envs)
+        self.fields: list[tuple[str, tuple[int, ...], np.dtype, int]] = []
+        offset = 0
+        for name, shape, dtype in (
+            ("actions", lead + act_shape, np.float64),
+            ("obs", lead + obs_shape, np.float64),
+            ("final_obs", lead + obs_shape, np.float64),
+            ("reward", lead, np.float64),
+            ("elapsed_steps", lead, np.int64),
+            ("cmd", lead, np.int8),
+            ("terminated", lead, np.bool_),
+            ("truncated", lead, np.bool_),
+            ("failed", lead, np.bool_),
+        ):
+            dt = np.dtype(dtype)
+            offset = -(-offset // 64) * 64  # cache-line align each array
+            self.fields.append((name, shape, dt, offset))
+            offset += int(np.prod(shape, dtype=np.int64)) * dt.itemsize
+        self.nbytes = max(1, offset)
+
+    def views(self, buf: Any) -> dict[str, np.ndarray]:
+        return {name: np.ndarray(shape, dtype=dt, buffer=buf, offset=off) for name, shape, dt, off in self.fields}
+
+
+@contextmanager
+def _worker_env(threads: int) -> Iterator[None]:
+    # Spawned children inherit os.environ at start(); set thread limits before they import numpy.
+    saved = {k: os.environ.get(k) for k in _THREAD_ENV_VARS}
+    try:
+        for k in _THREAD_ENV_VARS:
+            os.environ[k] = str(max(1, int(threads)))
+        yield
+    finally:
+        for k, v in saved.items():
+            if v is None:
+                os.environ.pop(k, None)
+            else:
+                os.environ[k] = v
+
+
+def _attach_shared(name: str) -> shared_memory.SharedMemory:
+    """Attach to the parent's block without registering it with this process' resource tracker."""
+    try:
+        return shared_memory.SharedMemory(name=name, track=False)  # type: ignore[call-arg]  # Python 3.13+
+    except TypeError:
+        shm = shared_memory.SharedMemory(name=name)
+        # The parent owns (and unlinks) the block; a second registration makes the tracker
+        # unlink or warn about it when the worker exits.
+        from multiprocessing import resource_tracker
+
+        try:
+            resource_tracker.unregister(shm._name, "shared_memory")  # type: ignore[attr-defined]
+        except Exception:
+            pass
+        return shm
+
+
+def _worker_main(
+    rank: int,
+    config: EnvPoolConfig,
+    task: EnvTask,
+    layout: _RingLayout,
+    shm_name: str,
+    cpu: int | None,
+    req: Any,
+    res: Any,
+    errors: Any,
+) -> None:
+    if cpu is not None and hasattr(os, "sched_setaffinity"):
+        try:
+            os.sched_setaffinity(0, {cpu})
+        except OSError:
+            pass
+    shm = _attach_shared(shm_name)
+    try:
+        ring = layout.views(shm.buf)
+        cmd, obs, final_obs = ring["cmd"], ring["obs"], ring["final_obs"]
+        depth = cmd.shape[0]
+        try:
+            seed = config.sim.seed
+            sim_config = config.sim if seed is None else replace(config.sim, seed=int(seed) + rank)
+            sim, loaded = task.load(config.bundle_dir, sim_config)
+            task.setup(sim, loaded)
+            rng = np.random.default_rng(None if seed is None else int(seed) + rank)
+            task.reset(sim, loaded, rng)
+        except BaseException:
+            ring["failed"][0, rank] = True
+            errors.put((rank, traceback.format_exc()))
+            res.release()
+            return
+        res.release()  # ready
+
+        k = 0
+        elapsed = 0
+        max_steps = int(config.max_episode_steps)
+        while True:
+            req.acquire()
+            s = k % depth
+            k += 1
+            c = int(cmd[s, rank])
+            if c == CMD_CLOSE:
+                res.release()
+                return
+            try:
+                terminated = truncated = False
+                reward = 0.0
+                if c == CMD_RESET:
+                    task.reset(sim, loaded, rng)
+                    elapsed = 0
+                    task.observe(sim, obs[s, rank])
+                else:
+                    task.act(sim, ring["actions"][s, rank])
+                    sim.step()
+                    elapsed += 1
+                    reward = float(task.reward(sim))
+                    terminated = bool(task.terminated(sim))
+                    truncated = (not terminated) and max_steps > 0 and elapsed >= max_steps
+                    task.observe(sim, obs[s, rank])
+                    if terminated or truncated:
+                        final_obs[s, rank] = obs[s, rank]
+                        ring["elapsed_steps"][s, rank] = elapsed
+                        task.reset(sim, loaded, rng)
+                        elapsed = 0
+                        task.observe(sim, obs[s, rank])
+                if not (terminated or truncated):
+                    ring["elapsed_steps"][s, rank] = elapsed
+                ring["reward"][s, rank] = reward
+                ring["terminated"][s, rank] = terminated
+                ring["truncated"][s, rank] = truncated
+                ring["failed"][s, rank] = False
+            except BaseException:
+                ring["failed"][s, rank] = True
+                errors.put((rank, traceback.format_exc()))
+            res.release()
+    finally:
+        shm.close()
+
+
+class EnvPool:
+    """
+    Pool of env worker processes with shared-memory action/observation rings.
+
+    Usage:
+        with EnvPool(EnvPoolConfig("examples/env_bundles/basic_v1", num_envs=8)) as pool:
+            obs = pool.reset().obs
+            for _ in range(1000):
+                out = pool.step(policy(obs))
+                obs = out.obs
+
+    `send(actions, env_ids)` queues one step for a subset of envs and returns immediately;
+    `recv()` waits for the oldest outstanding batch. Up to `ring_depth` batches may be in flight
+    per env, so a caller can split envs into groups and overlap its own work with stepping.
+    """
+
+    def __init__(self, config: EnvPoolConfig, task: EnvTask | None = None) -> None:
+        from kiln.envio.bundle import load_env_bundle
+
+        if int(config.num_envs) <= 0:
+            raise ValueError(f"num_envs must be positive, got {config.num_envs!r}")
+        if int(config.ring_depth) <= 0:
+            raise ValueError(f"ring_depth must be positive, got {config.ring_depth!r}")
+        self.config = config
+        self.task = task if task is not None else EnvTask()
+        self.num_envs = int(config.num_envs)
+        self.ring_depth = int(config.ring_depth)
+
+        # Shapes come from the parsed bundle; the parent never imports Genesis.
+        obs_shape, act_shape = self.task.shapes(load_env_bundle(config.bundle_dir))
+        self.obs_shape = tuple(int(v) for v in obs_shape)
+        self.act_shape = tuple(int(v) for v in act_shape)
+        self._layout = _RingLayout(self.ring_depth, self.num_envs, self.obs_shape, self.act_shape)
+        self._shm = shared_memory.SharedMemory(create=True, size=self._layout.nbytes)
+        self._ring = self._layout.views(self._shm.buf)
+        self._sent = np.zeros(self.num_envs, dtype=np.int64)  # sends issued per env
+        self._in_flight = np.zeros(self.num_envs, dtype=np.int64)
+        self._pending: deque[tuple[np.ndarray, np.ndarray]] = deque()
+        self._all_envs = np.arange(self.num_envs, dtype=np.int64)
+        self._closed = False
+
+        ctx = mp.get_context(config.start_method)
+        self._errors = ctx.Queue()
+        self._req = [ctx.Semaphore(0) for _ in range(self.num_envs)]
+        self._res = [ctx.Semaphore(0) for _ in range(self.num_envs)]
+        cpus: list[int] = []
+        if config.pin_cpus and hasattr(os, "sched_getaffinity"):
+            cpus = sorted(os.sched_getaffinity(0))
+        self._procs = []
+        try:
+            with _worker_env(config.threads_per_worker):
+                for rank in range(self.num_envs):
+                    p = ctx.Process(
+                        target=_worker_main,
+                        args=(
+                            rank,
+                            config,
+                            self.task,
+                            self._layout,
+                            self._shm.name,
+                            cpus[rank % len(cpus)] if cpus else None,
+                            self._req[rank],
+                            self._res[rank],
+                            self._errors,
+                        ),
+                        name=f"kiln-env-{rank}",
+                        daemon=True,
+                    )
+                    p.start()
+                    self._procs.append(p)
+            for rank in range(self.num_envs):
+                self._wait(rank, timeout=float(config.startup_timeout))
+            if bool(self._ring["failed"][0].any()):
+                self._raise_worker_errors(block=True)
+                raise RuntimeError("Env worker failed during startup.")
+        except BaseException:
+            self.close()
+            raise
+
+    # ----------------------------
+    # Worker signalling
+    # ----------------------------
+    def _wait(self, rank: int, *, timeout: float | None = None) -> None:
+        waited = 0.0
+        while not self._res[rank].acquire(timeout=1.0):
+            waited += 1.0
+            if not self._procs[rank].is_alive():
+                self._raise_worker_errors()
+                raise RuntimeError(f"Env worker {rank} exited (code {self._procs[rank].exitcode}).")
+            if timeout is not None and waited >= timeout:
+                raise TimeoutError(f"Env worker {rank} did not respond within {timeout:.0f}s.")
+
+    def _raise_worker_errors(self, *, block: bool = False) -> None:
+        # A worker posts its traceback before signalling, but the queue's feeder thread may
+        # still be flushing it; `block` waits briefly for the first message.
+        msgs = []
+        while True:
+            try:
+                rank, tb = self._errors.get(timeout=5.0) if (block and not msgs) else self._errors.get_nowait()
+            except Exception:
+                break
+            msgs.append(f"[env {rank}]\n{tb}")
+        if msgs:
+            raise RuntimeError("Env worker failed:\n" + "\n".join(msgs))
+
+    def _env_ids(self, env_ids: Sequence[int] | np.ndarray | None) -> np.ndarray:
+        if env_ids is None:
+            return self._all_envs
+        ids = np.asarray(env_ids, dtype=np.int64).reshape(-1)
+        if ids.size and (ids.min() < 0 or ids.max() >= self.num_envs):
+            raise IndexError(f"env_ids out of range [0, {self.num_envs}).")
+        if np.unique(ids).size != ids.size:
+            raise ValueError("env_ids must not repeat within one batch.")
+        return ids
+
+    def _post(self, ids: np.ndarray, cmd: int, actions: Any | None) -> None:
+        if self._closed:
+            raise RuntimeError("EnvPool is closed.")
+        if np.any(self._in_flight[ids] >= self.ring_depth):
+            raise RuntimeError(f"More than ring_depth={self.ring_depth} batches in flight; call recv() first.")
+        slots = self._sent[ids] % self.ring_depth
+        self._ring["cmd"][slots, ids] = cmd
+        if actions is not None:
+            self._ring["actions"][slots, ids] = np.asarray(actions, dtype=np.float64).reshape(
+                (ids.size,) + self.act_shape
+            )
+        self._sent[ids] += 1
+        self._in_flight[ids] += 1
+        self._pending.append((ids, slots))
+        for rank in ids.tolist():
+            self._req[rank].release()
+
+    # ----------------------------
+    # Public API
+    # ----------------------------
+    def send(self, actions: Any, env_ids: Sequence[int] | np.ndarray | None = None) -> None:
+        """Queue one step for `env_ids` (default: all) with `[len(env_ids), *act_shape]` actions."""
+        self._post(self._env_ids(env_ids), CMD_STEP, actions)
+
+    def send_reset(self, env_ids: Sequence[int] | np.ndarray | None = None) -> None:
+        """Queue an explicit reset for `env_ids` (default: all)."""
+        self._post(self._env_ids(env_ids), CMD_RESET, None)
+
+    def recv(self) -> EnvPoolResult:
+        """Wait for the oldest outstanding batch and return its results."""
+        if not self._pending:
+            raise RuntimeError("No batch in flight; call send() first.")
+        ids, slots = self._pending.popleft()
+        for rank in ids.tolist():
+            self._wait(rank)
+        self._in_flight[ids] -= 1
+        r = self._ring
+        if ids.size and bool(r["failed"][slots, ids].any()):
+            self._raise_worker_errors(block=True)
+            raise RuntimeError("Env worker failed.")
+
+        if ids.size == self.num_envs and bool((ids == self._all_envs).all()) and bool((slots == slots[0]).all()):
+            s = int(slots[0])
+            return EnvPoolResult(
+                env_ids=ids,
+                obs=r["obs"][s],
+                reward=r["reward"][s],
+                terminated=r["terminated"][s],
+                truncated=r["truncated"][s],
+                final_obs=r["final_obs"][s],
+                elapsed_steps=r["elapsed_steps"][s],
+            )
+        return EnvPoolResult(
+            env_ids=ids,
+            obs=r["obs"][slots, ids],
+            reward=r["reward"][slots, ids],
+            terminated=r["terminated"][slots, ids],
+            truncated=r["truncated"][slots, ids],
+            final_obs=r["final_obs"][slots, ids],
+            elapsed_steps=r["elapsed_steps"][slots, ids],
+        )
+
+    def reset(self, env_ids: Sequence[int] | np.ndarray | None = None) -> EnvPoolResult:
+        """Synchronous `send_reset` + `recv` (requires no other batch in flight)."""
+        if self._pending:
+            raise RuntimeError("reset() with batches in flight; recv() them first.")
+        self.send_reset(env_ids)
+        return self.recv()
+
+    def step(self, actions: Any, env_ids: Sequence[int] | np.ndarray | None = None) -> EnvPoolResult:
+        """Synchronous `send` + `recv` (requires no other batch in flight)."""
+        if self._pending:
+            raise RuntimeError("step() with batches in flight; recv() them first.")
+        self.send(actions, env_ids)
+        return self.recv()
+
+    def close(self) -> None:
+        """Stop the workers and release the shared block (results views become invalid)."""
+        if self._closed:
+            return
+        self._closed = True
+        procs = getattr(self, "_procs", [])
+        for rank, p in enumerate(procs):
+            if not p.is_alive():
+                continue
+            # Drain this env's outstanding work so the close command lands in a free slot.
+            while self._in_flight[rank] > 0:
+                try:
+                    self._wait(rank, timeout=30.0)
+                except Exception:
+                    break
+                self._in_flight[rank] -= 1
+            s = int(self._sent[rank] % self.ring_depth)
+            self._ring["cmd"][s, rank] = CMD_CLOSE
+            self._sent[rank] += 1
+            self._req[rank].release()
+        for p in procs:
+            p.join(timeout=30.0)
+            if p.is_alive():
+                p.terminate()
+                p.join()
+        self._pending.clear()
+        self._ring = {}
+        try:
+            self._shm.close()
+        except BufferError:
+            # Caller still holds zero-copy result views; the mapping goes away with them.
+            pass
+        self._shm.unlink()
+
+    def __enter__(self) -> "EnvPool":
+        return self
+
+    def __exit__(self, *exc: object) -> None:
+        self.close()
@@ -0,0 +1,361 @@
+from __future__ import annotations
+
+"""
+Always-available, low-overhead phase instrumentation for `GenesisSim`.
+
+`GenesisSim` wraps its step, control writes, contact polling, raycasts and readbacks in
+`sim.profiler.phase(...)` scopes and reports device->host transfers through `sim.profiler.d2h`.
+User code can time its own phases the same way (`with sim.profiler.phase("policy"): ...`).
+
+When the profiler is disabled (the default) `phase()` returns a shared no-op context manager and
+the counters return immediately, so the instrumented call sites cost one attribute check.
+When enabled, each phase records wall time into a fixed-bucket histogram (Prometheus-style
+cumulative buckets, p50/p99 estimated from the buckets). Phases marked `gpu=True` can also record
+CUDA events (`cuda_events=True`); their elapsed device time is collected lazily, once the events
+have completed, so timing adds no host syncs to the step loop.
+
+Counters:
+- `device_syncs`: host waits on the device (blocking device->host copies).
+- `d2h_transfers` / `d2h_bytes`: device->host copies issued by the adapter.
+- `steps`: `sim.step()` ticks.
+
+Recording is thread-safe: with `PipelinedRunner` readbacks and observers record from the physics
+worker while the main thread times its own phases, so every mutation (and `reset()` /
+`snapshot()`) runs under one lock held by the profiler.
+
+`snapshot()` returns everything as plain dicts (also under `runtime_info()["profile"]`),
+`to_prometheus(snapshot)` renders it in the Prometheus text exposition format, and
+`on_metrics` (called every `metrics_every` steps with a snapshot) forwards it elsewhere.
+"""
+
+from bisect import bisect_left
+from collections import deque
+import threading
+import time
+from typing import Any, Callable
+
+# Upper bucket bounds in seconds (10 us .. 1 s); observations above go to the +Inf bucket.
+DEFAULT_BUCKETS: tuple[float, ...] = (
+    1e-5,
+    2.5e-5,
+    5e-5,
+    1e-4,
+    2.5e-4,
+    5e-4,
+    1e-3,
+    2.5e-3,
+    5e-3,
+    1e-2,
+    2.5e-2,
+    5e-2,
+    1e-1,
+    2.5e-1,
+    5e-1,
+    1.0,
+)
+
+
+class Histogram:
+    """Fixed-bucket duration histogram (count, sum, max and per-bucket counts; not locked itself)."""
+
+    __slots__ = ("bounds", "counts", "count", "sum", "max")
+
+    def __init__(self, bounds: tuple[float, ...] = DEFAULT_BUCKETS) -> None:
+        self.bounds = tuple(float(b) for b in bounds)
+        self.counts = [0] * (len(self.bounds) + 1)
+        self.count = 0
+        self.sum = 0.0
+        self.max = 0.0
+
+    def observe(self, seconds: float) -> None:
+        self.counts[bisect_left(self.bounds, seconds)] += 1
+        self.count += 1
+        self.sum += seconds
+        if seconds > self.max:
+            self.max = seconds
+
+    def quantile(self, q: float) -> float:
+        """Quantile estimate in seconds (linear within the bucket, Prometheus `histogram_quantile` style)."""
+        if self.count == 0:
+            return 0.0
+        rank = float(q) * self.count
+        seen = 0
+        for i, c in enumerate(self.counts):
+            if c and seen + c >= rank:
+                lo = self.bounds[i - 1] if i > 0 else 0.0
+                hi = self.bounds[i] if i < len(self.bounds) else self.max
+                return min(self.max, lo + (hi - lo) * (rank - seen) / c)
+            seen += c
+        return self.max
+
+    def snapshot(self) -> dict[str, Any]:
+        cumulative = []
+        total = 0
+        for le, c in zip((*self.bounds, float("inf")), self.counts):
+            total += c
+            cumulative.append((le, total))
+        return {
+            "count": self.count,
+            "sum_s": self.sum,
+            "max_s": self.max,
+            "p50_ms": self.quantile(0.5) * 1e3,
+            "p99_ms": self.quantile(0.99) * 1e3,
+            "buckets": cumulative,
+        }
+
+
+class _NullPhase:
+    __slots__ = ()
+
+    def __enter__(self) -> None:
+        return None
+
+    def __exit__(self, *exc: Any) -> None:
+        return None
+
+
+_NULL_PHASE = _NullPhase()
+
+
+class _Phase:
+    __slots__ = ("_prof", "_name", "_t0", "_ev0")
+
+    def __init__(self, prof: "Profiler", name: str, gpu: bool) -> None:
+        self._prof = prof
+        self._name = name
+        self._ev0 = prof._cuda_event() if gpu else None
+
+    def __enter__(self) -> None:
+        self._t0 = time.perf_counter()
+
+    def __exit__(self, *exc: Any) -> None:
+        prof = self._prof
+        prof.observe(self._name, time.perf_counter() - self._t0)
+        if self._ev0 is not None:
+            ev1 = prof._cuda_event()
+            if ev1 is not None:
+                with prof._lock:
+                    prof._pending.append((self._name, self._ev0, ev1))
+        if prof._pending:
+            prof._drain(block=False)
+
+
+class Profiler:
+    """
+    Phase timers and transfer counters for one `GenesisSim` (see module docstring).
+
+    Args:
+        enabled: Start recording immediately (`enable()` / `disable()` toggle it later).
+        cuda_events: Also time `gpu=True` phases with CUDA events (ignored without CUDA).
+        on_metrics: Optional callback receiving `snapshot()` every `metrics_every` steps.
+        metrics_every: Step interval for `on_metrics`.
+    """
+
+    def __init__(
+        self,
+        *,
+        enabled: bool = False,
+        cuda_events: bool = False,
+        on_metrics: Callable[[dict[str, Any]], None] | None = None,
+        metrics_every: int = 600,
+        buckets: tuple[float, ...] = DEFAULT_BUCKETS,
+    ) -> None:
+        self.enabled = bool(enabled)
+        self.cuda_events = bool(cuda_events)
+        self.on_metrics = on_metrics
+        self.metrics_every = max(1, int(metrics_every))
+        self._buckets = tuple(buckets)
+        self.histograms: dict[str, Histogram] = {}
+        self.gpu_histograms: dict[str, Histogram] = {}
+        self.counters: dict[str, int] = {"steps": 0, "device_syncs": 0, "d2h_transfers": 0, "d2h_bytes": 0}
+        # (phase, start_event, end_event) not yet known to have completed, oldest first.
+        self._pending: deque[tuple[str, Any, Any]] = deque()
+        self._torch: Any | None = None
+        # Guards histograms, counters and `_pending` (recorded from worker threads too).
+        self._lock = threading.Lock()
+
+    # ----------------------------
+    # Switches
+    # ----------------------------
+    def enable(self, *, cuda_events: bool | None = None) -> None:
+        self.enabled = True
+        if cuda_events is not None:
+            self.cuda_events = bool(cuda_events)
+
+    def disable(self) -> None:
+        self.enabled = False
+
+    def reset(self) -> None:
+        """Clear histograms and counters (e.g. after warmup)."""
+        with self._lock:
+            self._pending.clear()
+            self.histograms.clear()
+            self.gpu_histograms.clear()
+            for k in self.counters:
+                self.counters[k] = 0
+
+    # ----------------------------
+    # Recording
+    # ----------------------------
+    def phase(self, name: str, *, gpu: bool = False) -> Any:
+        """Context manager timing one occurrence of phase `name` (no-op while disabled)."""
+        if not self.enabled:
+            return _NULL_PHASE
+        return _Phase(self, name, gpu and self.cuda_events)
+
+    def observe(self, name: str, seconds: float) -> None:
+        """Record one wall-time sample for `name` (for timings measured elsewhere)."""
+        if not self.enabled:
+            return
+        with self._lock:
+            h = self.histograms.get(name)
+            if h is None:
+                h = self.histograms[name] = Histogram(self._buckets)
+            h.observe(float(seconds))
+
+    def count(self, name: str, n: int = 1) -> None:
+        if not self.enabled:
+            return
+        with self._lock:
+            self.counters[name] = self.counters.get(name, 0) + int(n)
+
+    def d2h(self, value: Any, *, sync: bool = True) -> None:
+        """
+        Count a device->host copy of `value` (no-op for host arrays and CPU tensors).
+
+        `sync=False` for asynchronous copies (`non_blocking=True` into pinned memory).
+        """
+        if not self.enabled:
+            return
+        device = getattr(value, "device", None)
+        if device is None or getattr(device, "type", "cpu") == "cpu":
+            return
+        try:
+            nbytes = int(value.numel()) * int(value.element_size())
+        except Exception:
+            nbytes = 0
+        self.transfer(nbytes, sync=sync)
+
+    def transfer(self, nbytes: int, *, sync: bool = True) -> None:
+        """Count one device->host copy of `nbytes` (for copies issued without the tensor at hand)."""
+        if not self.enabled:
+            return
+        with self._lock:
+            c = self.counters
+            c["d2h_transfers"] += 1
+            c["d2h_bytes"] += int(nbytes)
+            if sync:
+                c["device_syncs"] += 1
+
+    def end_step(self) -> None:
+        """Called by `GenesisSim.step()` after every tick."""
+        if not self.enabled:
+            return
+        with self._lock:
+            self.counters["steps"] += 1
+            due = self.on_metrics is not None and self.counters["steps"] % self.metrics_every == 0
+        if due:
+            self.on_metrics(self.snapshot(block=False))
+
+    # ----------------------------
+    # CUDA events
+    # ----------------------------
+    def _cuda_event(self) -> Any | None:
+        torch = self._torch
+        if torch is None:
+            try:
+                import torch  # type: ignore
+            except Exception:
+                self.cuda_events = False
+                return None
+            if not torch.cuda.is_available():
+                self.cuda_events = False
+                return None
+            self._torch = torch
+        ev = torch.cuda.Event(enable_timing=True)
+        ev.record()
+        return ev
+
+    def _drain(self, *, block: bool) -> None:
+        """Move completed CUDA event pairs into `gpu_histograms` (waits for all if `block`)."""
+        with self._lock:
+            self._drain_locked(block=block)
+
+    def _drain_locked(self, *, block: bool) -> None:
+        pending = self._pending
+        while pending:
+            name, ev0, ev1 = pending[0]
+            if block:
+                ev1.synchronize()
+            elif not ev1.query():
+                return
+            pending.popleft()
+            h = self.gpu_histograms.get(name)
+            if h is None:
+                h = self.gpu_histograms[name] = Histogram(self._buckets)
+            h.observe(float(ev0.elapsed_time(ev1)) * 1e-3)
+
+    # ----------------------------
+    # Reporting
+    # ----------------------------
+    def snapshot(self, *, block: bool = True) -> dict[str, Any]:
+        """
+        Counters and per-phase histograms as plain data.
+
+        `block=True` first waits for outstanding CUDA timing events (a profiler-internal sync
+        that is not counted in `device_syncs`).
+        """
+        with self._lock:
+            if self._pending:
+                self._drain_locked(block=block)
+            out: dict[str, Any] = {
+                "enabled": self.enabled,
+                "counters": dict(self.counters),
+                "phases": {k: h.snapshot() for k, h in self.histograms.items()},
+            }
+            if self.gpu_histograms:
+                out["gpu_phases"] = {k: h.snapshot() for k, h in self.gpu_histograms.items()}
+        return out
+
+    def summary(self) -> str:
+        """One-line-per-phase text summary (used by the demo)."""
+        snap = self.snapshot()
+        lines = []
+        for kind in ("phases", "gpu_phases"):
+            for name, h in sorted(snap.get(kind, {}).items()):
+                label = name if kind == "phases" else f"{name}[gpu]"
+                lines.append(
+                    f"{label:<16} n={h['count']:<7d} total={h['sum_s'] * 1e3:10.3f}ms "
+                    f"p50~{h['p50_ms']:.3f}ms p99~{h['p99_ms']:.3f}ms max={h['max_s'] * 1e3:.3f}ms"
+                )
+        lines.append(" ".join(f"{k}={v}" for k, v in snap["counters"].items()))
+        return "\n".join(lines)
+
+
+def to_prometheus(snapshot: dict[str, Any], *, prefix: str = "kiln_sim", labels: dict[str, str] | None = None) -> str:
+    """Render a `Profiler.snapshot()` in the Prometheus text exposition format."""
+
+    def fmt_labels(extra: dict[str, str]) -> str:
+        merged = {**(labels or {}), **extra}
+        if not merged:
+            return ""
+        return "{" + ",".join(f'{k}="{v}"' for k, v in merged.items()) + "}"
+
+    lines = []
+    for name, value in snapshot.get("counters", {}).items():
+        metric = f"{prefix}_{name}_total"
+        lines.append(f"# TYPE {metric} counter")
+        lines.append(f"{metric}{fmt_labels({})} {value}")
+    for kind, suffix in (("phases", "phase_seconds"), ("gpu_phases", "gpu_phase_seconds")):
+        phases = snapshot.get(kind) or {}
+        if not phases:
+            continue
+        metric = f"{prefix}_{suffix}"
+        lines.append(f"# TYPE {metric} histogram")
+        for phase, h in phases.items():
+            for le, c in h["buckets"]:
+                le_s = "+Inf" if le == float("inf") else repr(float(le))
+                lines.append(f"{metric}_bucket{fmt_labels({'phase': phase, 'le': le_s})} {c}")
+            lines.append(f"{metric}_sum{fmt_labels({'phase': phase})} {h['sum_s']}")
+            lines.append(f"{metric}_count{fmt_labels({'phase': phase})} {h['count']}")
+    return "\n".join(lines) + "\n"
@@ -0,0 +1,518 @@
+from __future__ import annotations
+
+"""
+Batched raycasting over the scene's collision primitives.
+
+Genesis does not expose a scene-level ray query in every version, so `GenesisSim` records
+the shapes it spawns (boxes, spheres, cylinders, planes, and optionally USD world triangles)
+in a `RaycastWorld`. Static geometry gets one BVH, built the first time it is queried;
+dynamic bodies are re-posed from a bulk solver read and cast against their own refit BVH.
+
+All rays in a batch traverse the BVH together as a wavefront of `(ray, node)` pairs, so a
+query costs a handful of numpy passes instead of one Python call per ray.
+"""
+
+from dataclasses import dataclass
+from typing import Any, Callable, Sequence
+
+import numpy as np
+
+from ...geometry.bvh import BVH, TINY, safe_inv, slab
+
+# Primitive kinds stored in `ShapeSet.kind`.
+SHAPE_BOX = 0
+SHAPE_SPHERE = 1
+SHAPE_CYLINDER = 2
+
+_SHAPE_KINDS = {"box": SHAPE_BOX, "sphere": SHAPE_SPHERE, "cylinder": SHAPE_CYLINDER}
+
+
+@dataclass(frozen=True)
+class RaycastHit:
+    hit: bool
+    distance: float | None = None
+    position: tuple[float, float, float] | None = None
+    normal: tuple[float, float, float] | None = None
+    # Optional: entity/prim identifiers if Genesis exposes them
+    collider: Any | None = None
+
+
+@dataclass(frozen=True, eq=False)
+class RaycastBatch:
+    """
+    Results of one batched raycast (`n` rays).
+
+    Attributes:
+        hit: Bool `[n]`.
+        distance: Float `[n]` distance along the (normalized) ray; `inf` on miss.
+        position: Float `[n, 3]` hit points; NaN on miss.
+        normal: Float `[n, 3]` unit surface normals facing the ray; zero on miss.
+        collider: Int `[n]` index into `colliders`; -1 on miss.
+        colliders: Entities addressed by `collider`.
+    """
+
+    hit: np.ndarray
+    distance: np.ndarray
+    position: np.ndarray
+    normal: np.ndarray
+    collider: np.ndarray
+    colliders: tuple[Any, ...] = ()
+
+    def __len__(self) -> int:
+        return int(self.hit.shape[0])
+
+    def __getitem__(self, i: int) -> RaycastHit:
+        """Single-ray view in the scalar `RaycastHit` form."""
+        if not bool(self.hit[i]):
+            return RaycastHit(hit=False)
+        c = int(self.collider[i])
+        return RaycastHit(
+            hit=True,
+            distance=float(self.distance[i]),
+            position=tuple(float(v) for v in self.position[i]),
+            normal=tuple(float(v) for v in self.normal[i]),
+            collider=self.colliders[c] if 0 <= c < len(self.colliders) else None,
+        )
+
+    def as_torch(self, device: Any | None = None) -> dict[str, Any]:
+        """Return `hit`/`distance`/`position`/`normal`/`collider` as torch tensors on `device`."""
+        import torch  # type: ignore
+
+        return {
+            "hit": torch.as_tensor(self.hit, device=device),
+            "distance": torch.as_tensor(self.distance, dtype=torch.float32, device=device),
+            "position": torch.as_tensor(self.position, dtype=torch.float32, device=device),
+            "normal": torch.as_tensor(self.normal, dtype=torch.float32, device=device),
+            "collider": torch.as_tensor(self.collider, dtype=torch.long, device=device),
+        }
+
+
+def quat_to_matrix(quat: Any) -> np.ndarray:
+    """Rotation matrices `[n, 3, 3]` (local -> world) from `(w, x, y, z)` quaternions `[n, 4]`."""
+    q = np.asarray(quat, dtype=np.float64).reshape(-1, 4)
+    q = q / np.maximum(np.linalg.norm(q, axis=1, keepdims=True), 1e-12)
+    w, x, y, z = q[:, 0], q[:, 1], q[:, 2], q[:, 3]
+    m = np.empty((q.shape[0], 3, 3), dtype=np.float64)
+    m[:, 0, 0] = 1 - 2 * (y * y + z * z)
+    m[:, 0, 1] = 2 * (x * y - w * z)
+    m[:, 0, 2] = 2 * (x * z + w * y)
+    m[:, 1, 0] = 2 * (x * y + w * z)
+    m[:, 1, 1] = 1 - 2 * (x * x + z * z)
+    m[:, 1, 2] = 2 * (y * z - w * x)
+    m[:, 2, 0] = 2 * (x * z - w * y)
+    m[:, 2, 1] = 2 * (y * z + w * x)
+    m[:, 2, 2] = 1 - 2 * (x * x + y * y)
+    return m
+
+
+def _dot(a: np.ndarray, b: np.ndarray) -> np.ndarray:
+    return np.einsum("ij,ij->i", a, b)
+
+
+class ShapeSet:
+    """Posed analytic primitives (`[n]` rows): boxes, spheres and z-axis cylinders."""
+
+    def __init__(
+        self, kind: np.ndarray, center: np.ndarray, rot: np.ndarray, half: np.ndarray, owner: np.ndarray
+    ) -> None:
+        self.kind = np.asarray(kind, dtype=np.int8).reshape(-1)
+        self.center = np.asarray(center, dtype=np.float64).reshape(-1, 3)
+        self.rot = np.asarray(rot, dtype=np.float64).reshape(-1, 3, 3)
+        # Box: half extents; sphere: (r, r, r); cylinder: (r, r, height / 2).
+        self.half = np.asarray(half, dtype=np.float64).reshape(-1, 3)
+        self.owner = np.asarray(owner, dtype=np.intp).reshape(-1)
+
+    def __len__(self) -> int:
+        return int(self.kind.shape[0])
+
+    def bounds(self) -> tuple[np.ndarray, np.ndarray]:
+        ext = np.einsum("nij,nj->ni", np.abs(self.rot), self.half)
+        sph = self.kind == SHAPE_SPHERE
+        ext[sph] = self.half[sph]
+        return self.center - ext, self.center + ext
+
+    def _local(self, o: np.ndarray, d: np.ndarray, s: np.ndarray) -> tuple[np.ndarray, np.ndarray]:
+        rt = self.rot[s]
+        return np.einsum("nji,nj->ni", rt, o - self.center[s]), np.einsum("nji,nj->ni", rt, d)
+
+    def intersect(self, o: np.ndarray, d: np.ndarray, s: np.ndarray) -> np.ndarray:
+        """Entry distance of ray `i` against shape `s[i]` (inf on miss or origin inside)."""
+        t = np.full(s.shape[0], np.inf)
+        kind = self.kind[s]
+
+        m = np.flatnonzero(kind == SHAPE_BOX)
+        if m.size:
+            ol, dl = self._local(o[m], d[m], s[m])
+            h = self.half[s[m]]
+            tn, tf = slab(-h, h, ol, safe_inv(dl))
+            ok = (tn >= 0.0) & (tf >= tn)
+            t[m[ok]] = tn[ok]
+
+        m = np.flatnonzero(kind == SHAPE_SPHERE)
+        if m.size:
+            oc = o[m] - self.center[s[m]]
+            r = self.half[s[m], 0]
+            b = _dot(oc, d[m])
+            disc = b * b - (_dot(oc, oc) - r * r)
+            ok = disc >= 0.0
+            te = -b - np.sqrt(np.where(ok, disc, 0.0))
+            ok &= te >= 0.0
+            t[m[ok]] = te[ok]
+
+        m = np.flatnonzero(kind == SHAPE_CYLINDER)
+        if m.size:
+            ol, dl = self._local(o[m], d[m], s[m])
+            r = self.half[s[m], 0]
+            hz = self.half[s[m], 2]
+            te = np.full(m.shape[0], np.inf)
+            # Side wall.
+            a = dl[:, 0] ** 2 + dl[:, 1] ** 2
+            b = ol[:, 0] * dl[:, 0] + ol[:, 1] * dl[:, 1]
+            c = ol[:, 0] ** 2 + ol[:, 1] ** 2 - r * r
+            disc = b * b - a * c
+            ok = (a > 1e-12) & (disc >= 0.0)
+            ts = (-b - np.sqrt(np.where(ok, disc, 0.0))) / np.where(ok, a, 1.0)
+            ok &= (ts >= 0.0) & (np.abs(ol[:, 2] + ts * dl[:, 2]) <= hz)
+            te[ok] = ts[ok]
+            # The cap facing the ray.
+            dz = np.where(dl[:, 2] == 0.0, TINY, dl[:, 2])
+            tc = (-np.sign(dz) * hz - ol[:, 2]) / dz
+            px = ol[:, 0] + tc * dl[:, 0]
+            py = ol[:, 1] + tc * dl[:, 1]
+            ok = (tc >= 0.0) & (px * px + py * py <= r * r)
+            te[ok] = np.minimum(te[ok], tc[ok])
+            t[m] = te
+        return t
+
+    def normals(self, p: np.ndarray, s: np.ndarray) -> np.ndarray:
+        """World-space outward normals at surface points `p` of shapes `s`."""
+        rot = self.rot[s]
+        pl = np.einsum("nji,nj->ni", rot, p - self.center[s])
+        h = np.maximum(self.half[s], 1e-12)
+        nl = np.zeros_like(pl)
+        rows = np.arange(s.shape[0])
+        kind = self.kind[s]
+
+        box = kind == SHAPE_BOX
+        axis = np.argmax(np.abs(pl) / h, axis=1)
+        nl[rows[box], axis[box]] = np.sign(pl[rows[box], axis[box]])
+
+        cyl = kind == SHAPE_CYLINDER
+        radial = np.hypot(pl[:, 0], pl[:, 1])
+        cap = cyl & (np.abs(np.abs(pl[:, 2]) - h[:, 2]) < np.abs(radial - h[:, 0]))
+        side = cyl & ~cap
+        nl[cap, 2] = np.sign(pl[cap, 2])
+        nl[side, :2] = pl[side, :2] / np.maximum(radial[side], 1e-12)[:, None]
+
+        n = np.einsum("nij,nj->ni", rot, nl)
+        sph = kind == SHAPE_SPHERE
+        n[sph] = (p[sph] - self.center[s[sph]]) / h[sph, :1]
+        return n
+
+
+class TriangleSet:
+    """Triangle soup (`[n]` rows), intersected two-sided."""
+
+    def __init__(self, vertices: np.ndarray, owner: np.ndarray) -> None:
+        v = np.asarray(vertices, dtype=np.float64).reshape(-1, 3, 3)
+        self.v0 = v[:, 0]
+        self.e1 = v[:, 1] - v[:, 0]
+        self.e2 = v[:, 2] - v[:, 0]
+        self._vmin = v.min(axis=1)
+        self._vmax = v.max(axis=1)
+        n = np.cross(self.e1, self.e2)
+        self.normal = n / np.maximum(np.linalg.norm(n, axis=1, keepdims=True), 1e-12)
+        self.owner = np.asarray(owner, dtype=np.intp).reshape(-1)
+
+    def __len__(self) -> int:
+        return int(self.v0.shape[0])
+
+    def bounds(self) -> tuple[np.ndarray, np.ndarray]:
+        return self._vmin, self._vmax
+
+    def intersect(self, o: np.ndarray, d: np.ndarray, s: np.ndarray) -> np.ndarray:
+        # Moller-Trumbore.
+        e1, e2 = self.e1[s], self.e2[s]
+        p = np.cross(d, e2)
+        det = _dot(e1, p)
+        ok = np.abs(det) > 1e-12
+        inv = 1.0 / np.where(ok, det, 1.0)
+        sv = o - self.v0[s]
+        u = _dot(sv, p) * inv
+        q = np.cross(sv, e1)
+        v = _dot(d, q) * inv
+        t = _dot(e2, q) * inv
+        ok &= (u >= 0.0) & (v >= 0.0) & (u + v <= 1.0) & (t >= 0.0)
+        return np.where(ok, t, np.inf)
+
+
+class RayGeometry:
+    """Shapes + triangles under one BVH (items `[0, n_shapes)` are shapes, the rest triangles)."""
+
+    def __init__(self, shapes: ShapeSet | None = None, triangles: TriangleSet | None = None) -> None:
+        self.shapes = shapes if shapes is not None and len(shapes) else None
+        self.triangles = triangles if triangles is not None and len(triangles) else None
+        self.n_shapes = len(self.shapes) if self.shapes is not None else 0
+        parts = [g.bounds() for g in (self.shapes, self.triangles) if g is not None]
+        if parts:
+            bmin = np.concatenate([p[0] for p in parts])
+            bmax = np.concatenate([p[1] for p in parts])
+        else:
+            bmin = bmax = np.zeros((0, 3))
+        self.bvh = BVH(bmin, bmax)
+
+    def __len__(self) -> int:
+        return len(self.bvh)
+
+    def refit(self, shapes: ShapeSet) -> None:
+        """Swap in re-posed shapes (same rows, same order) and refit the BVH."""
+        self.shapes = shapes
+        bmin, bmax = shapes.bounds()
+        if self.triangles is not None:
+            tmin, tmax = self.triangles.bounds()
+            bmin, bmax = np.concatenate([bmin, tmin]), np.concatenate([bmax, tmax])
+        self.bvh.refit(bmin, bmax)
+
+    def _narrow(self, o: np.ndarray, d: np.ndarray) -> Callable[[np.ndarray, np.ndarray], np.ndarray]:
+        def narrow(rays: np.ndarray, items: np.ndarray) -> np.ndarray:
+            t = np.full(rays.shape[0], np.inf)
+            is_shape = items < self.n_shapes
+            if self.shapes is not None and is_shape.any():
+                m = np.flatnonzero(is_shape)
+                t[m] = self.shapes.intersect(o[rays[m]], d[rays[m]], items[m])
+            if self.triangles is not None and not is_shape.all():
+                m = np.flatnonzero(~is_shape)
+                t[m] = self.triangles.intersect(o[rays[m]], d[rays[m]], items[m] - self.n_shapes)
+            return t
+
+        return narrow
+
+    def closest(self, o: np.ndarray, d: np.ndarray, t_best: np.ndarray) -> np.ndarray:
+        """Closest item per ray (lowering `t_best` in place); -1 where nothing closer was hit."""
+        return self.bvh.closest(o, d, t_best, self._narrow(o, d))
+
+    def resolve(self, p: np.ndarray, d: np.ndarray, items: np.ndarray) -> tuple[np.ndarray, np.ndarray]:
+        """Normals (facing the ray) and collider indices for hit points `p` on `items`."""
+        n = np.zeros((items.shape[0], 3))
+        owner = np.full(items.shape[0], -1, dtype=np.intp)
+        is_shape = items < self.n_shapes
+        if self.shapes is not None and is_shape.any():
+            m = np.flatnonzero(is_shape)
+            n[m] = self.shapes.normals(p[m], items[m])
+            owner[m] = self.shapes.owner[items[m]]
+        if self.triangles is not None and not is_shape.all():
+            m = np.flatnonzero(~is_shape)
+            tri = items[m] - self.n_shapes
+            n[m] = self.triangles.normal[tri]
+            owner[m] = self.triangles.owner[tri]
+        flip = _dot(n, d) > 0.0
+        n[flip] = -n[flip]
+        return n, owner
+
+
+@dataclass(frozen=True)
+class _ShapeRecord:
+    collider: int
+    kind: int
+    fixed: bool
+    pos: tuple[float, float, float]
+    quat: tuple[float, float, float, float]
+    half: tuple[float, float, float]
+
+
+PoseReader = Callable[[Sequence[Any]], tuple[np.ndarray, np.ndarray]]
+
+
+class RaycastWorld:
+    """
+    Registry of ray-intersectable scene geometry plus the cached static BVH.
+
+    Fixed shapes, fixed meshes and planes are static: their BVH is built once, on the first
+    query after the geometry changes. Dynamic shapes are re-posed on every query through
+    `pose_reader(entities) -> (pos [n, 3], quat [n, 4])` and cast against their own BVH,
+    which is refit to the new poses and rebuilt every `rebuild_every` queries (refits keep
+    results exact; rebuilding only restores pruning quality as bodies drift apart).
+    """
+
+    rebuild_every = 32
+
+    def __init__(self) -> None:
+        self._colliders: list[Any] = []
+        self._index: dict[int, int] = {}
+        self._shapes: list[_ShapeRecord] = []
+        self._meshes: list[tuple[int, Callable[[], Any]]] = []
+        self._plane_point: list[tuple[float, float, float]] = []
+        self._plane_normal: list[tuple[float, float, float]] = []
+        self._plane_owner: list[int] = []
+        self._static: RayGeometry | None = None
+        self._dynamic: RayGeometry | None = None
+        self._dynamic_casts = 0
+        self._dynamic_entities: tuple[Any, ...] = ()
+
+    @property
+    def colliders(self) -> tuple[Any, ...]:
+        return tuple(self._colliders)
+
+    def clear(self) -> None:
+        self.__init__()
+
+    def _collider(self, entity: Any) -> int:
+        key = id(entity)
+        idx = self._index.get(key)
+        if idx is None:
+            idx = len(self._colliders)
+            self._colliders.append(entity)
+            self._index[key] = idx
+        return idx
+
+    def add_shape(
+        self,
+        entity: Any,
+        kind: str,
+        *,
+        fixed: bool,
+        pos: Sequence[float],
+        quat: Sequence[float] | None,
+        half_extents: Sequence[float],
+    ) -> None:
+        """Record a box/sphere/cylinder (`half_extents` as in `ShapeSet.half`)."""
+        rec = _ShapeRecord(
+            collider=self._collider(entity),
+            kind=_SHAPE_KINDS[kind],
+            fixed=bool(fixed),
+            pos=tuple(float(v) for v in pos),  # type: ignore[arg-type]
+            quat=tuple(float(v) for v in quat) if quat is not None else (1.0, 0.0, 0.0, 0.0),  # type: ignore[arg-type]
+            half=tuple(float(v) for v in half_extents),  # type: ignore[arg-type]
+        )
+        self._shapes.append(rec)
+        if rec.fixed:
+            self._static = None
+        else:
+            self._dynamic = None
+            self._dynamic_entities = self._dynamic_entities + (entity,)
+
+    def add_plane(self, entity: Any, *, pos: Sequence[float], normal: Sequence[float]) -> None:
+        n = np.asarray(normal, dtype=np.float64)
+        n = n / max(float(np.linalg.norm(n)), 1e-12)
+        self._plane_owner.append(self._collider(entity))
+        self._plane_point.append(tuple(float(v) for v in pos))  # type: ignore[arg-type]
+        self._plane_normal.append(tuple(float(v) for v in n))  # type: ignore[arg-type]
+
+    def add_mesh(self, entity: Any, load_triangles: Callable[[], Any]) -> None:
+        """
+        Record a static mesh; `load_triangles()` returns world-space triangles `[n, 3, 3]`
+        (or None) and is only called when the static BVH is (re)built.
+        """
+        self._meshes.append((self._collider(entity), load_triangles))
+        self._static = None
+
+    def _shape_set(self, recs: Sequence[_ShapeRecord], pos: np.ndarray, quat: np.ndarray) -> ShapeSet:
+        return ShapeSet(
+            kind=np.array([r.kind for r in recs], dtype=np.int8),
+            center=pos,
+            rot=quat_to_matrix(quat),
+            half=np.array([r.half for r in recs], dtype=np.float64).reshape(-1, 3),
+            owner=np.array([r.collider for r in recs], dtype=np.intp),
+        )
+
+    def static_geometry(self) -> RayGeometry:
+        """Static BVH (built on first use after the static geometry changed)."""
+        if self._static is None:
+            recs = [r for r in self._shapes if r.fixed]
+            shapes = None
+            if recs:
+                pos = np.array([r.pos for r in recs], dtype=np.float64)
+                quat = np.array([r.quat for r in recs], dtype=np.float64)
+                shapes = self._shape_set(recs, pos, quat)
+            tris: list[np.ndarray] = []
+            owners: list[np.ndarray] = []
+            for owner, load in self._meshes:
+                v = load()
+                if v is None:
+                    continue
+                v = np.asarray(v, dtype=np.float64).reshape(-1, 3, 3)
+                tris.append(v)
+                owners.append(np.full(v.shape[0], owner, dtype=np.intp))
+            triangles = TriangleSet(np.concatenate(tris), np.concatenate(owners)) if tris else None
+            self._static = RayGeometry(shapes, triangles)
+        return self._static
+
+    def cast(
+        self,
+        origins: Any,
+        directions: Any,
+        max_distance: Any = 5.0,
+        *,
+        pose_reader: PoseReader | None = None,
+    ) -> RaycastBatch:
+        """
+        Closest hit for every ray.
+
+        `directions` need not be normalized (distances are along the normalized ray; zero
+        directions never hit). Without `pose_reader`, dynamic shapes use their spawn pose.
+        """
+        o = np.asarray(origins, dtype=np.float64).reshape(-1, 3)
+        d = np.asarray(directions, dtype=np.float64).reshape(-1, 3)
+        if d.shape[0] != o.shape[0]:
+            o, d = np.broadcast_arrays(o, d)
+            o, d = o.copy(), d.copy()
+        n_rays = o.shape[0]
+        norm = np.linalg.norm(d, axis=1)
+        d = d / np.where(norm > 0.0, norm, 1.0)[:, None]
+        max_t = np.broadcast_to(np.asarray(max_distance, dtype=np.float64), (n_rays,))
+        t_best = np.where(norm > 0.0, max_t, 0.0).astype(np.float64)
+
+        hits: list[tuple[RayGeometry, np.ndarray]] = []
+        static = self.static_geometry()
+        hits.append((static, static.closest(o, d, t_best)))
+
+        dyn_recs = [r for r in self._shapes if not r.fixed]
+        if dyn_recs:
+            if pose_reader is not None and self._dynamic_entities:
+                pos, quat = pose_reader(self._dynamic_entities)
+            else:
+                pos = np.array([r.pos for r in dyn_recs], dtype=np.float64)
+                quat = np.array([r.quat for r in dyn_recs], dtype=np.float64)
+            shapes = self._shape_set(dyn_recs, np.asarray(pos, dtype=np.float64).reshape(-1, 3), np.asarray(quat))
+            dynamic = self._dynamic
+            if dynamic is None or self._dynamic_casts >= self.rebuild_every:
+                dynamic = RayGeometry(shapes)
+                self._dynamic = dynamic
+                self._dynamic_casts = 0
+            else:
+                dynamic.refit(shapes)
+            self._dynamic_casts += 1
+            hits.append((dynamic, dynamic.closest(o, d, t_best)))
+
+        normal = np.zeros((n_rays, 3))
+        collider = np.full(n_rays, -1, dtype=np.intp)
+        # Later sources only win where they lowered `t_best`, so resolve in order.
+        for geom, items in hits:
+            m = np.flatnonzero(items >= 0)
+            if m.size:
+                p = o[m] + t_best[m, None] * d[m]
+                normal[m], collider[m] = geom.resolve(p, d[m], items[m])
+
+        if self._plane_owner:
+            pp = np.asarray(self._plane_point)
+            pn = np.asarray(self._plane_normal)
+            denom = d @ pn.T
+            front = denom < -1e-12
+            with np.errstate(divide="ignore", invalid="ignore"):
+                t = np.where(front, ((pp * pn).sum(axis=1)[None, :] - o @ pn.T) / np.where(front, denom, 1.0), np.inf)
+            t = np.where(t >= 0.0, t, np.inf)
+            j = np.argmin(t, axis=1)
+            tj = t[np.arange(n_rays), j]
+            m = np.flatnonzero(tj < t_best)
+            if m.size:
+                t_best[m] = tj[m]
+                normal[m] = pn[j[m]]
+                collider[m] = np.asarray(self._plane_owner, dtype=np.intp)[j[m]]
+
+        hit = collider >= 0
+        distance = np.where(hit, t_best, np.inf)
+        position = np.full((n_rays, 3), np.nan)
+        position[hit] = o[hit] + distance[hit, None] * d[hit]
+        return RaycastBatch(
+            hit=hit, distance=distance, position=position, normal=normal, collider=collider, colliders=self.colliders
+        )
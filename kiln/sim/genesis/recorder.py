@@ -0,0 +1,341 @@
+from __future__ import annotations
+
+"""
+Streaming episode recorder for `GenesisSim`.
+
+`EpisodeRecorder.record(step, ...)` copies one step of data (base poses of the recorded
+entities, the action, collision events and, every `frame_every` steps, a camera frame) into
+preallocated chunk buffers. Full chunks are handed to a background thread through a bounded
+queue, which compresses and writes them; the step loop itself never touches the filesystem.
+
+On disk a recording is a directory of columnar chunks plus a manifest:
+
+    episode/
+    ├── meta.json                 # entities, dt, column dtypes/shapes, chunk list
+    ├── chunk_00000.npz           # compressed columns for steps [0, chunk_steps)
+    └── ...
+
+Columns per chunk: `step [k]`, `pos [k, (n_envs,) n, 3]`, `quat [k, (n_envs,) n, 4]`,
+`action [k, ...]` (if actions are recorded), `event_step / event_phase / event_source /
+event_other / event_force / event_contacts [m]` and `frame_step [f]`, `frame [f, h, w, c]`.
+`load_recording` reads them back, e.g. to replay an episode in the UI or for offline analysis.
+"""
+
+from dataclasses import dataclass
+import json
+import os
+from pathlib import Path
+import queue
+import threading
+import time
+from typing import Any, Iterable, Iterator, Mapping, Sequence
+
+import numpy as np
+
+from .collisions import CollisionEvent, CollisionPhase
+
+_PHASE_CODES = {CollisionPhase.BEGIN: 0, CollisionPhase.END: 1}
+_EVENT_COLUMNS = ("event_step", "event_phase", "event_source", "event_other", "event_force", "event_contacts")
+_MANIFEST = "meta.json"
+_STOP = object()
+
+
+@dataclass(frozen=True)
+class RecorderConfig:
+    """
+    Attributes:
+        path: Output directory (created; existing chunks in it are overwritten).
+        chunk_steps: Steps per chunk file.
+        queue_chunks: Bound on chunks waiting for the writer thread.
+        on_full: What `record()` does when the queue is full: "block" (backpressure, time is
+            counted in `stats["blocked_s"]`) or "drop" (the chunk is discarded and counted).
+        compress: Write chunks with `np.savez_compressed` (else uncompressed `np.savez`).
+        record_quats: Also record base orientations.
+        frame_every: Capture a camera frame every N recorded steps (needs a camera).
+    """
+
+    path: str | Path
+    chunk_steps: int = 256
+    queue_chunks: int = 4
+    on_full: str = "block"
+    compress: bool = True
+    record_quats: bool = True
+    frame_every: int = 1
+
+
+class _Chunk:
+    """Preallocated per-step columns for one chunk (row-major in steps)."""
+
+    def __init__(self, capacity: int) -> None:
+        self.capacity = capacity
+        self.n = 0
+        self.columns: dict[str, np.ndarray] = {}
+        self.events: list[tuple[int, int, int, int, float, int]] = []
+        self.frame_steps: list[int] = []
+        self.frames: list[np.ndarray] = []
+
+    def put(self, name: str, value: np.ndarray) -> None:
+        col = self.columns.get(name)
+        if col is None:
+            col = np.empty((self.capacity, *value.shape), dtype=value.dtype)
+            self.columns[name] = col
+        col[self.n] = value
+
+    def arrays(self) -> dict[str, np.ndarray]:
+        out = {name: col[: self.n] for name, col in self.columns.items()}
+        ev = self.events
+        out["event_step"] = np.array([e[0] for e in ev], dtype=np.int64)
+        out["event_phase"] = np.array([e[1] for e in ev], dtype=np.uint8)
+        out["event_source"] = np.array([e[2] for e in ev], dtype=np.int64)
+        out["event_other"] = np.array([e[3] for e in ev], dtype=np.int64)
+        out["event_force"] = np.array([e[4] for e in ev], dtype=np.float64)
+        out["event_contacts"] = np.array([e[5] for e in ev], dtype=np.int32)
+        if self.frames:
+            out["frame_step"] = np.array(self.frame_steps, dtype=np.int64)
+            out["frame"] = np.stack(self.frames)
+        return out
+
+
+def _frame_array(rendered: Any) -> np.ndarray:
+    # Genesis cameras return (rgb, depth, segmentation, normal) from `render(...)`.
+    rgb = rendered[0] if isinstance(rendered, tuple) else rendered
+    if hasattr(rgb, "detach"):
+        rgb = rgb.detach().to("cpu").numpy()
+    return np.array(rgb, copy=True)
+
+
+class EpisodeRecorder:
+    """
+    Records per-step poses, actions, collision events and camera frames of a `GenesisSim`.
+
+    Use `GenesisSim.start_recording(...)` (which also stops it in `sim.close()`), or directly:
+
+        with EpisodeRecorder(sim, RecorderConfig("runs/ep0"), entities=bodies) as rec:
+            for step in range(n):
+                ...
+                sim.step()
+                rec.record(step, action=a, events={0: car.poll_collision_events(step_idx=step)})
+
+    Attributes:
+        stats: Counters: steps, chunks_written, chunks_dropped, blocked_s, write_s.
+    """
+
+    def __init__(
+        self,
+        sim: Any,
+        config: RecorderConfig,
+        *,
+        entities: Sequence[Any] | None = None,
+        camera: Any | None = None,
+        names: Sequence[str] | None = None,
+    ) -> None:
+        if config.on_full not in ("block", "drop"):
+            raise ValueError(f"on_full must be 'block' or 'drop', got {config.on_full!r}")
+        self.sim = sim
+        self.config = config
+        self.path = Path(config.path)
+        self.path.mkdir(parents=True, exist_ok=True)
+        # Default: every actor body registered in the sim's state store.
+        self.entities = tuple(entities) if entities is not None else tuple(sim.actor_state.entities)
+        self.camera = camera
+        self.names = list(names) if names is not None else [f"entity_{i}" for i in range(len(self.entities))]
+        if len(self.names) != len(self.entities):
+            raise ValueError("names must match entities one-to-one")
+        self.stats: dict[str, float] = {
+            "steps": 0,
+            "chunks_written": 0,
+            "chunks_dropped": 0,
+            "blocked_s": 0.0,
+            "write_s": 0.0,
+        }
+        self._chunk = _Chunk(max(1, int(config.chunk_steps)))
+        self._chunk_index = 0
+        self._chunk_files: list[dict[str, Any]] = []
+        self._schema: dict[str, Any] = {}
+        self._queue: queue.Queue[Any] = queue.Queue(maxsize=max(1, int(config.queue_chunks)))
+        self._error: BaseException | None = None
+        self._closed = False
+        self._thread = threading.Thread(target=self._writer, name="kiln-recorder", daemon=True)
+        self._thread.start()
+
+    # ----------------------------
+    # Step loop side
+    # ----------------------------
+    def record(
+        self,
+        step: int,
+        *,
+        action: Any | None = None,
+        events: Mapping[int, Iterable[CollisionEvent]] | Iterable[CollisionEvent] | None = None,
+    ) -> None:
+        """
+        Record step `step` (call after `sim.step()`).
+
+        Args:
+            step: Step index stored with the row.
+            action: Optional action array for this step (copied).
+            events: Collision events, either an iterable or a mapping `source id -> events`
+                (e.g. actor index -> `poll_collision_events(...)`); sources default to -1.
+        """
+        if self._closed:
+            raise RuntimeError("Recorder is closed.")
+        self._raise_writer_error()
+        c = self._chunk
+        c.put("step", np.asarray(step, dtype=np.int64))
+        if self.entities:
+            c.put("pos", np.asarray(self.sim.get_positions(self.entities).positions, dtype=np.float32))
+            if self.config.record_quats:
+                quat = self.sim.get_quats_batch(self.entities)
+                if hasattr(quat, "detach"):
+                    quat = quat.detach().to("cpu").numpy()
+                c.put("quat", np.asarray(quat, dtype=np.float32))
+        if action is not None:
+            if hasattr(action, "detach"):
+                action = action.detach().to("cpu").numpy()
+            c.put("action", np.asarray(action))
+        if events is not None:
+            sources = events.items() if isinstance(events, Mapping) else ((-1, events),)
+            for source, evs in sources:
+                for e in evs:
+                    force = float("nan") if e.max_force is None else float(e.max_force)
+                    c.events.append(
+                        (int(e.step_idx), _PHASE_CODES[e.phase], int(source), int(e.other_entity_id), force, int(e.contact_count))
+                    )
+        if self.camera is not None and int(self.stats["steps"]) % max(1, int(self.config.frame_every)) == 0:
+            c.frame_steps.append(int(step))
+            c.frames.append(_frame_array(self.camera.render(rgb=True, depth=False, segmentation=False, normal=False)))
+        c.n += 1
+        self.stats["steps"] += 1
+        if c.n == c.capacity:
+            self._flush()
+
+    def _flush(self) -> None:
+        c = self._chunk
+        if c.n == 0:
+            return
+        self._chunk = _Chunk(c.capacity)
+        item = (self._chunk_index, c)
+        self._chunk_index += 1
+        if self.config.on_full == "drop":
+            try:
+                self._queue.put_nowait(item)
+            except queue.Full:
+                self.stats["chunks_dropped"] += 1
+            return
+        t0 = time.perf_counter()
+        self._queue.put(item)
+        self.stats["blocked_s"] += time.perf_counter() - t0
+
+    # ----------------------------
+    # Writer thread
+    # ----------------------------
+    def _writer(self) -> None:
+        save = np.savez_compressed if self.config.compress else np.savez
+        while True:
+            item = self._queue.get()
+            if item is _STOP:
+                return
+            if self._error is not None:
+                # Keep draining so a blocked `record()` can finish and raise.
+                continue
+            idx, chunk = item
+            try:
+                t0 = time.perf_counter()
+                arrays = chunk.arrays()
+                name = f"chunk_{idx:05d}.npz"
+                tmp = self.path / f".{name}.tmp"
+                with open(tmp, "wb") as f:
+                    save(f, **arrays)
+                os.replace(tmp, self.path / name)
+                self._chunk_files.append({"file": name, "steps": int(chunk.n), "events": len(chunk.events), "frames": len(chunk.frames)})
+                for k, v in arrays.items():
+                    if k not in _EVENT_COLUMNS and k != "frame_step":
+                        self._schema.setdefault(k, {"dtype": v.dtype.str, "shape": list(v.shape[1:])})
+                self.stats["chunks_written"] += 1
+                self.stats["write_s"] += time.perf_counter() - t0
+            except BaseException as e:  # surfaced on the step loop side
+                self._error = e
+
+    def _raise_writer_error(self) -> None:
+        if self._error is not None:
+            raise RuntimeError(f"Recorder writer failed: {self._error!r}") from self._error
+
+    def close(self) -> None:
+        """Flush the last partial chunk, wait for the writer and write the manifest."""
+        if self._closed:
+            return
+        self._closed = True
+        self._flush()
+        self._queue.put(_STOP)
+        self._thread.join()
+        self._raise_writer_error()
+        meta = {
+            "format": "kiln-recording",
+            "version": 1,
+            "dt": float(getattr(getattr(self.sim, "config", None), "dt", 0.0) or 0.0),
+            "n_envs": int(getattr(self.sim, "n_envs", 0)),
+            "entities": self.names,
+            "entity_ids": [id(e) for e in self.entities],
+            "steps": int(self.stats["steps"]),
+            "chunks_dropped": int(self.stats["chunks_dropped"]),
+            "columns": self._schema,
+            "chunks": sorted(self._chunk_files, key=lambda c: c["file"]),
+        }
+        tmp = self.path / f".{_MANIFEST}.tmp"
+        tmp.write_text(json.dumps(meta, indent=2), encoding="utf-8")
+        os.replace(tmp, self.path / _MANIFEST)
+
+    def __enter__(self) -> "EpisodeRecorder":
+        return self
+
+    def __exit__(self, *exc: object) -> None:
+        self.close()
+
+
+class Recording:
+    """
+    A recording written by `EpisodeRecorder`.
+
+    Attributes:
+        path: Recording directory.
+        meta: Parsed `meta.json`.
+    """
+
+    def __init__(self, path: str | Path) -> None:
+        self.path = Path(path)
+        manifest = self.path / _MANIFEST
+        if not manifest.exists():
+            raise FileNotFoundError(f"Not a recording (missing {_MANIFEST}): {self.path}")
+        self.meta: dict[str, Any] = json.loads(manifest.read_text(encoding="utf-8"))
+
+    @property
+    def entities(self) -> list[str]:
+        return list(self.meta["entities"])
+
+    def __len__(self) -> int:
+        return int(self.meta["steps"])
+
+    def iter_chunks(self) -> Iterator[dict[str, np.ndarray]]:
+        """Yield each chunk's columns in step order (one file open at a time)."""
+        for rec in self.meta["chunks"]:
+            with np.load(self.path / rec["file"]) as z:
+                yield {k: z[k] for k in z.files}
+
+    def column(self, name: str) -> np.ndarray:
+        """One column concatenated over all chunks (e.g. "pos", "event_phase", "frame")."""
+        parts = [c[name] for c in self.iter_chunks() if name in c]
+        if not parts:
+            raise KeyError(name)
+        return np.concatenate(parts)
+
+    def iter_steps(self) -> Iterator[tuple[int, np.ndarray, np.ndarray | None]]:
+        """Yield `(step, pos, quat)` per recorded step, e.g. to drive a replay."""
+        for c in self.iter_chunks():
+            quat = c.get("quat")
+            for i, step in enumerate(c["step"].tolist()):
+                yield step, c["pos"][i], (quat[i] if quat is not None else None)
+
+
+def load_recording(path: str | Path) -> Recording:
+    """Open a recording directory written by `EpisodeRecorder`."""
+    return Recording(path)
@@ -4,10 +4,35 @@ import math
 import os
 import platform
 import sys
+import tempfile
+import threading
+import time
 import warnings
 from dataclasses import dataclass
 from pathlib import Path
-from typing import Any, TYPE_CHECKING
+from typing import Any, Mapping, Sequence, TYPE_CHECKING
+
+import numpy as np
+
+from .batch import (
+    DOFS_PER_BODY,
+    EntityBatch,
+    PositionSnapshot,
+    _import_torch,
+    as_dof_tensor,
+    count_envs,
+    resolve_entity_batch,
+)
+from .cameras import CameraRig, CameraRigConfig
+from .collisions import CollisionService
+from .compound import can_merge, write_static_compound
+from .handles import EntityHandle, resolve_entity_handle
+from .kernel_cache import KernelCache, file_digest, topology_hash
+from .profiler import Profiler
+from .raycast import RaycastBatch, RaycastHit, RaycastWorld, quat_to_matrix
+from .recorder import EpisodeRecorder, RecorderConfig
+from .state import ActorStateStore, SimStateSnapshot
+from .task import TaskRuntime
 
 if TYPE_CHECKING:
     from kiln.envio.runtime import LoadedEnvBundle
@@ -144,21 +169,80 @@ def _usd_stage_bounds(usd_path: Path) -> tuple[tuple[float, float, float], tuple
         return None
 
 
-def _to_cpu_once(v: Any) -> Any:
+def _usd_world_triangles(
+    usd_path: Path,
+    *,
+    pos: Sequence[float] = (0.0, 0.0, 0.0),
+    quat: Sequence[float] = (1.0, 0.0, 0.0, 0.0),
+    scale: float = 1.0,
+) -> np.ndarray | None:
     """
-    Best-effort conversion of tensor-like values to CPU once.
-
-    This is mainly to avoid per-element CUDA synchronization when we later do `float(v[i])`.
+    Fan-triangulated world-space triangles `[n, 3, 3]` of every USD Mesh prim, placed with the
+    given entity pose/scale. Returns None if USD is unavailable or the stage has no meshes.
     """
     try:
-        import torch  # type: ignore
+        from pxr import Usd, UsdGeom  # type: ignore
+    except Exception:
+        return None
 
-        if isinstance(v, torch.Tensor) and getattr(v, "device", None) is not None:
-            if v.device.type != "cpu":
-                return v.detach().to("cpu")
+    stage = Usd.Stage.Open(str(usd_path))
+    if stage is None:
+        return None
+
+    try:
+        xform_cache = UsdGeom.XformCache(Usd.TimeCode.Default())
+        parts: list[np.ndarray] = []
+        for prim in stage.Traverse():
+            if not prim.IsA(UsdGeom.Mesh):
+                continue
+            mesh = UsdGeom.Mesh(prim)
+            points = mesh.GetPointsAttr().Get()
+            counts = mesh.GetFaceVertexCountsAttr().Get()
+            indices = mesh.GetFaceVertexIndicesAttr().Get()
+            if not points or not counts or not indices:
+                continue
+            # USD matrices act on row vectors: p_world = [p, 1] @ M.
+            m = np.asarray(xform_cache.GetLocalToWorldTransform(prim), dtype=np.float64).reshape(4, 4)
+            pts = np.asarray(points, dtype=np.float64).reshape(-1, 3) @ m[:3, :3] + m[3, :3]
+            counts_a = np.asarray(counts, dtype=np.intp)
+            indices_a = np.asarray(indices, dtype=np.intp)
+            n_tris = np.maximum(counts_a - 2, 0)
+            face = np.repeat(np.arange(counts_a.shape[0]), n_tris)
+            k = np.arange(int(n_tris.sum())) - np.repeat(np.cumsum(n_tris) - n_tris, n_tris)
+            base = (np.cumsum(counts_a) - counts_a)[face]
+            tri = np.stack([indices_a[base], indices_a[base + k + 1], indices_a[base + k + 2]], axis=1)
+            parts.append(pts[tri])
     except Exception:
-        pass
-    return v
+        return None
+
+    if not parts:
+        return None
+    rot = quat_to_matrix([tuple(quat)])[0]
+    return (np.concatenate(parts) * float(scale)) @ rot.T + np.asarray(pos, dtype=np.float64)
+
+
+def _host_array(v: Any) -> np.ndarray:
+    """float64 numpy copy of an array-like (torch tensors are moved to the host first)."""
+    if hasattr(v, "detach"):
+        v = v.detach().to("cpu").numpy()
+    return np.asarray(v, dtype=np.float64)
+
+
+def _clone(v: Any) -> Any:
+    """Independent copy of a tensor/array, kept on its device."""
+    if hasattr(v, "clone"):
+        return v.detach().clone()
+    return np.array(v, copy=True)
+
+
+def _select_envs(v: Any, envs_idx: Any) -> tuple[Any, Any]:
+    """Rows `envs_idx` of a leading-env-axis tensor/array, plus the index in a matching type."""
+    if hasattr(v, "clone"):
+        torch = _import_torch()
+        idx = torch.as_tensor(envs_idx, dtype=torch.long, device=v.device).reshape(-1)
+    else:
+        idx = np.asarray(envs_idx, dtype=np.int64).reshape(-1)
+    return v[idx], idx
 
 
 def _fixed_from_mass(mass: float | None) -> bool:
@@ -174,6 +258,16 @@ def _fixed_from_mass(mass: float | None) -> bool:
     return bool(float(mass) <= 0.0)
 
 
+def _half_extents(prim: Any) -> tuple[float, float, float]:
+    """Ray-world half extents of a box/sphere/cylinder `PrimitiveSpec` (as the add_* helpers record)."""
+    if prim.shape == "box":
+        return (0.5 * float(prim.size[0]), 0.5 * float(prim.size[1]), 0.5 * float(prim.size[2]))
+    r = float(prim.radius)
+    if prim.shape == "sphere":
+        return (r, r, r)
+    return (r, r, 0.5 * float(prim.height))
+
+
 def _maybe_make_surface(gs: Any, color: tuple[float, ...] | None) -> Any | None:
     """Create a Genesis surface object from a color if supported by this Genesis version."""
     if color is None:
@@ -204,16 +298,22 @@ class GenesisSimConfig:
     # Genesis backend selector. Common values: "cpu", "gpu", "cuda", "vulkan".
     # If None, Genesis chooses its default backend for the platform.
     backend: str | None = None
-
-
-@dataclass(frozen=True)
-class RaycastHit:
-    hit: bool
-    distance: float | None = None
-    position: tuple[float, float, float] | None = None
-    normal: tuple[float, float, float] | None = None
-    # Optional: entity/prim identifiers if Genesis exposes them
-    collider: Any | None = None
+    # Batched mode: replicate the scene `n_envs` times at build time (Genesis `n_envs`).
+    # 0 keeps the classic single, unbatched scene (no leading env dimension on tensors).
+    n_envs: int = 0
+    # Spacing between replicated envs in XY (only affects rendering/debug views).
+    env_spacing: tuple[float, float] = (0.0, 0.0)
+    # Persistent compiled-kernel cache shared across processes (see `kernel_cache.py`).
+    # None keeps Taichi/Genesis defaults.
+    kernel_cache_dir: str | None = None
+    # Create the scene with Genesis' batch renderer (when available) so `CameraRig`s render
+    # all their cameras in one pass on the device (see `cameras.py`).
+    batch_render: bool = False
+    # Record phase timings and transfer counters from the start (see `profiler.py`); the
+    # profiler can also be toggled later through `sim.profiler.enable()`.
+    profile: bool = False
+    # Also time the simulation step on the device with CUDA events (CUDA backends only).
+    profile_cuda_events: bool = False
 
 
 class GenesisSim:
@@ -230,11 +330,43 @@ class GenesisSim:
         self._gs = None
         self.scene = None
         self._built = False
-        # Cache 6-DoF velocity/force vectors per entity (Genesis rigid entities are controlled
-        # through dof vectors). This lets higher-level code set linear and angular parts
-        # separately without clobbering the other.
-        self._vel6_cache: dict[int, tuple[float, float, float, float, float, float]] = {}
-        self._force6_cache: dict[int, tuple[float, float, float, float, float, float]] = {}
+        # Contiguous per-entity state (Genesis rigid entities are controlled through dof vectors).
+        # Its vel6/force6 columns let higher-level code set linear and angular parts separately
+        # without clobbering the other; actors keep their controller state in the same slots.
+        self.actor_state = ActorStateStore()
+        # Resolved solver indices per ordered entity group (see `entity_batch`).
+        self._entity_batches: dict[tuple[int, ...], EntityBatch] = {}
+        # Reused (pinned, on CUDA) host buffers for bulk readback, keyed by reading thread plus
+        # the `_entity_batches` key, so a pipeline worker never overwrites the main thread's buffer.
+        self._readback_buffers: dict[tuple[int, tuple[int, ...]], Any] = {}
+        self._readback_lock = threading.Lock()
+        # Scene-level contact pass shared by all actors that poll collision events.
+        self.collisions = CollisionService(self)
+        # Shapes spawned through the add_* helpers, for the `raycast_batch` fallback.
+        self.ray_world = RaycastWorld()
+        # Probed native scene ray-query method names (None = not available).
+        self._native_ray_methods: dict[tuple[str, ...], str | None] = {}
+        # Accessors bound once per entity after build (see `entity_handle`).
+        self._handles: dict[int, EntityHandle] = {}
+        # State right after `build()`, restored by `reset()`.
+        self._initial_state: SimStateSnapshot | None = None
+        # Compiled-kernel cache namespace (set in `init()` when `kernel_cache_dir` is configured).
+        self.kernel_cache: KernelCache | None = None
+        # Entity records hashed into the scene topology key, whether the kernel cache had seen
+        # that topology at the last build, and per-phase `warmup()` timings.
+        self._topology: list[tuple[Any, ...]] = []
+        self._kernel_cache_scene_seen: bool | None = None
+        self._warmup_timings: dict[str, float] | None = None
+        # Surfaces/materials shared by key while a bundle loads with `merge_static=True`
+        # (None: every add_* call creates its own, as Genesis examples do).
+        self._shared_assets: dict[tuple[Any, ...], Any] | None = None
+        # Active episode recorder (see `start_recording`).
+        self.recorder: EpisodeRecorder | None = None
+        # Camera groups added through `add_camera_rig`.
+        self.camera_rigs: list[CameraRig] = []
+        # Phase timers / transfer counters (no-ops unless enabled). Kept across scenes so
+        # counters stay monotonic; call `profiler.reset()` to start over.
+        self.profiler = Profiler(enabled=self.config.profile, cuda_events=self.config.profile_cuda_events)
 
     # ----------------------------
     # Lifecycle / scene management
@@ -255,6 +387,10 @@ class GenesisSim:
         }
         _maybe_prepend_wsl_libcuda_path(reexec=want_cuda)
 
+        if self.config.kernel_cache_dir is not None:
+            self.kernel_cache = KernelCache(self.config.kernel_cache_dir, backend=self.config.backend)
+            self.kernel_cache.configure_env()
+
         gs = _import_genesis()
         self._gs = gs
 
@@ -304,10 +440,85 @@ class GenesisSim:
 
     def close(self) -> None:
         """Release references to the current scene and clear per-entity caches."""
+        self.stop_recording()
         self.scene = None
         self._built = False
-        self._vel6_cache.clear()
-        self._force6_cache.clear()
+        self.actor_state.clear()
+        self._entity_batches.clear()
+        self._readback_buffers.clear()
+        self.collisions.clear()
+        self.ray_world.clear()
+        self._native_ray_methods.clear()
+        self._handles.clear()
+        self._initial_state = None
+        self._topology.clear()
+        self._kernel_cache_scene_seen = None
+        self._warmup_timings = None
+        self.camera_rigs.clear()
+
+    def add_camera_rig(
+        self,
+        config: CameraRigConfig | None = None,
+        *,
+        mounts: Sequence[Any] | None = None,
+        poses: Sequence[tuple[Sequence[float], Sequence[float]]] | None = None,
+    ) -> CameraRig:
+        """
+        Add a group of same-resolution cameras rendered together (call before `build()`).
+
+        Args:
+            config: Resolution, FOV, frame skip and mount offsets.
+            mounts: Bodies to follow, one camera each (e.g. every `CarBlock.entity`).
+            poses: Static `(eye, lookat)` pairs instead of mounts.
+
+        Returns:
+            The rig; `rig.render(step)` returns a `[n_cams, H, W, C]` uint8 device tensor.
+        """
+        rig = CameraRig(self, config, mounts=mounts, poses=poses)
+        self.camera_rigs.append(rig)
+        return rig
+
+    def start_recording(
+        self,
+        config: RecorderConfig | str | Path,
+        *,
+        entities: Sequence[Any] | None = None,
+        camera: Any | None = None,
+        names: Sequence[str] | None = None,
+    ) -> EpisodeRecorder:
+        """
+        Start streaming episode data to disk (see `recorder.py`); returns the recorder.
+
+        Call `recorder.record(step, action=..., events=...)` after each `step()`. Encoding and
+        writes run on a background thread. `entities` defaults to every actor body.
+        """
+        self.stop_recording()
+        if not isinstance(config, RecorderConfig):
+            config = RecorderConfig(path=config)
+        self.recorder = EpisodeRecorder(self, config, entities=entities, camera=camera, names=names)
+        return self.recorder
+
+    def create_task(self, loaded: "LoadedEnvBundle", *, agent: Any | None = None) -> TaskRuntime:
+        """
+        Compile the bundle's `task` section into a device-side `TaskRuntime` (see `task.py`).
+
+        Call after `build()` (the scene is built if needed). `agent` overrides the task's agent
+        primitive, e.g. with an actor body spawned outside the bundle.
+        """
+        spec = loaded.bundle.task
+        if spec is None:
+            raise ValueError(f"Env bundle {loaded.bundle_dir} has no task section.")
+        if not self._built:
+            self.build()
+        return TaskRuntime(
+            self, spec, agent=agent, entities_by_id=loaded.entities_by_id, spawn_points=loaded.spawn_points
+        )
+
+    def stop_recording(self) -> None:
+        """Flush and close the active recorder (no-op if none)."""
+        rec, self.recorder = self.recorder, None
+        if rec is not None:
+            rec.close()
 
     def create_programmatic_scene(self, *, with_default_ground: bool = True) -> Any:
         """
@@ -330,12 +541,28 @@ class GenesisSim:
 
         # Genesis 0.3.x supports show_viewer=...
         scene_kwargs["show_viewer"] = (not self.config.headless)
+        if self.config.batch_render and hasattr(getattr(gs, "renderers", None), "BatchRenderer"):
+            try:
+                scene_kwargs["renderer"] = gs.renderers.BatchRenderer(use_rasterizer=True)
+            except Exception:
+                # Optional: falls back to per-camera rendering.
+                pass
         scene = gs.Scene(**scene_kwargs)  # type: ignore[attr-defined]
 
         self.scene = scene
         self._built = False
-        self._vel6_cache.clear()
-        self._force6_cache.clear()
+        self.actor_state.clear()
+        self._entity_batches.clear()
+        self._readback_buffers.clear()
+        self.collisions.clear()
+        self.ray_world.clear()
+        self._native_ray_methods.clear()
+        self._handles.clear()
+        self._initial_state = None
+        self._topology.clear()
+        self._kernel_cache_scene_seen = None
+        self._warmup_timings = None
+        self.camera_rigs.clear()
 
         if with_default_ground:
             # Add a ground plane if available.
@@ -354,9 +581,78 @@ class GenesisSim:
             raise RuntimeError("Scene is not created.")
         if self._built:
             return
+        if self.kernel_cache is not None:
+            self._kernel_cache_scene_seen = self.kernel_cache.scene_seen_before(self.topology_key())
         if hasattr(self.scene, "build"):
-            self.scene.build()
+            n_envs = int(self.config.n_envs)
+            if n_envs > 0:
+                self.scene.build(n_envs=n_envs, env_spacing=tuple(float(v) for v in self.config.env_spacing))
+            else:
+                self.scene.build()
         self._built = True
+        # Resolve accessors for every actor body up front so the first step doesn't probe.
+        for ent in self.actor_state.entities:
+            self.entity_handle(ent)
+        try:
+            self._initial_state = self.save_state()
+        except Exception:
+            # Optional: `reset()` is unavailable on Genesis versions without qpos accessors.
+            self._initial_state = None
+        if self.kernel_cache is not None:
+            self.kernel_cache.record_scene(self.topology_key(), n_entities=len(self._topology))
+
+    def topology_key(self) -> str:
+        """Content hash of the entities added so far (shapes, sizes, fixed/collision flags, assets)."""
+        return topology_hash(self._topology, n_envs=self.n_envs, substeps=self.config.substeps)
+
+    def warmup(self) -> dict[str, float]:
+        """
+        Compile the step, contact and raycast kernels ahead of time.
+
+        Builds the scene if needed, then runs one physics step, one contact fetch, one ray query
+        and one actor snapshot, and restores the pre-warmup state so the episode is unchanged.
+        (The step is skipped when this Genesis version cannot save/restore state.) With a
+        `kernel_cache_dir`, later processes load these kernels from disk instead of compiling.
+
+        Returns:
+            Seconds spent per phase (`step_s`, `contacts_s`, `raycast_s`, `snapshot_s`).
+        """
+        if self.scene is None:
+            raise RuntimeError("Scene is not created. Call create_programmatic_scene() first.")
+        self.build()
+        timings: dict[str, float] = {}
+        try:
+            state = self.save_state()
+        except Exception:
+            state = None
+        t0 = time.perf_counter()
+        if state is not None:
+            self.scene.step()
+        t1 = time.perf_counter()
+        self.collisions.warmup()
+        t2 = time.perf_counter()
+        self.raycast_batch(np.zeros((1, 3)), np.array([[1.0, 0.0, 0.0]]), 1.0)
+        t3 = time.perf_counter()
+        if self.actor_state.n:
+            self.snapshot()
+        t4 = time.perf_counter()
+        if state is not None:
+            self.restore_state(state)
+        timings.update(step_s=t1 - t0, contacts_s=t2 - t1, raycast_s=t3 - t2, snapshot_s=t4 - t3)
+        self._warmup_timings = timings
+        if self.kernel_cache is not None:
+            self.kernel_cache.record_scene(self.topology_key(), n_entities=len(self._topology), warmup=timings)
+        return timings
+
+    @property
+    def n_envs(self) -> int:
+        """Number of replicated envs (0 for an unbatched scene)."""
+        return max(0, int(self.config.n_envs))
+
+    @property
+    def batched(self) -> bool:
+        """True when the scene was built with Genesis `n_envs` replication."""
+        return self.n_envs > 0
 
     def load_scene_from_usd(self, usd_path: str | Path) -> Any:
         """
@@ -386,7 +682,9 @@ class GenesisSim:
                 "Failed to load USD. Install USD deps (e.g. `pip install -e \".[usd]\"`) and ensure `pxr` is available."
             ) from e
 
-        self.scene.add_entity(morph)  # type: ignore[misc]
+        entity = self.scene.add_entity(morph)  # type: ignore[misc]
+        self._topology.append(("mesh", file_digest(usd_path), True, True, 1.0))
+        self.ray_world.add_mesh(entity, lambda: _usd_world_triangles(usd_path))
         return self.scene
 
     def _add_bundle_world(self, *, bundle: Any, bundle_root: Path) -> Any | None:
@@ -433,22 +731,181 @@ class GenesisSim:
                     visualization=bool(bundle.world.visualization),
                     color=None,
                 )
-        try:
-            morph = gs.morphs.Mesh(
-                file=str(usd_path),
-                pos=bundle.world.pose.pos,
-                quat=bundle.world.pose.quat,
-                fixed=bool(bundle.world.fixed),
-                collision=bool(bundle.world.collision),
-                visualization=bool(bundle.world.visualization),
-                scale=float(bundle.world.scale),
+        digest = file_digest(usd_path)
+        lod = getattr(bundle.world, "collision_lod", None)
+        use_proxies = lod is not None and lod.type != "full" and bool(bundle.world.collision)
+        if use_proxies and not bool(bundle.world.fixed):
+            warnings.warn("world.collision_lod only applies to fixed worlds; colliding with the full USD mesh.")
+            use_proxies = False
+        # With proxies the USD mesh is render-only (and skipped if it is not rendered either).
+        collision = bool(bundle.world.collision) and not use_proxies
+        entity = None
+        if collision or bool(bundle.world.visualization):
+            try:
+                morph = gs.morphs.Mesh(
+                    file=str(usd_path),
+                    pos=bundle.world.pose.pos,
+                    quat=bundle.world.pose.quat,
+                    fixed=bool(bundle.world.fixed),
+                    collision=collision,
+                    visualization=bool(bundle.world.visualization),
+                    scale=float(bundle.world.scale),
+                )
+            except ImportError as e:
+                raise ImportError(
+                    "Failed to load USD. Install USD deps (e.g. `pip install -e \".[usd]\"`) and ensure `pxr` is available."
+                ) from e
+
+            entity = self.scene.add_entity(morph)  # type: ignore[misc]
+            self._topology.append(("mesh", digest, bool(bundle.world.fixed), collision, float(bundle.world.scale)))
+        if use_proxies:
+            proxy_entity = self._add_world_proxies(
+                usd_path=usd_path, digest=digest, world=bundle.world, bundle_root=bundle_root
             )
-        except ImportError as e:
-            raise ImportError(
-                "Failed to load USD. Install USD deps (e.g. `pip install -e \".[usd]\"`) and ensure `pxr` is available."
-            ) from e
+            return entity if entity is not None else proxy_entity
+        if bool(bundle.world.fixed) and collision:
+            pose = bundle.world.pose
+            scale = float(bundle.world.scale)
+            self.ray_world.add_mesh(
+                entity, lambda: _usd_world_triangles(usd_path, pos=pose.pos, quat=pose.quat, scale=scale)
+            )
+        return entity
+
+    def _surface(self, gs: Any, color: tuple[float, ...] | None) -> Any | None:
+        """`_maybe_make_surface`, deduplicated by normalized color while assets are shared."""
+        if self._shared_assets is None or color is None:
+            return _maybe_make_surface(gs, color)
+        key = ("surface", _normalize_rgb(tuple(color)))
+        if key not in self._shared_assets:
+            self._shared_assets[key] = _maybe_make_surface(gs, color)
+        return self._shared_assets[key]
+
+    def _rigid_material(self, gs: Any, *, mass: float | None, volume: float, fixed: bool) -> Any | None:
+        """`_maybe_make_rigid_material`, deduplicated by density while assets are shared."""
+        if self._shared_assets is None or mass is None or fixed or float(mass) <= 0.0 or volume <= 0.0:
+            return _maybe_make_rigid_material(gs, mass=mass, volume=volume, fixed=fixed)
+        key = ("rigid", float(mass) / float(volume))
+        if key not in self._shared_assets:
+            self._shared_assets[key] = _maybe_make_rigid_material(gs, mass=mass, volume=volume, fixed=fixed)
+        return self._shared_assets[key]
+
+    def _add_world_proxies(self, *, usd_path: Path, digest: str, world: Any, bundle_root: Path) -> Any | None:
+        """
+        Add the collision-only LOD proxies of the USD world (`world.collision_lod`).
+
+        Proxies are built from the stage triangles once and cached next to the bundle (see
+        `world_lod`); returns the proxy entity, or None if the stage has no triangles.
+        """
+        from kiln.envio.bundle import Pose, PrimitiveSpec
 
-        return self.scene.add_entity(morph)  # type: ignore[misc]
+        from .world_lod import load_world_proxies, place_points, world_proxy_cache_dirs, write_convex_mjcf
+
+        if self.scene is None:
+            raise RuntimeError("Scene is not created.")
+        gs = self._gs or _import_genesis()
+        pose, scale = world.pose, float(world.scale)
+        proxies = load_world_proxies(
+            world.collision_lod,
+            source_digest=digest,
+            load_triangles=lambda: _usd_world_triangles(usd_path),
+            cache_dirs=world_proxy_cache_dirs(bundle_root),
+        )
+        if proxies is None:
+            warnings.warn(
+                f"No triangles read from {usd_path} (is `pxr` installed?); the world has no collision geometry."
+            )
+            return None
+
+        if proxies.kind == "heightfield":
+            assert proxies.heights is not None
+            rot = quat_to_matrix([tuple(pose.quat)])[0]
+            if abs(float(rot[2, 2]) - 1.0) > 1e-6:
+                warnings.warn("Heightfield collision proxies assume the world keeps +z up; the pose tilts it.")
+            corner = place_points([proxies.origin[0], proxies.origin[1], 0.0], pose.pos, pose.quat, scale)
+            kwargs: dict[str, Any] = dict(
+                height_field=proxies.heights,
+                horizontal_scale=proxies.cell_size * scale,
+                vertical_scale=scale,
+                pos=tuple(float(v) for v in corner),
+            )
+            try:
+                morph = gs.morphs.Terrain(**kwargs, quat=pose.quat, visualization=False)
+            except TypeError:
+                # Older Terrain morphs without orientation / visualization switches.
+                morph = gs.morphs.Terrain(**kwargs)
+            entity = self.scene.add_entity(morph)  # type: ignore[misc]
+        else:
+            directory = self._compound_dir()
+            if proxies.kind == "boxes":
+                centers = place_points(proxies.centers, pose.pos, pose.quat, scale)
+                prims = [
+                    PrimitiveSpec(
+                        id=f"lod{i}",
+                        shape="box",
+                        pose=Pose(pos=tuple(float(v) for v in c), quat=tuple(pose.quat)),
+                        fixed=True,
+                        size=tuple(float(2.0 * v * scale) for v in h),
+                    )
+                    for i, (c, h) in enumerate(zip(centers, proxies.halves))
+                ]
+                path = write_static_compound(prims, directory, name="kiln_world_lod")
+            else:
+                hulls = [(place_points(v, pose.pos, pose.quat, scale), f) for v, f in proxies.hulls]
+                path = write_convex_mjcf(hulls, directory)
+            try:
+                morph = gs.morphs.MJCF(file=str(path), collision=True, visualization=False)
+            except TypeError:
+                morph = gs.morphs.MJCF(file=str(path))
+            entity = self.scene.add_entity(morph)  # type: ignore[misc]
+            if proxies.kind == "boxes":
+                for p in prims:
+                    self.ray_world.add_shape(
+                        entity, "box", fixed=True, pos=p.pose.pos, quat=p.pose.quat, half_extents=_half_extents(p)
+                    )
+        self._topology.append(("world_lod", proxies.key, pose.to_json(), scale))
+        if proxies.kind != "boxes":
+            self.ray_world.add_mesh(entity, lambda: place_points(proxies.triangles(), pose.pos, pose.quat, scale))
+        return entity
+
+    def _compound_dir(self) -> Path:
+        """Directory for generated MJCF files (the kernel cache if configured, else the temp dir)."""
+        if self.kernel_cache is not None:
+            return self.kernel_cache.dir / "compounds"
+        return Path(tempfile.gettempdir()) / "kiln_compounds"
+
+    def _add_bundle_static_compounds(self, prims: Sequence[Any]) -> list[tuple[Any, tuple[str, ...]]]:
+        """
+        Add fixed box/sphere/cylinder primitives as static compound entities.
+
+        One fixed MJCF body per (collision, visualization) combination holds one geom per
+        primitive; returns `(entity, primitive ids)` per compound.
+        """
+        if self.scene is None:
+            raise RuntimeError("Scene is not created.")
+        gs = self._gs or _import_genesis()
+        directory = self._compound_dir()
+
+        groups: dict[tuple[bool, bool], list[Any]] = {}
+        for p in prims:
+            groups.setdefault((bool(p.collision), bool(p.visualization)), []).append(p)
+
+        out: list[tuple[Any, tuple[str, ...]]] = []
+        for i, ((collision, visualization), group) in enumerate(groups.items()):
+            path = write_static_compound(group, directory, name=f"kiln_static_{i}")
+            try:
+                morph = gs.morphs.MJCF(file=str(path), collision=collision, visualization=visualization)
+            except TypeError:
+                # Older morphs without per-morph collision/visualization switches.
+                morph = gs.morphs.MJCF(file=str(path))
+            entity = self.scene.add_entity(morph)  # type: ignore[misc]
+            self._topology.append(("compound", path.stem, collision, visualization))
+            if collision:
+                for p in group:
+                    self.ray_world.add_shape(
+                        entity, p.shape, fixed=True, pos=p.pose.pos, quat=p.pose.quat, half_extents=_half_extents(p)
+                    )
+            out.append((entity, tuple(p.id for p in group)))
+        return out
 
     def _add_bundle_primitive(self, prim: Any) -> Any:
         """Spawn a single primitive from an env-bundle PrimitiveSpec."""
@@ -515,15 +972,28 @@ class GenesisSim:
             case _:
                 raise EnvBundleError(f"Unsupported primitive shape: {prim.shape!r}")
 
-    def load_env_bundle(self, bundle_dir: str | Path, *, env_filename: str = "env.json") -> LoadedEnvBundle:
+    def load_env_bundle(
+        self,
+        bundle_dir: str | Path,
+        *,
+        env_filename: str = "env.json",
+        merge_static: bool = False,
+    ) -> LoadedEnvBundle:
         """
         Load a Kiln env bundle directory (USD geometry + env.json semantics) into this GenesisSim.
 
+        Args:
+            bundle_dir: Bundle directory path.
+            env_filename: Name of the JSON sidecar file within the bundle.
+            merge_static: Merge fixed box/sphere/cylinder primitives into a few static compound
+                entities (see `compound.py`) and share surfaces/materials between the remaining
+                primitives with equal color/density. Merged ids all map to their compound entity.
+
         Returns:
             LoadedEnvBundle: typed bundle contents + entity mapping.
         """
         from kiln.envio.bundle import EnvBundleError, load_env_bundle as _load_env_bundle
-        from kiln.envio.runtime import LoadedEnvBundle
+        from kiln.envio.runtime import LoadedEnvBundle, MergedPrimitives
 
         bundle_root = Path(bundle_dir)
         bundle = _load_env_bundle(bundle_root, env_filename=env_filename)
@@ -542,10 +1012,32 @@ class GenesisSim:
         if world_entity is not None:
             entities["world"] = world_entity
 
+        seen = set(entities)
         for prim in bundle.primitives:
-            if prim.id in entities:
+            if prim.id in seen:
                 raise EnvBundleError(f"Duplicate entity id in bundle: {prim.id!r}")
-            entities[prim.id] = self._add_bundle_primitive(prim)
+            seen.add(prim.id)
+
+        prims = list(bundle.primitives)
+        merged: list[MergedPrimitives] = []
+        if merge_static and hasattr(self._gs.morphs, "MJCF"):
+            static = [p for p in prims if can_merge(p)]
+            # A single primitive gains nothing from a compound.
+            if len(static) > 1:
+                for entity, ids in self._add_bundle_static_compounds(static):
+                    merged.append(MergedPrimitives(entity=entity, ids=ids))
+                    entities.update(dict.fromkeys(ids, entity))
+                prims = [p for p in prims if p.id not in entities]
+
+        self._shared_assets = {} if merge_static else None
+        try:
+            for prim in prims:
+                entities[prim.id] = self._add_bundle_primitive(prim)
+        finally:
+            self._shared_assets = None
+        # Keep `entities_by_id` in bundle order.
+        ordered = {"world": world_entity} if world_entity is not None else {}
+        ordered.update((p.id, entities[p.id]) for p in bundle.primitives)
 
         # Build once after adding all entities.
         self.build()
@@ -554,9 +1046,10 @@ class GenesisSim:
         return LoadedEnvBundle(
             bundle_dir=bundle_root,
             bundle=bundle,
-            entities_by_id=entities,
+            entities_by_id=ordered,
             world_entity=world_entity,
             spawn_points=spawn_points,
+            merged=tuple(merged),
         )
 
     # ----------------------------
@@ -568,8 +1061,15 @@ class GenesisSim:
             raise RuntimeError("Scene is not created. Call create_programmatic_scene() first.")
         if not self._built:
             self.build()
+        prof = self.profiler
+        if not prof.enabled:
+            for _ in range(n):
+                self.scene.step()
+            return
         for _ in range(n):
-            self.scene.step()
+            with prof.phase("step", gpu=True):
+                self.scene.step()
+            prof.end_step()
 
     # ----------------------------
     # Entity creation helpers
@@ -608,8 +1108,12 @@ class GenesisSim:
                 collision=bool(collision),
                 visualization=bool(visualization),
             )
-            surface = _maybe_make_surface(gs, color)
-            return self.scene.add_entity(morph, surface=surface)  # type: ignore[misc]
+            surface = self._surface(gs, color)
+            entity = self.scene.add_entity(morph, surface=surface)  # type: ignore[misc]
+            self._topology.append(("plane", bool(fixed), bool(collision)))
+            if collision:
+                self.ray_world.add_plane(entity, pos=position, normal=normal)
+            return entity
 
         raise RuntimeError("Genesis Plane morph is not available in this version.")
 
@@ -654,12 +1158,17 @@ class GenesisSim:
             vol = float(size[0]) * float(size[1]) * float(size[2])
             if vol <= 0.0:
                 raise ValueError(f"Invalid box size/volume: size={size!r}")
-            material = _maybe_make_rigid_material(gs, mass=mass, volume=vol, fixed=fixed)
-            surface = _maybe_make_surface(gs, color)
+            material = self._rigid_material(gs, mass=mass, volume=vol, fixed=fixed)
+            surface = self._surface(gs, color)
             # NOTE: Genesis morphs/entities don't currently accept a friendly name in this call
             # signature, so `name` is kept for future USD mapping only.
             _ = name
-            return self.scene.add_entity(morph, material=material, surface=surface)  # type: ignore[misc]
+            entity = self.scene.add_entity(morph, material=material, surface=surface)  # type: ignore[misc]
+            self._topology.append(("box", tuple(float(v) for v in size), fixed, bool(collision)))
+            if collision:
+                half = (0.5 * float(size[0]), 0.5 * float(size[1]), 0.5 * float(size[2]))
+                self.ray_world.add_shape(entity, "box", fixed=fixed, pos=position, quat=quat, half_extents=half)
+            return entity
 
         raise RuntimeError("Genesis Box morph is not available in this version.")
 
@@ -703,10 +1212,15 @@ class GenesisSim:
             vol = (4.0 / 3.0) * math.pi * float(radius) ** 3
             if vol <= 0.0:
                 raise ValueError(f"Invalid sphere radius/volume: radius={radius!r}")
-            material = _maybe_make_rigid_material(gs, mass=mass, volume=vol, fixed=fixed)
-            surface = _maybe_make_surface(gs, color)
+            material = self._rigid_material(gs, mass=mass, volume=vol, fixed=fixed)
+            surface = self._surface(gs, color)
             _ = name
-            return self.scene.add_entity(morph, material=material, surface=surface)  # type: ignore[misc]
+            entity = self.scene.add_entity(morph, material=material, surface=surface)  # type: ignore[misc]
+            self._topology.append(("sphere", float(radius), fixed, bool(collision)))
+            if collision:
+                r = float(radius)
+                self.ray_world.add_shape(entity, "sphere", fixed=fixed, pos=position, quat=quat, half_extents=(r, r, r))
+            return entity
 
         raise RuntimeError("Genesis Sphere morph is not available in this version.")
 
@@ -752,58 +1266,74 @@ class GenesisSim:
             vol = math.pi * float(radius) ** 2 * float(height)
             if vol <= 0.0:
                 raise ValueError(f"Invalid cylinder radius/height/volume: radius={radius!r} height={height!r}")
-            material = _maybe_make_rigid_material(gs, mass=mass, volume=vol, fixed=fixed)
-            surface = _maybe_make_surface(gs, color)
+            material = self._rigid_material(gs, mass=mass, volume=vol, fixed=fixed)
+            surface = self._surface(gs, color)
             _ = name
-            return self.scene.add_entity(morph, material=material, surface=surface)  # type: ignore[misc]
+            entity = self.scene.add_entity(morph, material=material, surface=surface)  # type: ignore[misc]
+            self._topology.append(("cylinder", float(radius), float(height), fixed, bool(collision)))
+            if collision:
+                r, hz = float(radius), 0.5 * float(height)
+                self.ray_world.add_shape(
+                    entity, "cylinder", fixed=fixed, pos=position, quat=quat, half_extents=(r, r, hz)
+                )
+            return entity
 
         raise RuntimeError("Genesis Cylinder morph is not available in this version.")
 
     # ----------------------------
     # Query / control helpers
     # ----------------------------
-    def get_position(self, entity: Any) -> tuple[float, float, float]:
-        """Best-effort read of an entity's XYZ position as Python floats."""
-        for attr in ("position", "pos"):
-            if hasattr(entity, attr):
-                v = _to_cpu_once(getattr(entity, attr))
-                try:
-                    return (float(v[0]), float(v[1]), float(v[2]))
-                except Exception:
-                    pass
+    def entity_handle(self, entity: Any) -> EntityHandle:
+        """
+        Return `entity`'s accessor handle (Genesis API probed once, cached after `build()`).
+
+        Before the scene is built, handles are re-resolved on every call since position
+        tensors may not be live yet.
+        """
+        h = self._handles.get(id(entity))
+        if h is not None and h.entity is entity:
+            return h
+        h = resolve_entity_handle(entity)
+        if self._built:
+            self._handles[id(entity)] = h
+        return h
 
-        for method in ("get_position", "get_pos"):
-            if hasattr(entity, method):
-                v = _to_cpu_once(getattr(entity, method)())
-                return (float(v[0]), float(v[1]), float(v[2]))
+    def get_position(self, entity: Any) -> tuple[float, float, float]:
+        """
+        Best-effort read of an entity's XYZ position as Python floats.
 
-        raise AttributeError("Entity has no readable position.")
+        In batched mode this reads env 0; use `get_positions_batch` for all envs.
+        """
+        reader = self.entity_handle(entity).read_position
+        if reader is None:
+            raise AttributeError("Entity has no readable position.")
+        prof = self.profiler
+        if not prof.enabled:
+            return reader()
+        with prof.phase("readback"):
+            xyz = reader()
+        if getattr(self._device(), "type", "cpu") != "cpu":
+            prof.transfer(3 * int(getattr(self._float_dtype(), "itemsize", 4)))
+        return xyz
 
     def set_position(self, entity: Any, position: tuple[float, float, float]) -> None:
         """Best-effort set of an entity's XYZ position."""
-        for method in ("set_position", "set_pos"):
-            if hasattr(entity, method):
-                getattr(entity, method)(position)
-                return
-        raise AttributeError("Entity has no set_position method.")
+        setter = self.entity_handle(entity).set_position
+        if setter is None:
+            raise AttributeError("Entity has no set_position method.")
+        setter(position)
 
     def set_linear_velocity(self, entity: Any, v_xyz: tuple[float, float, float]) -> None:
         """Set the entity's linear velocity (vx, vy, vz), preserving cached angular components."""
-        key = id(entity)
-        vx, vy, vz = v_xyz
-        _, _, _, wx, wy, wz = self._vel6_cache.get(key, (0.0, 0.0, 0.0, 0.0, 0.0, 0.0))
-        vel6 = (float(vx), float(vy), float(vz), float(wx), float(wy), float(wz))
-        self._set_dofs_velocity6(entity, vel6)
-        self._vel6_cache[key] = vel6
+        row = self.actor_state.vel6[self.actor_state.add(entity)]
+        row[0:3] = v_xyz
+        self._set_dofs_velocity6(entity, row.tolist())
 
     def set_angular_velocity(self, entity: Any, w_xyz: tuple[float, float, float]) -> None:
         """Set the entity's angular velocity (wx, wy, wz), preserving cached linear components."""
-        key = id(entity)
-        wx, wy, wz = w_xyz
-        vx, vy, vz, _, _, _ = self._vel6_cache.get(key, (0.0, 0.0, 0.0, 0.0, 0.0, 0.0))
-        vel6 = (float(vx), float(vy), float(vz), float(wx), float(wy), float(wz))
-        self._set_dofs_velocity6(entity, vel6)
-        self._vel6_cache[key] = vel6
+        row = self.actor_state.vel6[self.actor_state.add(entity)]
+        row[3:6] = w_xyz
+        self._set_dofs_velocity6(entity, row.tolist())
 
     def set_linear_angular_velocity(
         self,
@@ -814,54 +1344,403 @@ class GenesisSim:
         """
         Set linear+angular velocity in one call (avoids two `set_dofs_velocity` calls per step).
         """
-        key = id(entity)
-        vx, vy, vz = v_xyz
-        wx, wy, wz = w_xyz
-        vel6 = (float(vx), float(vy), float(vz), float(wx), float(wy), float(wz))
-        self._set_dofs_velocity6(entity, vel6)
-        self._vel6_cache[key] = vel6
+        row = self.actor_state.vel6[self.actor_state.add(entity)]
+        row[0:3] = v_xyz
+        row[3:6] = w_xyz
+        self._set_dofs_velocity6(entity, row.tolist())
 
     def apply_force(self, entity: Any, f_xyz: tuple[float, float, float]) -> None:
         """Apply a force (fx, fy, fz), preserving cached torque components."""
-        key = id(entity)
-        fx, fy, fz = f_xyz
-        _, _, _, tx, ty, tz = self._force6_cache.get(key, (0.0, 0.0, 0.0, 0.0, 0.0, 0.0))
-        force6 = (float(fx), float(fy), float(fz), float(tx), float(ty), float(tz))
-        self._set_dofs_force6(entity, force6)
-        self._force6_cache[key] = force6
+        row = self.actor_state.force6[self.actor_state.add(entity)]
+        row[0:3] = f_xyz
+        self._set_dofs_force6(entity, row.tolist())
 
     def apply_torque(self, entity: Any, tau_xyz: tuple[float, float, float]) -> None:
         """Apply a torque (tx, ty, tz), preserving cached force components."""
-        key = id(entity)
-        tx, ty, tz = tau_xyz
-        fx, fy, fz, _, _, _ = self._force6_cache.get(key, (0.0, 0.0, 0.0, 0.0, 0.0, 0.0))
-        force6 = (float(fx), float(fy), float(fz), float(tx), float(ty), float(tz))
-        self._set_dofs_force6(entity, force6)
-        self._force6_cache[key] = force6
-
-    def _set_dofs_velocity6(self, entity: Any, vel6: tuple[float, float, float, float, float, float]) -> None:
+        row = self.actor_state.force6[self.actor_state.add(entity)]
+        row[3:6] = tau_xyz
+        self._set_dofs_force6(entity, row.tolist())
+
+    def _set_dofs_velocity6(self, entity: Any, vel6: Sequence[float]) -> None:
         """Best-effort set of a 6-DoF base velocity on a Genesis entity."""
-        # NOTE: In Genesis 0.3.x, `control_dofs_velocity()` does not appear to move free rigid
-        # bodies (it's intended for articulated/actuated control). For kinematic-ish control
-        # of rigid entities, we prefer `set_dofs_velocity()` to directly set base DoF velocity.
-        if hasattr(entity, "set_dofs_velocity"):
-            entity.set_dofs_velocity(vel6)
+        # `set_dofs_velocity()` is preferred over `control_dofs_velocity()` (see `resolve_entity_handle`).
+        setter = self.entity_handle(entity).set_dofs_velocity
+        if setter is None:
+            raise AttributeError("Entity has no supported dofs velocity setter.")
+        with self.profiler.phase("control"):
+            setter(self._broadcast_envs(vel6))
+
+    def _set_dofs_force6(self, entity: Any, force6: Sequence[float]) -> None:
+        """Best-effort application of a 6-DoF base force/torque on a Genesis entity."""
+        setter = self.entity_handle(entity).control_dofs_force
+        if setter is None:
+            raise AttributeError("Entity has no supported dofs force control method.")
+        with self.profiler.phase("control"):
+            setter(self._broadcast_envs(force6))
+
+    def _broadcast_envs(self, values: Sequence[float]) -> Any:
+        """Repeat a per-entity DoF vector across envs in batched mode (no-op when unbatched)."""
+        if not self.batched:
+            return values
+        torch = _import_torch()
+        return torch.tensor(values, dtype=self._float_dtype(), device=self._device()).expand(self.n_envs, len(values))
+
+    # ----------------------------
+    # Batched state I/O
+    # ----------------------------
+    def _rigid_solver(self) -> Any | None:
+        """Return the scene's rigid solver (None if unavailable in this Genesis version)."""
+        if self.scene is None:
+            return None
+        solver = getattr(self.scene, "rigid_solver", None)
+        if solver is None:
+            solver = getattr(getattr(self.scene, "sim", None), "rigid_solver", None)
+        return solver
+
+    def _device(self) -> Any | None:
+        return getattr(self._gs, "device", None)
+
+    def _float_dtype(self) -> Any:
+        torch = _import_torch()
+        return getattr(self._gs, "tc_float", None) or torch.float32
+
+    def entity_batch(self, entities: Sequence[Any]) -> EntityBatch:
+        """
+        Resolve (and cache) solver indices for an ordered group of entities.
+
+        The scene is built lazily if needed, since indices are only final after `build()`.
+        Reuse the same ordered group every step so the cached indices are hit.
+        """
+        if self.scene is None:
+            raise RuntimeError("Scene is not created.")
+        if not self._built:
+            self.build()
+        key = tuple(id(e) for e in entities)
+        batch = self._entity_batches.get(key)
+        if batch is None:
+            batch = resolve_entity_batch(entities, device=self._device())
+            self._entity_batches[key] = batch
+        return batch
+
+    def _as_batch(self, entities: Sequence[Any] | EntityBatch) -> EntityBatch:
+        return entities if isinstance(entities, EntityBatch) else self.entity_batch(entities)
+
+    def get_positions_batch(self, entities: Sequence[Any] | EntityBatch, *, envs_idx: Any | None = None) -> Any:
+        """
+        Read base positions for a group of entities in one solver call.
+
+        Returns:
+            Tensor `[n_envs, n_entities, 3]` (batched) or `[n_entities, 3]` (unbatched), on the
+            Genesis device.
+        """
+        torch = _import_torch()
+        batch = self._as_batch(entities)
+        solver = self._rigid_solver()
+        if solver is not None and batch.links_idx is not None and hasattr(solver, "get_links_pos"):
+            return solver.get_links_pos(batch.links_idx, envs_idx)
+
+        # Fallback: per-entity reads stacked along the entity axis.
+        rows = []
+        for ent in batch.entities:
+            getter = getattr(ent, "get_pos", None) or getattr(ent, "get_position")
+            rows.append(getter(envs_idx) if (self.batched and envs_idx is not None) else getter())
+        return torch.stack([torch.as_tensor(r) for r in rows], dim=-2)
+
+    def get_quats_batch(self, entities: Sequence[Any] | EntityBatch, *, envs_idx: Any | None = None) -> Any:
+        """
+        Read base orientations `(w, x, y, z)` for a group of entities in one solver call.
+
+        Returns:
+            Tensor `[n_envs, n_entities, 4]` (batched) or `[n_entities, 4]` (unbatched).
+        """
+        torch = _import_torch()
+        batch = self._as_batch(entities)
+        solver = self._rigid_solver()
+        if solver is not None and batch.links_idx is not None and hasattr(solver, "get_links_quat"):
+            return solver.get_links_quat(batch.links_idx, envs_idx)
+
+        rows = []
+        for ent in batch.entities:
+            getter = getattr(ent, "get_quat")
+            rows.append(getter(envs_idx) if (self.batched and envs_idx is not None) else getter())
+        return torch.stack([torch.as_tensor(r) for r in rows], dim=-2)
+
+    def get_positions(self, entities: Sequence[Any] | EntityBatch) -> PositionSnapshot:
+        """
+        Bulk host readback of base positions for a group of entities.
+
+        One batched solver read plus a single device->host copy into a reused (pinned on CUDA)
+        host buffer, instead of one `get_position` call (and sync) per entity. Buffers are kept
+        per calling thread. The result can be passed anywhere a `positions_by_id` dict is accepted.
+        """
+        batch = self._as_batch(entities)
+        with self.profiler.phase("readback"):
+            pos = self.get_positions_batch(batch)
+            if getattr(getattr(pos, "device", None), "type", "cpu") == "cpu":
+                host = pos.detach()
+            else:
+                key = (threading.get_ident(), tuple(id(e) for e in batch.entities))
+                with self._readback_lock:
+                    host = self._readback_buffers.get(key)
+                    if host is None or tuple(host.shape) != tuple(pos.shape) or host.dtype != pos.dtype:
+                        torch = _import_torch()
+                        host = torch.empty(tuple(pos.shape), dtype=pos.dtype, pin_memory=True)
+                        self._readback_buffers[key] = host
+                self.profiler.d2h(pos)
+                host.copy_(pos)
+        return PositionSnapshot(host.numpy(), batch.index, batch.entities)
+
+    def snapshot(self) -> PositionSnapshot:
+        """
+        Bulk readback of every entity registered in `actor_state` (all actor bodies).
+
+        Also refreshes the store's `position` column, so actor bodies see the new positions
+        without per-actor reads.
+        """
+        st = self.actor_state
+        snap = self.get_positions(st.entities)
+        rows = snap.positions[0] if snap.positions.ndim == 3 else snap.positions
+        st.position[: st.n] = rows
+        return snap
+
+    def get_velocities_batch(self, entities: Sequence[Any] | EntityBatch, *, envs_idx: Any | None = None) -> Any:
+        """
+        Read 6-DoF base velocities for a group of free bodies in one solver call.
+
+        Returns:
+            Tensor `[n_envs, n_entities, 6]` (batched) or `[n_entities, 6]` (unbatched).
+        """
+        batch = self._as_batch(entities)
+        if not batch.controllable:
+            raise ValueError("All entities in the batch must be free 6-DoF bodies.")
+        solver = self._rigid_solver()
+        if solver is not None and hasattr(solver, "get_dofs_velocity"):
+            v = solver.get_dofs_velocity(batch.dofs_idx, envs_idx)
+        else:
+            torch = _import_torch()
+            v = torch.cat([torch.as_tensor(e.get_dofs_velocity()) for e in batch.entities], dim=-1)
+        return v.reshape(*v.shape[:-1], len(batch), DOFS_PER_BODY)
+
+    def set_dofs_velocity_batch(
+        self,
+        entities: Sequence[Any] | EntityBatch,
+        vel6: Any,
+        *,
+        envs_idx: Any | None = None,
+    ) -> None:
+        """
+        Set 6-DoF base velocities for a group of free bodies in one solver call.
+
+        Args:
+            entities: Entities (or a pre-resolved `EntityBatch`).
+            vel6: `[n_envs, n_entities, 6]` / `[n_entities, 6]` tensor or array-like. In batched
+                mode a `[n_entities, 6]` input is broadcast to every selected env.
+            envs_idx: Optional env indices to write (batched mode only).
+        """
+        batch = self._as_batch(entities)
+        with self.profiler.phase("control"):
+            self._write_dofs_batch(batch, vel6, envs_idx=envs_idx, solver_method="set_dofs_velocity")
+
+    def apply_dofs_force_batch(
+        self,
+        entities: Sequence[Any] | EntityBatch,
+        force6: Any,
+        *,
+        envs_idx: Any | None = None,
+    ) -> None:
+        """Apply 6-DoF base force/torque to a group of free bodies in one solver call (see `set_dofs_velocity_batch`)."""
+        batch = self._as_batch(entities)
+        with self.profiler.phase("control"):
+            self._write_dofs_batch(batch, force6, envs_idx=envs_idx, solver_method="control_dofs_force")
+
+    def _write_dofs_batch(self, batch: EntityBatch, values: Any, *, envs_idx: Any | None, solver_method: str) -> None:
+        if not batch.controllable:
+            raise ValueError("All entities in the batch must be free 6-DoF bodies.")
+        if len(batch) == 0:
             return
-        if hasattr(entity, "control_dofs_velocity"):
-            entity.control_dofs_velocity(vel6)
+        v = as_dof_tensor(
+            values,
+            n_entities=len(batch),
+            n_envs=self.n_envs,
+            n_envs_selected=count_envs(envs_idx, self.n_envs),
+            dtype=self._float_dtype(),
+            device=self._device(),
+        )
+        solver = self._rigid_solver()
+        if solver is not None and hasattr(solver, solver_method):
+            if envs_idx is None:
+                getattr(solver, solver_method)(v, batch.dofs_idx)
+            else:
+                getattr(solver, solver_method)(v, batch.dofs_idx, envs_idx)
             return
-        raise AttributeError("Entity has no supported dofs velocity setter.")
 
-    def _set_dofs_force6(self, entity: Any, force6: tuple[float, float, float, float, float, float]) -> None:
-        """Best-effort application of a 6-DoF base force/torque on a Genesis entity."""
-        if hasattr(entity, "control_dofs_force"):
-            entity.control_dofs_force(force6)
-            return
-        raise AttributeError("Entity has no supported dofs force control method.")
+        # Fallback: per-entity writes of the matching DoF slice.
+        for i, ent in enumerate(batch.entities):
+            part = v[..., i * DOFS_PER_BODY : (i + 1) * DOFS_PER_BODY]
+            if envs_idx is None:
+                getattr(ent, solver_method)(part)
+            else:
+                getattr(ent, solver_method)(part, envs_idx=envs_idx)
+
+    # ----------------------------
+    # State snapshots (episode reset without rebuild)
+    # ----------------------------
+    def _rigid_entities(self) -> list[Any]:
+        """Rigid entities with generalized coordinates (fixed entities without qpos are skipped)."""
+        solver = self._rigid_solver()
+        ents = getattr(solver, "entities", None) if solver is not None else None
+        if ents is None:
+            ents = getattr(self.scene, "entities", None) or []
+        return [e for e in ents if hasattr(e, "get_qpos") and int(getattr(e, "n_qs", 1)) > 0]
+
+    def save_state(self) -> SimStateSnapshot:
+        """
+        Capture qpos/qvel of every rigid entity plus the actor state store.
+
+        The copies stay on the simulation device, so saving and restoring are memcpys instead
+        of a scene rebuild. A snapshot is only valid for the scene it was taken from.
+        """
+        if self.scene is None or not self._built:
+            raise RuntimeError("Scene is not built. Call build() first.")
+        st = self.actor_state
+        actor = {"actor_entities": tuple(st.entities), "actor_columns": st.save_columns()}
+        solver = self._rigid_solver()
+        if solver is not None and all(
+            hasattr(solver, m) for m in ("get_qpos", "set_qpos", "get_dofs_velocity", "set_dofs_velocity")
+        ):
+            return SimStateSnapshot(qpos=_clone(solver.get_qpos()), dofs_vel=_clone(solver.get_dofs_velocity()), **actor)
+
+        states = []
+        for ent in self._rigid_entities():
+            vel = ent.get_dofs_velocity() if hasattr(ent, "get_dofs_velocity") else None
+            states.append((ent, _clone(ent.get_qpos()), None if vel is None else _clone(vel)))
+        return SimStateSnapshot(entity_states=tuple(states), **actor)
+
+    def restore_state(self, snapshot: SimStateSnapshot, *, envs_idx: Any | None = None) -> None:
+        """
+        Restore a `save_state()` snapshot.
+
+        Args:
+            snapshot: State saved from this scene.
+            envs_idx: Batched scenes only: restore just these envs (masked reset). The actor
+                state store is shared by all envs, so it is only restored when `envs_idx` is None.
+        """
+        if self.scene is None or not self._built:
+            raise RuntimeError("Scene is not built. Call build() first.")
+        if envs_idx is not None and not self.batched:
+            raise ValueError("envs_idx requires a batched scene (n_envs > 0).")
+        st = self.actor_state
+        k = len(snapshot.actor_entities)
+        if k > st.n or any(a is not b for a, b in zip(snapshot.actor_entities, st.entities)):
+            raise ValueError("Snapshot was taken from a different scene.")
+
+        solver = self._rigid_solver()
+        if snapshot.qpos is not None:
+            if envs_idx is None:
+                solver.set_qpos(snapshot.qpos)
+                solver.set_dofs_velocity(snapshot.dofs_vel)
+            else:
+                qpos, idx = _select_envs(snapshot.qpos, envs_idx)
+                vel, _ = _select_envs(snapshot.dofs_vel, envs_idx)
+                solver.set_qpos(qpos, envs_idx=idx)
+                solver.set_dofs_velocity(vel, envs_idx=idx)
+        else:
+            for ent, qpos, vel in snapshot.entity_states:
+                if envs_idx is None:
+                    ent.set_qpos(qpos)
+                    if vel is not None:
+                        ent.set_dofs_velocity(vel)
+                else:
+                    q, idx = _select_envs(qpos, envs_idx)
+                    ent.set_qpos(q, envs_idx=idx)
+                    if vel is not None:
+                        ent.set_dofs_velocity(_select_envs(vel, envs_idx)[0], envs_idx=idx)
+
+        if envs_idx is None:
+            st.restore_columns(snapshot.actor_columns)
+
+    def reset(self, *, envs_idx: Any | None = None) -> None:
+        """Restore the state captured at the end of `build()` (all envs, or only `envs_idx`)."""
+        if self._initial_state is None:
+            raise RuntimeError("No initial state: build() the scene first (requires Genesis qpos accessors).")
+        self.restore_state(self._initial_state, envs_idx=envs_idx)
 
     # ----------------------------
     # Optional spatial queries
     # ----------------------------
+    def _native_ray_method(self, names: tuple[str, ...]) -> Any | None:
+        """First of `names` the scene implements (probed once per scene)."""
+        if self.scene is None:
+            return None
+        if names not in self._native_ray_methods:
+            self._native_ray_methods[names] = next((n for n in names if hasattr(self.scene, n)), None)
+        name = self._native_ray_methods[names]
+        return getattr(self.scene, name) if name is not None else None
+
+    def _ray_poses(self, entities: Sequence[Any]) -> tuple[np.ndarray, np.ndarray]:
+        """Current env-0 positions/orientations of dynamic ray shapes (two bulk reads)."""
+        batch = self.entity_batch(entities)
+        pos = self.get_positions_batch(batch)
+        quat = self.get_quats_batch(batch)
+        if self.batched:
+            pos, quat = pos[0], quat[0]
+        return self._to_host(pos), self._to_host(quat)
+
+    def _to_host(self, v: Any) -> np.ndarray:
+        """`_host_array` that reports device->host copies to the profiler."""
+        self.profiler.d2h(v)
+        return _host_array(v)
+
+    def raycast_batch(self, origins: Any, directions: Any, max_distance: Any = 5.0) -> RaycastBatch:
+        """
+        Cast many rays at once and return the closest hit per ray.
+
+        Args:
+            origins: `[n, 3]` (or one `[3]` origin shared by all rays); numpy or torch.
+            directions: `[n, 3]` directions (normalized here; zero vectors never hit).
+            max_distance: Scalar or `[n]` ray lengths.
+
+        A native batched scene query is used when this Genesis version has one. Otherwise
+        rays are tested against the shapes spawned through the `add_*` helpers and
+        `load_env_bundle` (planes, boxes, spheres, cylinders and, with USD installed, world
+        mesh triangles): static geometry through a BVH built once, dynamic bodies at their
+        current (env 0) pose through a refit BVH. `RaycastBatch.as_torch()` converts the
+        result to tensors.
+        """
+        if self.scene is None:
+            raise RuntimeError("Scene is not created.")
+        with self.profiler.phase("raycast"):
+            return self._raycast_batch(origins, directions, max_distance)
+
+    def _raycast_batch(self, origins: Any, directions: Any, max_distance: Any) -> RaycastBatch:
+        native = self._native_ray_method(("raycast_batch", "cast_rays"))
+        if native is not None:
+            try:
+                res = native(origins=origins, directions=directions, max_distance=max_distance)
+            except TypeError:
+                res = native(origins, directions, max_distance)
+            if isinstance(res, RaycastBatch):
+                return res
+            if isinstance(res, Mapping):
+                dist = self._to_host(res["distance"]).reshape(-1)
+                hit = np.asarray(self._to_host(res["hit"]) if "hit" in res else np.isfinite(dist), dtype=bool).reshape(-1)
+                n = hit.shape[0]
+                return RaycastBatch(
+                    hit=hit,
+                    distance=np.where(hit, dist, np.inf),
+                    position=self._to_host(res["position"]).reshape(n, 3) if "position" in res else np.full((n, 3), np.nan),
+                    normal=self._to_host(res["normal"]).reshape(n, 3) if "normal" in res else np.zeros((n, 3)),
+                    collider=np.asarray(res.get("collider", np.full(n, -1)), dtype=np.intp).reshape(-1),
+                    colliders=tuple(res.get("colliders", ())),
+                )
+
+        return self.ray_world.cast(
+            self._to_host(origins),
+            self._to_host(directions),
+            self._to_host(max_distance),
+            pose_reader=self._ray_poses if self._built else None,
+        )
+
     def raycast(
         self,
         origin: tuple[float, float, float],
@@ -871,30 +1750,32 @@ class GenesisSim:
         """
         Best-effort raycast wrapper.
 
-        Returns RaycastHit(hit=False) if unsupported.
+        Uses a native scene ray query if this Genesis version has one; otherwise a one-ray
+        `raycast_batch`.
         """
         if self.scene is None:
             raise RuntimeError("Scene is not created.")
 
-        for method in ("raycast", "cast_ray", "query_raycast"):
-            if hasattr(self.scene, method):
-                try:
-                    res = getattr(self.scene, method)(origin=origin, direction=direction, max_distance=max_distance)
-                except TypeError:
-                    res = getattr(self.scene, method)(origin, direction, max_distance)
-
-                # Try to normalize a few likely return types.
-                if isinstance(res, dict):
-                    return RaycastHit(
-                        hit=bool(res.get("hit", True)),
-                        distance=res.get("distance"),
-                        position=res.get("position"),
-                        normal=res.get("normal"),
-                        collider=res.get("collider"),
-                    )
-                return RaycastHit(hit=True, collider=res)
+        method = self._native_ray_method(("raycast", "cast_ray", "query_raycast"))
+        if method is None:
+            return self.raycast_batch([origin], [direction], max_distance)[0]
 
-        return RaycastHit(hit=False)
+        with self.profiler.phase("raycast"):
+            try:
+                res = method(origin=origin, direction=direction, max_distance=max_distance)
+            except TypeError:
+                res = method(origin, direction, max_distance)
+
+        # Try to normalize a few likely return types.
+        if isinstance(res, dict):
+            return RaycastHit(
+                hit=bool(res.get("hit", True)),
+                distance=res.get("distance"),
+                position=res.get("position"),
+                normal=res.get("normal"),
+                collider=res.get("collider"),
+            )
+        return RaycastHit(hit=True, collider=res)
 
     # ----------------------------
     # Diagnostics
@@ -953,6 +1834,18 @@ class GenesisSim:
         except Exception as e:
             info["torch_error"] = repr(e)
 
+        # Compiled-kernel cache. `scene_seen_before` only means this topology was built with the
+        # cache before; `warmup_s` shows whether compiled kernels were actually reused.
+        if self.kernel_cache is not None:
+            info["kernel_cache_dir"] = str(self.kernel_cache.dir)
+            info["scene_seen_before"] = self._kernel_cache_scene_seen
+            info["scene_topology"] = self.topology_key()
+        if self._warmup_timings is not None:
+            info["warmup_s"] = round(sum(self._warmup_timings.values()), 3)
+        # Phase histograms and transfer counters (see `profiler.py`).
+        if self.profiler.enabled:
+            info["profile"] = self.profiler.snapshot()
+
         # If available, report where contact tensors live (cpu vs cuda).
         if sample_contact_entity is not None and hasattr(sample_contact_entity, "get_contacts"):
             try:
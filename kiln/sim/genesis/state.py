@@ -0,0 +1,214 @@
+from __future__ import annotations
+
+"""
+Struct-of-arrays state store for rigid bodies driven through `GenesisSim`.
+
+Every controlled entity (actor bodies, or any entity written through the per-entity velocity /
+force helpers) owns one slot. Columns are contiguous numpy arrays so per-step control can run
+as one vectorized pass over all actors instead of per-entity dict lookups and tuple building.
+"""
+
+from dataclasses import dataclass, field
+from typing import Any
+
+import numpy as np
+
+# `control_mode` column codes.
+CONTROL_NONE = -1  # raw entity: only vel6/force6 are tracked
+CONTROL_KINEMATIC = 0
+CONTROL_FORCE_TORQUE = 1
+
+# Keyed by `ControlMode` values (kept as strings to avoid importing `kiln.actors` here).
+_CONTROL_MODE_CODES = {"kinematic": CONTROL_KINEMATIC, "force_torque": CONTROL_FORCE_TORQUE}
+
+# `last_action` column value when no action was applied yet.
+NO_ACTION = -1
+
+_FLOAT_COLUMNS = (
+    "yaw",
+    "target_speed",
+    "target_yaw_rate",
+    "max_speed",
+    "speed_delta",
+    "turn_rate",
+    "force",
+    "torque",
+)
+
+
+class ActorStateStore:
+    """
+    Contiguous per-slot state for controlled rigid bodies.
+
+    Columns (first `n` rows are live; arrays are over-allocated to `capacity`):
+    - `position` `[N, 3]`: last known base position
+    - `yaw`, `target_speed`, `target_yaw_rate` `[N]`: controller state
+    - `last_action` `[N]` (int8, `NO_ACTION` if none), `control_mode` `[N]` (int8)
+    - `max_speed`, `speed_delta`, `turn_rate`, `force`, `torque` `[N]`: control tuning
+    - `vel6`, `force6` `[N, 6]`: last commanded base velocity / force+torque
+
+    Floats are float64 so vectorized control matches the scalar per-actor math exactly.
+    """
+
+    def __init__(self, capacity: int = 64) -> None:
+        self.entities: list[Any] = []
+        # Optional per-slot NavGrid used by the kinematic "don't drive into blocked cells" clamp.
+        self.nav_grids: list[Any | None] = []
+        self._slots: dict[int, int] = {}
+        self._version = 0
+        self._groups: tuple[int, np.ndarray, np.ndarray] | None = None
+        self._nav_groups: tuple[tuple[int, bytes], list[tuple[Any, np.ndarray]]] | None = None
+        self._alloc(max(1, int(capacity)))
+
+    def _alloc(self, capacity: int) -> None:
+        self.capacity = capacity
+        self.position = np.zeros((capacity, 3), dtype=np.float64)
+        for name in _FLOAT_COLUMNS:
+            setattr(self, name, np.zeros(capacity, dtype=np.float64))
+        self.last_action = np.full(capacity, NO_ACTION, dtype=np.int8)
+        self.control_mode = np.full(capacity, CONTROL_NONE, dtype=np.int8)
+        self.vel6 = np.zeros((capacity, 6), dtype=np.float64)
+        self.force6 = np.zeros((capacity, 6), dtype=np.float64)
+
+    def _grow(self, min_capacity: int) -> None:
+        capacity = self.capacity
+        while capacity < min_capacity:
+            capacity *= 2
+        old = {name: getattr(self, name) for name in self.column_names()}
+        n = self.n
+        self._alloc(capacity)
+        for name, arr in old.items():
+            getattr(self, name)[:n] = arr[:n]
+
+    @staticmethod
+    def column_names() -> tuple[str, ...]:
+        """Names of all array columns (used for growth and snapshots)."""
+        return ("position", *_FLOAT_COLUMNS, "last_action", "control_mode", "vel6", "force6")
+
+    @property
+    def n(self) -> int:
+        """Number of live slots."""
+        return len(self.entities)
+
+    def __len__(self) -> int:
+        return self.n
+
+    @property
+    def version(self) -> int:
+        """Bumped whenever slots are added or control modes change (invalidates cached groups)."""
+        return self._version
+
+    def slot(self, entity: Any) -> int | None:
+        """Return the slot of `entity`, or None if it has none."""
+        return self._slots.get(id(entity))
+
+    def add(self, entity: Any, *, position: tuple[float, float, float] | None = None) -> int:
+        """Return the slot for `entity`, allocating a zeroed one on first use."""
+        key = id(entity)
+        idx = self._slots.get(key)
+        if idx is None:
+            idx = self.n
+            if idx >= self.capacity:
+                self._grow(idx + 1)
+            self._slots[key] = idx
+            self.entities.append(entity)
+            self.nav_grids.append(None)
+            self._version += 1
+        if position is not None:
+            self.position[idx] = position
+        return idx
+
+    def configure_control(self, idx: int, config: Any, *, initial_yaw: float = 0.0) -> None:
+        """Mark slot `idx` as actor-controlled and copy tuning from a `BlockControlConfig`."""
+        mode = str(getattr(config.control_mode, "value", config.control_mode))
+        if mode not in _CONTROL_MODE_CODES:
+            raise ValueError(f"Unknown control_mode: {config.control_mode!r}")
+        self.control_mode[idx] = _CONTROL_MODE_CODES[mode]
+        self.yaw[idx] = float(initial_yaw)
+        self.target_speed[idx] = 0.0
+        self.target_yaw_rate[idx] = 0.0
+        self.last_action[idx] = NO_ACTION
+        self.max_speed[idx] = float(config.max_speed)
+        self.speed_delta[idx] = float(config.speed_delta)
+        self.turn_rate[idx] = float(config.turn_rate)
+        self.force[idx] = float(config.force)
+        self.torque[idx] = float(config.torque)
+        self._version += 1
+
+    def set_nav_grid(self, idx: int, nav_grid: Any | None) -> None:
+        """Attach (or clear) the NavGrid used to clamp kinematic motion of slot `idx`."""
+        self.nav_grids[idx] = nav_grid
+        self._version += 1
+
+    def control_groups(self) -> tuple[np.ndarray, np.ndarray]:
+        """Return `(kinematic_slots, force_torque_slots)` index arrays (cached per `version`)."""
+        if self._groups is None or self._groups[0] != self._version:
+            modes = self.control_mode[: self.n]
+            kin = np.flatnonzero(modes == CONTROL_KINEMATIC)
+            ft = np.flatnonzero(modes == CONTROL_FORCE_TORQUE)
+            self._groups = (self._version, kin, ft)
+        return self._groups[1], self._groups[2]
+
+    def nav_grid_groups(self, slots: np.ndarray) -> list[tuple[Any, np.ndarray]]:
+        """Group `slots` (e.g. the kinematic group) by attached NavGrid, skipping slots without one."""
+        key = (self._version, slots.tobytes())
+        if self._nav_groups is None or self._nav_groups[0] != key:
+            by_grid: dict[int, tuple[Any, list[int]]] = {}
+            for i in slots.tolist():
+                grid = self.nav_grids[i]
+                if grid is not None:
+                    by_grid.setdefault(id(grid), (grid, []))[1].append(i)
+            groups = [(grid, np.asarray(idx, dtype=np.intp)) for grid, idx in by_grid.values()]
+            self._nav_groups = (key, groups)
+        return self._nav_groups[1]
+
+    def save_columns(self) -> dict[str, np.ndarray]:
+        """Copies of every column's live rows (see `restore_columns`)."""
+        n = self.n
+        return {name: getattr(self, name)[:n].copy() for name in self.column_names()}
+
+    def restore_columns(self, columns: dict[str, np.ndarray]) -> None:
+        """Write back rows saved by `save_columns` (slots added since then keep their values)."""
+        for name, saved in columns.items():
+            getattr(self, name)[: saved.shape[0]] = saved
+        self._version += 1
+
+    def clear(self) -> None:
+        """Drop all slots (e.g. when the owning scene is closed or rebuilt)."""
+        self.entities.clear()
+        self.nav_grids.clear()
+        self._slots.clear()
+        self._groups = None
+        self._nav_groups = None
+        self._version += 1
+        self._alloc(self.capacity)
+
+
+@dataclass(frozen=True, eq=False)
+class SimStateSnapshot:
+    """
+    Rigid-body and actor-controller state captured by `GenesisSim.save_state()`.
+
+    Attributes:
+        qpos: Rigid-solver generalized positions (`[n_envs, n_qs]` / `[n_qs]` device copy), or
+            None when the solver has no bulk accessors.
+        dofs_vel: Rigid-solver DoF velocities, laid out like `qpos`.
+        entity_states: Per-entity `(entity, qpos, dofs_vel)` copies (fallback when `qpos` is None).
+        actor_entities: Actor-store entities at save time (restores must match them).
+        actor_columns: Actor-store rows at save time (`ActorStateStore.save_columns`).
+    """
+
+    qpos: Any | None = None
+    dofs_vel: Any | None = None
+    entity_states: tuple[tuple[Any, Any, Any], ...] = ()
+    actor_entities: tuple[Any, ...] = ()
+    actor_columns: dict[str, np.ndarray] = field(default_factory=dict)
+
+
+def actor_state_store(sim: Any) -> ActorStateStore:
+    """Return the store shared by everything driving `sim` (attaching one if `sim` has none)."""
+    store = getattr(sim, "actor_state", None)
+    if store is None:
+        store = ActorStateStore()
+        setattr(sim, "actor_state", store)
+    return store
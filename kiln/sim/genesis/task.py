@@ -0,0 +1,307 @@
+from __future__ import annotations
+
+"""
+Device-side task runtime for env bundles with a `task` section (see `kiln.envio.bundle.TaskSpec`).
+
+`TaskRuntime` compiles the declarative task (goal, role contacts, reward/termination terms,
+time limit, observation layout) into batched torch ops over every env at once. Each `step()`
+reads the agent pose and velocity with one solver call each and the rigid contact buffer once.
+Observations, rewards and done flags are left as tensors on the simulation device. Nothing is
+copied to the host, so the results can go straight to a learner.
+
+Shapes always have a leading env axis (`n_envs = 1` for unbatched scenes):
+- `obs`: `[n_envs, obs_dim]` float, terms concatenated in `TaskSpec.observations` order
+- `reward`: `[n_envs]` float (sum of weighted terms; each term is in `info["reward_terms"]`)
+- `terminated` / `truncated`: `[n_envs]` bool (termination terms / time limit)
+
+The runtime does not reset envs itself: call `sim.reset(envs_idx=...)` (or restore a snapshot)
+followed by `task.reset(envs_idx)` for the envs that are done.
+"""
+
+from dataclasses import dataclass, field
+from fnmatch import fnmatchcase
+from typing import Any, Callable, Mapping, Sequence
+
+from .batch import _import_torch
+from .collisions import geom_range
+
+# Observation term widths (`contacts` has one column per task role).
+_OBS_WIDTHS = {"agent_pos": 3, "agent_vel": 3, "goal_delta": 3, "goal_distance": 1, "time_left": 1}
+
+
+@dataclass
+class TaskStep:
+    """Result of one `TaskRuntime.step()` (all tensors on the simulation device)."""
+
+    obs: Any
+    reward: Any
+    terminated: Any
+    truncated: Any
+    info: dict[str, Any] = field(default_factory=dict)
+
+    @property
+    def done(self) -> Any:
+        return self.terminated | self.truncated
+
+
+def match_roles(roles: Mapping[str, Sequence[str]], ids: Sequence[str]) -> dict[str, list[str]]:
+    """Primitive ids matching each role's `fnmatch` patterns (in `ids` order)."""
+    return {role: [i for i in ids if any(fnmatchcase(i, p) for p in patterns)] for role, patterns in roles.items()}
+
+
+class TaskRuntime:
+    """
+    Compiled `TaskSpec` for one built `GenesisSim` (see module docstring).
+
+    Args:
+        sim: Built simulation.
+        spec: Task definition.
+        agent: Entity the task is about (defaults to `spec.agent` looked up in `entities_by_id`).
+        entities_by_id: Bundle primitive entities (`LoadedEnvBundle.entities_by_id`), used for
+            the agent and role lookups. Merged static compounds take every role of the ids
+            they contain.
+        spawn_points: Bundle spawn points, for a goal given as a spawn point name.
+    """
+
+    def __init__(
+        self,
+        sim: Any,
+        spec: Any,
+        *,
+        agent: Any | None = None,
+        entities_by_id: Mapping[str, Any] | None = None,
+        spawn_points: Mapping[str, Any] | None = None,
+    ) -> None:
+        torch = _import_torch()
+        self.sim = sim
+        self.spec = spec
+        entities_by_id = dict(entities_by_id or {})
+        if agent is None:
+            if spec.agent is None or spec.agent not in entities_by_id:
+                raise ValueError(f"Task agent {spec.agent!r} is not a loaded primitive; pass agent=...")
+            agent = entities_by_id[spec.agent]
+        self.agent = agent
+        self.n_envs = max(1, int(sim.n_envs))
+        self.device = sim._device() if sim._device() is not None else torch.device("cpu")
+        self.dtype = sim._float_dtype()
+        self._batch = sim.entity_batch([agent])
+        self._has_vel = bool(self._batch.controllable)
+
+        # Roles -> boolean geom lookup table [n_geoms, n_roles].
+        self.role_names: tuple[str, ...] = tuple(spec.roles)
+        matched = match_roles(spec.roles, list(entities_by_id))
+        ranges: list[tuple[int, int, int]] = []
+        for r, role in enumerate(self.role_names):
+            seen: set[int] = set()
+            for pid in matched[role]:
+                ent = entities_by_id[pid]
+                if id(ent) in seen or ent is agent:
+                    continue
+                seen.add(id(ent))
+                gr = geom_range(ent)
+                if gr is not None:
+                    ranges.append((gr[0], gr[1], r))
+        agent_range = geom_range(agent)
+        if agent_range is None and self.role_names:
+            raise ValueError("Task agent has no collision geoms; role contacts cannot be detected.")
+        self._agent_geoms = agent_range or (0, 0)
+        n_geoms = max([1, self._agent_geoms[1], *(g1 for _, g1, _ in ranges)])
+        lut = torch.zeros((n_geoms, len(self.role_names)), dtype=torch.bool)
+        for g0, g1, r in ranges:
+            lut[g0:g1, r] = True
+        self._role_lut = lut.to(self.device)
+        self.role_ids = matched
+
+        # Goal per env.
+        goal = spec.goal
+        if isinstance(goal, str):
+            goal = tuple((spawn_points or {})[goal].pos)
+        needs_goal = (
+            any(t.type in ("goal_distance", "progress", "goal_reached") for t in spec.rewards)
+            or any(t.type == "goal_reached" for t in spec.terminations)
+            or any(o in ("goal_delta", "goal_distance") for o in spec.observations)
+        )
+        if goal is None and needs_goal:
+            raise ValueError("Task needs a goal (set task.goal or call set_goal()).")
+        self.goal = torch.zeros((self.n_envs, 3), dtype=self.dtype, device=self.device)
+        if goal is not None:
+            self.goal[:] = torch.as_tensor(goal, dtype=self.dtype, device=self.device)
+
+        self.time_limit = spec.time_limit
+        self.steps = torch.zeros(self.n_envs, dtype=torch.long, device=self.device)
+        self._prev_dist = torch.zeros(self.n_envs, dtype=self.dtype, device=self.device)
+        self._reward_terms = [self._compile_reward(t) for t in spec.rewards]
+        self._termination_terms = [self._compile_termination(t) for t in spec.terminations]
+
+        widths = [_OBS_WIDTHS.get(o, len(self.role_names)) for o in spec.observations]
+        self.obs_dim = int(sum(widths))
+        self._obs_slices = []
+        start = 0
+        for name, w in zip(spec.observations, widths):
+            self._obs_slices.append((name, start, start + w))
+            start += w
+        # Reused output buffer (clone if you keep observations across steps).
+        self._obs = torch.zeros((self.n_envs, self.obs_dim), dtype=self.dtype, device=self.device)
+        self.reset()
+
+    # ----------------------------
+    # Term compilation
+    # ----------------------------
+    def _role_index(self, role: str) -> int:
+        return self.role_names.index(role)
+
+    def _compile_reward(self, term: Any) -> tuple[str, Callable[[dict[str, Any]], Any]]:
+        w = float(term.weight)
+        kind = term.type
+        name = f"{kind}_{term.role}" if term.role else kind
+        if kind == "goal_distance":
+            return name, lambda s: w * s["dist"]
+        if kind == "progress":
+            return name, lambda s: w * (s["prev_dist"] - s["dist"])
+        if kind == "goal_reached":
+            r = float(term.radius)
+            return name, lambda s: w * (s["dist"] <= r).to(s["dist"].dtype)
+        if kind == "collision":
+            k = self._role_index(term.role)
+            return name, lambda s: w * s["contacts"][:, k].to(s["dist"].dtype)
+        if kind == "alive":
+            return name, lambda s: s["dist"].new_full(s["dist"].shape, w)
+        raise ValueError(f"Unsupported reward term {kind!r}")
+
+    def _compile_termination(self, term: Any) -> Callable[[dict[str, Any]], Any]:
+        if term.type == "goal_reached":
+            r = float(term.radius)
+            return lambda s: s["dist"] <= r
+        if term.type == "contact":
+            k = self._role_index(term.role)
+            return lambda s: s["contacts"][:, k]
+        raise ValueError(f"Unsupported termination term {term.type!r}")
+
+    # ----------------------------
+    # Device state
+    # ----------------------------
+    def _agent_pos(self) -> Any:
+        return self.sim.get_positions_batch(self._batch).reshape(self.n_envs, 3).to(self.dtype)
+
+    def _agent_vel(self) -> Any:
+        if not self._has_vel:
+            return self.goal.new_zeros((self.n_envs, 3))
+        v = self.sim.get_velocities_batch(self._batch)
+        return v.reshape(self.n_envs, 6)[:, :3].to(self.dtype)
+
+    def _contacts(self) -> Any:
+        """`[n_envs, n_roles]` bool: agent touches a geom of each role this step."""
+        torch = _import_torch()
+        n_roles = len(self.role_names)
+        if n_roles == 0:
+            return torch.zeros((self.n_envs, 0), dtype=torch.bool, device=self.device)
+        contacts = None
+        solver = self.sim._rigid_solver()
+        collider = getattr(solver, "collider", None)
+        if collider is not None and hasattr(collider, "get_contacts"):
+            try:
+                contacts = collider.get_contacts(as_tensor=True, to_torch=True)
+            except TypeError:
+                contacts = collider.get_contacts()
+        if not isinstance(contacts, dict) and hasattr(self.agent, "get_contacts"):
+            contacts = self.agent.get_contacts()
+        if not isinstance(contacts, dict) or contacts.get("geom_a") is None:
+            return torch.zeros((self.n_envs, n_roles), dtype=torch.bool, device=self.device)
+
+        ga = contacts["geom_a"].long()
+        gb = contacts["geom_b"].long()
+        valid = contacts.get("valid_mask")
+        if ga.dim() == 1:
+            ga, gb = ga.unsqueeze(0), gb.unsqueeze(0)
+            valid = valid.unsqueeze(0) if valid is not None else None
+        if valid is None:
+            valid = torch.ones_like(ga, dtype=torch.bool)
+        g0, g1 = self._agent_geoms
+        a_is = (ga >= g0) & (ga < g1)
+        b_is = (gb >= g0) & (gb < g1)
+        other = torch.where(a_is, gb, ga)
+        n_lut = int(self._role_lut.shape[0])
+        ok = valid.bool() & (a_is ^ b_is) & (other >= 0) & (other < n_lut)
+        roles = self._role_lut[other.clamp(0, n_lut - 1)] & ok.unsqueeze(-1)
+        return roles.any(dim=1)
+
+    # ----------------------------
+    # Public API
+    # ----------------------------
+    def set_goal(self, goal: Any, *, envs_idx: Any | None = None) -> None:
+        """Set the goal `[3]` (all selected envs) or `[len(envs_idx), 3]` for `envs_idx` (default: all)."""
+        torch = _import_torch()
+        g = torch.as_tensor(goal, dtype=self.dtype, device=self.device)
+        if envs_idx is None:
+            self.goal[:] = g
+        else:
+            self.goal[torch.as_tensor(envs_idx, dtype=torch.long, device=self.device)] = g
+        self.reset(envs_idx)
+
+    def reset(self, envs_idx: Any | None = None) -> None:
+        """Restart the episode clock and progress baseline for `envs_idx` (default: all envs)."""
+        torch = _import_torch()
+        dist = torch.linalg.vector_norm(self.goal - self._agent_pos(), dim=-1)
+        if envs_idx is None:
+            self.steps.zero_()
+            self._prev_dist.copy_(dist)
+        else:
+            idx = torch.as_tensor(envs_idx, dtype=torch.long, device=self.device).reshape(-1)
+            self.steps[idx] = 0
+            self._prev_dist[idx] = dist[idx]
+
+    def step(self) -> TaskStep:
+        """Evaluate observations, rewards and done flags for the state after the last `sim.step()`."""
+        torch = _import_torch()
+        with self.sim.profiler.phase("task", gpu=True):
+            self.steps += 1
+            pos = self._agent_pos()
+            delta = self.goal - pos
+            dist = torch.linalg.vector_norm(delta, dim=-1)
+            s = {"pos": pos, "delta": delta, "dist": dist, "prev_dist": self._prev_dist, "contacts": self._contacts()}
+
+            reward = torch.zeros(self.n_envs, dtype=self.dtype, device=self.device)
+            terms: dict[str, Any] = {}
+            for name, fn in self._reward_terms:
+                v = fn(s)
+                terms[name] = terms[name] + v if name in terms else v
+                reward = reward + v
+
+            terminated = torch.zeros(self.n_envs, dtype=torch.bool, device=self.device)
+            for fn in self._termination_terms:
+                terminated = terminated | fn(s)
+            if self.time_limit is not None:
+                truncated = (self.steps >= int(self.time_limit)) & ~terminated
+            else:
+                truncated = torch.zeros_like(terminated)
+
+            obs = self._write_obs(s)
+            self._prev_dist.copy_(dist)
+        return TaskStep(
+            obs=obs,
+            reward=reward,
+            terminated=terminated,
+            truncated=truncated,
+            info={"reward_terms": terms, "contacts": s["contacts"], "steps": self.steps},
+        )
+
+    def _write_obs(self, s: dict[str, Any]) -> Any:
+        out = self._obs
+        for name, a, b in self._obs_slices:
+            if name == "agent_pos":
+                out[:, a:b] = s["pos"]
+            elif name == "agent_vel":
+                out[:, a:b] = self._agent_vel()
+            elif name == "goal_delta":
+                out[:, a:b] = s["delta"]
+            elif name == "goal_distance":
+                out[:, a] = s["dist"]
+            elif name == "time_left":
+                if self.time_limit is None:
+                    out[:, a] = 1.0
+                else:
+                    out[:, a] = 1.0 - self.steps.to(self.dtype) / float(self.time_limit)
+            elif name == "contacts":
+                out[:, a:b] = s["contacts"].to(self.dtype)
+        return out
+
@@ -0,0 +1,408 @@
+from __future__ import annotations
+
+"""
+Level-of-detail collision proxies for an env bundle's USD world.
+
+Colliding against the full render mesh is the expensive part of large generated worlds: the
+solver (and the raycast BVH) sees every triangle. With `world.collision_lod` set, the USD mesh
+is only rendered and one of these simplified proxies is added for collision instead:
+
+- `boxes`: the triangles are split into at most `max_parts` spatial clusters (median split of
+  triangle centroids along the widest axis, largest cluster first) and each cluster becomes the
+  box bounding it,
+- `convex`: the same clusters, each replaced by its convex hull,
+- `heightfield`: heights sampled from above on a `cell_size` grid (ground-like worlds).
+
+Proxies are computed in the stage frame from the fan-triangulated USD meshes and cached as
+`<key>.npz` under `<bundle>/.kiln_cache/collision/` (or the temp directory if the bundle is
+read-only); the key covers the USD file digest and the LOD settings, so editing either rebuilds.
+The world pose/scale are applied when placing the proxies, so they are not part of the key.
+"""
+
+import hashlib
+import heapq
+import json
+import math
+import os
+import tempfile
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, Callable, Sequence
+from xml.etree.ElementTree import Element, SubElement, tostring
+
+import numpy as np
+
+from .raycast import RayGeometry, TriangleSet, quat_to_matrix
+
+# Bump when the proxy construction changes, to invalidate cached proxies.
+PROXY_VERSION = 1
+
+# Minimum half-thickness of a proxy part (flat clusters, e.g. a ground quad, still need volume).
+MIN_HALF_EXTENT = 0.005
+
+# Heightfield grids larger than this (per side) almost always mean a wrong `cell_size`.
+MAX_HEIGHTFIELD_CELLS = 4096
+
+_RAY_CHUNK = 1 << 16
+
+
+def world_proxy_cache_dirs(bundle_root: str | Path) -> tuple[Path, Path]:
+    """Cache directories tried in order: next to the bundle, then the system temp directory."""
+    return Path(bundle_root) / ".kiln_cache" / "collision", Path(tempfile.gettempdir()) / "kiln_collision"
+
+
+def place_points(points: np.ndarray, pos: Sequence[float], quat: Sequence[float], scale: float) -> np.ndarray:
+    """Stage-frame points `[..., 3]` placed with the world entity pose and uniform scale."""
+    rot = quat_to_matrix([tuple(quat)])[0]
+    return (np.asarray(points, dtype=np.float64) * float(scale)) @ rot.T + np.asarray(pos, dtype=np.float64)
+
+
+# ----------------------------
+# Proxy construction
+# ----------------------------
+
+
+def cluster_triangles(triangles: np.ndarray, max_parts: int) -> list[np.ndarray]:
+    """
+    Split triangles `[n, 3, 3]` into at most `max_parts` spatially coherent clusters.
+
+    Returns one index array per cluster, ordered by their first triangle index.
+    """
+    tris = np.asarray(triangles, dtype=np.float64).reshape(-1, 3, 3)
+    n = tris.shape[0]
+    if n == 0:
+        return []
+    centroids = tris.mean(axis=1)
+    vmin, vmax = tris.min(axis=1), tris.max(axis=1)
+
+    def entry(idx: np.ndarray) -> tuple[float, int, np.ndarray]:
+        # Largest bounds diagonal first (a flat cluster has zero volume but may still be huge).
+        diag = float(np.linalg.norm(vmax[idx].max(axis=0) - vmin[idx].min(axis=0)))
+        return -diag, int(idx[0]), idx
+
+    heap = [entry(np.arange(n))]
+    done: list[np.ndarray] = []
+    while heap and len(heap) + len(done) < max(1, int(max_parts)):
+        _, _, idx = heapq.heappop(heap)
+        if idx.shape[0] < 2:
+            done.append(idx)
+            continue
+        c = centroids[idx]
+        axis = int(np.argmax(c.max(axis=0) - c.min(axis=0)))
+        order = idx[np.argsort(c[:, axis], kind="stable")]
+        half = order.shape[0] // 2
+        for part in (order[:half], order[half:]):
+            heapq.heappush(heap, entry(np.sort(part)))
+    clusters = done + [idx for _, _, idx in heap]
+    clusters.sort(key=lambda idx: int(idx[0]))
+    return clusters
+
+
+def box_proxies(triangles: np.ndarray, max_parts: int) -> tuple[np.ndarray, np.ndarray]:
+    """Axis-aligned boxes (centers `[k, 3]`, half extents `[k, 3]`) bounding each triangle cluster."""
+    tris = np.asarray(triangles, dtype=np.float64).reshape(-1, 3, 3)
+    clusters = cluster_triangles(tris, max_parts)
+    centers = np.zeros((len(clusters), 3))
+    halves = np.zeros((len(clusters), 3))
+    for i, idx in enumerate(clusters):
+        pts = tris[idx].reshape(-1, 3)
+        lo, hi = pts.min(axis=0), pts.max(axis=0)
+        centers[i] = 0.5 * (lo + hi)
+        halves[i] = np.maximum(0.5 * (hi - lo), MIN_HALF_EXTENT)
+    return centers, halves
+
+
+def _outward(verts: np.ndarray, faces: np.ndarray) -> np.ndarray:
+    """*faces* of a convex polytope, rewound so normals point away from its centroid."""
+    faces = np.array(faces, dtype=np.int64)
+    v = verts[faces]
+    normal = np.cross(v[:, 1] - v[:, 0], v[:, 2] - v[:, 0])
+    flip = np.einsum("ij,ij->i", normal, v.mean(axis=1) - verts.mean(axis=0)) < 0.0
+    faces[flip] = faces[flip][:, ::-1]
+    return faces
+
+
+# Unit box corners (index = 4 x + 2 y + z over {-1, 1}) and two triangles per side.
+_BOX_SIGNS = np.array([[x, y, z] for x in (-1, 1) for y in (-1, 1) for z in (-1, 1)], dtype=np.float64)
+_BOX_FACES = _outward(
+    _BOX_SIGNS,
+    [[0, 1, 3], [0, 3, 2], [4, 6, 7], [4, 7, 5], [0, 4, 5], [0, 5, 1],
+     [2, 3, 7], [2, 7, 6], [0, 2, 6], [0, 6, 4], [1, 5, 7], [1, 7, 3]],
+)
+
+
+def convex_hull(points: np.ndarray) -> tuple[np.ndarray, np.ndarray]:
+    """
+    Convex hull of `points` `[m, 3]` as (vertices `[k, 3]`, outward-wound faces `[f, 3]`).
+
+    Degenerate (flat or tiny) point sets fall back to their bounding box, thickened to
+    `MIN_HALF_EXTENT`. Requires scipy (a Genesis dependency).
+    """
+    try:
+        from scipy.spatial import ConvexHull  # type: ignore
+    except Exception as e:  # pragma: no cover - depends on optional dependency
+        raise ImportError("The `convex` collision LOD needs scipy (`pip install scipy`).") from e
+
+    pts = np.unique(np.asarray(points, dtype=np.float64).reshape(-1, 3), axis=0)
+    lo, hi = pts.min(axis=0), pts.max(axis=0)
+    if pts.shape[0] < 4 or np.min(hi - lo) < 2.0 * MIN_HALF_EXTENT:
+        center, half = 0.5 * (lo + hi), np.maximum(0.5 * (hi - lo), MIN_HALF_EXTENT)
+        return center + _BOX_SIGNS * half, _BOX_FACES.copy()
+    try:
+        hull = ConvexHull(pts)
+    except Exception:
+        center, half = 0.5 * (lo + hi), np.maximum(0.5 * (hi - lo), MIN_HALF_EXTENT)
+        return center + _BOX_SIGNS * half, _BOX_FACES.copy()
+
+    keep = hull.vertices
+    remap = np.full(pts.shape[0], -1, dtype=np.int64)
+    remap[keep] = np.arange(keep.shape[0])
+    verts = pts[keep]
+    # Qhull does not orient simplices (MuJoCo needs outward faces for a positive mesh volume).
+    return verts, _outward(verts, remap[hull.simplices])
+
+
+def convex_proxies(triangles: np.ndarray, max_parts: int) -> list[tuple[np.ndarray, np.ndarray]]:
+    """Convex hull (vertices, faces) of each triangle cluster."""
+    tris = np.asarray(triangles, dtype=np.float64).reshape(-1, 3, 3)
+    return [convex_hull(tris[idx].reshape(-1, 3)) for idx in cluster_triangles(tris, max_parts)]
+
+
+def heightfield_proxy(triangles: np.ndarray, cell_size: float) -> tuple[np.ndarray, tuple[float, float]]:
+    """
+    Heights `[nx, ny]` of the topmost surface at grid points `origin + (i, j) * cell_size` (x/y).
+
+    Grid points with no triangle below them get the lowest z of the mesh.
+    """
+    tris = np.asarray(triangles, dtype=np.float64).reshape(-1, 3, 3)
+    pts = tris.reshape(-1, 3)
+    lo, hi = pts.min(axis=0), pts.max(axis=0)
+    cell = float(cell_size)
+    nx = int(math.ceil((hi[0] - lo[0]) / cell)) + 1
+    ny = int(math.ceil((hi[1] - lo[1]) / cell)) + 1
+    if max(nx, ny) > MAX_HEIGHTFIELD_CELLS:
+        raise ValueError(
+            f"Heightfield of {nx}x{ny} samples exceeds {MAX_HEIGHTFIELD_CELLS} per side; increase cell_size (={cell})"
+        )
+    gx, gy = np.meshgrid(lo[0] + np.arange(nx) * cell, lo[1] + np.arange(ny) * cell, indexing="ij")
+    top = float(hi[2]) + 1.0
+    origins = np.stack([gx.ravel(), gy.ravel(), np.full(gx.size, top)], axis=1)
+    down = np.tile(np.array([0.0, 0.0, -1.0]), (_RAY_CHUNK, 1))
+
+    geom = RayGeometry(triangles=TriangleSet(tris, np.zeros(tris.shape[0], dtype=np.intp)))
+    heights = np.full(gx.size, float(lo[2]))
+    for start in range(0, gx.size, _RAY_CHUNK):
+        o = origins[start : start + _RAY_CHUNK]
+        t = np.full(o.shape[0], top - float(lo[2]) + 1.0)
+        hit = geom.closest(o, down[: o.shape[0]], t) >= 0
+        heights[start : start + o.shape[0]][hit] = top - t[hit]
+    return heights.reshape(nx, ny), (float(lo[0]), float(lo[1]))
+
+
+def heightfield_triangles(heights: np.ndarray, origin: Sequence[float], cell_size: float) -> np.ndarray:
+    """Two triangles `[2 (nx-1)(ny-1), 3, 3]` per heightfield cell (stage frame)."""
+    h = np.asarray(heights, dtype=np.float64)
+    nx, ny = h.shape
+    gx, gy = np.meshgrid(origin[0] + np.arange(nx) * cell_size, origin[1] + np.arange(ny) * cell_size, indexing="ij")
+    v = np.stack([gx, gy, h], axis=-1)
+    a, b, c, d = v[:-1, :-1], v[1:, :-1], v[1:, 1:], v[:-1, 1:]
+    tris = np.concatenate([np.stack([a, b, c], axis=-2), np.stack([a, c, d], axis=-2)], axis=0)
+    return tris.reshape(-1, 3, 3)
+
+
+# ----------------------------
+# Proxies + cache
+# ----------------------------
+
+
+@dataclass(frozen=True)
+class WorldProxies:
+    """
+    Collision proxies of a USD world in its stage frame (one kind per instance).
+
+    Attributes:
+        kind: `boxes`, `convex` or `heightfield`.
+        key: Cache key (USD digest + LOD settings); also used in scene topology records.
+        centers / halves: Box centers and half extents `[k, 3]` (`boxes`).
+        hulls: Convex hull (vertices, faces) per part (`convex`).
+        heights / origin / cell_size: Heightfield grid (`heightfield`).
+    """
+
+    kind: str
+    key: str
+    centers: np.ndarray = field(default_factory=lambda: np.zeros((0, 3)))
+    halves: np.ndarray = field(default_factory=lambda: np.zeros((0, 3)))
+    hulls: tuple[tuple[np.ndarray, np.ndarray], ...] = ()
+    heights: np.ndarray | None = None
+    origin: tuple[float, float] = (0.0, 0.0)
+    cell_size: float = 0.0
+
+    def __len__(self) -> int:
+        if self.kind == "boxes":
+            return int(self.centers.shape[0])
+        if self.kind == "convex":
+            return len(self.hulls)
+        return 1
+
+    def triangles(self) -> np.ndarray:
+        """Stage-frame triangles `[n, 3, 3]` of the proxy surface (for raycasts)."""
+        if self.kind == "heightfield":
+            assert self.heights is not None
+            return heightfield_triangles(self.heights, self.origin, self.cell_size)
+        if self.kind == "convex":
+            parts = [v[f] for v, f in self.hulls]
+        else:
+            parts = [(c + _BOX_SIGNS * h)[_BOX_FACES] for c, h in zip(self.centers, self.halves)]
+        return np.concatenate(parts) if parts else np.zeros((0, 3, 3))
+
+    def save(self, path: Path) -> None:
+        """Write as `.npz` (atomically, via a temp file next to *path*)."""
+        arrays: dict[str, Any] = {
+            "version": np.int64(PROXY_VERSION),
+            "kind": np.array(self.kind),
+            "key": np.array(self.key),
+            "centers": self.centers,
+            "halves": self.halves,
+            "hull_vertices": np.concatenate([v for v, _ in self.hulls]) if self.hulls else np.zeros((0, 3)),
+            "hull_nverts": np.array([len(v) for v, _ in self.hulls], dtype=np.int64),
+            "hull_faces": np.concatenate([f for _, f in self.hulls]) if self.hulls else np.zeros((0, 3), np.int64),
+            "hull_nfaces": np.array([len(f) for _, f in self.hulls], dtype=np.int64),
+            "heights": self.heights if self.heights is not None else np.zeros((0, 0)),
+            "origin": np.array(self.origin, dtype=np.float64),
+            "cell_size": np.float64(self.cell_size),
+        }
+        path.parent.mkdir(parents=True, exist_ok=True)
+        # `np.savez` appends `.npz` to names without it.
+        tmp = path.with_name(f".{path.stem}.{os.getpid()}.tmp.npz")
+        np.savez(tmp, **arrays)
+        os.replace(tmp, path)
+
+    @staticmethod
+    def load(path: Path) -> "WorldProxies":
+        with np.load(path, allow_pickle=False) as z:
+            if int(z["version"]) != PROXY_VERSION:
+                raise ValueError(f"{path}: proxy version {int(z['version'])} != {PROXY_VERSION}")
+            kind = str(z["kind"])
+            hulls: list[tuple[np.ndarray, np.ndarray]] = []
+            split_v = np.cumsum(z["hull_nverts"])[:-1]
+            split_f = np.cumsum(z["hull_nfaces"])[:-1]
+            if z["hull_nverts"].size:
+                hulls = list(zip(np.split(z["hull_vertices"], split_v), np.split(z["hull_faces"], split_f)))
+            heights = z["heights"] if kind == "heightfield" else None
+            origin = z["origin"]
+            return WorldProxies(
+                kind=kind,
+                key=str(z["key"]),
+                centers=z["centers"],
+                halves=z["halves"],
+                hulls=tuple(hulls),
+                heights=heights,
+                origin=(float(origin[0]), float(origin[1])),
+                cell_size=float(z["cell_size"]),
+            )
+
+
+def build_world_proxies(triangles: np.ndarray, lod: Any, *, key: str = "") -> WorldProxies:
+    """Build the proxies `lod` (a `CollisionLodSpec`) asks for from stage-frame triangles."""
+    tris = np.asarray(triangles, dtype=np.float64).reshape(-1, 3, 3)
+    if lod.type == "boxes":
+        centers, halves = box_proxies(tris, lod.max_parts)
+        return WorldProxies(kind="boxes", key=key, centers=centers, halves=halves)
+    if lod.type == "convex":
+        return WorldProxies(kind="convex", key=key, hulls=tuple(convex_proxies(tris, lod.max_parts)))
+    if lod.type == "heightfield":
+        heights, origin = heightfield_proxy(tris, lod.cell_size)
+        return WorldProxies(kind="heightfield", key=key, heights=heights, origin=origin, cell_size=float(lod.cell_size))
+    raise ValueError(f"No collision proxies for collision_lod.type={lod.type!r}")
+
+
+def proxy_key(source_digest: str, lod: Any) -> str:
+    payload = json.dumps({"v": PROXY_VERSION, "source": source_digest, "lod": lod.to_json()}, sort_keys=True)
+    return hashlib.sha256(payload.encode("utf-8")).hexdigest()[:32]
+
+
+def load_world_proxies(
+    lod: Any,
+    *,
+    source_digest: str,
+    load_triangles: Callable[[], np.ndarray | None],
+    cache_dirs: Sequence[Path],
+) -> WorldProxies | None:
+    """
+    Cached proxies for `lod`, building (and caching in the first writable directory) on a miss.
+
+    `load_triangles()` returns the stage-frame world triangles and is only called on a miss;
+    returns None if it yields no triangles.
+    """
+    key = proxy_key(source_digest, lod)
+    for directory in cache_dirs:
+        path = Path(directory) / f"{key}.npz"
+        if path.exists():
+            try:
+                return WorldProxies.load(path)
+            except (OSError, ValueError, KeyError):
+                pass  # Corrupt or outdated: rebuild below.
+
+    tris = load_triangles()
+    if tris is None or len(tris) == 0:
+        return None
+    proxies = build_world_proxies(tris, lod, key=key)
+    for directory in cache_dirs:
+        try:
+            proxies.save(Path(directory) / f"{key}.npz")
+            break
+        except OSError:
+            continue
+    return proxies
+
+
+# ----------------------------
+# MJCF export (convex proxies)
+# ----------------------------
+
+
+def _fmt(v: float) -> str:
+    return f"{float(v):.9g}"
+
+
+def write_convex_mjcf(
+    hulls: Sequence[tuple[np.ndarray, np.ndarray]], directory: str | Path, *, name: str = "kiln_world_lod"
+) -> Path:
+    """
+    Write placed convex hulls as one fixed MJCF body with a mesh geom per hull.
+
+    Files are named by a hash of their contents (`<hash>.xml` plus `<hash>_<i>.obj` meshes,
+    referenced relative to the XML), so reloading the same world reuses them.
+    """
+    objs = []
+    for verts, faces in hulls:
+        lines = [f"v {_fmt(x)} {_fmt(y)} {_fmt(z)}" for x, y, z in np.asarray(verts, dtype=np.float64)]
+        lines += [f"f {a + 1} {b + 1} {c + 1}" for a, b, c in np.asarray(faces, dtype=np.int64)]
+        objs.append("\n".join(lines) + "\n")
+    h = hashlib.sha256(name.encode("utf-8"))
+    for text in objs:
+        h.update(text.encode("utf-8"))
+    digest = h.hexdigest()[:32]
+
+    root = Element("mujoco", model=name)
+    asset = SubElement(root, "asset")
+    worldbody = SubElement(root, "worldbody")
+    body = SubElement(worldbody, "body", name=name, pos="0 0 0")
+    for i in range(len(objs)):
+        SubElement(asset, "mesh", name=f"h{i}", file=f"{digest}_{i}.obj")
+        SubElement(body, "geom", name=f"g{i}", type="mesh", mesh=f"h{i}", rgba="0.5 0.5 0.5 1")
+
+    directory = Path(directory)
+    directory.mkdir(parents=True, exist_ok=True)
+    path = directory / f"{digest}.xml"
+    if not path.exists():
+        for i, text in enumerate(objs):
+            obj_path = directory / f"{digest}_{i}.obj"
+            tmp = obj_path.with_suffix(f".{os.getpid()}.tmp")
+            tmp.write_text(text, encoding="utf-8")
+            os.replace(tmp, obj_path)
+        # The XML goes last: its presence means the meshes are complete.
+        tmp = path.with_suffix(f".{os.getpid()}.tmp")
+        tmp.write_text(tostring(root, encoding="unicode"), encoding="utf-8")
+        os.replace(tmp, path)
+    return path
@@ -0,0 +1,224 @@
+from __future__ import annotations
+
+"""
+CPU side of the viewport's instanced render path.
+
+Objects that report an `instance_shape()` (boxes and planes) are drawn from one
+shared unit mesh per shape. `InstanceSet` keeps, per mesh:
+
+- one row of `INSTANCE_FLOATS` floats per object (column-major model matrix with
+  the shape scale folded in, followed by RGBA), in a stable slot order,
+- world-space AABBs for frustum culling,
+- the set of slots whose row changed since the last upload.
+
+Rows are recomputed only for objects passed to `update()` (or on `rebuild()`),
+and only if their transform / color / shape actually changed, so the viewport
+uploads just the dirty slots. `visible_slots()` culls against the view frustum
+and returns the slot indices to draw.
+
+No OpenGL here: `ViewportWidget` owns the GL buffers.
+"""
+
+from typing import Any, Iterable
+
+import numpy as np
+
+# mat4 (4 columns of vec4) + vec4 color.
+INSTANCE_FLOATS = 20
+
+
+# ----------------------------
+# Unit meshes
+# ----------------------------
+
+# Unit box: x/z in [-0.5, 0.5], y in [0, 1] (base on the ground, like `Box`).
+_BOX_CORNERS = np.array(
+    [
+        [-0.5, 0.0, 0.5], [0.5, 0.0, 0.5], [0.5, 1.0, 0.5], [-0.5, 1.0, 0.5],
+        [-0.5, 0.0, -0.5], [0.5, 0.0, -0.5], [0.5, 1.0, -0.5], [-0.5, 1.0, -0.5],
+    ],
+    dtype=np.float32,
+)
+_BOX_TRIANGLES = [
+    0, 1, 2, 0, 2, 3,  # Front
+    5, 4, 7, 5, 7, 6,  # Back
+    4, 0, 3, 4, 3, 7,  # Left
+    1, 5, 6, 1, 6, 2,  # Right
+    3, 2, 6, 3, 6, 7,  # Top
+    4, 5, 1, 4, 1, 0,  # Bottom
+]
+_BOX_LINES = [0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4, 0, 4, 1, 5, 2, 6, 3, 7]
+
+# Unit quad on the x/z plane, x/z in [-0.5, 0.5] (like `Plane`).
+_QUAD_CORNERS = np.array(
+    [[-0.5, 0.0, -0.5], [-0.5, 0.0, 0.5], [0.5, 0.0, 0.5], [0.5, 0.0, -0.5]],
+    dtype=np.float32,
+)
+_QUAD_TRIANGLES = [0, 1, 3, 3, 1, 2]
+_QUAD_LINES = [0, 1, 1, 2, 2, 3, 3, 0]
+
+
+def unit_mesh(shape: str) -> tuple[np.ndarray, np.ndarray, tuple[np.ndarray, np.ndarray]]:
+    """(triangle vertices [N, 3], line vertices [M, 3], local AABB (min, max)) for *shape*."""
+    if shape == "box":
+        corners, tris, lines = _BOX_CORNERS, _BOX_TRIANGLES, _BOX_LINES
+    elif shape == "plane":
+        corners, tris, lines = _QUAD_CORNERS, _QUAD_TRIANGLES, _QUAD_LINES
+    else:
+        raise ValueError(f"unknown instance shape: {shape!r}")
+    return (
+        np.ascontiguousarray(corners[tris]),
+        np.ascontiguousarray(corners[lines]),
+        (corners.min(axis=0), corners.max(axis=0)),
+    )
+
+
+# ----------------------------
+# Culling
+# ----------------------------
+
+
+def frustum_planes(
+    view_projection: np.ndarray, ndc_rect: tuple[float, float, float, float] = (-1.0, -1.0, 1.0, 1.0)
+) -> np.ndarray:
+    """
+    Six inward-facing planes [6, 4] (``n.p + d >= 0`` inside) of a row-major view-projection matrix.
+
+    `ndc_rect` (x0, y0, x1, y1) restricts the side planes to a sub-rectangle of the screen in
+    normalized device coordinates (rubber-band selection); the default is the whole view.
+    """
+    m = np.asarray(view_projection, dtype=np.float64)
+    x0, y0, x1, y1 = (float(v) for v in ndc_rect)
+    planes = np.stack([m[0] - x0 * m[3], x1 * m[3] - m[0], m[1] - y0 * m[3], y1 * m[3] - m[1], m[3] + m[2], m[3] - m[2]])
+    norms = np.linalg.norm(planes[:, :3], axis=1, keepdims=True)
+    return planes / np.maximum(norms, 1e-12)
+
+
+def aabbs_in_frustum(planes: np.ndarray, centers: np.ndarray, extents: np.ndarray) -> np.ndarray:
+    """Bool mask of AABBs (center / half-extent [N, 3]) not entirely outside any plane."""
+    if len(centers) == 0:
+        return np.zeros((0,), dtype=bool)
+    n = planes[:, :3]
+    dist = centers @ n.T + planes[:, 3]  # [N, 6]
+    radius = extents @ np.abs(n).T  # [N, 6]
+    return np.all(dist + radius >= 0.0, axis=1)
+
+
+# ----------------------------
+# Instance data
+# ----------------------------
+
+
+def _instance_key(obj: Any, scale: tuple[float, float, float]) -> tuple:
+    p, r, s, c = obj.position, obj.rotation, obj.scale, obj.color
+    return (
+        p.x(), p.y(), p.z(), r.x(), r.y(), r.z(), s.x(), s.y(), s.z(),
+        c.redF(), c.greenF(), c.blueF(), scale, bool(obj.visible),
+    )
+
+
+class InstanceSet:
+    """Per-object instance rows for one shared mesh (see module docstring)."""
+
+    def __init__(self, shape: str) -> None:
+        self.shape = shape
+        self.triangles, self.lines, (lo, hi) = unit_mesh(shape)
+        self._local_center = ((lo + hi) * 0.5).astype(np.float64)
+        self._local_extent = ((hi - lo) * 0.5).astype(np.float64)
+        self.objects: list[Any] = []
+        self._slots: dict[int, int] = {}
+        self._keys: list[tuple | None] = []
+        self.data = np.zeros((0, INSTANCE_FLOATS), dtype=np.float32)
+        self.centers = np.zeros((0, 3), dtype=np.float64)
+        self.extents = np.zeros((0, 3), dtype=np.float64)
+        self.shown = np.zeros((0,), dtype=bool)
+        self.dirty: set[int] = set()
+        # Set by `rebuild()`: the whole buffer must be (re)allocated on upload.
+        self.resized = True
+
+    def __len__(self) -> int:
+        return len(self.objects)
+
+    def __contains__(self, obj: Any) -> bool:
+        return id(obj) in self._slots
+
+    def rebuild(self, objects: Iterable[Any]) -> None:
+        """Assign slots for *objects* (all drawn with this mesh) and compute every row."""
+        self.objects = list(objects)
+        n = len(self.objects)
+        self._slots = {id(obj): i for i, obj in enumerate(self.objects)}
+        self._keys = [None] * n
+        self.data = np.zeros((n, INSTANCE_FLOATS), dtype=np.float32)
+        self.centers = np.zeros((n, 3), dtype=np.float64)
+        self.extents = np.zeros((n, 3), dtype=np.float64)
+        self.shown = np.zeros((n,), dtype=bool)
+        for i in range(n):
+            self._update_slot(i)
+        self.dirty.clear()
+        self.resized = True
+
+    def update(self, obj: Any) -> bool:
+        """Recompute *obj*'s row if it changed; returns True if it was marked dirty."""
+        slot = self._slots.get(id(obj))
+        if slot is None:
+            return False
+        if self._update_slot(slot):
+            self.dirty.add(slot)
+            return True
+        return False
+
+    def _update_slot(self, slot: int) -> bool:
+        obj = self.objects[slot]
+        _, scale = obj.instance_shape()
+        key = _instance_key(obj, scale)
+        if key == self._keys[slot]:
+            return False
+        self._keys[slot] = key
+
+        model = obj.transform_array().astype(np.float64) @ np.diag((*scale, 1.0))
+        row = self.data[slot]
+        row[:16] = model.T.reshape(-1)  # column-major, as GLSL mat4 columns
+        c = obj.color
+        row[16:] = (c.redF(), c.greenF(), c.blueF(), 1.0)
+
+        lin = model[:3, :3]
+        self.centers[slot] = lin @ self._local_center + model[:3, 3]
+        self.extents[slot] = np.abs(lin) @ self._local_extent
+        self.shown[slot] = bool(obj.visible)
+        return True
+
+    def take_dirty_runs(self) -> list[tuple[int, int]]:
+        """Contiguous ``[start, stop)`` slot runs changed since the last call (clears them)."""
+        if not self.dirty:
+            return []
+        slots = sorted(self.dirty)
+        self.dirty.clear()
+        runs = []
+        start = prev = slots[0]
+        for s in slots[1:]:
+            if s != prev + 1:
+                runs.append((start, prev + 1))
+                start = s
+            prev = s
+        runs.append((start, prev + 1))
+        return runs
+
+    def visible_slots(self, planes: np.ndarray | None) -> np.ndarray:
+        """int32 slots of shown instances inside the frustum (all shown ones if *planes* is None)."""
+        mask = self.shown
+        if planes is not None and len(mask):
+            mask = mask & aabbs_in_frustum(planes, self.centers, self.extents)
+        return np.flatnonzero(mask).astype(np.int32)
+
+
+def group_by_shape(objects: Iterable[Any]) -> tuple[dict[str, list[Any]], list[Any]]:
+    """Split *objects* into ``{shape: [objects]}`` for instancing and the rest (drawn one by one)."""
+    groups: dict[str, list[Any]] = {}
+    other: list[Any] = []
+    for obj in objects:
+        shape = obj.instance_shape() if hasattr(obj, "instance_shape") else None
+        if shape is None:
+            other.append(obj)
+        else:
+            groups.setdefault(shape[0], []).append(obj)
+    return groups, other
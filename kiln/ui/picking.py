@@ -0,0 +1,173 @@
+from __future__ import annotations
+
+"""
+World-space BVH over the scene's objects for viewport picking and region queries.
+
+`PickIndex` keeps, per pickable object (anything with an `instance_shape()`),
+its local bounds, inverse model matrix and world AABB, plus a
+:class:`~kiln.geometry.bvh.BVH` over the world AABBs:
+
+- `pick(origin, direction)` walks the BVH and runs the exact local-space
+  ray/box test only on the leaves it reaches,
+- `in_frustum(planes)` returns the objects overlapping a (sub-)frustum, for
+  rubber-band selection with :func:`~kiln.ui.instancing.frustum_planes`.
+
+Changed objects are reported with `touch()`; the tree is refit (topology kept)
+on the next query, and rebuilt once object add/remove is signalled with
+`invalidate()` or enough objects have moved that a refit would leave loose bounds.
+"""
+
+from typing import Any, Iterable
+
+import numpy as np
+
+from kiln.geometry.bvh import BVH, safe_inv, slab
+from kiln.ui.instancing import aabbs_in_frustum, unit_mesh
+
+
+def _pick_key(obj: Any, scale: tuple[float, float, float]) -> tuple:
+    p, r, s = obj.position, obj.rotation, obj.scale
+    return (p.x(), p.y(), p.z(), r.x(), r.y(), r.z(), s.x(), s.y(), s.z(), scale, bool(obj.visible))
+
+
+class PickIndex:
+    """Incrementally maintained BVH over pickable objects (see module docstring)."""
+
+    def __init__(self, *, leaf_size: int = 4, rebuild_fraction: float = 0.25) -> None:
+        self.leaf_size = int(leaf_size)
+        # Rebuild instead of refit once this fraction of objects moved since the last build.
+        self.rebuild_fraction = float(rebuild_fraction)
+        self.objects: list[Any] = []
+        self._slots: dict[int, int] = {}
+        self._keys: list[tuple | None] = []
+        self._local_min = np.zeros((0, 3))
+        self._local_max = np.zeros((0, 3))
+        self._inv_model = np.zeros((0, 4, 4))
+        self.world_min = np.zeros((0, 3))
+        self.world_max = np.zeros((0, 3))
+        self._shown = np.zeros((0,), dtype=bool)
+        self._bvh: BVH | None = None
+        self._stale = True
+        self._touched: set[int] = set()
+        self._moved_since_build = 0
+        self._refit_pending = False
+
+    def __len__(self) -> int:
+        return len(self.objects)
+
+    # ----------------------------
+    # Maintenance
+    # ----------------------------
+    def invalidate(self) -> None:
+        """The object list changed: rebuild on the next query."""
+        self._stale = True
+
+    def touch(self, obj: Any) -> None:
+        """*obj* may have moved: recheck it on the next query."""
+        slot = self._slots.get(id(obj))
+        if slot is not None:
+            self._touched.add(slot)
+
+    def sync(self, objects: Iterable[Any]) -> None:
+        """Bring the index up to date with *objects* (rebuild if invalidated, else refit touched ones)."""
+        if self._stale:
+            self._rebuild(objects)
+            return
+        moved = 0
+        for slot in self._touched:
+            if self._update_slot(slot):
+                moved += 1
+        self._touched.clear()
+        if moved:
+            self._moved_since_build += moved
+            self._refit_pending = True
+        if self._refit_pending and self._bvh is not None:
+            if self._moved_since_build > max(16, self.rebuild_fraction * len(self.objects)):
+                self._build_tree()
+            else:
+                self._bvh.refit(self.world_min, self.world_max)
+            self._refit_pending = False
+
+    def _rebuild(self, objects: Iterable[Any]) -> None:
+        self.objects = [o for o in objects if getattr(o, "instance_shape", None) and o.instance_shape() is not None]
+        n = len(self.objects)
+        self._slots = {id(o): i for i, o in enumerate(self.objects)}
+        self._keys = [None] * n
+        self._local_min = np.zeros((n, 3))
+        self._local_max = np.zeros((n, 3))
+        self._inv_model = np.zeros((n, 4, 4))
+        self.world_min = np.zeros((n, 3))
+        self.world_max = np.zeros((n, 3))
+        self._shown = np.zeros((n,), dtype=bool)
+        for i in range(n):
+            self._update_slot(i)
+        self._touched.clear()
+        self._stale = False
+        self._build_tree()
+
+    def _build_tree(self) -> None:
+        self._bvh = BVH(self.world_min, self.world_max, leaf_size=self.leaf_size)
+        self._moved_since_build = 0
+        self._refit_pending = False
+
+    def _update_slot(self, slot: int) -> bool:
+        obj = self.objects[slot]
+        shape, scale = obj.instance_shape()
+        key = _pick_key(obj, scale)
+        if key == self._keys[slot]:
+            return False
+        self._keys[slot] = key
+
+        _, _, (lo, hi) = unit_mesh(shape)
+        s = np.asarray(scale, dtype=np.float64)
+        self._local_min[slot] = lo * s
+        self._local_max[slot] = hi * s
+        model = obj.transform_array().astype(np.float64)
+        try:
+            self._inv_model[slot] = np.linalg.inv(model)
+        except np.linalg.LinAlgError:
+            self._inv_model[slot] = 0.0
+        lin = model[:3, :3]
+        center = lin @ (0.5 * (self._local_min[slot] + self._local_max[slot])) + model[:3, 3]
+        extent = np.abs(lin) @ (0.5 * (self._local_max[slot] - self._local_min[slot]))
+        self.world_min[slot] = center - extent
+        self.world_max[slot] = center + extent
+        self._shown[slot] = bool(obj.visible) and bool(np.any(self._inv_model[slot]))
+        return True
+
+    # ----------------------------
+    # Queries
+    # ----------------------------
+    def pick(self, origin: Any, direction: Any, max_distance: float = np.inf) -> tuple[Any, float] | None:
+        """Closest object hit by the ray and its distance (in units of *direction*), or None."""
+        if self._bvh is None or len(self.objects) == 0:
+            return None
+        o = np.asarray(origin, dtype=np.float64).reshape(1, 3)
+        d = np.asarray(direction, dtype=np.float64).reshape(1, 3)
+        t_best = np.array([float(max_distance)])
+
+        def narrow(rays: np.ndarray, items: np.ndarray) -> np.ndarray:
+            inv = self._inv_model[items]
+            lo_ = np.einsum("nij,nj->ni", inv[:, :3, :3], o[rays]) + inv[:, :3, 3]
+            ld = np.einsum("nij,nj->ni", inv[:, :3, :3], d[rays])
+            tn, tf = slab(self._local_min[items], self._local_max[items], lo_, safe_inv(ld))
+            hit = (tf >= np.maximum(tn, 0.0)) & self._shown[items]
+            return np.where(hit, np.maximum(tn, 0.0), np.inf)
+
+        best = self._bvh.closest(o, d, t_best, narrow)
+        if best[0] < 0:
+            return None
+        return self.objects[int(best[0])], float(t_best[0])
+
+    def in_frustum(self, planes: np.ndarray) -> list[Any]:
+        """Shown objects whose world AABB overlaps the frustum given by *planes* ([6, 4])."""
+        if self._bvh is None or len(self.objects) == 0:
+            return []
+
+        def accept(bmin: np.ndarray, bmax: np.ndarray) -> np.ndarray:
+            return aabbs_in_frustum(planes, 0.5 * (bmin + bmax), 0.5 * (bmax - bmin))
+
+        items = self._bvh.query(accept)
+        if items.size:
+            items = items[self._shown[items] & accept(self.world_min[items], self.world_max[items])]
+        return [self.objects[int(i)] for i in items]
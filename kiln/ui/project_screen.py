@@ -88,6 +88,7 @@ class ProjectScreen(QWidget):
         # 2. Scene -> Hierarchy + Properties (Sync selection)
         self.scene.selection_changed.connect(self.hierarchy.select_object)
         self.scene.selection_changed.connect(self.properties.set_object)
+        self.scene.object_changed.connect(self._on_object_changed)
         
         # 3. Hierarchy -> Scene (Input selection + deletion)
         self.hierarchy.object_selected.connect(self.scene.select)
@@ -106,6 +107,11 @@ class ProjectScreen(QWidget):
         # Trigger viewport redraw
         self.viewport.update()
 
+    def _on_object_changed(self, obj) -> None:
+        """An object was re-read after an external stage edit."""
+        if obj is self.scene.selected_object:
+            self.properties.set_object(obj)
+
     def _on_context_menu(self, position) -> None:
         index = self.tree.indexAt(position)
         if not index.isValid():
@@ -10,6 +10,12 @@ It is intentionally simple (no materials/textures), and renders either:
 
 The ViewportWidget is a **pure renderer**: it does not own the objects list
 or the USD stage.  It reads from a :class:`~kiln.scene.Scene` instance.
+
+Boxes and planes are drawn instanced (see :mod:`kiln.ui.instancing`): one
+shared unit mesh per shape, per-instance rows in a texture buffer updated only
+for changed objects, frustum culling on the CPU, and one instanced draw call
+for solids plus one for outlines per shape.  Other objects, or GL contexts
+without texture buffers, use the per-object path.
 """
 
 from typing import TYPE_CHECKING
@@ -19,11 +25,15 @@ from PyQt6.QtOpenGL import QOpenGLShaderProgram, QOpenGLShader
 from PyQt6.QtCore import Qt, QPoint
 from PyQt6.QtGui import QPainter, QColor, QFont
 from OpenGL.GL import *
+import ctypes
 import numpy as np
 import math
 from PyQt6.QtWidgets import QMenu
 from PyQt6.QtGui import QAction
 
+from kiln.ui.instancing import INSTANCE_FLOATS, InstanceSet, frustum_planes, group_by_shape
+from kiln.ui.picking import PickIndex
+
 if TYPE_CHECKING:
     from kiln.scene import Scene
 
@@ -49,10 +59,23 @@ class ViewportWidget(QOpenGLWidget):
         self.grid_vbo = None
         self.grid_vertex_count = 0
 
+        # Instanced path (see module docstring)
+        self.instanced_program = None
+        self.frustum_culling = True
+        self._instance_sets: dict[str, InstanceSet] = {}
+        self._instance_gl: dict[str, _InstancedMeshGL] = {}
+        self._loose_objects: list = []
+        self._instances_stale = True
+        self._dirty_objects: set = set()
+
+        # World-space BVH for picking / region selection (see kiln.ui.picking)
+        self.pick_index = PickIndex()
+
         # Drag and Drop
         self.setAcceptDrops(True)
 
-        self.scene.objects_changed.connect(self.update)
+        self.scene.objects_changed.connect(self._on_scene_objects_changed)
+        self.scene.object_changed.connect(self.mark_object_dirty)
         self.scene.selection_changed.connect(self._on_scene_selection_changed)
 
         self.setFocusPolicy(Qt.FocusPolicy.StrongFocus)
@@ -85,6 +108,23 @@ class ViewportWidget(QOpenGLWidget):
         """Repaint when the scene's selection changes."""
         self.update()
 
+    def _on_scene_objects_changed(self):
+        """Objects were added / removed: reassign instance slots on the next paint."""
+        self._instances_stale = True
+        self.pick_index.invalidate()
+        self.update()
+
+    def mark_object_dirty(self, obj):
+        """Re-upload *obj*'s instance data (if it changed) and repaint.
+
+        The selected object is re-checked on every paint, so edits made through
+        the properties panel need no explicit call.
+        """
+        if obj is not None:
+            self._dirty_objects.add(obj)
+            self.pick_index.touch(obj)
+        self.update()
+
     # ------------------------------------------------------------------
     # Drag & Drop
     # ------------------------------------------------------------------
@@ -190,48 +230,27 @@ class ViewportWidget(QOpenGLWidget):
             return real_tmin if real_tmin > 0 else 0
         return None
 
+    def _sync_pick_index(self):
+        if self.scene.selected_object is not None:
+            self.pick_index.touch(self.scene.selected_object)
+        self.pick_index.sync(self.scene.objects)
+
     def pick_object(self, screen_x, screen_y):
         """Returns the frontmost object at the given screen coordinates."""
         ray_o, ray_d = self.get_ray_from_mouse(screen_x, screen_y)
-        
-        closest_obj = None
-        min_t = float('inf')
-        
-        from kiln.objects import Box, Plane
-        
-        for obj in self.scene.objects:
-            # Transform ray to local space
-            model_q = obj.get_transform_matrix()
-            model = np.array(model_q.copyDataTo(), dtype=np.float32).reshape(4, 4).T
-            try:
-                inv_model = np.linalg.inv(model)
-            except np.linalg.LinAlgError:
-                continue
-                
-            local_o = (inv_model @ np.append(ray_o, 1.0))[:3]
-            local_d = (inv_model @ np.append(ray_d, 0.0))[:3]
-            
-            t = None
-            if isinstance(obj, Box):
-                hs = obj.size / 2.0
-                b_min = np.array([-hs, 0, -hs])
-                b_max = np.array([hs, obj.size, hs])
-                t = self.intersect_ray_aabb(local_o, local_d, b_min, b_max)
-            elif isinstance(obj, Plane):
-                # Simple infinite plane intersection in local space (y=0)
-                if abs(local_d[1]) > 1e-6:
-                    t_val = -local_o[1] / local_d[1]
-                    if t_val >= 0:
-                        # Check bounds if it's a finite plane (optional, but keep it simple)
-                        hit_local = local_o + t_val * local_d
-                        if abs(hit_local[0]) <= obj.width/2.0 and abs(hit_local[2]) <= obj.depth/2.0:
-                            t = t_val
-                            
-            if t is not None and t < min_t:
-                min_t = t
-                closest_obj = obj
-                
-        return closest_obj
+        self._sync_pick_index()
+        hit = self.pick_index.pick(ray_o, ray_d)
+        return hit[0] if hit is not None else None
+
+    def objects_in_rect(self, x0, y0, x1, y1):
+        """Objects overlapping the screen rectangle (rubber-band selection)."""
+        w = max(self.width(), 1)
+        h = max(self.height(), 1)
+        nx0, nx1 = sorted(((x0 / w) * 2.0 - 1.0, (x1 / w) * 2.0 - 1.0))
+        ny0, ny1 = sorted((1.0 - (y0 / h) * 2.0, 1.0 - (y1 / h) * 2.0))
+        planes = frustum_planes(self.get_view_projection_matrix(), (nx0, ny0, nx1, ny1))
+        self._sync_pick_index()
+        return self.pick_index.in_frustum(planes)
 
     # ------------------------------------------------------------------
     # Selection (delegates to scene)
@@ -304,8 +323,64 @@ class ViewportWidget(QOpenGLWidget):
         if not self.program.link():
             raise RuntimeError(self.program.log())
 
+        self.create_instanced_program()
         self.create_grid()
 
+    def create_instanced_program(self):
+        """Shader for the instanced path; leaves `instanced_program` None if unsupported."""
+        program = QOpenGLShaderProgram()
+        program.addShaderFromSourceCode(
+            QOpenGLShader.ShaderTypeBit.Vertex,
+            """
+            #version 330 core
+            layout (location = 0) in vec3 position;
+            layout (location = 2) in int instanceSlot;
+
+            // 5 RGBA32F texels per instance: model matrix columns, then color.
+            uniform samplerBuffer instances;
+            uniform mat4 VP;
+            uniform float zOffset;
+
+            out vec4 vertexColor;
+
+            void main()
+            {
+                int base = instanceSlot * 5;
+                mat4 model = mat4(texelFetch(instances, base),
+                                  texelFetch(instances, base + 1),
+                                  texelFetch(instances, base + 2),
+                                  texelFetch(instances, base + 3));
+                gl_Position = VP * model * vec4(position, 1.0);
+                gl_Position.z -= zOffset;
+                vertexColor = texelFetch(instances, base + 4);
+            }
+            """
+        )
+        program.addShaderFromSourceCode(
+            QOpenGLShader.ShaderTypeBit.Fragment,
+            """
+            #version 330 core
+            in vec4 vertexColor;
+            out vec4 fragColor;
+
+            uniform int useUniformColor;
+            uniform vec4 overrideColor;
+
+            void main()
+            {
+                if (useUniformColor == 1) {
+                    fragColor = overrideColor;
+                } else {
+                    fragColor = vertexColor;
+                }
+            }
+            """
+        )
+        if not program.link():
+            print(f"Instanced viewport shader unavailable, drawing per object: {program.log()}")
+            return
+        self.instanced_program = program
+
     def create_grid(self):
         """Create an infinite-looking grid centered at origin"""
         grid_size = 100
@@ -436,6 +511,13 @@ class ViewportWidget(QOpenGLWidget):
             return
 
         if hasattr(self, 'program') and self.program.isLinked():
+            vp = self.get_view_projection_matrix()
+
+            # 1. Draw solid objects (instanced shapes first, then the rest one by one)
+            loose = self.scene.objects
+            if self.instanced_program is not None:
+                loose = self._draw_instanced(vp)
+
             self.program.bind()
 
             mvp_loc = glGetUniformLocation(self.program.programId(), "MVP")
@@ -443,13 +525,10 @@ class ViewportWidget(QOpenGLWidget):
             override_color_loc = glGetUniformLocation(self.program.programId(), "overrideColor")
             z_offset_loc = glGetUniformLocation(self.program.programId(), "zOffset")
 
-            vp = self.get_view_projection_matrix()
-
-            # 1. Draw solid objects
             glUniform1i(use_color_loc, 0)
             glUniform1f(z_offset_loc, 0.0)
 
-            for obj in self.scene.objects:
+            for obj in loose:
                 model_q = obj.get_transform_matrix()
                 model_t = np.array(model_q.copyDataTo(), dtype=np.float32).reshape(4, 4)
                 model = model_t.T
@@ -487,6 +566,74 @@ class ViewportWidget(QOpenGLWidget):
 
         glEnable(GL_BLEND)
 
+    def _sync_instances(self):
+        """Bring the instance sets up to date with the scene (dirty objects only, unless stale)."""
+        if self._instances_stale:
+            groups, self._loose_objects = group_by_shape(self.scene.objects)
+            for shape in list(self._instance_sets):
+                if shape not in groups:
+                    del self._instance_sets[shape]
+                    gl = self._instance_gl.pop(shape, None)
+                    if gl is not None:
+                        gl.delete()
+            for shape, objs in groups.items():
+                inst = self._instance_sets.get(shape)
+                if inst is None:
+                    inst = self._instance_sets[shape] = InstanceSet(shape)
+                inst.rebuild(objs)
+            self._instances_stale = False
+            self._dirty_objects.clear()
+            return
+
+        dirty = self._dirty_objects
+        if self.scene.selected_object is not None:
+            dirty.add(self.scene.selected_object)
+        for obj in dirty:
+            shape = obj.instance_shape()
+            inst = self._instance_sets.get(shape[0]) if shape is not None else None
+            if inst is None or obj not in inst:
+                # Changed shape kind (or not instanced any more): regroup next frame.
+                if shape is not None or obj not in self._loose_objects:
+                    self._instances_stale = True
+                continue
+            inst.update(obj)
+        dirty.clear()
+
+    def _draw_instanced(self, vp):
+        """Draw every instanced shape; returns the objects left for the per-object path."""
+        self._sync_instances()
+        planes = frustum_planes(vp) if self.frustum_culling else None
+
+        program = self.instanced_program
+        program.bind()
+        pid = program.programId()
+        glUniformMatrix4fv(glGetUniformLocation(pid, "VP"), 1, GL_FALSE, vp.T)
+        glUniform1i(glGetUniformLocation(pid, "instances"), 0)
+        use_color_loc = glGetUniformLocation(pid, "useUniformColor")
+        override_color_loc = glGetUniformLocation(pid, "overrideColor")
+        z_offset_loc = glGetUniformLocation(pid, "zOffset")
+
+        for shape, inst in self._instance_sets.items():
+            gl = self._instance_gl.get(shape)
+            if gl is None:
+                gl = self._instance_gl[shape] = _InstancedMeshGL(inst)
+            gl.upload(inst)
+            if not gl.set_visible(inst.visible_slots(planes)):
+                continue
+
+            glUniform1i(use_color_loc, 0)
+            glUniform1f(z_offset_loc, 0.0)
+            gl.draw(solid=True)
+
+            # Wireframe overlay (black)
+            glUniform1i(use_color_loc, 1)
+            glUniform4f(override_color_loc, 0.0, 0.0, 0.0, 1.0)
+            glUniform1f(z_offset_loc, 0.002)
+            gl.draw(solid=False)
+
+        program.release()
+        return self._loose_objects
+
     def resizeGL(self, w, h):
         glViewport(0, 0, w, h)
 
@@ -579,4 +726,89 @@ class ViewportWidget(QOpenGLWidget):
         add_box_action.triggered.connect(lambda: self.scene.add_box())
         add_object_menu.addAction(add_box_action)
 
-        menu.exec(self.mapToGlobal(pos))
\ No newline at end of file
+        menu.exec(self.mapToGlobal(pos))
+
+
+class _InstancedMeshGL:
+    """GL buffers for one :class:`~kiln.ui.instancing.InstanceSet`.
+
+    The unit mesh lives in static VBOs, instance rows in a texture buffer
+    (updated per dirty slot run), and the culled slot indices in a small
+    per-instance attribute buffer re-uploaded only when the visible set changes.
+    """
+
+    def __init__(self, inst: InstanceSet):
+        self.slot_vbo = glGenBuffers(1)
+        self.tri_vao, self.tri_vbo = self._mesh_vao(inst.triangles)
+        self.line_vao, self.line_vbo = self._mesh_vao(inst.lines)
+        self.tri_count = len(inst.triangles)
+        self.line_count = len(inst.lines)
+        self.tbo = glGenBuffers(1)
+        self.tbo_tex = glGenTextures(1)
+        self.capacity = -1
+        self.count = 0
+        self._visible = None
+
+    def _mesh_vao(self, vertices):
+        vao = glGenVertexArrays(1)
+        vbo = glGenBuffers(1)
+        glBindVertexArray(vao)
+        glBindBuffer(GL_ARRAY_BUFFER, vbo)
+        glBufferData(GL_ARRAY_BUFFER, vertices.nbytes, vertices, GL_STATIC_DRAW)
+        glEnableVertexAttribArray(0)
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * 4, ctypes.c_void_p(0))
+
+        glBindBuffer(GL_ARRAY_BUFFER, self.slot_vbo)
+        glEnableVertexAttribArray(2)
+        glVertexAttribIPointer(2, 1, GL_INT, 4, ctypes.c_void_p(0))
+        glVertexAttribDivisor(2, 1)
+
+        glBindVertexArray(0)
+        glBindBuffer(GL_ARRAY_BUFFER, 0)
+        return vao, vbo
+
+    def upload(self, inst: InstanceSet):
+        glBindBuffer(GL_TEXTURE_BUFFER, self.tbo)
+        if inst.resized or self.capacity != len(inst):
+            data = inst.data if len(inst) else np.zeros((1, INSTANCE_FLOATS), dtype=np.float32)
+            glBufferData(GL_TEXTURE_BUFFER, data.nbytes, data, GL_DYNAMIC_DRAW)
+            glBindTexture(GL_TEXTURE_BUFFER, self.tbo_tex)
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, self.tbo)
+            glBindTexture(GL_TEXTURE_BUFFER, 0)
+            self.capacity = len(inst)
+            self._visible = None
+            inst.resized = False
+            inst.take_dirty_runs()
+        else:
+            row_bytes = INSTANCE_FLOATS * 4
+            for start, stop in inst.take_dirty_runs():
+                rows = inst.data[start:stop]
+                glBufferSubData(GL_TEXTURE_BUFFER, start * row_bytes, rows.nbytes, rows)
+        glBindBuffer(GL_TEXTURE_BUFFER, 0)
+
+    def set_visible(self, slots) -> int:
+        """Upload the slot indices to draw (skipped if unchanged); returns the instance count."""
+        self.count = len(slots)
+        if self.count and (self._visible is None or not np.array_equal(slots, self._visible)):
+            glBindBuffer(GL_ARRAY_BUFFER, self.slot_vbo)
+            glBufferData(GL_ARRAY_BUFFER, slots.nbytes, slots, GL_STREAM_DRAW)
+            glBindBuffer(GL_ARRAY_BUFFER, 0)
+            self._visible = slots
+        return self.count
+
+    def draw(self, solid: bool):
+        glActiveTexture(GL_TEXTURE0)
+        glBindTexture(GL_TEXTURE_BUFFER, self.tbo_tex)
+        if solid:
+            glBindVertexArray(self.tri_vao)
+            glDrawArraysInstanced(GL_TRIANGLES, 0, self.tri_count, self.count)
+        else:
+            glBindVertexArray(self.line_vao)
+            glDrawArraysInstanced(GL_LINES, 0, self.line_count, self.count)
+        glBindVertexArray(0)
+        glBindTexture(GL_TEXTURE_BUFFER, 0)
+
+    def delete(self):
+        glDeleteVertexArrays(2, [self.tri_vao, self.line_vao])
+        glDeleteBuffers(4, [self.tri_vbo, self.line_vbo, self.slot_vbo, self.tbo])
+        glDeleteTextures([self.tbo_tex])
@@ -0,0 +1,98 @@
+from __future__ import annotations
+
+import io
+import json
+import tempfile
+import unittest
+from contextlib import redirect_stdout
+from pathlib import Path
+import sys
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.bench.cli import main, run_scenarios
+from kiln.bench.report import compare, load_report, make_report, write_report
+from kiln.bench.scenarios import SCENARIOS, BenchContext
+from kiln.bench.stats import PhaseTimer, summarize
+
+
+def _report(p50: dict[str, float]) -> dict:
+    phases = {k: {"n": 10, "p50_ms": v, "p99_ms": v, "mean_ms": v, "total_s": v * 1e-2} for k, v in p50.items()}
+    result = {"scenario": "city", "case": "full", "params": {}, "backend": "cpu", "status": "ok", "phases": phases, "extra": {}}
+    return make_report([result], settings={})
+
+
+class TestStats(unittest.TestCase):
+    def test_summarize(self) -> None:
+        s = summarize([0.001 * i for i in range(1, 101)])
+        self.assertEqual(s["n"], 100)
+        self.assertAlmostEqual(s["p50_ms"], 50.5, places=3)
+        self.assertGreater(s["p99_ms"], 98.0)
+        self.assertEqual(summarize([])["n"], 0)
+
+    def test_phase_timer_one_sample_per_step(self) -> None:
+        timer = PhaseTimer(phases=("a", "b"))
+        for i in range(5):
+            timer.add("a", 0.001)
+            if i >= 3:
+                timer.add("late", 0.002)
+            timer.end_step()
+        self.assertEqual([len(timer.samples[p]) for p in ("a", "b", "late")], [5, 5, 5])
+        self.assertEqual(timer.samples["late"][:3], [0.0, 0.0, 0.0])
+        self.assertIn("step", timer.summary())
+        timer.reset()
+        self.assertEqual(timer.summary()["a"]["n"], 0)
+
+
+class TestCompare(unittest.TestCase):
+    def test_flags_regressions_above_threshold(self) -> None:
+        base = _report({"physics": 10.0, "policy": 1.0, "render": 0.01})
+        new = _report({"physics": 12.0, "policy": 1.05, "render": 0.03})
+        deltas = {d.phase: d for d in compare(base, new)}
+        self.assertTrue(deltas["physics"].regressed(0.10, 0.05))
+        self.assertFalse(deltas["policy"].regressed(0.10, 0.05))
+        # Tripled but below the noise floor.
+        self.assertFalse(deltas["render"].regressed(0.10, 0.05))
+
+    def test_cli_exit_code(self) -> None:
+        with tempfile.TemporaryDirectory() as d:
+            write_report(_report({"physics": 10.0}), Path(d) / "a.json")
+            write_report(_report({"physics": 15.0}), Path(d) / "b.json")
+            with redirect_stdout(io.StringIO()):
+                self.assertEqual(main(["compare", str(Path(d) / "a.json"), str(Path(d) / "a.json")]), 0)
+                self.assertEqual(main(["compare", str(Path(d) / "a.json"), str(Path(d) / "b.json")]), 1)
+                self.assertEqual(main(["compare", "--threshold", "0.6", str(Path(d) / "a.json"), str(Path(d) / "b.json")]), 0)
+
+
+class TestScenarios(unittest.TestCase):
+    def test_registry(self) -> None:
+        for name in ("city", "npc_sweep", "collisions", "bundle_load", "navgrid_build", "astar_replans"):
+            self.assertIn(name, SCENARIOS)
+
+    def test_pure_scenarios_quick(self) -> None:
+        ctx = BenchContext(backend="cpu", steps=3, warmup=1, quick=True)
+        names = [n for n, sc in SCENARIOS.items() if not sc.needs_sim]
+        results = run_scenarios(names, ctx, log=lambda *_: None)
+        self.assertEqual({r["scenario"] for r in results}, set(names))
+        for r in results:
+            self.assertEqual(r["status"], "ok", r)
+            self.assertIsNone(r["backend"])
+            for summary in r["phases"].values():
+                self.assertGreaterEqual(summary["p99_ms"], summary["p50_ms"])
+        json.dumps(results)
+
+    def test_cli_run_writes_report(self) -> None:
+        with tempfile.TemporaryDirectory() as d:
+            out = Path(d) / "bench.json"
+            with redirect_stdout(io.StringIO()):
+                rc = main(["run", "--scenario", "navgrid_build", "--quick", "--steps", "3", "--out", str(out)])
+            self.assertEqual(rc, 0)
+            report = load_report(out)
+            self.assertIn("genesis_version", report["environment"])
+            self.assertEqual(report["results"][0]["scenario"], "navgrid_build")
+
+
+if __name__ == "__main__":
+    unittest.main()
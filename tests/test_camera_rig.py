@@ -0,0 +1,61 @@
+from __future__ import annotations
+
+import math
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.sim.genesis.cameras import CameraRig, CameraRigConfig, mount_poses
+
+
+class _FakeScene:
+    def __init__(self) -> None:
+        self.cameras: list[dict] = []
+
+    def add_camera(self, **kw):
+        self.cameras.append(kw)
+        return kw
+
+
+class _FakeSim:
+    def __init__(self) -> None:
+        self.scene = _FakeScene()
+        self._built = False
+
+
+class TestCameraRig(unittest.TestCase):
+    def test_mount_poses_follow_yaw(self) -> None:
+        half = math.sqrt(0.5)
+        pos = np.array([[0.0, 0.0, 0.5], [1.0, 2.0, 0.5]])
+        # Identity, and 90 degrees about z.
+        quat = np.array([[1.0, 0.0, 0.0, 0.0], [half, 0.0, 0.0, half]])
+        eye, lookat = mount_poses(pos, quat, offset=(-3.0, 0.0, 1.5), lookahead=2.0)
+        np.testing.assert_allclose(eye, [[-3.0, 0.0, 2.0], [1.0, -1.0, 2.0]], atol=1e-12)
+        np.testing.assert_allclose(lookat, [[2.0, 0.0, 0.5], [1.0, 4.0, 0.5]], atol=1e-12)
+
+    def test_cameras_share_config(self) -> None:
+        sim = _FakeSim()
+        rig = CameraRig(sim, CameraRigConfig(res=(32, 24), fov=50.0), mounts=[object(), object(), object()])
+        self.assertEqual(len(rig), 3)
+        self.assertTrue(all(c["res"] == (32, 24) and c["fov"] == 50.0 and not c["GUI"] for c in sim.scene.cameras))
+
+        static = CameraRig(sim, poses=[((0, 0, 5), (0, 0, 0))])
+        self.assertEqual(static.cameras[0]["pos"], (0.0, 0.0, 5.0))
+
+    def test_rejects_bad_arguments(self) -> None:
+        sim = _FakeSim()
+        with self.assertRaises(ValueError):
+            CameraRig(sim)
+        sim._built = True
+        with self.assertRaises(RuntimeError):
+            CameraRig(sim, mounts=[object()])
+
+
+if __name__ == "__main__":
+    unittest.main()
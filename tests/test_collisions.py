@@ -0,0 +1,112 @@
+from __future__ import annotations
+
+import contextlib
+import unittest
+from unittest import mock
+from pathlib import Path
+import sys
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+import kiln.actors.components as components
+from kiln.actors.components import CollisionTracker
+from kiln.sim.genesis.collisions import CollisionPhase, CollisionService
+
+
+class _Entity:
+    pass
+
+
+class _Geoms:
+    def __init__(self, geom_start: int, geom_end: int) -> None:
+        self.geom_start = geom_start
+        self.geom_end = geom_end
+
+
+class _Lut(list):
+    """Host stand-in for the tracker's 1-D `torch.long` lookup table."""
+
+    def __setitem__(self, key, value) -> None:
+        if isinstance(key, slice):
+            for i in range(*key.indices(len(self))):
+                super().__setitem__(i, value)
+        else:
+            super().__setitem__(key, value)
+
+
+class _LutTorch:
+    long = "long"
+
+    @staticmethod
+    def full(shape: tuple[int], value: int, dtype: object = None) -> _Lut:
+        return _Lut([value] * shape[0])
+
+
+class _Profiler:
+    def phase(self, name: str) -> contextlib.AbstractContextManager:
+        return contextlib.nullcontext()
+
+
+class _Sim:
+    profiler = _Profiler()
+
+
+class TestCollisionService(unittest.TestCase):
+    def test_each_subscription_applies_its_own_min_force(self) -> None:
+        service = CollisionService(_Sim())
+        wall = _Entity()
+        soft, hard = service.subscribe(_Entity()), service.subscribe(_Entity())
+        topo = {"targets": [(id(wall), wall)], "n_targets": 1}
+        # Stand-in for the device pass: one (subscriber * n_targets + target, force) row per contact.
+        contacts = {
+            0: {0: [0.5, 3.0, 4.0], 1: [5.0, 8.0]},
+            1: {0: [2.0], 1: [50.0, 12.0, 3.0]},
+            2: {0: [2.0], 1: [5.0]},
+            3: {},
+        }
+
+        def fake_poll() -> None:
+            rows = [[float(k), f] for k, fs in contacts[service._last_step].items() for f in fs]
+            service._route(rows=rows, topo=topo, with_force=True)
+
+        service._poll = fake_poll
+
+        def phases(step: int) -> tuple[list, list]:
+            # The strict subscriber polls first, so its threshold must not leak to the other one.
+            h = [(e.phase, e.max_force, e.contact_count) for e in hard.poll(step_idx=step, min_force=10.0)]
+            s = [(e.phase, e.max_force, e.contact_count) for e in soft.poll(step_idx=step, min_force=1.0)]
+            return h, s
+
+        # Only contacts at or above each subscriber's min_force are counted.
+        self.assertEqual(phases(0), ([], [(CollisionPhase.BEGIN, 4.0, 2)]))
+        self.assertEqual(phases(1), ([(CollisionPhase.BEGIN, 50.0, 2)], []))
+        self.assertEqual(phases(2), ([(CollisionPhase.END, 50.0, 0)], []))
+        self.assertEqual(phases(3), ([], [(CollisionPhase.END, 2.0, 0)]))
+        # Polling the same step again returns the same events without re-diffing.
+        self.assertEqual([e.phase for e in soft.poll(step_idx=3, min_force=1.0)], [CollisionPhase.END])
+
+    def test_without_min_force_every_contact_counts(self) -> None:
+        service = CollisionService(_Sim())
+        wall = _Entity()
+        sub = service.subscribe(_Entity())
+        topo = {"targets": [(id(wall), wall)], "n_targets": 1}
+        service._poll = lambda: service._route(rows=[[0.0, 0.1], [0.0, 9.0]], topo=topo, with_force=True)
+        (ev,) = sub.poll(step_idx=0)
+        self.assertEqual((ev.phase, ev.max_force, ev.contact_count), (CollisionPhase.BEGIN, None, 2))
+
+
+class TestCollisionTracker(unittest.TestCase):
+    def test_first_tracked_entity_wins_overlapping_geoms(self) -> None:
+        parent, child, ignored = _Geoms(0, 6), _Geoms(2, 4), _Geoms(5, 6)
+        tracker = CollisionTracker(_Geoms(10, 11))
+        with mock.patch.object(components, "_import_torch_optional", return_value=_LutTorch):
+            tracker.set_targets(tracked_entities=[child, parent], ignore_entities=[ignored])
+            self.assertEqual(list(tracker._geom_lut_cpu), [1, 1, 0, 0, 1, -1])
+            tracker.set_targets(tracked_entities=[parent, child], ignore_entities=[ignored])
+            self.assertEqual(list(tracker._geom_lut_cpu), [0, 0, 0, 0, 0, -1])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,102 @@
+from __future__ import annotations
+
+import json
+import os
+import shutil
+import tempfile
+import unittest
+from pathlib import Path
+import sys
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.envio import PrimitiveColumns, compile_env_bundle, load_env_bundle
+from kiln.envio.bundle import EnvBundleError
+from kiln.envio.cli import main as cli_main
+
+EXAMPLE = ROOT / "examples" / "env_bundles" / "basic_v1"
+
+
+def _generated_primitives(n: int) -> list[dict[str, object]]:
+    prims: list[dict[str, object]] = []
+    for i in range(n):
+        p: dict[str, object] = {
+            "id": f"prim_{i}_é",
+            "pose": {"pos": [i * 0.5, -i * 0.25, 0.1 * i], "quat": [1.0, 0.0, 0.0, 0.0]},
+        }
+        kind = i % 4
+        if kind == 0:
+            p.update(shape="box", size=[1.0, 2.0, 0.5 + i], mass=0.0, color=[0.1, 0.2, 0.3])
+        elif kind == 1:
+            p.update(shape="sphere", radius=0.25 + i, mass=2.0, color=[0.1, 0.2, 0.3, 0.5], collision=False)
+        elif kind == 2:
+            p.update(shape="cylinder", radius=0.5, height=1.0 + i, fixed=False, visualization=False)
+        else:
+            p.update(shape="plane", normal=[0.0, 1.0, 0.0] if i % 8 == 3 else None)
+            if p["normal"] is None:
+                del p["normal"]
+        prims.append(p)
+    return prims
+
+
+class TestCompiledBundle(unittest.TestCase):
+    def setUp(self) -> None:
+        self._tmp = tempfile.TemporaryDirectory()
+        self.dir = Path(self._tmp.name) / "bundle"
+        shutil.copytree(EXAMPLE, self.dir)
+
+    def tearDown(self) -> None:
+        self._tmp.cleanup()
+
+    def test_roundtrip_matches_json(self) -> None:
+        env = json.loads((self.dir / "env.json").read_text(encoding="utf-8"))
+        env["primitives"] = env["primitives"] + _generated_primitives(64)
+        (self.dir / "env.json").write_text(json.dumps(env), encoding="utf-8")
+
+        parsed = load_env_bundle(self.dir)
+        out = compile_env_bundle(self.dir)
+        self.assertEqual(out.name, "env.kbundle")
+
+        compiled = load_env_bundle(self.dir)
+        self.assertIsInstance(compiled.primitives, PrimitiveColumns)
+        self.assertEqual(len(compiled.primitives), len(parsed.primitives))
+        self.assertEqual(list(compiled.primitives), list(parsed.primitives))
+        self.assertEqual(compiled.primitives[-1], parsed.primitives[-1])
+        self.assertEqual(compiled, parsed)
+        self.assertEqual(compiled.primitives.ids(), [p.id for p in parsed.primitives])
+        self.assertEqual(compiled.to_json(), parsed.to_json())
+
+    def test_stale_compiled_file_falls_back_to_json(self) -> None:
+        compile_env_bundle(self.dir)
+        env_path = self.dir / "env.json"
+        env = json.loads(env_path.read_text(encoding="utf-8"))
+        env["primitives"] = env["primitives"][:1]
+        env_path.write_text(json.dumps(env), encoding="utf-8")
+
+        bundle = load_env_bundle(self.dir)
+        self.assertNotIsInstance(bundle.primitives, PrimitiveColumns)
+        self.assertEqual(len(bundle.primitives), 1)
+        # Forcing the compiled copy skips the freshness check.
+        self.assertEqual(len(load_env_bundle(self.dir, compiled=True).primitives), 4)
+
+    def test_compiled_required_but_missing(self) -> None:
+        with self.assertRaises(EnvBundleError):
+            load_env_bundle(self.dir, compiled=True)
+
+    def test_same_contents_with_new_mtime_is_fresh(self) -> None:
+        compile_env_bundle(self.dir)
+        env_path = self.dir / "env.json"
+        st = env_path.stat()
+        os.utime(env_path, ns=(st.st_atime_ns, st.st_mtime_ns + 10_000_000_000))
+        self.assertIsInstance(load_env_bundle(self.dir).primitives, PrimitiveColumns)
+
+    def test_cli_compile(self) -> None:
+        self.assertEqual(cli_main(["compile", str(self.dir)]), 0)
+        self.assertTrue((self.dir / "env.kbundle").exists())
+        self.assertEqual(cli_main(["info", str(self.dir)]), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,76 @@
+from __future__ import annotations
+
+import unittest
+from pathlib import Path
+import sys
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.sim.genesis.handles import resolve_entity_handle
+
+
+class _Batched2D(list):
+    ndim = 2
+
+
+class _OldStyleEntity:
+    """`pos` attribute + `control_dofs_velocity` only."""
+
+    def __init__(self) -> None:
+        self.pos = [1.0, 2.0, 3.0]
+        self.velocity = None
+
+    def control_dofs_velocity(self, v) -> None:
+        self.velocity = ("control", v)
+
+
+class _NewStyleEntity:
+    """Getter methods; both velocity setters (the direct setter must win)."""
+
+    def __init__(self) -> None:
+        self.velocity = None
+        self.force = None
+        self.reads = 0
+
+    def get_pos(self):
+        self.reads += 1
+        return _Batched2D([[4.0, 5.0, 6.0], [7.0, 8.0, 9.0]])  # batched: env 0 first
+
+    def set_dofs_velocity(self, v) -> None:
+        self.velocity = ("set", v)
+
+    def control_dofs_velocity(self, v) -> None:
+        self.velocity = ("control", v)
+
+    def control_dofs_force(self, f) -> None:
+        self.force = f
+
+
+class TestEntityHandles(unittest.TestCase):
+    def test_binds_version_specific_accessors(self) -> None:
+        old = _OldStyleEntity()
+        h = resolve_entity_handle(old)
+        self.assertEqual(h.read_position(), (1.0, 2.0, 3.0))
+        old.pos = [1.5, 2.5, 3.5]
+        self.assertEqual(h.read_position(), (1.5, 2.5, 3.5))
+        h.set_dofs_velocity([0.0] * 6)
+        self.assertEqual(old.velocity, ("control", [0.0] * 6))
+        self.assertIsNone(h.control_dofs_force)
+        self.assertIsNone(h.set_position)
+
+        new = _NewStyleEntity()
+        h = resolve_entity_handle(new)
+        new.get_pos = lambda: [0.0, 0.0, 0.0]  # type: ignore[method-assign]
+        # The getter was bound at resolve time, so the original method is still used.
+        self.assertEqual(h.read_position(), (4.0, 5.0, 6.0))
+        self.assertEqual(new.reads, 1)
+        h.set_dofs_velocity([1.0] * 6)
+        self.assertEqual(new.velocity, ("set", [1.0] * 6))
+        h.control_dofs_force([2.0] * 6)
+        self.assertEqual(new.force, [2.0] * 6)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,111 @@
+from __future__ import annotations
+
+import multiprocessing as mp
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.sim.genesis.pool import EnvPool, EnvPoolConfig, EnvTask
+
+BUNDLE = str(ROOT / "examples" / "env_bundles" / "basic_v1")
+START_METHOD = "fork" if "fork" in mp.get_all_start_methods() else "spawn"
+
+
+class _CounterWorld:
+    """Stands in for a sim: a 1-D position integrating the last commanded velocity."""
+
+    def __init__(self) -> None:
+        self.pos = 0.0
+        self.vel = 0.0
+
+    def step(self) -> None:
+        self.pos += self.vel
+
+
+class _CounterTask(EnvTask):
+    def shapes(self, bundle):
+        return (1,), (1,)
+
+    def load(self, bundle_dir, sim_config):
+        return _CounterWorld(), None
+
+    def setup(self, sim, loaded) -> None:
+        pass
+
+    def reset(self, sim, loaded, rng) -> None:
+        sim.pos = 0.0
+        sim.vel = 0.0
+
+    def act(self, sim, action) -> None:
+        if float(action[0]) < 0.0:
+            raise ValueError("negative velocity")
+        sim.vel = float(action[0])
+
+    def observe(self, sim, out) -> None:
+        out[0] = sim.pos
+
+    def reward(self, sim) -> float:
+        return sim.pos
+
+    def terminated(self, sim) -> bool:
+        return sim.pos >= 3.0
+
+
+def _pool(**kw) -> EnvPool:
+    cfg = EnvPoolConfig(bundle_dir=BUNDLE, num_envs=2, start_method=START_METHOD, pin_cpus=False, **kw)
+    return EnvPool(cfg, _CounterTask())
+
+
+class TestEnvPool(unittest.TestCase):
+    def test_step_autoreset_and_zero_copy(self) -> None:
+        with _pool() as pool:
+            out = pool.reset()
+            np.testing.assert_array_equal(out.obs, [[0.0], [0.0]])
+
+            out = pool.step([[1.0], [2.0]])
+            np.testing.assert_array_equal(out.obs, [[1.0], [2.0]])
+            self.assertTrue(np.shares_memory(out.obs, pool._ring["obs"]))
+
+            out = pool.step([[1.0], [2.0]])
+            # Env 1 reached 4.0: terminated, auto-reset, final observation kept aside.
+            np.testing.assert_array_equal(out.terminated, [False, True])
+            np.testing.assert_array_equal(out.obs, [[2.0], [0.0]])
+            self.assertEqual(float(out.final_obs[1, 0]), 4.0)
+            np.testing.assert_array_equal(out.reward, [2.0, 4.0])
+            np.testing.assert_array_equal(out.elapsed_steps, [2, 2])
+
+    def test_async_subsets_and_truncation(self) -> None:
+        with _pool(max_episode_steps=2, ring_depth=2) as pool:
+            pool.reset()
+            pool.send([[0.5]], env_ids=[1])
+            pool.send([[0.5]], env_ids=[1])
+            with self.assertRaises(RuntimeError):
+                pool.send([[0.5]], env_ids=[1])  # ring full for env 1
+            pool.send([[1.0]], env_ids=[0])
+
+            first = pool.recv()
+            self.assertEqual(first.env_ids.tolist(), [1])
+            self.assertEqual(float(first.obs[0, 0]), 0.5)
+            second = pool.recv()
+            self.assertTrue(bool(second.truncated[0]))
+            self.assertEqual(float(second.final_obs[0, 0]), 1.0)
+            self.assertEqual(float(second.obs[0, 0]), 0.0)
+            third = pool.recv()
+            self.assertEqual(third.env_ids.tolist(), [0])
+            self.assertEqual(float(third.obs[0, 0]), 1.0)
+
+    def test_worker_error_is_raised(self) -> None:
+        with _pool() as pool:
+            pool.reset()
+            with self.assertRaisesRegex(RuntimeError, "negative velocity"):
+                pool.step([[1.0], [-1.0]])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -1,15 +1,19 @@
 from __future__ import annotations
 
+import io
+import os
+import tempfile
 import unittest
 from types import SimpleNamespace
 from pathlib import Path
 import sys
+from xml.etree.ElementTree import ElementTree, indent, iterparse
 
 ROOT = Path(__file__).resolve().parents[1]
 if str(ROOT) not in sys.path:
     sys.path.insert(0, str(ROOT))
 
-from kiln.envio.export import KILN_NS, _build_mjcf
+from kiln.envio.export import KILN_NS, _build_mjcf, export_scene_mjcf, write_mjcf_stream
 from kiln.objects import Box, Plane
 
 
@@ -112,5 +116,61 @@ class TestMjcfExport(unittest.TestCase):
         self.assertIsNone(building_body.find("kiln:actor", ns))
 
 
+def _mixed_scene() -> SimpleNamespace:
+    ground = Plane("ground")
+    ground.role = "ground"
+    objs = [ground]
+    for i in range(20):
+        b = Box(f"b_{i}")
+        b.role = ("car", "npc", "building", None)[i % 4]
+        objs.append(b)
+    return SimpleNamespace(objects=objs)
+
+
+class TestStreamingExport(unittest.TestCase):
+    def test_stream_matches_tree(self) -> None:
+        scene = _mixed_scene()
+        buf = io.StringIO()
+        write_mjcf_stream(buf.write, scene, "scene.usda", "test_scene")
+        tree = ElementTree(_build_mjcf(scene, "scene.usda", "test_scene"))
+        indent(tree, space="  ")
+        out = io.BytesIO()
+        tree.write(out, encoding="utf-8", xml_declaration=True)
+        self.assertEqual(buf.getvalue(), out.getvalue().decode("utf-8"))
+
+    def test_iterparse_bodies(self) -> None:
+        scene = _mixed_scene()
+        buf = io.StringIO()
+        write_mjcf_stream(buf.write, scene, "scene.usda", "test_scene")
+        names = [
+            el.get("name")
+            for _, el in iterparse(io.BytesIO(buf.getvalue().encode("utf-8")), events=("end",))
+            if el.tag == "body"
+        ]
+        self.assertEqual(len(names), 1 + len(scene.objects))
+
+    def test_export_skips_unchanged_files(self) -> None:
+        with tempfile.TemporaryDirectory() as d:
+            src = Path(d) / "src" / "city.usda"
+            src.parent.mkdir()
+            src.write_text("#usda 1.0\n", encoding="utf-8")
+            scene = _mixed_scene()
+            scene.scene_path = src
+            out = Path(d) / "out"
+
+            xml_path = export_scene_mjcf(scene, out)
+            past = 1_000_000_000
+            for f in (xml_path, out / "scene.usda"):
+                os.utime(f, ns=(past, past))
+            export_scene_mjcf(scene, out, concurrent=False)
+            self.assertEqual(xml_path.stat().st_mtime_ns, past)
+            self.assertEqual((out / "scene.usda").stat().st_mtime_ns, past)
+
+            scene.objects[1].position.setX(3.0)
+            export_scene_mjcf(scene, out, streaming=False)
+            self.assertNotEqual(xml_path.stat().st_mtime_ns, past)
+            self.assertEqual(sorted(p.name for p in out.iterdir()), ["scene.usda", "scene.xml"])
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,83 @@
+from __future__ import annotations
+
+import math
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from PyQt6.QtGui import QVector3D
+
+from kiln.objects import Box, Plane
+from kiln.ui.instancing import InstanceSet, frustum_planes, group_by_shape
+
+
+def _projection(near: float = 0.1, far: float = 1000.0, fov_deg: float = 45.0) -> np.ndarray:
+    # Same convention as ViewportWidget; camera at the origin looking down -z.
+    f = 1.0 / math.tan(math.radians(fov_deg) / 2.0)
+    m = np.zeros((4, 4), dtype=np.float32)
+    m[0, 0] = f
+    m[1, 1] = f
+    m[2, 2] = (far + near) / (near - far)
+    m[2, 3] = (2 * far * near) / (near - far)
+    m[3, 2] = -1.0
+    return m
+
+
+class TestInstanceSet(unittest.TestCase):
+    def test_rows_and_bounds(self) -> None:
+        box = Box("b", size=2.0, position=QVector3D(1.0, 0.0, -3.0))
+        inst = InstanceSet("box")
+        inst.rebuild([box])
+        model = inst.data[0, :16].reshape(4, 4).T
+        expected = box.transform_array() @ np.diag((2.0, 2.0, 2.0, 1.0))
+        np.testing.assert_allclose(model, expected, atol=1e-6)
+        np.testing.assert_allclose(inst.centers[0], (1.0, 1.0, -3.0), atol=1e-6)
+        np.testing.assert_allclose(inst.extents[0], (1.0, 1.0, 1.0), atol=1e-6)
+        self.assertAlmostEqual(float(inst.data[0, 16]), box.color.redF(), places=6)
+
+    def test_only_changed_objects_are_dirty(self) -> None:
+        boxes = [Box(f"b{i}") for i in range(6)]
+        inst = InstanceSet("box")
+        inst.rebuild(boxes)
+        self.assertEqual(inst.take_dirty_runs(), [])
+        self.assertFalse(inst.update(boxes[0]))
+        # In-place edit, as done by the properties panel.
+        boxes[1].position.setX(5.0)
+        boxes[2].position.setZ(1.0)
+        boxes[4].rotation.setY(30.0)
+        for b in boxes:
+            inst.update(b)
+        self.assertEqual(inst.take_dirty_runs(), [(1, 3), (4, 5)])
+        self.assertEqual(inst.take_dirty_runs(), [])
+        self.assertAlmostEqual(float(inst.data[1, 12]), 5.0)
+
+    def test_frustum_culling(self) -> None:
+        planes = frustum_planes(_projection())
+        ahead = Box("ahead", position=QVector3D(0.0, 0.0, -10.0))
+        behind = Box("behind", position=QVector3D(0.0, 0.0, 10.0))
+        aside = Box("aside", position=QVector3D(100.0, 0.0, -10.0))
+        hidden = Box("hidden", position=QVector3D(0.0, 0.0, -5.0))
+        hidden.visible = False
+        inst = InstanceSet("box")
+        inst.rebuild([ahead, behind, aside, hidden])
+        self.assertEqual(inst.visible_slots(planes).tolist(), [0])
+        self.assertEqual(inst.visible_slots(None).tolist(), [0, 1, 2])
+
+    def test_group_by_shape(self) -> None:
+        box, plane = Box("b"), Plane("p", width=4.0, depth=2.0)
+        groups, other = group_by_shape([box, plane, object()])
+        self.assertEqual(groups, {"box": [box], "plane": [plane]})
+        self.assertEqual(len(other), 1)
+        inst = InstanceSet("plane")
+        inst.rebuild([plane])
+        np.testing.assert_allclose(inst.extents[0], (2.0, 0.0, 1.0), atol=1e-6)
+
+
+if __name__ == "__main__":
+    unittest.main()
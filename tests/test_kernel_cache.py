@@ -0,0 +1,50 @@
+from __future__ import annotations
+
+import os
+import tempfile
+import unittest
+from pathlib import Path
+import sys
+from unittest import mock
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.sim.genesis.kernel_cache import KernelCache, topology_hash
+
+
+class TestKernelCache(unittest.TestCase):
+    def test_namespace_env_and_scene_markers(self) -> None:
+        with tempfile.TemporaryDirectory() as tmp, mock.patch.dict(os.environ, {}, clear=False):
+            cache = KernelCache(tmp, backend="CUDA", version="0.3.1+dev")
+            self.assertEqual(cache.key, "genesis-0.3.1_dev-cuda")
+            self.assertNotEqual(cache.key, KernelCache(tmp, backend="cpu", version="0.3.1+dev").key)
+
+            cache.configure_env()
+            self.assertEqual(os.environ["TI_OFFLINE_CACHE"], "1")
+            self.assertEqual(os.environ["TI_OFFLINE_CACHE_FILE_PATH"], str(cache.dir / "taichi"))
+            self.assertEqual(os.environ["GS_CACHE_FILE_PATH"], str(cache.dir / "genesis"))
+
+            (cache.dir / "taichi" / "kernels.tcb").write_bytes(b"")
+            topo = topology_hash([("box", (1.0, 1.0, 1.0), False, True)], n_envs=0, substeps=8)
+            self.assertFalse(cache.scene_seen_before(topo))
+            cache.record_scene(topo, n_entities=1)
+            self.assertTrue(cache.scene_seen_before(topo))
+            self.assertEqual(list((cache.dir / "scenes").glob("*.tmp")), [])
+            # Markers only record that a topology was built; they survive a wiped kernel cache.
+            for f in (cache.dir / "taichi").iterdir():
+                f.unlink()
+            self.assertTrue(cache.scene_seen_before(topo))
+
+    def test_topology_hash_tracks_entities_and_build_options(self) -> None:
+        records = [("plane", True, True), ("box", (1.0, 0.5, 0.3), False, True)]
+        base = topology_hash(records, n_envs=0, substeps=8)
+        self.assertEqual(base, topology_hash(list(records), n_envs=0, substeps=8))
+        self.assertNotEqual(base, topology_hash(records[:1], n_envs=0, substeps=8))
+        self.assertNotEqual(base, topology_hash(records, n_envs=4, substeps=8))
+        self.assertNotEqual(base, topology_hash(records, n_envs=0, substeps=4))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,122 @@
+from __future__ import annotations
+
+import random
+import unittest
+from pathlib import Path
+import sys
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.actors import NPCBlock, NPCBlockConfig, NPCCrowdPolicy, compute_crowd_avoidance, step_control_all
+from kiln.actors.pathfinding import AABB, NavGrid
+from kiln.actors.planner import CrowdPlanner
+
+
+class _Entity:
+    pass
+
+
+class _KinematicSim:
+    """Duck-typed sim: boxes integrate the last commanded planar velocity each step."""
+
+    def __init__(self) -> None:
+        self.pos: dict[int, list[float]] = {}
+        self.vel: dict[int, tuple[float, float]] = {}
+
+    def add_box(self, *, position, **_: object) -> _Entity:
+        ent = _Entity()
+        self.pos[id(ent)] = list(position)
+        self.vel[id(ent)] = (0.0, 0.0)
+        return ent
+
+    def get_position(self, ent: _Entity) -> tuple[float, float, float]:
+        x, y, z = self.pos[id(ent)]
+        return (x, y, z)
+
+    def set_linear_angular_velocity(self, ent: _Entity, v, w) -> None:
+        self.vel[id(ent)] = (float(v[0]), float(v[1]))
+
+    def positions_by_id(self) -> dict[int, tuple[float, float, float]]:
+        return {k: (p[0], p[1], p[2]) for k, p in self.pos.items()}
+
+    def step(self, dt: float) -> None:
+        for k, (vx, vy) in self.vel.items():
+            self.pos[k][0] += vx * dt
+            self.pos[k][1] += vy * dt
+
+
+def _world(seed: int, *, with_planner: bool) -> tuple[_KinematicSim, list[NPCBlock], CrowdPlanner | None]:
+    sim = _KinematicSim()
+    grid = NavGrid.build(
+        xy_min=(-8.0, -8.0),
+        xy_max=(8.0, 8.0),
+        cell_size=0.5,
+        obstacles=[AABB(-1.0, -6.0, 1.0, 4.0), AABB(3.0, 2.0, 6.0, 3.0)],
+        inflate=0.3,
+    )
+    planner = CrowdPlanner(grid) if with_planner else None
+    cfg = NPCBlockConfig(roam_xy_min=(-7.5, -7.5), roam_xy_max=(7.5, 7.5), stuck_steps=12)
+    rnd = random.Random(seed)
+    npcs = []
+    for i in range(24):
+        cell = grid.sample_free_cell(rnd, component=grid.component_of((0, 0)))
+        assert cell is not None
+        x, y = grid.cell_center_world(cell)
+        npcs.append(
+            NPCBlock(
+                sim,
+                name=f"npc_{i}",
+                position=(x, y, 0.15),
+                config=cfg,
+                rng=random.Random(seed * 1000 + i),
+                # A few NPCs roam without a nav grid (goal-tolerance branch).
+                nav_grid=grid if i % 6 else None,
+                planner=planner,
+            )
+        )
+    return sim, npcs, planner
+
+
+class TestNPCCrowdPolicy(unittest.TestCase):
+    def _run(self, *, with_planner: bool) -> None:
+        dt = 0.05
+        sim_a, npcs_a, planner_a = _world(3, with_planner=with_planner)
+        sim_b, npcs_b, planner_b = _world(3, with_planner=with_planner)
+        crowd = NPCCrowdPolicy(npcs_b)
+        obstacles_a = [n.entity for n in npcs_a]
+        obstacles_b = [n.entity for n in npcs_b]
+
+        for _ in range(400):
+            pos_a = sim_a.positions_by_id()
+            actions_a = []
+            avoidance = compute_crowd_avoidance(npcs_a, obstacles_a, positions_by_id=pos_a)
+            for npc in npcs_a:
+                a = npc.policy_step(positions_by_id=pos_a, avoidance=avoidance)
+                npc.apply_action(a)
+                actions_a.append(int(a))
+
+            actions_b = crowd.step(obstacles_b, positions_by_id=sim_b.positions_by_id())
+            self.assertEqual(actions_b.tolist(), actions_a)
+
+            for planner in (planner_a, planner_b):
+                if planner is not None:
+                    planner.solve_pending()
+            step_control_all(sim_a, dt)
+            step_control_all(sim_b, dt)
+            sim_a.step(dt)
+            sim_b.step(dt)
+
+        self.assertEqual(list(sim_a.pos.values()), list(sim_b.pos.values()))
+        self.assertLess(crowd.stats["python_fallbacks"], 400 * len(npcs_b) // 2)
+
+    def test_matches_per_npc_loop_inline_astar(self) -> None:
+        self._run(with_planner=False)
+
+    def test_matches_per_npc_loop_with_planner(self) -> None:
+        self._run(with_planner=True)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,97 @@
+from __future__ import annotations
+
+import random
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.actors import CarBlock, NPCBlock, NPCBlockConfig, ObservationBuffer, ObservationSpec
+from kiln.actors.actions import DiscreteAction
+from kiln.actors.observations import ACTOR_OBS_SPEC, NPC_OBS_SPEC
+
+
+class _Entity:
+    pass
+
+
+class _Sim:
+    """Duck-typed sim: boxes stay where they were spawned unless moved by the test."""
+
+    def __init__(self) -> None:
+        self.pos: dict[int, tuple[float, float, float]] = {}
+
+    def add_box(self, *, position, **_: object) -> _Entity:
+        ent = _Entity()
+        self.pos[id(ent)] = tuple(position)
+        return ent
+
+    def get_position(self, ent: _Entity) -> tuple[float, float, float]:
+        return self.pos[id(ent)]
+
+
+def _row(state) -> list[float]:
+    return [*state.position, state.yaw, state.linear_speed, state.yaw_rate]
+
+
+class TestObservationBuffer(unittest.TestCase):
+    def test_matches_actor_state(self) -> None:
+        sim = _Sim()
+        cars = [CarBlock(sim, name=f"car{i}", position=(float(i), 2.0 * i, 0.15)) for i in range(5)]
+        for i, car in enumerate(cars):
+            for _ in range(i):
+                car.apply_action(DiscreteAction.ACCELERATE)
+            car.apply_action(DiscreteAction.TURN_LEFT)
+        buf = ObservationBuffer(cars)
+        self.assertIs(buf.spec, ACTOR_OBS_SPEC)
+        obs = buf.update()
+        self.assertEqual((obs.shape, obs.dtype), ((5, ACTOR_OBS_SPEC.dim), np.float32))
+        expected = np.array([_row(c.state()) for c in cars], dtype=np.float32)
+        np.testing.assert_array_equal(obs, expected)
+        np.testing.assert_array_equal(buf.field("linear_speed"), expected[:, 4])
+
+        # Same array every update, refreshed in place.
+        cars[2].apply_action(DiscreteAction.ACCELERATE)
+        self.assertIs(buf.update(), obs)
+        self.assertEqual(float(obs[2, 4]), np.float32(cars[2].state().linear_speed))
+
+    def test_non_contiguous_slots(self) -> None:
+        sim = _Sim()
+        cars = [CarBlock(sim, name=f"car{i}", position=(float(i), 0.0, 0.15)) for i in range(6)]
+        picked = [cars[4], cars[1], cars[3]]
+        obs = ObservationBuffer(picked).update()
+        np.testing.assert_array_equal(obs[:, 0], np.array([4.0, 1.0, 3.0], dtype=np.float32))
+
+    def test_npc_layout(self) -> None:
+        sim = _Sim()
+        cfg = NPCBlockConfig(roam_xy_min=(-5.0, -5.0), roam_xy_max=(5.0, 5.0))
+        npcs = [NPCBlock(sim, name=f"npc{i}", position=(float(i), 0.0, 0.15), config=cfg, rng=random.Random(i)) for i in range(3)]
+        goals = [npc.pick_new_goal() for npc in npcs]
+        buf = ObservationBuffer(npcs)
+        self.assertIs(buf.spec, NPC_OBS_SPEC)
+        obs = buf.update()
+        np.testing.assert_allclose(buf.field("goal_xy"), np.array(goals, dtype=np.float32))
+        np.testing.assert_array_equal(buf.field("has_goal"), np.ones(3, dtype=np.float32))
+
+        # Mixed groups fall back to the shared actor layout.
+        mixed = ObservationBuffer([*npcs, CarBlock(sim, name="car")])
+        self.assertIs(mixed.spec, ACTOR_OBS_SPEC)
+        np.testing.assert_array_equal(mixed.update()[:3], obs[:, : ACTOR_OBS_SPEC.dim])
+
+    def test_spec_validation(self) -> None:
+        with self.assertRaises(ValueError):
+            ObservationSpec(("position", "velocity"))
+        with self.assertRaises(ValueError):
+            ObservationSpec(("yaw", "yaw"))
+        self.assertEqual(NPC_OBS_SPEC.slices["goal_xy"], slice(6, 8))
+        with self.assertRaises(ValueError):
+            ObservationBuffer([CarBlock(_Sim())], NPC_OBS_SPEC)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,178 @@
+from __future__ import annotations
+
+import gc
+import math
+import random
+import unittest
+import weakref
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.actors.pathfinding import _SEARCHES, AABB, NavGrid, _aabb_intersects, astar
+from kiln.actors.planner import CrowdPlanner
+
+
+def _brute_force_blocked(
+    xy_min: tuple[float, float], cell_size: float, width: int, height: int, obstacles: list[AABB]
+) -> list[list[bool]]:
+    xmin, ymin = xy_min
+    rows = []
+    for iy in range(height):
+        row = []
+        for ix in range(width):
+            cx0 = xmin + ix * cell_size
+            cy0 = ymin + iy * cell_size
+            row.append(any(_aabb_intersects(cx0, cy0, cx0 + cell_size, cy0 + cell_size, o) for o in obstacles))
+        rows.append(row)
+    return rows
+
+
+class TestNavGrid(unittest.TestCase):
+    def test_rasterization_matches_cell_intersection_test(self) -> None:
+        rng = random.Random(0)
+        for cell_size in (0.25, 0.5, 0.3):
+            obstacles = []
+            for _ in range(25):
+                x = rng.uniform(-12.0, 12.0)
+                y = rng.uniform(-12.0, 12.0)
+                obstacles.append(AABB(x, y, x + rng.uniform(0.0, 3.0), y + rng.uniform(0.0, 3.0)))
+            # Boundaries exactly on cell edges and obstacles partly outside the grid.
+            obstacles.append(AABB(-1.0, -1.0, 1.0, 1.0))
+            obstacles.append(AABB(9.0, 9.0, 14.0, 14.0))
+
+            grid = NavGrid.build(
+                xy_min=(-10.0, -10.0), xy_max=(10.0, 10.0), cell_size=cell_size, obstacles=obstacles, inflate=0.2
+            )
+            inflated = [o.inflated(0.2) for o in obstacles]
+            expected = _brute_force_blocked(grid.xy_min, cell_size, grid.width, grid.height, inflated)
+            self.assertEqual(grid.occupancy.tolist(), expected)
+            self.assertEqual(grid.blocked, tuple(tuple(r) for r in expected))
+            for iy in range(grid.height):
+                for ix in range(grid.width):
+                    self.assertEqual(grid.is_blocked((ix, iy)), expected[iy][ix])
+
+    def test_packed_store_and_vectorized_lookup(self) -> None:
+        grid = NavGrid.build(
+            xy_min=(0.0, 0.0), xy_max=(10.0, 5.0), cell_size=0.5, obstacles=[AABB(2.1, 1.1, 3.9, 2.9)]
+        )
+        self.assertEqual((grid.width, grid.height), (20, 10))
+        self.assertEqual(grid.bits.shape, (10, 3))
+        self.assertTrue(bool(grid.blocked_at([3.0], [2.0])[0]))
+        self.assertFalse(bool(grid.blocked_at([8.0], [4.0])[0]))
+        self.assertEqual(list(grid.neighbors4((0, 0))), [(1, 0), (0, 1)])
+
+    def test_astar_routes_around_obstacle(self) -> None:
+        grid = NavGrid.build(
+            xy_min=(0.0, 0.0), xy_max=(5.0, 5.0), cell_size=1.0, obstacles=[AABB(2.2, 0.0, 2.8, 3.8)]
+        )
+        path = astar(grid, (0, 0), (4, 0))
+        self.assertIsNotNone(path)
+        assert path is not None
+        self.assertEqual(path[0], (0, 0))
+        self.assertEqual(path[-1], (4, 0))
+        self.assertTrue(all(not grid.is_blocked(c) for c in path))
+
+    def test_diagonal_and_jps_find_equal_cost_paths(self) -> None:
+        rng = random.Random(1)
+        occ = [[rng.random() < 0.25 for _ in range(24)] for _ in range(18)]
+        grid = NavGrid.from_occupancy(xy_min=(0.0, 0.0), xy_max=(24.0, 18.0), cell_size=1.0, occupancy=occ)
+
+        def cost(path: list[tuple[int, int]]) -> float:
+            total = 0.0
+            for a, b in zip(path, path[1:]):
+                dx, dy = abs(a[0] - b[0]), abs(a[1] - b[1])
+                self.assertLessEqual(max(dx, dy), 1)
+                if dx and dy:
+                    # No corner cutting.
+                    self.assertFalse(grid.is_blocked((b[0], a[1])) or grid.is_blocked((a[0], b[1])))
+                    total += math.sqrt(2.0)
+                else:
+                    total += 1.0
+                self.assertFalse(grid.is_blocked(b))
+            return total
+
+        free = [(ix, iy) for iy in range(grid.height) for ix in range(grid.width) if not grid.is_blocked((ix, iy))]
+        for _ in range(50):
+            start, goal = rng.choice(free), rng.choice(free)
+            p4 = astar(grid, start, goal)
+            p8 = astar(grid, start, goal, diagonal=True)
+            pj = astar(grid, start, goal, jps=True)
+            self.assertEqual(p8 is None, pj is None)
+            if p8 is None or pj is None:
+                continue
+            self.assertIsNotNone(p4)
+            self.assertEqual((pj[0], pj[-1]), (start, goal))
+            self.assertAlmostEqual(cost(p8), cost(pj))
+
+    def test_component_labels_reject_unreachable_goals(self) -> None:
+        # A walled courtyard (cells 6..8 x 6..8) inside an open 12x12 grid.
+        occ = [[False] * 12 for _ in range(12)]
+        for i in range(5, 10):
+            occ[5][i] = occ[9][i] = occ[i][5] = occ[i][9] = True
+        grid = NavGrid.from_occupancy(xy_min=(0.0, 0.0), xy_max=(12.0, 12.0), cell_size=1.0, occupancy=occ)
+
+        self.assertEqual(grid.n_components, 2)
+        self.assertEqual(grid.component_of((5, 5)), -1)
+        self.assertTrue(grid.reachable((0, 0), (11, 11)))
+        self.assertFalse(grid.reachable((0, 0), (7, 7)))
+        self.assertIsNone(astar(grid, (0, 0), (7, 7)))
+        inner = grid.component_of((7, 7))
+        self.assertEqual(grid.component_size(inner), 9)
+        self.assertEqual(sum(grid.component_size(k) for k in range(grid.n_components)), 144 - 16)
+        # One byte per cell for few components; the free-cell index waits for the first sample.
+        self.assertEqual(grid.labels.dtype, np.int8)
+        self.assertNotIn("free_cells", vars(grid))
+
+        rng = random.Random(0)
+        for _ in range(20):
+            c = grid.sample_free_cell(rng, component=inner)
+            assert c is not None
+            self.assertEqual(grid.component_of(c), inner)
+        self.assertEqual(grid.free_cells.shape, (144 - 16,))
+
+    def test_search_cache_does_not_keep_grids_alive(self) -> None:
+        grid = NavGrid.build(xy_min=(0.0, 0.0), xy_max=(8.0, 8.0), cell_size=1.0, obstacles=[])
+        self.assertIsNotNone(astar(grid, (0, 0), (7, 7)))
+        self.assertIn(grid, _SEARCHES)
+        ref = weakref.ref(grid)
+        del grid
+        gc.collect()
+        self.assertIsNone(ref())
+
+    def test_crowd_planner_batches_shared_goals_and_caches(self) -> None:
+        grid = NavGrid.build(
+            xy_min=(0.0, 0.0), xy_max=(10.0, 10.0), cell_size=1.0, obstacles=[AABB(4.2, 0.0, 4.8, 7.8)]
+        )
+        planner = CrowdPlanner(grid, shared_goal_min=3)
+        goal = (9, 0)
+        reqs = [planner.submit((0, iy), goal) for iy in range(5)] + [planner.submit((0, 0), goal)]
+        self.assertFalse(any(r.done for r in reqs))
+        self.assertEqual(planner.solve_pending(), 6)
+        self.assertEqual(planner.stats["shared_goal_searches"], 1)
+        for r in reqs:
+            self.assertTrue(r.done)
+            assert r.waypoints is not None
+            ref = astar(grid, r.start, goal)
+            assert ref is not None
+            self.assertEqual(r.waypoints[0], grid.cell_center_world(r.start))
+            self.assertEqual(r.waypoints[-1], grid.cell_center_world(goal))
+            # 4-connected waypoints are the corners of axis-aligned runs: their Manhattan length is
+            # the step count, which must match the independent A* answer.
+            steps = sum(
+                abs(bx - ax) + abs(by - ay) for (ax, ay), (bx, by) in zip(r.waypoints, r.waypoints[1:])
+            ) / grid.cell_size
+            self.assertAlmostEqual(steps, len(ref) - 1)
+
+        again = planner.submit((0, 2), goal)
+        self.assertTrue(again.done)
+        self.assertEqual(planner.stats["cache_hits"], 1)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,127 @@
+from __future__ import annotations
+
+import math
+import random
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from PyQt6.QtGui import QVector3D
+
+from kiln.geometry.bvh import BVH
+from kiln.objects import Box, Plane
+from kiln.ui.instancing import frustum_planes
+from kiln.ui.picking import PickIndex
+
+
+def _brute_pick(objects, o, d):
+    # Per-object local-space test, as the viewport did before the BVH.
+    best, best_t = None, math.inf
+    for obj in objects:
+        inv = np.linalg.inv(obj.transform_array().astype(np.float64))
+        lo = (inv @ np.append(o, 1.0))[:3]
+        ld = (inv @ np.append(d, 0.0))[:3]
+        if isinstance(obj, Box):
+            hs = obj.size / 2.0
+            bmin, bmax = np.array([-hs, 0, -hs]), np.array([hs, obj.size, hs])
+        else:
+            bmin = np.array([-obj.width / 2, 0, -obj.depth / 2])
+            bmax = np.array([obj.width / 2, 0, obj.depth / 2])
+        with np.errstate(divide="ignore", invalid="ignore"):
+            t1 = (bmin - lo) / ld
+            t2 = (bmax - lo) / ld
+        t1, t2 = np.nan_to_num(t1, nan=-np.inf), np.nan_to_num(t2, nan=np.inf)
+        tn, tf = np.minimum(t1, t2).max(), np.maximum(t1, t2).min()
+        if tf >= max(tn, 0.0):
+            t = max(tn, 0.0)
+            if t < best_t:
+                best, best_t = obj, t
+    return best
+
+
+def _city(n: int, seed: int = 0) -> list:
+    rng = random.Random(seed)
+    objs: list = [Plane("ground", width=200.0, depth=200.0)]
+    for i in range(n):
+        b = Box(f"b{i}", size=rng.uniform(0.5, 3.0))
+        b.position = QVector3D(rng.uniform(-80, 80), 0.0, rng.uniform(-80, 80))
+        b.rotation = QVector3D(0.0, rng.uniform(0, 90), 0.0)
+        b.scale = QVector3D(1.0, rng.uniform(1.0, 6.0), 1.0)
+        objs.append(b)
+    return objs
+
+
+class TestPickIndex(unittest.TestCase):
+    def test_matches_brute_force(self) -> None:
+        objs = _city(300)
+        index = PickIndex()
+        index.sync(objs)
+        rng = random.Random(1)
+        for _ in range(200):
+            o = np.array([rng.uniform(-90, 90), rng.uniform(5, 40), rng.uniform(-90, 90)])
+            target = np.array([rng.uniform(-80, 80), 0.0, rng.uniform(-80, 80)])
+            d = (target - o) / np.linalg.norm(target - o)
+            hit = index.pick(o, d)
+            self.assertIs(hit[0] if hit else None, _brute_pick(objs, o, d))
+
+    def test_touch_refits_moved_object(self) -> None:
+        objs = _city(50)
+        index = PickIndex()
+        index.sync(objs)
+        box = objs[10]
+        o, d = np.array([500.0, 1.0, 500.0]), np.array([0.0, -1.0, 0.0])
+        self.assertIsNone(index.pick(o, d))
+        box.position.setX(500.0)  # in-place edit, as the properties panel does
+        box.position.setZ(500.0)
+        index.touch(box)
+        index.sync(objs)
+        self.assertIs(index.pick(o, d)[0], box)
+
+    def test_invalidate_rebuilds(self) -> None:
+        objs = _city(5)
+        index = PickIndex()
+        index.sync(objs)
+        extra = Box("extra", position=QVector3D(300.0, 0.0, 0.0))
+        objs.append(extra)
+        index.invalidate()
+        index.sync(objs)
+        self.assertIs(index.pick(np.array([300.0, 10.0, 0.0]), np.array([0.0, -1.0, 0.0]))[0], extra)
+
+    def test_region_query(self) -> None:
+        a = Box("a", position=QVector3D(0.0, 0.0, -10.0))
+        b = Box("b", position=QVector3D(20.0, 0.0, -10.0))
+        index = PickIndex()
+        index.sync([a, b])
+        # Orthographic-style clip matrix: clip = world, looking down -z.
+        vp = np.eye(4)
+        vp[0, 0] = vp[1, 1] = 1.0 / 30.0
+        vp[2, 2] = -1.0 / 50.0
+        self.assertEqual(index.in_frustum(frustum_planes(vp)), [a, b])
+        self.assertEqual(index.in_frustum(frustum_planes(vp, (-0.2, -1.0, 0.2, 1.0))), [a])
+
+
+class TestBvhQuery(unittest.TestCase):
+    def test_overlap_query(self) -> None:
+        rng = np.random.default_rng(0)
+        lo = rng.uniform(-10, 10, size=(200, 3))
+        hi = lo + rng.uniform(0.1, 1.0, size=(200, 3))
+        bvh = BVH(lo, hi)
+        qlo, qhi = np.array([-2.0, -2.0, -2.0]), np.array([2.0, 2.0, 2.0])
+
+        def accept(bmin, bmax):
+            return np.all((bmin <= qhi) & (bmax >= qlo), axis=1)
+
+        items = bvh.query(accept)
+        exact = np.flatnonzero(accept(lo, hi))
+        self.assertTrue(set(exact.tolist()) <= set(items.tolist()))
+        self.assertEqual(items[accept(lo[items], hi[items])].tolist(), exact.tolist())
+
+
+if __name__ == "__main__":
+    unittest.main()
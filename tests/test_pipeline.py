@@ -0,0 +1,131 @@
+from __future__ import annotations
+
+import threading
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.sim.genesis.batch import PositionSnapshot
+from kiln.sim.genesis.pipeline import PipelineConfig, PipelinedRunner
+
+
+class _CounterSim:
+    """Duck-typed sim: the state is one integer position advanced by the last control."""
+
+    def __init__(self) -> None:
+        self.pos = 0
+        self.command = 0
+        self.step_threads: set[str] = set()
+
+    def snapshot(self) -> int:
+        return self.pos
+
+    def step(self) -> None:
+        self.step_threads.add(threading.current_thread().name)
+        self.pos += self.command
+
+
+class _ReadbackSim:
+    """Duck-typed sim whose readbacks refill one reused host buffer, as `GenesisSim` does on CUDA."""
+
+    def __init__(self) -> None:
+        self.entities = (object(), object())
+        self.x = 0.0
+        self._buf = np.zeros((2, 3))
+
+    def get_positions(self, entities) -> PositionSnapshot:
+        self._buf[:, 0] = self.x
+        return PositionSnapshot(self._buf, {id(e): i for i, e in enumerate(entities)}, entities)
+
+    def snapshot(self) -> PositionSnapshot:
+        return self.get_positions(self.entities)
+
+    def step(self) -> None:
+        self.x += 1.0
+
+
+def _run(latency: int, n: int) -> tuple[_CounterSim, list[tuple[int, int]], list[tuple[int, int, str]]]:
+    sim = _CounterSim()
+    decisions: list[tuple[int, int]] = []
+    observed: list[tuple[int, int, str]] = []
+    pending: dict[int, int] = {}
+
+    def policy(snapshot: int, step_idx: int) -> None:
+        decisions.append((step_idx, snapshot))
+        pending[step_idx] = step_idx + 1
+
+    def control(step_idx: int) -> None:
+        sim.command = pending.pop(step_idx)
+
+    with PipelinedRunner(sim, policy, control=control, config=PipelineConfig(action_latency=latency)) as runner:
+        runner.add_observer(lambda k: observed.append((k, sim.pos, threading.current_thread().name)), every=2)
+        runner.run(n)
+        assert runner.stats["steps"] == n
+    return sim, decisions, observed
+
+
+class TestPipelinedRunner(unittest.TestCase):
+    def test_serial_order(self) -> None:
+        sim, decisions, observed = _run(0, 4)
+        # Step k sees the state after step k-1 and applies command k+1.
+        self.assertEqual(decisions, [(0, 0), (1, 1), (2, 3), (3, 6)])
+        self.assertEqual(sim.pos, 1 + 2 + 3 + 4)
+        self.assertEqual([o[:2] for o in observed], [(0, 1), (2, 6)])
+
+    def test_one_step_latency(self) -> None:
+        sim, decisions, observed = _run(1, 4)
+        # Priming decides step 0; afterwards step k+1 is decided from the pre-step-k snapshot.
+        self.assertEqual(decisions, [(0, 0), (1, 0), (2, 1), (3, 3), (4, 6)])
+        self.assertEqual(sim.pos, 1 + 2 + 3 + 4)
+        # Observers run on the physics worker, right after their step.
+        self.assertEqual([o[:2] for o in observed], [(0, 1), (2, 6)])
+        self.assertTrue(all(o[2].startswith("kiln-physics") for o in observed))
+        self.assertTrue(all(t.startswith("kiln-physics") for t in sim.step_threads))
+
+    def test_observer_readback_keeps_policy_snapshot(self) -> None:
+        sim = _ReadbackSim()
+        refilled = threading.Event()
+        seen: list[float] = []
+
+        def observer(step_idx: int) -> None:
+            sim.get_positions(sim.entities)
+            refilled.set()
+
+        def policy(snapshot: PositionSnapshot, step_idx: int) -> None:
+            if step_idx > 0:
+                # Read only once the worker has refilled the shared buffer with post-step positions.
+                self.assertTrue(refilled.wait(timeout=5.0))
+                refilled.clear()
+            seen.append(float(snapshot.positions[0, 0]))
+
+        with PipelinedRunner(sim, policy, control=lambda k: None) as runner:
+            runner.add_observer(observer)
+            runner.run(3)
+        self.assertEqual(seen, [0.0, 0.0, 1.0, 2.0])
+
+    def test_policy_error_joins_worker(self) -> None:
+        sim = _CounterSim()
+
+        def policy(snapshot: int, step_idx: int) -> None:
+            if step_idx == 2:
+                raise RuntimeError("boom")
+
+        runner = PipelinedRunner(sim, policy, control=lambda k: None)
+        with self.assertRaises(RuntimeError):
+            runner.run(5)
+        runner.close()
+        self.assertEqual(runner.step_idx, 1)
+
+    def test_rejects_unsupported_latency(self) -> None:
+        with self.assertRaises(ValueError):
+            PipelinedRunner(_CounterSim(), lambda s, k: None, control=lambda k: None, config=PipelineConfig(action_latency=2))
+
+
+if __name__ == "__main__":
+    unittest.main()
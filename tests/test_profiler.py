@@ -0,0 +1,123 @@
+from __future__ import annotations
+
+import threading
+import unittest
+from pathlib import Path
+import sys
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.sim.genesis.profiler import Histogram, Profiler, to_prometheus
+
+
+class _FakeDevice:
+    def __init__(self, type: str) -> None:
+        self.type = type
+
+
+class _FakeTensor:
+    def __init__(self, device: str, n: int, itemsize: int = 4) -> None:
+        self.device = _FakeDevice(device)
+        self._n = n
+        self._itemsize = itemsize
+
+    def numel(self) -> int:
+        return self._n
+
+    def element_size(self) -> int:
+        return self._itemsize
+
+
+class TestProfiler(unittest.TestCase):
+    def test_disabled_is_noop(self) -> None:
+        prof = Profiler()
+        self.assertIs(prof.phase("step"), prof.phase("control"))
+        with prof.phase("step"):
+            pass
+        prof.d2h(_FakeTensor("cuda", 10))
+        prof.end_step()
+        snap = prof.snapshot()
+        self.assertEqual(snap["phases"], {})
+        self.assertEqual(sum(snap["counters"].values()), 0)
+
+    def test_phases_and_counters(self) -> None:
+        prof = Profiler(enabled=True)
+        for _ in range(5):
+            with prof.phase("step"):
+                pass
+            prof.end_step()
+        prof.observe("policy", 2e-3)
+        prof.d2h(_FakeTensor("cuda", 12))
+        prof.d2h(_FakeTensor("cuda", 4, itemsize=8), sync=False)
+        prof.d2h(_FakeTensor("cpu", 100))
+        snap = prof.snapshot()
+        self.assertEqual(snap["phases"]["step"]["count"], 5)
+        self.assertAlmostEqual(snap["phases"]["policy"]["sum_s"], 2e-3)
+        self.assertEqual(snap["counters"], {"steps": 5, "device_syncs": 1, "d2h_transfers": 2, "d2h_bytes": 80})
+        prof.reset()
+        self.assertEqual(prof.snapshot()["counters"]["steps"], 0)
+
+    def test_worker_thread_recording(self) -> None:
+        # As under `PipelinedRunner`: workers record readbacks/observers while the main thread steps.
+        prof = Profiler(enabled=True)
+        n_workers, n_iter = 4, 2000
+        start = threading.Barrier(n_workers + 1)
+
+        def worker() -> None:
+            start.wait()
+            for _ in range(n_iter):
+                with prof.phase("readback"):
+                    pass
+                prof.d2h(_FakeTensor("cuda", 3))
+                prof.count("observer_calls")
+
+        threads = [threading.Thread(target=worker) for _ in range(n_workers)]
+        for t in threads:
+            t.start()
+        start.wait()
+        for _ in range(n_iter):
+            with prof.phase("policy"):
+                pass
+            prof.end_step()
+            prof.snapshot()
+        for t in threads:
+            t.join()
+
+        snap = prof.snapshot()
+        total = n_workers * n_iter
+        self.assertEqual(snap["phases"]["readback"]["count"], total)
+        self.assertEqual(snap["phases"]["readback"]["buckets"][-1][1], total)
+        self.assertEqual(snap["phases"]["policy"]["count"], n_iter)
+        counters = {"steps": n_iter, "device_syncs": total, "d2h_transfers": total, "d2h_bytes": 12 * total}
+        self.assertEqual(snap["counters"], {**counters, "observer_calls": total})
+
+    def test_metrics_callback(self) -> None:
+        seen = []
+        prof = Profiler(enabled=True, on_metrics=seen.append, metrics_every=3)
+        for _ in range(7):
+            prof.end_step()
+        self.assertEqual([s["counters"]["steps"] for s in seen], [3, 6])
+
+    def test_histogram_quantiles(self) -> None:
+        h = Histogram((1e-3, 2e-3, 4e-3))
+        for v in [0.5e-3] * 50 + [1.5e-3] * 49 + [3e-3]:
+            h.observe(v)
+        self.assertLessEqual(h.quantile(0.5), 1e-3)
+        self.assertGreater(h.quantile(0.99), 1e-3)
+        self.assertLessEqual(h.quantile(1.0), h.max)
+        self.assertEqual(h.snapshot()["buckets"][-1], (float("inf"), 100))
+
+    def test_prometheus_text(self) -> None:
+        prof = Profiler(enabled=True)
+        prof.observe("step", 1e-3)
+        prof.end_step()
+        text = to_prometheus(prof.snapshot(), labels={"backend": "cpu"})
+        self.assertIn('kiln_sim_steps_total{backend="cpu"} 1', text)
+        self.assertIn('kiln_sim_phase_seconds_bucket{backend="cpu",phase="step",le="+Inf"} 1', text)
+        self.assertIn('kiln_sim_phase_seconds_count{backend="cpu",phase="step"} 1', text)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,113 @@
+from __future__ import annotations
+
+import math
+import random
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.sim.genesis.raycast import RaycastWorld
+
+
+def _ray_aabb(o, d, lo, hi) -> float:
+    t_enter, t_exit = -math.inf, math.inf
+    for a in range(3):
+        if d[a] == 0.0:
+            if not (lo[a] <= o[a] <= hi[a]):
+                return math.inf
+            continue
+        t1 = (lo[a] - o[a]) / d[a]
+        t2 = (hi[a] - o[a]) / d[a]
+        t_enter = max(t_enter, min(t1, t2))
+        t_exit = min(t_exit, max(t1, t2))
+    return t_enter if (t_enter >= 0.0 and t_exit >= t_enter) else math.inf
+
+
+def _ray_sphere(o, d, c, r) -> float:
+    oc = [o[i] - c[i] for i in range(3)]
+    b = sum(oc[i] * d[i] for i in range(3))
+    disc = b * b - (sum(v * v for v in oc) - r * r)
+    if disc < 0.0:
+        return math.inf
+    t = -b - math.sqrt(disc)
+    return t if t >= 0.0 else math.inf
+
+
+class TestRaycastWorld(unittest.TestCase):
+    def test_batch_matches_brute_force(self) -> None:
+        rng = random.Random(0)
+        world = RaycastWorld()
+        boxes, spheres = [], []
+        for i in range(60):
+            c = (rng.uniform(-10, 10), rng.uniform(-10, 10), rng.uniform(0, 3))
+            h = (rng.uniform(0.2, 1.5), rng.uniform(0.2, 1.5), rng.uniform(0.2, 1.5))
+            world.add_shape(("box", i), "box", fixed=True, pos=c, quat=None, half_extents=h)
+            boxes.append((c, h))
+        for i in range(30):
+            c = (rng.uniform(-10, 10), rng.uniform(-10, 10), rng.uniform(0, 3))
+            r = rng.uniform(0.2, 1.0)
+            world.add_shape(("sphere", i), "sphere", fixed=True, pos=c, quat=None, half_extents=(r, r, r))
+            spheres.append((c, r))
+
+        ids = [("box", i) for i in range(len(boxes))] + [("sphere", i) for i in range(len(spheres))]
+        n = 400
+        origins = np.array([(rng.uniform(-12, 12), rng.uniform(-12, 12), rng.uniform(0, 3)) for _ in range(n)])
+        dirs = np.array([(rng.gauss(0, 1), rng.gauss(0, 1), rng.gauss(0, 0.3)) for _ in range(n)])
+        res = world.cast(origins, dirs, 15.0)
+
+        unit = dirs / np.linalg.norm(dirs, axis=1, keepdims=True)
+        for i in range(n):
+            o, d = origins[i].tolist(), unit[i].tolist()
+            ts = [_ray_aabb(o, d, [c[a] - h[a] for a in range(3)], [c[a] + h[a] for a in range(3)]) for c, h in boxes]
+            ts += [_ray_sphere(o, d, c, r) for c, r in spheres]
+            best = min(ts)
+            if best > 15.0:
+                self.assertFalse(bool(res.hit[i]))
+                continue
+            self.assertTrue(bool(res.hit[i]))
+            self.assertAlmostEqual(float(res.distance[i]), best, places=6)
+            self.assertEqual(res.colliders[int(res.collider[i])], ids[ts.index(best)])
+            self.assertAlmostEqual(float(np.linalg.norm(res.normal[i])), 1.0, places=6)
+            self.assertLess(float(np.dot(res.normal[i], unit[i])), 0.0)
+
+    def test_rotated_box_plane_and_dynamic_poses(self) -> None:
+        world = RaycastWorld()
+        # Unit cube yawed 45 degrees: its corner points at the ray, sqrt(2)/2 from the center.
+        yaw = math.pi / 4
+        quat = (math.cos(yaw / 2), 0.0, 0.0, math.sin(yaw / 2))
+        world.add_shape("box", "box", fixed=True, pos=(5.0, 0.0, 0.5), quat=quat, half_extents=(0.5, 0.5, 0.5))
+        world.add_plane("ground", pos=(0.0, 0.0, 0.0), normal=(0.0, 0.0, 1.0))
+        world.add_shape("npc", "cylinder", fixed=False, pos=(0.0, 0.0, 0.5), quat=None, half_extents=(0.3, 0.3, 0.5))
+
+        origins = [[0.0, 0.0, 0.5], [0.0, 3.0, 2.0], [-1.0, 0.0, 0.5]]
+        dirs = [[1.0, 0.0, 0.0], [0.0, 0.0, -1.0], [1.0, 0.0, 0.0]]
+        res = world.cast(origins, dirs, 10.0)
+        # Ray 0 starts inside the cylinder (no self-hit) and reaches the box corner.
+        self.assertEqual(res[0].collider, "box")
+        self.assertAlmostEqual(float(res.distance[0]), 5.0 - math.sqrt(0.5), places=6)
+        self.assertEqual(res[1].collider, "ground")
+        self.assertAlmostEqual(float(res.distance[1]), 2.0, places=6)
+        self.assertEqual(res[2].collider, "npc")
+        self.assertAlmostEqual(float(res.distance[2]), 0.7, places=6)
+        np.testing.assert_allclose(res.normal[2], [-1.0, 0.0, 0.0], atol=1e-9)
+
+        # Move the cylinder off the ray through the pose reader: the box is hit instead.
+        def poses(entities):
+            return np.array([[0.0, 4.0, 0.5]]), np.array([[1.0, 0.0, 0.0, 0.0]])
+
+        for _ in range(3):
+            res = world.cast([-1.0, 0.0, 0.5], [1.0, 0.0, 0.0], 10.0, pose_reader=poses)
+            self.assertEqual(res[0].collider, "box")
+        side = world.cast([0.0, 0.0, 0.5], [0.0, 1.0, 0.0], 10.0, pose_reader=poses)
+        self.assertEqual(side[0].collider, "npc")
+        self.assertAlmostEqual(float(side.distance[0]), 3.7, places=6)
+
+
+if __name__ == "__main__":
+    unittest.main()
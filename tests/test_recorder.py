@@ -0,0 +1,107 @@
+from __future__ import annotations
+
+import tempfile
+import threading
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+import kiln.sim.genesis.recorder as recorder_mod
+from kiln.sim.genesis.collisions import CollisionEvent, CollisionPhase
+from kiln.sim.genesis.recorder import EpisodeRecorder, RecorderConfig, load_recording
+
+
+class _Snap:
+    def __init__(self, positions: np.ndarray) -> None:
+        self.positions = positions
+
+
+class _FakeSim:
+    """Two bodies moving along x; positions come back in a reused buffer like `get_positions`."""
+
+    def __init__(self) -> None:
+        self.t = 0
+        self._buf = np.zeros((2, 3))
+
+    def step(self) -> None:
+        self.t += 1
+
+    def get_positions(self, entities):
+        self._buf[:, 0] = [self.t, -self.t]
+        return _Snap(self._buf)
+
+    def get_quats_batch(self, entities):
+        return np.tile([1.0, 0.0, 0.0, 0.0], (len(entities), 1))
+
+
+class _Camera:
+    def render(self, **kw):
+        return (np.full((4, 4, 3), 7, dtype=np.uint8), None, None, None)
+
+
+def _event(step: int, phase: CollisionPhase) -> CollisionEvent:
+    return CollisionEvent(step_idx=step, phase=phase, other_entity=None, other_entity_id=42, max_force=None)
+
+
+class TestRecorder(unittest.TestCase):
+    def test_roundtrip_over_chunks(self) -> None:
+        sim = _FakeSim()
+        with tempfile.TemporaryDirectory() as d:
+            cfg = RecorderConfig(path=d, chunk_steps=4, frame_every=5)
+            with EpisodeRecorder(sim, cfg, entities=[object(), object()], camera=_Camera(), names=["a", "b"]) as rec:
+                for step in range(10):
+                    sim.step()
+                    events = {1: [_event(step, CollisionPhase.BEGIN)]} if step == 6 else None
+                    rec.record(step, action=np.array([step, 2 * step]), events=events)
+            self.assertEqual(rec.stats["chunks_written"], 3)
+
+            r = load_recording(d)
+            self.assertEqual(len(r), 10)
+            self.assertEqual(r.entities, ["a", "b"])
+            np.testing.assert_array_equal(r.column("step"), np.arange(10))
+            pos = r.column("pos")
+            self.assertEqual(pos.shape, (10, 2, 3))
+            np.testing.assert_array_equal(pos[:, 0, 0], np.arange(1, 11))
+            np.testing.assert_array_equal(r.column("action")[:, 1], 2 * np.arange(10))
+            np.testing.assert_array_equal(r.column("event_step"), [6])
+            np.testing.assert_array_equal(r.column("event_source"), [1])
+            self.assertTrue(np.isnan(r.column("event_force")[0]))
+            np.testing.assert_array_equal(r.column("frame_step"), [0, 5])
+            self.assertEqual(r.column("frame").shape, (2, 4, 4, 3))
+            steps = list(r.iter_steps())
+            self.assertEqual(steps[3][0], 3)
+            np.testing.assert_array_equal(steps[3][2], [[1, 0, 0, 0], [1, 0, 0, 0]])
+
+    def test_drop_when_writer_is_behind(self) -> None:
+        sim = _FakeSim()
+        gate = threading.Event()
+        with tempfile.TemporaryDirectory() as d:
+            rec = EpisodeRecorder(sim, RecorderConfig(path=d, chunk_steps=1, queue_chunks=1, on_full="drop"), entities=[object()])
+            # Hold the writer on its first chunk so the queue fills up.
+            real_arrays = recorder_mod._Chunk.arrays
+
+            def slow_arrays(chunk):
+                gate.wait(5.0)
+                return real_arrays(chunk)
+
+            recorder_mod._Chunk.arrays = slow_arrays
+            try:
+                for step in range(5):
+                    rec.record(step)
+                gate.set()
+                rec.close()
+            finally:
+                recorder_mod._Chunk.arrays = real_arrays
+            self.assertGreater(rec.stats["chunks_dropped"], 0)
+            self.assertEqual(rec.stats["chunks_written"] + rec.stats["chunks_dropped"], 5)
+            self.assertEqual(load_recording(d).meta["chunks_dropped"], rec.stats["chunks_dropped"])
+
+
+if __name__ == "__main__":
+    unittest.main()
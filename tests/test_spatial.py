@@ -0,0 +1,79 @@
+from __future__ import annotations
+
+import math
+import random
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.actors.actions import DiscreteAction
+from kiln.actors.spatial import NO_AVOIDANCE, SpatialHash, proximity_avoidance_actions
+
+
+def _sequential_avoidance(px, py, yaw, obstacles, self_row, avoid_radius, brake_radius) -> int:
+    # Same rules as NPCPolicy._avoid_with_proximity.
+    fx, fy = math.cos(yaw), math.sin(yaw)
+    best_dist = None
+    best_cross = None
+    for j, (ox, oy) in enumerate(obstacles):
+        if j == self_row:
+            continue
+        dx, dy = ox - px, oy - py
+        dist = math.hypot(dx, dy)
+        if dist <= 1e-9:
+            continue
+        if dx * fx + dy * fy <= 0:
+            continue
+        if dist <= brake_radius:
+            return int(DiscreteAction.DECELERATE)
+        if dist <= avoid_radius and (best_dist is None or dist < best_dist):
+            best_dist = dist
+            best_cross = fx * dy - fy * dx
+    if best_dist is None or best_cross is None:
+        return NO_AVOIDANCE
+    return int(DiscreteAction.TURN_RIGHT if best_cross > 0 else DiscreteAction.TURN_LEFT)
+
+
+class TestSpatialHash(unittest.TestCase):
+    def test_query_pairs_matches_brute_force(self) -> None:
+        rng = np.random.default_rng(0)
+        pts = rng.uniform(-20.0, 20.0, size=(300, 2))
+        queries = rng.uniform(-22.0, 22.0, size=(80, 2))
+        grid = SpatialHash(1.5)
+        grid.rebuild(pts)
+        for radius in (0.7, 1.5, 3.2):
+            qi, pj, _, _, dist = grid.query_pairs(queries, radius)
+            got = sorted(zip(qi.tolist(), pj.tolist()))
+            d = np.hypot(*(pts[None, :, :] - queries[:, None, :]).transpose(2, 0, 1))
+            want = sorted(zip(*np.nonzero(d <= radius)))
+            self.assertEqual(got, [(int(a), int(b)) for a, b in want])
+            np.testing.assert_allclose(dist, d[qi, pj])
+
+    def test_crowd_avoidance_matches_sequential_rules(self) -> None:
+        rnd = random.Random(2)
+        n = 200
+        xy = np.array([(rnd.uniform(-8, 8), rnd.uniform(-8, 8)) for _ in range(n)])
+        yaw = np.array([rnd.uniform(-math.pi, math.pi) for _ in range(n)])
+        # Obstacles: every agent plus a few extra bodies (e.g. the car).
+        obstacles = np.concatenate([xy, np.array([(0.0, 0.0), (3.0, -2.0)])])
+        self_idx = np.arange(n)
+        avoid = np.full(n, 1.0)
+        brake = np.full(n, 0.6)
+
+        codes = proximity_avoidance_actions(
+            xy, yaw, obstacles, self_obstacle_idx=self_idx, avoid_radius=avoid, brake_radius=brake
+        )
+        obs_list = [tuple(o) for o in obstacles.tolist()]
+        for i in range(n):
+            expected = _sequential_avoidance(xy[i, 0], xy[i, 1], yaw[i], obs_list, i, 1.0, 0.6)
+            self.assertEqual(int(codes[i]), expected)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,62 @@
+from __future__ import annotations
+
+import tempfile
+import unittest
+from pathlib import Path
+import sys
+from xml.etree.ElementTree import fromstring
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.envio.bundle import Pose, PrimitiveSpec
+from kiln.sim.genesis.compound import can_merge, static_compound_mjcf, write_static_compound
+
+
+def _prims() -> list[PrimitiveSpec]:
+    return [
+        PrimitiveSpec(id="b", shape="box", fixed=True, size=(2.0, 4.0, 6.0), pose=Pose(pos=(1.0, 2.0, 3.0)), color=(255, 0, 0)),
+        PrimitiveSpec(id="s", shape="sphere", fixed=True, radius=0.5, color=(0.1, 0.2, 0.3, 0.4)),
+        PrimitiveSpec(
+            id="c", shape="cylinder", fixed=True, radius=0.25, height=2.0, pose=Pose(quat=(2.0, 0.0, 0.0, 0.0))
+        ),
+    ]
+
+
+class TestStaticCompound(unittest.TestCase):
+    def test_geoms_match_primitives(self) -> None:
+        root = fromstring(static_compound_mjcf(_prims(), name="blk"))
+        bodies = root.findall("./worldbody/body")
+        self.assertEqual(len(bodies), 1)
+        self.assertEqual(bodies[0].get("name"), "blk")
+        # No joint: the body is welded to the world.
+        self.assertEqual(bodies[0].findall("joint") + bodies[0].findall("freejoint"), [])
+
+        box, sphere, cyl = bodies[0].findall("geom")
+        self.assertEqual((box.get("type"), box.get("size"), box.get("pos")), ("box", "1 2 3", "1 2 3"))
+        self.assertEqual(box.get("rgba"), "1 0 0 1")
+        self.assertEqual((sphere.get("size"), sphere.get("rgba")), ("0.5", "0.1 0.2 0.3 0.4"))
+        self.assertEqual((cyl.get("size"), cyl.get("quat")), ("0.25 1", "1 0 0 0"))
+
+    def test_only_fixed_solids_merge(self) -> None:
+        dynamic = PrimitiveSpec(id="d", shape="box", fixed=False, size=(1.0, 1.0, 1.0), mass=1.0)
+        plane = PrimitiveSpec(id="p", shape="plane", fixed=True)
+        self.assertTrue(all(can_merge(p) for p in _prims()))
+        self.assertFalse(can_merge(dynamic))
+        self.assertFalse(can_merge(plane))
+        with self.assertRaises(ValueError):
+            static_compound_mjcf([*_prims(), dynamic])
+
+    def test_file_is_content_addressed(self) -> None:
+        with tempfile.TemporaryDirectory() as d:
+            a = write_static_compound(_prims(), d)
+            b = write_static_compound(_prims(), d)
+            c = write_static_compound(_prims()[:2], d)
+            self.assertEqual(a, b)
+            self.assertNotEqual(a, c)
+            self.assertEqual(len(list(Path(d).glob("*.xml"))), 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
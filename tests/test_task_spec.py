@@ -0,0 +1,92 @@
+from __future__ import annotations
+
+import json
+import shutil
+import tempfile
+import unittest
+from pathlib import Path
+import sys
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.envio.bundle import EnvBundleError, EnvBundleV1, TaskSpec
+
+EXAMPLE = ROOT / "examples" / "env_bundles" / "basic_v1"
+
+
+def _env(task: dict) -> dict:
+    return {
+        "schema_version": 1,
+        "world": {"enabled": False},
+        "spawn_points": {"goal": {"pos": [1.0, 2.0, 0.5]}},
+        "task": task,
+    }
+
+
+class TestTaskSpec(unittest.TestCase):
+    def test_example_bundle_task(self) -> None:
+        bundle = EnvBundleV1.from_json(json.loads((EXAMPLE / "env.json").read_text()))
+        task = bundle.task
+        assert task is not None
+        self.assertEqual(task.agent, "sphere1")
+        self.assertEqual(task.goal, "alt")
+        self.assertEqual(task.roles, {"obstacle": ("box1", "cylinder1")})
+        self.assertEqual([t.type for t in task.rewards], ["progress", "collision", "goal_reached"])
+        self.assertEqual(task.time_limit, 300)
+
+    def test_json_roundtrip(self) -> None:
+        bundle = EnvBundleV1.from_json(
+            _env(
+                {
+                    "agent": "a",
+                    "goal": [1, 2, 3],
+                    "roles": {"wall": "building_*"},
+                    "rewards": [{"type": "collision", "role": "wall", "weight": -2}],
+                    "terminations": [{"type": "contact", "role": "wall"}],
+                    "observations": ["goal_distance", "time_left"],
+                }
+            )
+        )
+        again = EnvBundleV1.from_json(bundle.to_json())
+        self.assertEqual(again.task, bundle.task)
+        self.assertEqual(again.task.goal, (1.0, 2.0, 3.0))
+        self.assertEqual(again.task.roles["wall"], ("building_*",))
+
+    def test_no_task_section(self) -> None:
+        obj = _env({})
+        del obj["task"]
+        bundle = EnvBundleV1.from_json(obj)
+        self.assertIsNone(bundle.task)
+        self.assertNotIn("task", bundle.to_json())
+        self.assertIsNone(TaskSpec.from_json(None, ctx="task"))
+
+    def test_validation(self) -> None:
+        bad = [
+            {"rewards": [{"type": "collision", "role": "lava"}]},
+            {"rewards": [{"type": "speed"}]},
+            {"terminations": [{"type": "contact"}]},
+            {"goal": "nowhere"},
+            {"time_limit": 0},
+            {"observations": ["pixels"]},
+            {"rewards": [{"type": "goal_reached", "radius": -1}]},
+        ]
+        for task in bad:
+            with self.subTest(task=task), self.assertRaises(EnvBundleError):
+                EnvBundleV1.from_json(_env(task))
+
+    def test_compiled_bundle_keeps_task(self) -> None:
+        from kiln.envio.bundle import load_env_bundle
+        from kiln.envio.compiled import compile_env_bundle
+
+        with tempfile.TemporaryDirectory() as d:
+            shutil.copytree(EXAMPLE, Path(d) / "b")
+            compile_env_bundle(Path(d) / "b")
+            compiled = load_env_bundle(Path(d) / "b", compiled=True)
+            plain = load_env_bundle(Path(d) / "b", compiled=False)
+            self.assertEqual(compiled.task, plain.task)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,120 @@
+from __future__ import annotations
+
+import tempfile
+import unittest
+from pathlib import Path
+import sys
+
+import numpy as np
+
+ROOT = Path(__file__).resolve().parents[1]
+if str(ROOT) not in sys.path:
+    sys.path.insert(0, str(ROOT))
+
+from kiln.envio.bundle import CollisionLodSpec, EnvBundleError, WorldSpec
+from kiln.sim.genesis.world_lod import (
+    box_proxies,
+    cluster_triangles,
+    heightfield_proxy,
+    load_world_proxies,
+)
+
+
+def _quad(x0: float, y0: float, x1: float, y1: float, z: float) -> np.ndarray:
+    a, b, c, d = [x0, y0, z], [x1, y0, z], [x1, y1, z], [x0, y1, z]
+    return np.array([[a, b, c], [a, c, d]], dtype=np.float64)
+
+
+def _cube(center: tuple[float, float, float], half: float) -> np.ndarray:
+    c = np.asarray(center, dtype=np.float64)
+    s = np.array([[x, y, z] for x in (-1, 1) for y in (-1, 1) for z in (-1, 1)], dtype=np.float64)
+    v = c + half * s
+    faces = [[0, 1, 3], [0, 3, 2], [4, 6, 7], [4, 7, 5], [0, 4, 5], [0, 5, 1],
+             [2, 3, 7], [2, 7, 6], [0, 2, 6], [0, 6, 4], [1, 5, 7], [1, 7, 3]]
+    return v[np.array(faces)]
+
+
+def _town() -> np.ndarray:
+    # A 20x20 ground with four 1m cubes standing on it.
+    parts = [_quad(-10.0, -10.0, 10.0, 10.0, 0.0)]
+    parts += [_cube((x, y, 0.5), 0.5) for x, y in ((-5.0, -5.0), (5.0, -5.0), (-5.0, 5.0), (5.0, 5.0))]
+    return np.concatenate(parts)
+
+
+class TestProxies(unittest.TestCase):
+    def test_clusters_partition_triangles(self) -> None:
+        tris = _town()
+        clusters = cluster_triangles(tris, 8)
+        self.assertLessEqual(len(clusters), 8)
+        self.assertEqual(sorted(np.concatenate(clusters).tolist()), list(range(len(tris))))
+        self.assertEqual(len(cluster_triangles(tris, 1)), 1)
+
+    def test_boxes_bound_their_clusters(self) -> None:
+        tris = _town()
+        centers, halves = box_proxies(tris, 8)
+        pts = tris.reshape(-1, 3)
+        inside = np.all(np.abs(pts[:, None, :] - centers[None]) <= halves[None] + 1e-9, axis=2)
+        self.assertTrue(inside.any(axis=1).all())
+        # Flat ground clusters still get some thickness.
+        self.assertTrue((halves > 0.0).all())
+
+    def test_heightfield_samples_top_surface(self) -> None:
+        heights, origin = heightfield_proxy(_town(), 0.25)
+        self.assertEqual(origin, (-10.0, -10.0))
+        self.assertEqual(heights.shape, (81, 81))
+
+        def h(x: float, y: float) -> float:
+            return float(heights[int(round((x - origin[0]) / 0.25)), int(round((y - origin[1]) / 0.25))])
+
+        # Sample points off the quads' diagonals.
+        self.assertAlmostEqual(h(2.0, -3.0), 0.0)
+        self.assertAlmostEqual(h(5.25, 4.75), 1.0)
+        self.assertAlmostEqual(h(-4.75, 5.25), 1.0)
+
+
+class TestProxyCache(unittest.TestCase):
+    def test_cached_by_source_and_settings(self) -> None:
+        calls = []
+
+        def load() -> np.ndarray:
+            calls.append(1)
+            return _town()
+
+        with tempfile.TemporaryDirectory() as d:
+            dirs = (Path(d) / "collision",)
+            lod = CollisionLodSpec(type="boxes", max_parts=6)
+            a = load_world_proxies(lod, source_digest="abc", load_triangles=load, cache_dirs=dirs)
+            b = load_world_proxies(lod, source_digest="abc", load_triangles=load, cache_dirs=dirs)
+            self.assertEqual(len(calls), 1)
+            self.assertEqual(a.key, b.key)
+            np.testing.assert_allclose(a.centers, b.centers)
+            np.testing.assert_allclose(a.triangles(), b.triangles())
+
+            load_world_proxies(lod, source_digest="def", load_triangles=load, cache_dirs=dirs)
+            hf = load_world_proxies(
+                CollisionLodSpec(type="heightfield", cell_size=1.0), source_digest="abc", load_triangles=load, cache_dirs=dirs
+            )
+            self.assertEqual(len(calls), 3)
+            self.assertEqual(len(list(dirs[0].glob("*.npz"))), 3)
+            again = load_world_proxies(
+                CollisionLodSpec(type="heightfield", cell_size=1.0), source_digest="abc", load_triangles=load, cache_dirs=dirs
+            )
+            np.testing.assert_allclose(again.heights, hf.heights)
+            self.assertEqual(len(calls), 3)
+
+
+class TestWorldSpecLod(unittest.TestCase):
+    def test_json(self) -> None:
+        self.assertNotIn("collision_lod", WorldSpec().to_json())
+        w = WorldSpec.from_json({"collision_lod": "heightfield"}, ctx="world")
+        self.assertEqual(w.collision_lod.type, "heightfield")
+        w = WorldSpec.from_json({"collision_lod": {"type": "boxes", "max_parts": 12}}, ctx="world")
+        self.assertEqual(WorldSpec.from_json(w.to_json(), ctx="world"), w)
+        with self.assertRaises(EnvBundleError):
+            WorldSpec.from_json({"collision_lod": "voxels"}, ctx="world")
+        with self.assertRaises(EnvBundleError):
+            WorldSpec.from_json({"collision_lod": {"type": "boxes", "max_parts": 0}}, ctx="world")
+
+
+if __name__ == "__main__":
+    unittest.main()